@@ -69,6 +69,9 @@ endif ()
 if (OGRE_BUILD_PLUGIN_BSP)
 	set(_plugins "${_plugins}  + BSP scene manager\n")
 endif ()
+if (OGRE_BUILD_PLUGIN_BVH)
+	set(_plugins "${_plugins}  + BVH scene manager\n")
+endif ()
 if (OGRE_BUILD_PLUGIN_CG)
 	set(_plugins "${_plugins}  + Cg program manager\n")
 endif ()
@@ -111,6 +114,9 @@ endif ()
 if (OGRE_BUILD_RENDERSYSTEM_GLES2)
 	set(_rendersystems "${_rendersystems}  + OpenGL ES2/ ES3\n")
 endif ()
+if (OGRE_BUILD_RENDERSYSTEM_NULL)
+	set(_rendersystems "${_rendersystems}  + Null (headless)\n")
+endif ()
 
 if (DEFINED _rendersystems)
 	set(_features "${_features}Building rendersystems:\n${_rendersystems}")
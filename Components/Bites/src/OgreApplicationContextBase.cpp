@@ -241,14 +241,16 @@ void ApplicationContextBase::enableShaderCache() const
 
     // Load for a package version of the shaders.
     Ogre::String path = mFSLayer->getWritablePath(SHADER_CACHE_FILENAME);
-    std::ifstream inFile(path.c_str(), std::ios::binary);
-    if (!inFile.is_open())
+    std::ifstream* inFile = OGRE_NEW_T(std::ifstream, Ogre::MEMCATEGORY_GENERAL)(path.c_str(), std::ios::binary);
+    if (!inFile->is_open())
     {
+        OGRE_DELETE_T(inFile, basic_ifstream, Ogre::MEMCATEGORY_GENERAL);
         Ogre::LogManager::getSingleton().logWarning("Could not open '"+path+"'");
         return;
     }
     Ogre::LogManager::getSingleton().logMessage("Loading shader cache from '"+path+"'");
-    Ogre::DataStreamPtr istream(new Ogre::FileStreamDataStream(path, &inFile, false));
+    // the microcodes are read on first use, so the stream owns the file
+    Ogre::DataStreamPtr istream(new Ogre::FileStreamDataStream(path, inFile, true));
     Ogre::GpuProgramManager::getSingleton().loadMicrocodeCache(istream);
 }
 
@@ -511,7 +513,10 @@ void ApplicationContextBase::shutdown()
     if (gpuMgr.getSaveMicrocodesToCache() && gpuMgr.isCacheDirty())
     {
         Ogre::String path = mFSLayer->getWritablePath(SHADER_CACHE_FILENAME);
-        std::fstream outFile(path.c_str(), std::ios::out | std::ios::binary);
+        // do not truncate the cache before the entries not used yet are copied from it
+        std::fstream outFile(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        if (!outFile.is_open())
+            outFile.open(path.c_str(), std::ios::out | std::ios::binary);
 
         if (outFile.is_open())
         {
@@ -12,6 +12,9 @@
 #ifdef OGRE_BUILD_RENDERSYSTEM_GLES2
 #define OGRE_STATIC_GLES2
 #endif
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+#define OGRE_STATIC_Null
+#endif
 #ifdef OGRE_BUILD_RENDERSYSTEM_D3D9
 #define OGRE_STATIC_Direct3D9
 #endif
@@ -30,6 +33,10 @@
 #define OGRE_STATIC_CgProgramManager
 #endif
 
+#ifdef OGRE_BUILD_PLUGIN_BVH
+#define OGRE_STATIC_BVHSceneManager
+#endif
+
 #ifdef OGRE_USE_PCZ
     #ifdef OGRE_BUILD_PLUGIN_PCZ
     #define OGRE_STATIC_PCZSceneManager
@@ -49,6 +56,9 @@
 #ifdef OGRE_STATIC_OctreeSceneManager
 #  include "OgreOctreePlugin.h"
 #endif
+#ifdef OGRE_STATIC_BVHSceneManager
+#  include "OgreBVHPlugin.h"
+#endif
 #ifdef OGRE_STATIC_ParticleFX
 #  include "OgreParticleFXPlugin.h"
 #endif
@@ -64,6 +74,9 @@
 #ifdef OGRE_STATIC_GLES2
 #  include "OgreGLES2Plugin.h"
 #endif
+#ifdef OGRE_STATIC_Null
+#  include "OgreNullPlugin.h"
+#endif
 #ifdef OGRE_STATIC_Direct3D9
 #  include "OgreD3D9Plugin.h"
 #endif
@@ -101,6 +114,10 @@ void OgreBites::StaticPluginLoader::load()
     plugin = OGRE_NEW GLES2Plugin();
     mPlugins.push_back(plugin);
 #endif
+#ifdef OGRE_STATIC_Null
+    plugin = OGRE_NEW NullPlugin();
+    mPlugins.push_back(plugin);
+#endif
 #ifdef OGRE_STATIC_Direct3D9
     plugin = OGRE_NEW D3D9Plugin();
     mPlugins.push_back(plugin);
@@ -118,6 +135,10 @@ void OgreBites::StaticPluginLoader::load()
     plugin = OGRE_NEW OctreePlugin();
     mPlugins.push_back(plugin);
 #endif
+#ifdef OGRE_STATIC_BVHSceneManager
+    plugin = OGRE_NEW BVHPlugin();
+    mPlugins.push_back(plugin);
+#endif
 #ifdef OGRE_STATIC_ParticleFX
     plugin = OGRE_NEW ParticleFXPlugin();
     mPlugins.push_back(plugin);
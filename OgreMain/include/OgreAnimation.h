@@ -279,6 +279,24 @@ namespace Ogre {
         void apply(Skeleton* skeleton, Real timePos, float weight,
           const AnimationState::BoneBlendMask* blendMask, Real scale);
 
+        /** Internal method applying all node tracks to a skeleton, used by the apply methods
+            and Skeleton::setAnimationState.
+        @remarks
+            If setUsePackedKeyFrames is enabled and spline interpolation is not used, all
+            tracks are sampled in one go from packed copies of their key frames, which are
+            built on demand. The result is the same as applying each track with
+            NodeAnimationTrack::applyToNode.
+        @param skeleton
+        @param timePos The time position in the animation to apply.
+        @param weight The influence to give to this animation.
+        @param blendMask Additional per bone weights, may be null.
+        @param scale The scale to apply to translations and scalings.
+        @param cursor Global key frame index found by the previous call for the same playback,
+            updated on return, see _getTimeIndex. May be null.
+        */
+        void _applyToSkeleton(Skeleton* skeleton, Real timePos, Real weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale, uint* cursor = 0);
+
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
         @param timePos The time position in the animation to apply.
@@ -349,6 +367,17 @@ namespace Ogre {
         */
         RotationInterpolationMode getRotationInterpolationMode(void) const;
 
+        /** Sets whether skeletons sample copies of the node key frames packed per component.
+        @remarks
+            Sampling the packed copies is faster than applying the tracks one by one, but
+            the copies cost another 44 bytes per key frame with single precision Real.
+            Compressed tracks and spline interpolation always sample the tracks. Disabled
+            by default.
+        */
+        void setUsePackedKeyFrames(bool usePacked);
+        /** Gets whether skeletons sample packed copies of the node key frames. */
+        bool getUsePackedKeyFrames(void) const { return mUsePackedKeyFrames; }
+
         // Methods for setting the defaults
         /** Sets the default animation interpolation mode. 
         @remarks
@@ -423,6 +452,20 @@ namespace Ogre {
         */
         void optimise(bool discardIdentityNodeTracks = true);
 
+        /** Removes the node keyframes which can be interpolated from the remaining ones
+            within the given tolerances, see NodeAnimationTrack::reduceKeyFrames.
+        @remarks
+            Meant for offline processing, e.g. before exporting with SkeletonSerializer.
+        */
+        void reduceNodeKeyFrames(Real translationTolerance, const Radian& rotationTolerance,
+            Real scaleTolerance);
+
+        /** Stores the keyframes of all node tracks quantised, see NodeAnimationTrack::compress.
+        @remarks
+            Use reduceNodeKeyFrames first to bound the error and save more memory.
+        */
+        void compressNodeTracks(void);
+
         /// A list of track handles
         typedef std::set<ushort> TrackHandleList;
 
@@ -449,7 +492,11 @@ namespace Ogre {
         
         /** Internal method used to tell the animation that keyframe list has been
             changed, which may cause it to rebuild some internal data */
-        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; }
+        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; mPackedNodeTracksDirty = true; }
+
+        /** Internal method used to tell the animation that the data of a node keyframe
+            has been changed, so the packed key frames need to be rebuilt */
+        void _keyFrameDataChanged(void) { mPackedNodeTracksDirty = true; }
 
         /** Internal method used to convert time position to time index object.
         @note
@@ -462,6 +509,22 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** Internal method used to convert time position to time index object, for
+            sequential playback.
+        @param timePos The time position.
+        @param cursor The global keyframe index returned for the previous time position of
+            the same playback, which is updated. If the time position is within the same or
+            the next keyframe interval, no search is needed.
+        */
+        TimeIndex _getTimeIndex(Real timePos, uint& cursor) const;
+
+        /** Internal method building everything apply would otherwise build on first use.
+        @remarks
+            Afterwards the node tracks of this animation can be applied to several skeletons
+            from different threads at once, as long as the animation is not modified.
+        */
+        void _prepareForConcurrentApply(void);
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -528,6 +591,34 @@ namespace Ogre {
         /// Dirty flag indicate that keyframe time list need to rebuild
         mutable bool mKeyFrameTimesDirty;
 
+        /** Key frames of all node tracks in separate arrays per component, for _applyToSkeleton
+        @remarks
+            This is a copy, only made if setUsePackedKeyFrames is enabled, costing 44 bytes per key frame of uncompressed tracks with single
+            precision Real, on top of the 64 bytes of each TransformKeyFrame on 64 bit targets.
+            The global to local key frame index maps are not copied, but read from the tracks.
+        */
+        struct PackedNodeTracks
+        {
+            struct Track
+            {
+                NodeAnimationTrack* track;
+                unsigned short handle;
+                /// Range of the key frames of this track in the arrays below, empty for
+                /// compressed tracks, which are sampled by the track
+                uint firstKey;
+                uint numKeys;
+            };
+            std::vector<Track> tracks;
+            std::vector<Real> times;
+            std::vector<Vector3> translates;
+            std::vector<Quaternion> rotations;
+            std::vector<Vector3> scales;
+        };
+        PackedNodeTracks mPackedNodeTracks;
+        /// Dirty flag indicate that the packed node tracks need to rebuild
+        bool mPackedNodeTracksDirty;
+        bool mUsePackedKeyFrames;
+
         bool mUseBaseKeyFrame;
         Real mBaseKeyFrameTime;
         String mBaseKeyFrameAnimationName;
@@ -538,6 +629,8 @@ namespace Ogre {
 
         /// Internal method to build global keyframe time list
         void buildKeyFrameTimeList(void) const;
+        /// Internal method to build mPackedNodeTracks
+        void buildPackedNodeTracks(void);
     };
 
     /** @} */
@@ -169,6 +169,11 @@ namespace Ogre {
           assert(mBlendMask && mBlendMask->size() > boneHandle);
           return (*mBlendMask)[boneHandle];
       }
+
+        /** Internal method returning the key frame index found when this state was last
+            applied, which lets Animation::_applyToSkeleton continue the search from there.
+        */
+        uint& _getKeyFrameCursor(void) const { return mKeyFrameCursor; }
     protected:
         /// The blend mask (containing per bone weights)
         BoneBlendMask* mBlendMask;
@@ -180,6 +185,8 @@ namespace Ogre {
         Real mWeight;
         bool mEnabled;
         bool mLoop;
+        /// Global key frame index of the last apply, see Animation::_getTimeIndex
+        mutable uint mKeyFrameCursor;
 
     };
 
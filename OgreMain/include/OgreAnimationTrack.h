@@ -231,6 +231,9 @@ namespace Ogre
         /** Internal method to build keyframe time index map to translate global lower
             bound index to local lower bound index. */
         virtual void _buildKeyFrameIndexMap(const std::vector<Real>& keyFrameTimes);
+
+        /// The map built by _buildKeyFrameIndexMap
+        const std::vector<ushort>& _getKeyFrameIndexMap(void) const { return mKeyFrameIndexMap; }
         
         /** Internal method to re-base the keyframes relative to a given keyframe. */
         virtual void _applyBaseKeyFrame(const KeyFrame* base);
@@ -238,6 +241,9 @@ namespace Ogre
         /** Set a listener for this track. */
         virtual void setListener(Listener* l) { mListener = l; }
 
+        /** Returns the listener of this track, if any. */
+        Listener* getListener() const { return mListener; }
+
         /** Returns the parent Animation object for this track. */
         Animation *getParent() const { return mParent; }
     protected:
@@ -342,6 +348,32 @@ namespace Ogre
         @param timePos The time from which this KeyFrame will apply.
         */
         virtual TransformKeyFrame* createNodeKeyFrame(Real timePos);
+        /// @copydoc AnimationTrack::getNumKeyFrames
+        virtual unsigned short getNumKeyFrames(void) const;
+
+        /** Returns the KeyFrame at the specified index.
+        @note
+            Compressed tracks have no KeyFrame objects, so this throws an InvalidStateException
+            for them. Use getNodeKeyFrameCopy, or call decompress first.
+        */
+        virtual KeyFrame* getKeyFrame(unsigned short index) const;
+
+        /** @copydoc AnimationTrack::getKeyFramesAtTime
+        @note
+            Throws an InvalidStateException for compressed tracks, see getKeyFrame.
+        */
+        virtual Real getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
+            unsigned short* firstKeyIndex = 0) const;
+
+        /// @copydoc AnimationTrack::createKeyFrame
+        virtual KeyFrame* createKeyFrame(Real timePos);
+
+        /// @copydoc AnimationTrack::removeKeyFrame
+        virtual void removeKeyFrame(unsigned short index);
+
+        /// @copydoc AnimationTrack::removeAllKeyFrames
+        virtual void removeAllKeyFrames(void);
+
         /** Returns a pointer to the associated Node object (if any). */
         virtual Node* getAssociatedNode(void) const;
 
@@ -352,6 +384,12 @@ namespace Ogre
         virtual void applyToNode(Node* node, const TimeIndex& timeIndex, Real weight = 1.0, 
             Real scale = 1.0f);
 
+        /** Internal method adding an interpolated key frame to a node, as applyToNode does
+            after sampling this track.
+        */
+        void _applyTransform(Node* node, const Vector3& translate, const Quaternion& rotation,
+            const Vector3& scale, Real weight, Real scl) const;
+
         /** Sets the method of rotation calculation */
         virtual void setUseShortestRotationPath(bool useShortestPath);
 
@@ -367,9 +405,21 @@ namespace Ogre
         /// @copydoc AnimationTrack::_keyFrameDataChanged
         void _keyFrameDataChanged(void) const;
 
-        /** Returns the KeyFrame at the specified index. */
+        /** Internal method building the interpolation splines now, if the parent animation
+            uses them and they are out of date, rather than on the next getInterpolatedKeyFrame.
+        */
+        void _prepareInterpolation(void) const;
+
+        /** Returns the KeyFrame at the specified index, see getKeyFrame. */
         virtual TransformKeyFrame* getNodeKeyFrame(unsigned short index) const;
 
+        /** Returns a copy of the KeyFrame at the specified index.
+        @remarks
+            Unlike getNodeKeyFrame, this also works for compressed tracks, which are decoded
+            into the copy. Changing the copy does not change the track.
+        */
+        TransformKeyFrame getNodeKeyFrameCopy(unsigned short index) const;
+
 
         /** Method to determine if this track has any KeyFrames which are
             doing anything useful - can be used to determine if this track
@@ -380,6 +430,49 @@ namespace Ogre
         /** Optimise the current track by removing any duplicate keyframes. */
         virtual void optimise(void);
 
+        /** Removes the keyframes which interpolating between the remaining ones reproduces
+            within the given tolerances.
+        @remarks
+            This is a lossy version of optimise, meant to be run offline. Every removed keyframe
+            stays within the tolerances of the track sampled at its time, measured for linear
+            interpolation with the rotation interpolation mode of the parent animation. The first
+            and last keyframes are always kept.
+        @param translationTolerance Maximum distance to the original translation.
+        @param rotationTolerance Maximum angle to the original rotation.
+        @param scaleTolerance Maximum distance to the original scale.
+        */
+        void reduceKeyFrames(Real translationTolerance, const Radian& rotationTolerance,
+            Real scaleTolerance);
+
+        /** Replaces the keyframes of this track by a quantised copy, which is decoded when
+            the track is sampled.
+        @remarks
+            Rotations are stored in 48 bits as their three smallest components, translations and
+            scales in 16 bits per component relative to their range in this track and left out if
+            they do not change. This takes around a fifth of the memory of the keyframe objects.
+            The rotation error is around 0.0001 radians, the translation and scale error below
+            1/131070 of their range.
+        @par
+            Keyframes may still be read but not modified. Adding or removing keyframes
+            decompresses the track.
+        */
+        void compress(void);
+
+        /** Turns a compressed track back into keyframe objects. */
+        void decompress(void);
+
+        /** Returns whether the keyframes of this track are compressed. */
+        bool isCompressed(void) const { return mCompressed != 0; }
+
+        /** Returns the memory used by the keyframes of this track, in bytes. */
+        size_t calculateKeyFrameSize(void) const;
+
+        /// @copydoc AnimationTrack::_collectKeyFrameTimes
+        virtual void _collectKeyFrameTimes(std::vector<Real>& keyFrameTimes);
+
+        /// @copydoc AnimationTrack::_buildKeyFrameIndexMap
+        virtual void _buildKeyFrameIndexMap(const std::vector<Real>& keyFrameTimes);
+
         /** Clone this track (internal use only) */
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
@@ -399,7 +492,39 @@ namespace Ogre
             RotationalSpline rotationSpline;
         };
 
+        // Quantised keyframes of a compressed track, allocate on demand
+        struct CompressedKeyFrames
+        {
+            std::vector<Real> times;
+            /// Per keyframe the smallest three components of the rotation, followed by the
+            /// translation and scale if they change
+            std::vector<uint16> values;
+            /// Number of values per keyframe
+            unsigned short stride;
+            /// Offsets of translation and scale in the values of a keyframe, 0 if they equal
+            /// their base in all keyframes
+            unsigned short translateOffset;
+            unsigned short scaleOffset;
+            Vector3 translateBase;
+            Vector3 translateStep;
+            Vector3 scaleBase;
+            Vector3 scaleStep;
+
+            CompressedKeyFrames();
+        };
+
+        /// Internal method reading a keyframe of a compressed track
+        void decodeKeyFrame(unsigned short index, Vector3& translate, Quaternion& rotation,
+            Vector3& scale) const;
+        /// Internal method interpolating between two keyframes for getInterpolatedKeyFrame
+        void interpolateKeyFrames(const TransformKeyFrame* k1, const TransformKeyFrame* k2,
+            unsigned short firstKeyIndex, Real t, TransformKeyFrame* kret) const;
+        /// getKeyFramesAtTime for compressed tracks, which returns the keyframe indices instead
+        Real getKeyFrameIndicesAtTime(const TimeIndex& timeIndex, unsigned short& index1,
+            unsigned short& index2) const;
+
         Node* mTargetNode;
+        CompressedKeyFrames* mCompressed;
         // Prebuilt splines, must be mutable since lazy-update in const method
         mutable Splines* mSplines;
         mutable bool mSplineBuildNeeded;
@@ -54,9 +54,22 @@ namespace Ogre {
         will calculate concatenated matrices etc only when required, passing back precalculated
         matrices when they are requested more than once when the underlying information has
         not altered.
+    @par
+        The matrices derived from the world, view and projection matrices are also kept
+        across renderables and cameras. Each base matrix has a version that only changes
+        when its value does, and each derived value remembers the versions it was computed
+        from, so e.g. renderables sharing a world transform reuse the inverse world matrix
+        and all renderables seen by a camera share the view projection matrix.
     */
     class _OgreExport AutoParamDataSource : public SceneMgtAlloc
     {
+    public:
+        /// How often derived matrices were reused or recomputed
+        struct CacheStatistics
+        {
+            size_t hits;
+            size_t misses;
+        };
     protected:
         const Light& getLight(size_t index) const;
         mutable Affine3 mWorldMatrix[256];
@@ -87,16 +100,38 @@ namespace Ogre {
         mutable bool mWorldMatrixDirty;
         mutable bool mViewMatrixDirty;
         mutable bool mProjMatrixDirty;
-        mutable bool mWorldViewMatrixDirty;
-        mutable bool mViewProjMatrixDirty;
-        mutable bool mWorldViewProjMatrixDirty;
-        mutable bool mInverseWorldMatrixDirty;
-        mutable bool mInverseWorldViewMatrixDirty;
-        mutable bool mInverseViewMatrixDirty;
-        mutable bool mInverseTransposeWorldMatrixDirty;
-        mutable bool mInverseTransposeWorldViewMatrixDirty;
         mutable bool mCameraPositionDirty;
-        mutable bool mCameraPositionObjectSpaceDirty;
+        /// The camera or render target changed, so view / projection must be refetched
+        mutable bool mCameraViewDirty;
+        mutable bool mCameraProjDirty;
+        /// Whether mViewMatrix / mProjectionMatrix are the identity variants of a renderable
+        mutable bool mViewMatrixIdentity;
+        mutable bool mProjMatrixIdentity;
+
+        /// Versions of the base matrices a derived value was computed from
+        struct DerivedStamp
+        {
+            uint32 world;
+            uint32 view;
+            uint32 proj;
+        };
+        /// Incremented when the value of mWorldMatrixArray[0] changes
+        mutable uint32 mWorldVersion;
+        /// Incremented when the view matrix or the camera position changes
+        mutable uint32 mViewVersion;
+        /// Incremented when the projection matrix changes
+        mutable uint32 mProjVersion;
+        /// The world matrix mWorldVersion refers to
+        mutable Affine3 mVersionedWorldMatrix;
+        mutable DerivedStamp mWorldViewMatrixStamp;
+        mutable DerivedStamp mViewProjMatrixStamp;
+        mutable DerivedStamp mWorldViewProjMatrixStamp;
+        mutable DerivedStamp mInverseWorldMatrixStamp;
+        mutable DerivedStamp mInverseWorldViewMatrixStamp;
+        mutable DerivedStamp mInverseViewMatrixStamp;
+        mutable DerivedStamp mInverseTransposeWorldMatrixStamp;
+        mutable DerivedStamp mInverseTransposeWorldViewMatrixStamp;
+        mutable DerivedStamp mCameraPositionObjectSpaceStamp;
         mutable bool mTextureViewProjMatrixDirty[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         mutable bool mTextureWorldViewProjMatrixDirty[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         mutable bool mSpotlightViewProjMatrixDirty[OGRE_MAX_SIMULTANEOUS_LIGHTS];
@@ -124,7 +159,18 @@ namespace Ogre {
         const VisibleObjectsBoundsInfo* mMainCamBoundsInfo;
         const Pass* mCurrentPass;
 
+        mutable CacheStatistics mCacheStatistics;
+
         Light mBlankLight;
+
+        /// Bumps mWorldVersion if the world matrix differs from mVersionedWorldMatrix
+        void updateWorldVersion() const;
+        /** Whether a derived value computed at stamp is still valid for the given versions.
+        @remarks
+            Counts a hit or a miss; on a miss stamp is set to the versions, as the caller
+            is expected to recompute the value.
+        */
+        bool isDerivedCurrent(DerivedStamp& stamp, uint32 world, uint32 view, uint32 proj) const;
     public:
         AutoParamDataSource();
         /** Updates the current renderable */
@@ -152,6 +198,10 @@ namespace Ogre {
         /** Sets the current pass */
         void setCurrentPass(const Pass* pass);
 
+        /// Hit and miss counts of the derived matrices since the last reset
+        const CacheStatistics& getCacheStatistics() const { return mCacheStatistics; }
+        void resetCacheStatistics();
+
 		/** Returns the current bounded camera */
 		const Camera* getCurrentCamera() const;
 
@@ -0,0 +1,156 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __DynamicAABBTree_H__
+#define __DynamicAABBTree_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Math
+    *  @{
+    */
+    /** Bounding volume hierarchy over axis aligned boxes which is updated
+        incrementally as boxes are added, moved and removed.
+    @remarks
+        Each box is stored in a leaf as a 'fat' box, enlarged by a fraction of
+        its size, so that small movements do not touch the tree at all. A box
+        leaving its fat box is removed and reinserted at the place where it
+        grows the surface area of the tree the least, and the tree is kept
+        balanced by rotations on the way back up. Insertion, removal and
+        queries are therefore O(log n) without any fixed world size or depth.
+    @par
+        Queries report the user data of all leaves whose fat box intersects
+        the query volume, so callers have to do their own exact test.
+    */
+    class _OgreExport DynamicAABBTree : public SceneMgtAlloc
+    {
+    public:
+        /// Returned in place of a proxy or node index to mean none
+        static const int NULL_NODE = -1;
+
+        /** Constructor.
+        @param margin Fraction of the size of a box by which its fat box is
+            enlarged on each side
+        */
+        explicit DynamicAABBTree(Real margin = 0.25f);
+
+        /** Add a box to the tree.
+        @param box A finite box
+        @param userData Reported by queries for this box
+        @return The proxy identifying the box
+        */
+        int createProxy(const AxisAlignedBox& box, void* userData);
+        /// Remove a box from the tree
+        void destroyProxy(int proxy);
+        /** Update the box of a proxy.
+        @return true if the box left its fat box, so the proxy was reinserted
+        */
+        bool moveProxy(int proxy, const AxisAlignedBox& box);
+
+        void* getUserData(int proxy) const { return mNodes[proxy].userData; }
+        /// The enlarged box the proxy is stored with
+        AxisAlignedBox getFatBox(int proxy) const
+        {
+            return AxisAlignedBox(mNodes[proxy].min, mNodes[proxy].max);
+        }
+
+        /** Set the fraction by which fat boxes are enlarged, only boxes
+            inserted or reinserted afterwards are affected */
+        void setMargin(Real margin) { mMargin = margin; }
+        Real getMargin(void) const { return mMargin; }
+
+        /// Remove all boxes, invalidating all proxies
+        void clear(void);
+
+        size_t getProxyCount(void) const { return mProxyCount; }
+        /// Height of the tree, 0 for a single leaf
+        int getHeight(void) const { return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height; }
+
+        /// Collect the user data of all proxies possibly intersecting the box
+        void query(const AxisAlignedBox& box, std::vector<void*>& result) const;
+        /// @overload
+        void query(const Sphere& sphere, std::vector<void*>& result) const;
+        /// @overload
+        void query(const Ray& ray, std::vector<void*>& result) const;
+        /** @overload
+        @remarks
+            Sub-trees entirely inside the volume are collected without further
+            tests, which makes this suitable for frustum culling.
+        */
+        void query(const PlaneBoundedVolume& volume, std::vector<void*>& result) const;
+
+    private:
+        struct TreeNode
+        {
+            Vector3 min;
+            Vector3 max;
+            void* userData;
+            /// Parent node, or next free node while in the free list
+            int parent;
+            int child1;
+            int child2;
+            /// 0 for leaves, -1 for free nodes
+            int height;
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        std::vector<TreeNode> mNodes;
+        int mRoot;
+        int mFreeList;
+        size_t mProxyCount;
+        Real mMargin;
+
+        int allocateNode(void);
+        void freeNode(int node);
+        void insertLeaf(int leaf);
+        void removeLeaf(int leaf);
+        /// Rotate the sub-tree at the node if it is imbalanced, returning its new root
+        int balance(int node);
+        /// Recompute box and height of the node from its children
+        void refit(int node);
+
+        /** Walk the tree, the test returns 0 to skip a sub-tree, 1 to descend
+            into it and 2 to collect it without further tests. */
+        template <typename Test>
+        void collect(const Test& test, std::vector<void*>& result) const;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -196,6 +196,8 @@ namespace Ogre {
         Affine3 *mBoneMatrices;
         /// Records the last frame in which animation was updated.
         unsigned long mFrameAnimationLastUpdated;
+        /// Records the last frame in which updateAnimation was called, i.e. the entity was rendered.
+        unsigned long mFrameAnimationLastNeeded;
 
         /// Perform all the updates required for an animated entity.
         void updateAnimation(void);
@@ -752,6 +754,25 @@ namespace Ogre {
         */
         bool _isSkeletonAnimated(void) const;
 
+        /** Internal method preparing the skeleton update for _updateBoneMatrices.
+        @remarks
+            Builds the lazily created data of the enabled animations, so they can then
+            be applied to several skeletons from different threads at once. Returns
+            false if the bone matrices are not going to be needed this frame or cannot
+            be updated apart from the other entities, which is the case if the skeleton
+            instance is shared or objects are attached to bones.
+            @see SceneManager::setParallelAnimationUpdate
+        */
+        bool _prepareBoneMatricesUpdate(void);
+
+        /** Internal method updating the bone matrices ahead of _updateAnimation.
+        @remarks
+            Only touches the skeleton instance owned by this entity, so it may be called
+            for several entities from different threads once _prepareBoneMatricesUpdate
+            returned true for them.
+        */
+        void _updateBoneMatrices(void) { cacheBoneMatrices(); }
+
         /** Advanced method to get the temporarily blended skeletal vertex information
             for entities which are software skinned.
         @remarks
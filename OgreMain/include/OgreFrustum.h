@@ -154,6 +154,9 @@ namespace Ogre
         void updateWorldSpaceCorners(void) const;
         /// Implementation of updateWorldSpaceCorners (called if out of date)
         virtual void updateWorldSpaceCornersImpl(void) const;
+        /// Implementation of getVisibility testing the boxes against the frustum planes
+        void calculateVisibility(const AxisAlignedBox* const* bounds, size_t numBounds,
+                                 bool* visible) const;
         void updateVertexData(void) const;
         virtual bool isViewOutOfDate(void) const;
         bool isFrustumOutOfDate(void) const;
@@ -472,6 +475,21 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether the given bounding boxes are visible in the Frustum.
+        @remarks
+            Same as calling isVisible(const AxisAlignedBox&, FrustumPlane*) for each box,
+            but the boxes are tested several at a time. Subclasses which may override
+            isVisible call it for each box instead, unless they override this too.
+        @param bounds
+            Pointers to the bounding boxes to be checked (world space).
+        @param numBounds
+            Number of bounding boxes.
+        @param visible
+            Array of at least numBounds flags, filled with the visibility of each box.
+        */
+        virtual void getVisibility(const AxisAlignedBox* const* bounds, size_t numBounds,
+                                   bool* visible) const;
+
         /// Overridden from MovableObject::getTypeFlags
         uint32 getTypeFlags(void) const;
 
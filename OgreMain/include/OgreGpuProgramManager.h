@@ -59,11 +59,39 @@ namespace Ogre {
         OGRE_DEPRECATED typedef std::map<String, Microcode> MicrocodeMap;
 
     protected:
+        /// Microcode cache entry, that might not be read from mCacheStream yet
+        struct MicrocodeEntry
+        {
+            /// Null until read from mCacheStream
+            Microcode microcode;
+            /// Offset of the stored data from mCacheDataStart
+            uint32 offset;
+            /// Size of the stored, possibly compressed, data
+            uint32 storedSize;
+            /// Size of the microcode
+            uint32 size;
+            uint32 flags;
+            /// Cache generation in which the entry was last used
+            uint32 lastUsed;
+        };
 
         SharedParametersMap mSharedParametersMap;
-        std::map<uint32, Microcode> mMicrocodeCache;
+        mutable std::map<uint32, MicrocodeEntry> mMicrocodeCache;
         bool mSaveMicrocodesToCache;
-        bool mCacheDirty;           // When this is true the cache is 'dirty' and should be resaved to disk.
+        mutable bool mCacheDirty;   // When this is true the cache is 'dirty' and should be resaved to disk.
+        /// Stream the cache was loaded from, microcodes are read on first lookup
+        mutable DataStreamPtr mCacheStream;
+        /// Position of the data block in mCacheStream
+        mutable size_t mCacheDataStart;
+        /// Incremented each time the cache is loaded
+        uint32 mCacheGeneration;
+        /// See setMicrocodeCacheMaxAge
+        uint32 mCacheMaxAge;
+
+        /// Reads the microcode of entry from mCacheStream, returns false on failure
+        bool readMicrocode(MicrocodeEntry& entry) const;
+        /// Reads all microcodes of a cache in the previous, unindexed format
+        void loadMicrocodeCacheV2(StreamSerialiser& serialiser);
             
         static String addRenderSystemToName( const String &  name );
 
@@ -219,6 +247,9 @@ namespace Ogre {
         }
 
         /** Returns a microcode for a program from the microcode cache.
+        @remarks
+        Throws if the id is not in the cache or its stored data cannot be decoded, in
+        which case the entry is removed. Check isMicrocodeAvailableInCache first.
         @param id The name of the program.
         */
         const Microcode& getMicrocodeFromCache(uint32 id) const;
@@ -261,13 +292,33 @@ namespace Ogre {
         }
 
         /** Saves the microcode cache to disk.
+        @remarks
+        Each microcode is compressed if OGRE was built with zlib. Entries that were loaded
+        but not yet used are copied as stored from the source stream. When stream has the
+        name of the source stream, their data is kept in memory afterwards, so the cache
+        may be saved over the file it was loaded from, as long as the file is not
+        truncated before this call.
         @param stream The destination stream
         */
         void saveMicrocodeCache( DataStreamPtr stream ) const;
         /** Loads the microcode cache from disk.
+        @remarks
+        Only the index is read here. Each microcode is read from the stream and
+        decompressed on its first lookup, so the stream must stay open and seekable until
+        the next load. Caches written by a different render system are discarded.
         @param stream The source stream
         */
         void loadMicrocodeCache( DataStreamPtr stream );
+
+        /** Drop entries not used in the given number of sessions when saving the cache.
+        @remarks
+        A session starts with loadMicrocodeCache. As the ids are hashes of the program
+        source, the entries of modified programs are never used again and would otherwise
+        stay in the cache forever. 0, the default, keeps all entries.
+        */
+        void setMicrocodeCacheMaxAge(uint32 sessions) { mCacheMaxAge = sessions; }
+        /// @copydoc setMicrocodeCacheMaxAge
+        uint32 getMicrocodeCacheMaxAge() const { return mCacheMaxAge; }
         
 
 
@@ -466,11 +466,21 @@ namespace Ogre {
 
         bool mDirty;
 
+        /// Uniform buffer holding the float constants, see enableUniformBuffer
+        HardwareUniformBufferSharedPtr mHardwareBuffer;
+        /// Byte range of the float constants changed since the last _upload
+        size_t mDirtyBegin, mDirtyEnd;
+
+        /// Marks the float constants in the byte range [begin, end) as changed, if any
+        void markDirtyRange(size_t begin, size_t end);
+        /// (Re)creates mHardwareBuffer to match the float constants
+        void createHardwareBuffer();
+
     public:
         GpuSharedParameters(const String& name);
 
         /// Get the name of this shared parameter set.
-        const String& getName() { return mName; }
+        const String& getName() const { return mName; }
 
         /** Add a new constant definition to this shared set of parameters.
             @remarks
@@ -524,6 +534,31 @@ namespace Ogre {
         /// Get the frame in which this shared parameter set was last updated
         size_t getFrameLastUpdated() const { return mFrameLastUpdated; }
 
+        /** Keep the float constants of this set in a HardwareUniformBuffer.
+            @remarks
+            The buffer has the layout of getFloatConstantList and is recreated whenever
+            the constant definitions change. Programs using this set no longer receive
+            copies of its float values in their own parameters. Instead the render system
+            binds the buffer and calls _upload, which writes only the bytes changed since
+            the previous upload, so per frame values like the view matrix, fog or time are
+            written once per frame instead of once per program.
+            @par
+            GL3Plus binds the buffer to the uniform blocks named like this set. Their layout
+            has to match the float constant list, so declare them std140 with the members in
+            the order they were defined, each at the offset of its constant in that list.
+            @note Only render systems with RSC_SHARED_PARAMETER_BUFFERS bind the buffer,
+            with any other this throws, as the programs would not see the values at all.
+        */
+        void enableUniformBuffer();
+        /// The buffer created by enableUniformBuffer or a null pointer
+        const HardwareUniformBufferSharedPtr& _getHardwareBuffer() const { return mHardwareBuffer; }
+        /** Write the float constants changed since the last call to the uniform buffer.
+            @remarks
+            Marks the set as clean.
+            @return the number of bytes written
+        */
+        size_t _upload();
+
         /** Gets an iterator over the named GpuConstantDefinition instances as defined
             by the user.
         */
@@ -566,15 +601,15 @@ namespace Ogre {
         /// Get a pointer to the 'nth' item in the float buffer
         const float* getFloatPointer(size_t pos) const { return &mFloatConstants[pos]; }
         /// Get a pointer to the 'nth' item in the double buffer
-        double* getDoublePointer(size_t pos) { _markDirty(); return &mDoubleConstants[pos]; }
+        double* getDoublePointer(size_t pos) { markDirtyRange(0, 0); return &mDoubleConstants[pos]; }
         /// Get a pointer to the 'nth' item in the double buffer
         const double* getDoublePointer(size_t pos) const { return &mDoubleConstants[pos]; }
         /// Get a pointer to the 'nth' item in the int buffer
-        int* getIntPointer(size_t pos) { _markDirty(); return &mIntConstants[pos]; }
+        int* getIntPointer(size_t pos) { markDirtyRange(0, 0); return &mIntConstants[pos]; }
         /// Get a pointer to the 'nth' item in the int buffer
         const int* getIntPointer(size_t pos) const { return &mIntConstants[pos]; }
         /// Get a pointer to the 'nth' item in the uint buffer
-        uint* getUnsignedIntPointer(size_t pos) { _markDirty(); return (uint*)&mIntConstants[pos]; }
+        uint* getUnsignedIntPointer(size_t pos) { markDirtyRange(0, 0); return (uint*)&mIntConstants[pos]; }
         /// Get a pointer to the 'nth' item in the uint buffer
         const uint* getUnsignedIntPointer(size_t pos) const { return (const uint*)&mIntConstants[pos]; }
         /// Get a reference to the list of float constants
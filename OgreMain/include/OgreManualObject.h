@@ -353,7 +353,7 @@ namespace Ogre
                 the object always stays visible when attached.
             @see ManualObject::setUseIdentityProjection, ManualObject::setUseIdentityView,
                 AxisAlignedBox::setInfinite */
-        void setBoundingBox(const AxisAlignedBox& box) { mAABB = box; }
+        void setBoundingBox(const AxisAlignedBox& box);
 
         /** Gets a pointer to a ManualObjectSection, i.e. a part of a ManualObject.
         */
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #define __MemoryAllocatorConfig_H__
 
 #include "OgreAlignedAllocator.h"
+#include "OgrePoolAllocator.h"
 
 namespace Ogre
 {
@@ -83,6 +84,31 @@ namespace Ogre
     // this is a template, mainly so swig does not pick it up
     template<int Category = MEMCATEGORY_GENERAL> class AllocatedObject {};
 
+#ifndef SWIG
+    /** Serves class allocations from the PoolAllocator.
+    @remarks
+        Nodes and scene objects are created and destroyed in large numbers and
+        traversed every frame, so their categories allocate from pools.
+    */
+    class PooledAllocatedObject
+    {
+    public:
+        static void* operator new(size_t sz) { return PoolAllocator::allocate(sz); }
+        static void operator delete(void* ptr, size_t sz) { PoolAllocator::deallocate(ptr, sz); }
+
+        // the placement form has to be restated, as the above hides the global one
+        static void* operator new(size_t sz, void* ptr) { return ptr; }
+        static void operator delete(void* ptr, void*) {}
+
+        // arrays are not pooled
+        static void* operator new[](size_t sz) { return ::operator new[](sz); }
+        static void operator delete[](void* ptr) { ::operator delete[](ptr); }
+    };
+
+    template<> class AllocatedObject<MEMCATEGORY_SCENE_CONTROL> : public PooledAllocatedObject {};
+    template<> class AllocatedObject<MEMCATEGORY_SCENE_OBJECTS> : public PooledAllocatedObject {};
+#endif
+
     // Useful shortcuts
     typedef AllocPolicy GeneralAllocPolicy;
     typedef AllocPolicy GeometryAllocPolicy;
@@ -97,8 +123,8 @@ namespace Ogre
     typedef AllocatedObject<> GeneralAllocatedObject;
     typedef AllocatedObject<> GeometryAllocatedObject;
     typedef AllocatedObject<> AnimationAllocatedObject;
-    typedef AllocatedObject<> SceneCtlAllocatedObject;
-    typedef AllocatedObject<> SceneObjAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCENE_CONTROL> SceneCtlAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCENE_OBJECTS> SceneObjAllocatedObject;
     typedef AllocatedObject<> ResourceAllocatedObject;
     typedef AllocatedObject<> ScriptingAllocatedObject;
     typedef AllocatedObject<> RenderSysAllocatedObject;
@@ -117,6 +117,10 @@ namespace Ogre {
             VertexElementSemantic targetSemantic, unsigned short index, 
             unsigned short sourceTexCoordSet);
 
+        /** Internal method asking the nodes of the entities using this mesh to update their
+            bounds, as they are only updated when something changed. */
+        void notifyBoundsChanged(void);
+
     public:
         /** A hashmap used to store optional SubMesh names.
             Translates a name into SubMesh index.
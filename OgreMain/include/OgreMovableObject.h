@@ -41,6 +41,7 @@ namespace Ogre {
 
     // Forward declaration
     class MovableObjectFactory;
+    struct StaticRenderQueueEntries;
 
     /** \addtogroup Core
     *  @{
@@ -127,6 +128,8 @@ namespace Ogre {
         bool mRenderQueuePrioritySet : 1;
         /// Does rendering this object disabled by listener?
         bool mRenderingDisabled : 1;
+        /// May the render queue retain the entries of this object?
+        bool mStatic : 1;
         /// The render queue to use when rendering this object
         uint8 mRenderQueueID;
         /// The render queue group to use when rendering this object
@@ -154,6 +157,12 @@ namespace Ogre {
         mutable ulong mLightListUpdated;
         /// the light mask defined for this movable. This will be taken into consideration when deciding which light should affect this movable
         uint32 mLightMask;
+        /// Proxy of this object in the query broadphase of its SceneManager
+        int mQueryProxy;
+        /// Rank of this object in the results of the query broadphase
+        uint32 mQueryOrder;
+        /// Render queue entries recorded while static
+        StaticRenderQueueEntries* mStaticEntries;
 
         // Static members
         /// Default query flags
@@ -181,6 +190,14 @@ namespace Ogre {
         virtual void _notifyManager(SceneManager* man) { mManager = man; }
         /** Get the manager of this object, if any (internal use only) */
         SceneManager* _getManager(void) const { return mManager; }
+        /// Proxy of this object in the query broadphase of its manager (internal use only)
+        int _getQueryProxy(void) const { return mQueryProxy; }
+        /// Set the proxy of this object in the query broadphase (internal use only)
+        void _setQueryProxy(int proxy) { mQueryProxy = proxy; }
+        /// Rank of this object in the results of the query broadphase (internal use only)
+        uint32 _getQueryOrder(void) const { return mQueryOrder; }
+        /// Set the rank of this object in the query broadphase (internal use only)
+        void _setQueryOrder(uint32 order) { mQueryOrder = order; }
 
         /** Notifies the movable object that hardware resources were lost
             @remarks
@@ -252,7 +269,9 @@ namespace Ogre {
 
         /** Retrieves the local axis-aligned bounding box for this object.
             @remarks
-                This bounding box is in local coordinates.
+                This bounding box is in local coordinates. Implementations changing it
+                while attached must call Node::needUpdate on their parent node, as
+                SceneNode::_update skips the bounds of unchanged sub-trees.
         */
         virtual const AxisAlignedBox& getBoundingBox(void) const = 0;
 
@@ -390,6 +409,33 @@ namespace Ogre {
         */
         uint8 getRenderQueueGroup(void) const { return mRenderQueueID; }
 
+        /** Marks this object as static, so the render queue may retain its entries.
+        @remarks
+            The first time a static object is queued, the RenderQueue records the
+            renderables, techniques and queue groups it adds. Later frames replay
+            that record instead of calling _updateRenderQueue, which skips the
+            technique lookups and the per object queueing logic. Culling, LOD and
+            light lists are still evaluated every frame.
+        @par
+            Only mark objects whose renderables and materials do not change, and
+            which are not animated. Changes to the queue group, to the materials or
+            visibility of sub entities and to LOD levels are picked up automatically,
+            anything else needs a call to notifyStaticDirty.
+        */
+        void setStatic(bool isStatic);
+
+        /// Gets whether the render queue may retain the entries of this object
+        bool isStatic(void) const { return mStatic; }
+
+        /** Discards the render queue entries recorded for this object, they
+            are recorded again the next time it is queued.
+        @see setStatic
+        */
+        void notifyStaticDirty(void);
+
+        /// Render queue entries recorded for this object, if it is static (internal use only)
+        StaticRenderQueueEntries* _getStaticRenderQueueEntries(void) const { return mStaticEntries; }
+
         /// Return the full transformation of the parent sceneNode or the attachingPoint node
         virtual const Affine3& _getParentNodeFullTransform(void) const;
 
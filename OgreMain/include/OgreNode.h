@@ -70,6 +70,8 @@ namespace Ogre {
         typedef std::vector<Node*> ChildNodeMap;
         typedef VectorIterator<ChildNodeMap> ChildNodeIterator;
         typedef ConstVectorIterator<ChildNodeMap> ConstChildNodeIterator;
+        /// Nodes still to be updated, paired with the parentHasChanged flag to pass to _update
+        typedef std::vector<std::pair<Node*, bool> > PendingUpdateList;
 
         /** Listener which gets called back on Node events.
         */
@@ -558,6 +560,30 @@ namespace Ogre {
         */
         virtual void _update(bool updateChildren, bool parentHasChanged);
 
+        /** Internal method to update the Node without cascading down to the children.
+        @remarks
+            Updates this node exactly like _update(true, parentHasChanged) would, but
+            instead of updating the children it appends the children which need to be
+            updated to @c pending, together with the parentHasChanged flag they must be
+            passed. This allows a SceneManager to update the resulting sub-trees
+            independently, e.g. on several threads. Anything the subclass does after
+            the children were updated (like SceneNode::_updateBounds) is left to the caller.
+        @param parentHasChanged See _update
+        @param pending List to which the children still to be updated are appended
+        */
+        void _updateSelf(bool parentHasChanged, PendingUpdateList& pending);
+
+        /** Returns whether _update would change anything in this node or below it.
+        @remarks
+            This is false for sub-trees in which no node moved, was (re)attached or
+            requested an update since the last _update, so they can be skipped entirely.
+        @param parentHasChanged See _update
+        */
+        bool _isUpdatePending(bool parentHasChanged) const
+        {
+            return parentHasChanged || mNeedParentUpdate || mNeedChildUpdate || !mChildrenToUpdate.empty();
+        }
+
         /** Sets a listener for this Node.
         @remarks
             Note for size and performance reasons only one listener per node is
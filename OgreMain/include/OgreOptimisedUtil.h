@@ -203,6 +203,28 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Test bounding boxes against a set of planes, e.g. the frustum planes.
+        @remarks
+            A box is culled if it lies completely on the negative side of any plane,
+            which is the test Frustum::isVisible(const AxisAlignedBox&) does.
+        @param planes The planes to test against.
+        @param numPlanes Number of planes.
+        @param centres Array of 3 pointers to the x, y and z components of the box
+            centres, one array per component. No alignment requirements.
+        @param halfSizes Array of 3 pointers to the x, y and z components of the box
+            half sizes, same layout as centres.
+        @param visible An array of flags to store the results, the flag is true if
+            the box is not culled by any plane, false otherwise. No alignment requires.
+        @param numBoxes Number of boxes to test.
+        */
+        virtual void calculateBoxVisibility(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* const* centres,
+            const Real* const* halfSizes,
+            char* visible,
+            size_t numBoxes) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
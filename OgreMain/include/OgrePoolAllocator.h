@@ -0,0 +1,88 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PoolAllocator_H__
+#define __PoolAllocator_H__
+
+#include "OgrePlatform.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Class to provide pooled memory for small objects.
+    @remarks
+        Requests are rounded up to a multiple of ALIGNMENT and served from a
+        free list per size. The lists are refilled from large chunks, so objects
+        created together end up next to each other in memory and creating or
+        destroying one costs a free list pop or push.
+    @par
+        Memory handed back is kept for reuse and never returned to the system.
+        Requests larger than MAX_POOLED_SIZE go to the heap.
+    @note
+        This is what the scene graph categories of AllocatedObject use; you
+        would not normally call it directly.
+    */
+    class _OgreExport PoolAllocator
+    {
+    public:
+        /// alignment of all pooled memory
+        static const size_t ALIGNMENT = 16;
+        /// largest request served from a pool
+        static const size_t MAX_POOLED_SIZE = 1024;
+
+        /** Allocate memory from the pool for the given size.
+            @param
+                size The size of memory need to allocate.
+            @return
+                The allocated memory pointer.
+        */
+        static DECL_MALLOC void* allocate(size_t size);
+
+        /** Deallocate memory that allocated by this class.
+            @param
+                p Pointer to the memory allocated by this class or <b>NULL</b> pointer.
+            @param
+                size The size that was passed to allocate.
+        */
+        static void deallocate(void* p, size_t size);
+
+        /// Number of blocks of the given size that are currently handed out
+        static size_t getAllocatedBlockCount(size_t size);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#endif  // __PoolAllocator_H__
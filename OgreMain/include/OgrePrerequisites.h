@@ -185,6 +185,7 @@ namespace Ogre {
     class RaySceneQuery;
     class RaySceneQueryListener;
     class Renderable;
+    class RenderCommandList;
     class RenderPriorityGroup;
     class RenderQueue;
     class RenderQueueGroup;
@@ -80,9 +80,10 @@ namespace Ogre {
     @note
         Radix sorting is often associated with just unsigned integer values. Our
         implementation can handle both unsigned and signed integers, as well as
-        floats (which are often not supported by other radix sorters). doubles
-        are not supported; you will need to implement your functor object to convert
-        to float if you wish to use this sort routine.
+        floats (which are often not supported by other radix sorters), and 64bit
+        unsigned integers for packed keys. doubles are not supported; you will need
+        to implement your functor object to convert to float if you wish to use
+        this sort routine.
     */
     template <class TContainer, class TContainerValueType, typename TCompValueType>
     class RadixSort
@@ -91,8 +92,8 @@ namespace Ogre {
         typedef typename TContainer::iterator ContainerIter;
     protected:
         /// Alpha-pass counters of values (histogram)
-        /// 4 of them so we can radix sort a maximum of a 32bit value
-        int mCounters[4][256];
+        /// one per byte of the sort value
+        int mCounters[sizeof(TCompValueType)][256];
         /// Beta-pass offsets 
         int mOffsets[256];
         /// Sort area size
@@ -302,6 +303,10 @@ namespace Ogre {
 
             for (p = 0; p < mNumPasses - 1; ++p)
             {
+                // skip bytes which are the same for all values, common for wide keys
+                if (mCounters[p][getByte(p, prevValue)] == mSortSize)
+                    continue;
+
                 sortPass(p);
                 // flip src/dst
                 SortVector* tmp = mSrc;
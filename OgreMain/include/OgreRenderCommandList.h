@@ -0,0 +1,261 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+ Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __RenderCommandList_H__
+#define __RenderCommandList_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreGpuProgramParams.h"
+#include "OgreRenderOperation.h"
+#include "OgreTextureUnitState.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** A recorded sequence of the render system work issued by a SceneManager.
+    @remarks
+        While a list is set with SceneManager::setRenderCommandList, every main scene
+        render of that SceneManager records what SceneManager::_setPass,
+        SceneManager::renderSingleObject and SceneManager::_issueRenderOp submit into
+        it: the render system state of each pass as _setPass resolved it, fixed function
+        transforms and lights, the constants of the GPU program parameters and the render
+        operations. The list can then be replayed with execute, which reproduces the draw
+        calls without culling, sorting or updating auto parameters again, e.g. for a view
+        that did not change.
+    @par
+        Replaying only needs the RenderSystem, so it can run on another thread than the
+        SceneManager, as long as the list is not recorded into at the same time. The list
+        does not own the recorded GPU programs, textures, samplers, Light, Frustum and
+        vertex / index data, so these must outlive it and the replay uses their current
+        contents. Renderable::preRender, RenderObjectListener and RenderQueueListener
+        callbacks are not replayed.
+    */
+    class _OgreExport RenderCommandList : public RenderSysAlloc
+    {
+    public:
+        enum CommandType
+        {
+            /// Apply the render system state of a Pass
+            CT_SET_PASS,
+            /// Fixed function world transform
+            CT_SET_WORLD_MATRIX,
+            /// Fixed function view transform
+            CT_SET_VIEW_MATRIX,
+            /// Fixed function projection transform
+            CT_SET_PROJECTION_MATRIX,
+            /// Culling, polygon mode and normalisation of the next object
+            CT_SET_OBJECT_STATE,
+            /// Fixed function lights
+            CT_USE_LIGHTS,
+            /// Upload GPU program parameters
+            CT_BIND_PARAMETERS,
+            /// Issue a RenderOperation
+            CT_RENDER
+        };
+
+        RenderCommandList();
+
+        /// Remove all commands, keeping the storage for the next recording
+        void clear();
+
+        /// Number of recorded commands
+        size_t size() const { return mCommands.size(); }
+        /// Whether no command was recorded
+        bool empty() const { return mCommands.empty(); }
+        /// Number of recorded CT_RENDER commands
+        size_t getDrawCount() const { return mDraws.size(); }
+        /// Type of the command at index
+        CommandType getCommandType(size_t index) const { return mCommands[index].type; }
+
+        /** Whether the recorded renders can be replayed.
+        @remarks
+            Light scissoring and clip planes, per light shadow textures, view relative
+            texture coordinate generation and per iteration depth bias are not recorded;
+            using them while recording makes the list incomplete.
+        */
+        bool isComplete() const { return mComplete; }
+
+        /** Records the render system state SceneManager::_setPass applies for pass.
+        @param fogMode, fogColour, fogDensity, fogStart, fogEnd The fog _setPass resolved
+            from the pass and the scene
+        @param cullingMode The culling mode _setPass resolved for the pass
+        */
+        void setPass(const Pass* pass, FogMode fogMode, const ColourValue& fogColour,
+                     Real fogDensity, Real fogStart, Real fogEnd, CullingMode cullingMode);
+        void setWorldMatrix(const Matrix4& m);
+        void setViewMatrix(const Matrix4& m);
+        void setProjectionMatrix(const Matrix4& m);
+        void setObjectState(CullingMode cullingMode, PolygonMode polygonMode, bool normaliseNormals);
+        void useLights(const LightList& lights, unsigned short limit);
+        /** Records a copy of the constants of params, so later changes to them do not
+            affect the replay.
+        @remarks
+            The constants are copied into storage reused by the next recording. params itself
+            is only copied the first time it is recorded or when its constant buffers changed
+            size, and kept until a recording does not use it any more.
+        */
+        void bindParameters(GpuProgramType type, const GpuProgramParametersPtr& params,
+                            uint16 variabilityMask);
+        void render(const RenderOperation& op, size_t iterationCount);
+        /// Notes that something that cannot be recorded was submitted, see isComplete
+        void _markIncomplete() { mComplete = false; }
+
+        /** Replays the commands on rs.
+        @remarks
+            The render target, viewport and frame must already be set up, as for
+            SceneManager::_renderScene. The replay changes the render system state behind
+            the back of the SceneManager, so call SceneManager::_markRenderStateDirty before
+            rendering with it again.
+        */
+        void execute(RenderSystem* rs) const;
+    private:
+        struct Command
+        {
+            CommandType type;
+            /// Index into the storage for type
+            uint32 index;
+        };
+        struct ObjectState
+        {
+            CullingMode cullingMode;
+            PolygonMode polygonMode;
+            bool normaliseNormals;
+        };
+        struct Lights
+        {
+            LightList lights;
+            unsigned short limit;
+        };
+        struct TextureUnit
+        {
+            TexturePtr texture;
+            TextureUnitState::BindingType bindingType;
+            unsigned int coordSet;
+            SamplerPtr sampler;
+            LayerBlendModeEx colourBlendMode;
+            LayerBlendModeEx alphaBlendMode;
+            TexCoordCalcMethod coordCalculation;
+            const Frustum* projector;
+            Matrix4 transform;
+        };
+        struct PassState
+        {
+            /// Binding delegates, null to unbind
+            GpuProgram* programs[GPT_COUNT];
+            /// Whether the surface and lighting state is applied
+            bool surfaceAndLightStates;
+            bool lightingEnabled;
+            ColourValue ambient;
+            ColourValue diffuse;
+            ColourValue specular;
+            ColourValue emissive;
+            Real shininess;
+            TrackVertexColourType vertexColourTracking;
+            FogMode fogMode;
+            ColourValue fogColour;
+            Real fogDensity;
+            Real fogStart;
+            Real fogEnd;
+            ColourBlendState blendState;
+            float lineWidth;
+            Real pointSize;
+            bool pointAttenuationEnabled;
+            Real pointAttenuation[3];
+            Real pointMinSize;
+            Real pointMaxSize;
+            bool pointSpritesEnabled;
+            /// Range in mTextureUnits
+            uint32 firstTextureUnit;
+            uint32 numTextureUnits;
+            CompareFunction depthFunction;
+            bool depthCheck;
+            bool depthWrite;
+            float depthBiasConstant;
+            float depthBiasSlopeScale;
+            CompareFunction alphaRejectFunction;
+            unsigned char alphaRejectValue;
+            bool alphaToCoverage;
+            CullingMode cullingMode;
+            ShadeOptions shading;
+            PolygonMode polygonMode;
+        };
+        /// Copy of recorded parameters the constants are restored into before binding
+        struct ParameterCopy
+        {
+            GpuProgramParametersPtr params;
+            /// Keeps the recorded parameters alive, so their address stays unique
+            GpuProgramParametersPtr source;
+            bool used;
+        };
+        typedef std::map<const GpuProgramParameters*, ParameterCopy> ParameterCopyMap;
+        struct Parameters
+        {
+            GpuProgramType type;
+            uint16 variabilityMask;
+            GpuProgramParametersPtr copy;
+            /// Start of the constants in mFloatConstants, mDoubleConstants and mIntConstants
+            uint32 floatOffset;
+            uint32 doubleOffset;
+            uint32 intOffset;
+        };
+        struct Draw
+        {
+            RenderOperation op;
+            size_t iterationCount;
+        };
+
+        void addCommand(CommandType type, size_t index);
+        void applyPassState(RenderSystem* rs, const PassState& state) const;
+
+        std::vector<Command> mCommands;
+        std::vector<PassState> mPassStates;
+        std::vector<TextureUnit> mTextureUnits;
+        std::vector<Matrix4> mMatrices;
+        std::vector<ObjectState> mObjectStates;
+        std::vector<Lights> mLights;
+        std::vector<Parameters> mParameters;
+        ParameterCopyMap mParameterCopies;
+        FloatConstantList mFloatConstants;
+        DoubleConstantList mDoubleConstants;
+        IntConstantList mIntConstants;
+        std::vector<Draw> mDraws;
+        bool mComplete;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
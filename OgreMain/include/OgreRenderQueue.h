@@ -78,6 +78,40 @@ namespace Ogre {
 
     #define OGRE_RENDERABLE_DEFAULT_PRIORITY  100
 
+    /** Queue entries recorded for a static MovableObject.
+    @remarks
+        Filled in by RenderQueue the first time the object is queued and
+        replayed on later frames instead of calling
+        MovableObject::_updateRenderQueue.
+    @see MovableObject::setStatic
+    */
+    struct StaticRenderQueueEntries : public RenderQueueAlloc
+    {
+        /// A single call to RenderQueue::addRenderable, after the technique lookup
+        struct Entry
+        {
+            Renderable* renderable;
+            Technique* technique;
+            ushort priority;
+            uint8 groupID;
+        };
+        std::vector<Entry> entries;
+        /// Queue the entries were recorded for
+        const RenderQueue* queue;
+        /// Generation of that queue, 0 if the entries need to be recorded again
+        uint32 generation;
+        /// Material scheme the techniques were looked up with
+        unsigned short schemeIndex;
+        /// Queue defaults the entries may have been resolved with
+        uint8 defaultQueueGroup;
+        ushort defaultPriority;
+
+        StaticRenderQueueEntries()
+            : queue(0), generation(0), schemeIndex(0), defaultQueueGroup(0), defaultPriority(0)
+        {
+        }
+    };
+
     /** Class to manage the scene object rendering queue.
         @remarks
             Objects are grouped by material to minimise rendering state changes. The map from
@@ -140,6 +174,24 @@ namespace Ogre {
         bool mShadowCastersCannotBeReceivers;
 
         RenderableListener* mRenderableListener;
+
+        /// Incremented whenever recorded static entries may refer to stale state
+        uint32 mStaticGeneration;
+        /// Static entries being recorded by addRenderable, if any
+        StaticRenderQueueEntries* mStaticRecording;
+        /// Queue whose generation static entries are recorded against
+        const RenderQueue* mStaticOwner;
+        /// Objects left to the owning thread, if this is a thread local queue
+        std::vector<MovableObject*>* mDeferredObjects;
+
+        /// Whether the recorded entries of a static object can be replayed into this queue
+        bool hasValidStaticEntries(MovableObject* mo) const;
+        /** Queue a static object, replaying its recorded entries if still valid.
+        @remarks
+            Recording them calls back into the object, so thread local queues only
+            get objects with valid entries.
+        */
+        void addStaticObject(MovableObject* mo);
     public:
         RenderQueue();
         virtual ~RenderQueue();
@@ -291,12 +343,30 @@ namespace Ogre {
             getting a visible object to add itself to the queue. This is 
             a replacement for SceneManager implementations of the associated
             tasks related to calling MovableObject::_updateRenderQueue.
+        @remarks
+            Objects marked with MovableObject::setStatic are only asked to
+            queue themselves once, later calls replay the recorded entries.
+            This is bypassed while a RenderableListener is set, since the
+            listener may decide differently every frame.
         */
         void processVisibleObject(MovableObject* mo, 
             Camera* cam, 
             bool onlyShadowCasters, 
             VisibleObjectsBoundsInfo* visibleBounds);
 
+        /** Prepares this queue to be filled on a worker thread and then merged into parent.
+        @remarks
+            Empties the queue and copies the settings of parent and its queue groups.
+            From then on processVisibleObject only handles static objects whose
+            recorded entries are still valid, as those do not call back into the
+            object for queueing. Any other object is appended to deferred instead,
+            to be passed to parent's processVisibleObject on the owning thread after
+            merging. Several thread local queues may be filled at the same time, as
+            long as parent is not modified meanwhile.
+        @see MovableObject::setStatic
+        */
+        void _prepareThreadLocal(const RenderQueue* parent, std::vector<MovableObject*>* deferred);
+
     };
 
     /** @} */
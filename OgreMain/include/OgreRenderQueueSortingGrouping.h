@@ -123,109 +123,64 @@ namespace Ogre {
         };
 
     protected:
-        /// Comparator to order pass groups
-        struct PassGroupLess
-        {
-            bool operator()(const Pass* a, const Pass* b) const
-            {
-                // Sort by passHash, which is pass, then texture unit changes
-                uint32 hasha = a->getHash();
-                uint32 hashb = b->getHash();
-                if (hasha == hashb)
-                {
-                    // Must differentTransparentQueueItemLessiate by pointer incase 2 passes end up with the same hash
-                    return a < b;
-                }
-                else
-                {
-                    return hasha < hashb;
-                }
-            }
-        };
-        /// Comparator to order objects by descending camera distance
-        struct DepthSortDescendingLess
+        /** A queued renderable together with the key it is ordered by.
+        @remarks
+            The key packs everything the order depends on into 64 bits, so a
+            single stable radix sort replaces the pass map and the two sort passes
+            used previously. Keys are built in sort(), since pass hashes may
+            still change after the renderable was queued.
+        */
+        struct SortedRenderablePass
         {
-            const Camera* camera;
+            /// Sort key, see buildGroupKey and buildDepthKey
+            uint64 key;
+            RenderablePass rp;
 
-            DepthSortDescendingLess(const Camera* cam)
-                : camera(cam)
-            {
-            }
-
-            bool operator()(const RenderablePass& a, const RenderablePass& b) const
-            {
-                if (a.renderable == b.renderable)
-                {
-                    // Same renderable, sort by pass hash
-                    return a.pass->getHash() < b.pass->getHash();
-                }
-                else
-                {
-                    // Different renderables, sort by depth
-                    Real adepth = a.renderable->getSquaredViewDepth(camera);
-                    Real bdepth = b.renderable->getSquaredViewDepth(camera);
-                    if (Math::RealEqual(adepth, bdepth))
-                    {
-                        // Must return deterministic result, doesn't matter what
-                        return a.pass < b.pass;
-                    }
-                    else
-                    {
-                        // Sort DESCENDING by depth (i.e. far objects first)
-                        return (adepth > bdepth);
-                    }
-                }
-
-            }
+            SortedRenderablePass(Renderable* rend, Pass* p) : key(0), rp(rend, p) {}
         };
 
-        /** Vector of RenderablePass objects, this is built on the assumption that
+        /** Flat list of queued renderables, this is built on the assumption that
          vectors only ever increase in size, so even if we do clear() the memory stays
          allocated, ie fast */
-        typedef std::vector<RenderablePass> RenderablePassList;
-        /** Map of pass to renderable lists, this is a grouping by pass. */
-        typedef std::map<Pass*, RenderableList, PassGroupLess> PassGroupRenderableMap;
+        typedef std::vector<SortedRenderablePass> SortedRenderablePassList;
 
-        /// Functor for accessing sort value 1 for radix sort (Pass)
-        struct RadixSortFunctorPass
+        /// Functor for accessing the key for radix sort
+        struct RadixSortFunctorKey
         {
-            uint32 operator()(const RenderablePass& p) const
+            uint64 operator()(const SortedRenderablePass& p) const
             {
-                return p.pass->getHash();
+                return p.key;
             }
         };
 
-        /// Radix sorter for accessing sort value 1 (Pass)
-        static RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
-
-        /// Functor for descending sort value 2 for radix sort (distance)
-        struct RadixSortFunctorDistance
+        /// Comparator for small lists, where stable_sort beats the radix sort
+        struct KeyLess
         {
-            const Camera* camera;
-
-            RadixSortFunctorDistance(const Camera* cam)
-                : camera(cam)
+            bool operator()(const SortedRenderablePass& a, const SortedRenderablePass& b) const
             {
-            }
-
-            float operator()(const RenderablePass& p) const
-            {
-                // Sort DESCENDING by depth (ie far objects first), use negative distance
-                // here because radix sorter always dealing with accessing sort
-                return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
+                return a.key < b.key;
             }
         };
 
-        /// Radix sorter for sort value 2 (distance)
-        static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
+        /// Radix sorter for the packed keys
+        static RadixSort<SortedRenderablePassList, SortedRenderablePass, uint64> msRadixSorter;
+
+        /// Key grouping by pass hash, then by pass
+        static uint64 buildGroupKey(const Pass* pass);
+        /// Key ordering by descending camera distance, then by pass hash
+        static uint64 buildDepthKey(const RenderablePass& rp, const Camera* cam);
+        /// Sort the list by key, stable
+        static void sortByKey(SortedRenderablePassList& list);
 
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
 
-        /// Grouped 
-        PassGroupRenderableMap mGrouped;
+        /// Ordered by pass, visited in runs of the same pass
+        SortedRenderablePassList mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
-        RenderablePassList mSortedDescending;
+        SortedRenderablePassList mSortedDescending;
+        /// Scratch list handed to the visitor for each run of mGrouped
+        mutable RenderableList mGroupScratch;
 
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
@@ -240,10 +195,9 @@ namespace Ogre {
         /// Empty the collection
         void clear(void);
 
-        /** Remove the group entry (if any) for a given Pass.
+        /** Remove any queued entries using a given Pass.
         @remarks
-            To be used when a pass is destroyed, such that any
-            grouping level for it becomes useless.
+            To be used when a pass is destroyed while still queued.
         */  
         void removePassGroup(Pass* p);
         
@@ -267,6 +221,15 @@ namespace Ogre {
             mOrganisationMode |= uint8(om);
         }
 
+        /** Use the same organisation modes as another collection.
+        @remarks
+            You can only do this when the collection is empty.
+        */
+        void copyOrganisationModes(const QueuedRenderableCollection& rhs)
+        {
+            mOrganisationMode = rhs.mOrganisationMode;
+        }
+
         /// Add a renderable to the collection using a given pass
         void addRenderable(Pass* pass, Renderable* rend);
         
@@ -438,6 +401,13 @@ namespace Ogre {
         */
         void merge( const RenderPriorityGroup* rhs );
 
+        /** Use the same splitting options and organisation modes as another group.
+        @remarks
+            You can only do this when the group is empty, i.e. after clearing the
+            queue.
+        */
+        void _copySettings(const RenderPriorityGroup* rhs);
+
 
     };
 
@@ -707,6 +677,15 @@ namespace Ogre {
                 pDstPriorityGrp->merge( pSrcPriorityGrp );
             }
         }
+
+        /** Use the same settings as another group, down to the priority groups.
+        @remarks
+            Priority groups which rhs does not have are destroyed, so entries
+            end up in the same collections once merged into rhs. You can only
+            do this when the group is empty, i.e. after clearing the queue.
+        @see RenderQueue::_prepareThreadLocal
+        */
+        void _copySettings(const RenderQueueGroup* rhs);
     };
 
     /** @} */
@@ -190,6 +190,8 @@ namespace Ogre
         RSC_ATOMIC_COUNTERS = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON_2, 25),
         /// Supports linewidth != 1.0
         RSC_WIDE_LINES = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON_2, 26),
+        /// Binds the uniform buffers of GpuSharedParameters::enableUniformBuffer
+        RSC_SHARED_PARAMETER_BUFFERS = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON_2, 27),
 
         // ***** DirectX specific caps *****
         /// Is DirectX feature "per stage constants" supported
@@ -48,6 +48,10 @@ Torus Knot Software Ltd.
 #include "OgreManualObject.h"
 #include "OgreRenderSystem.h"
 #include "OgreLodListener.h"
+#include "OgreWorkQueue.h"
+#include "OgreNode.h"
+#include "OgreDynamicAABBTree.h"
+#include <tuple>
 #include "OgreHeaderPrefix.h"
 #include "OgreNameGenerator.h"
 
@@ -102,7 +106,8 @@ namespace Ogre {
         */
         void mergeNonRenderedButInFrustum(const AxisAlignedBox& boxBounds, 
             const Sphere& sphereBounds, const Camera* cam);
-
+        /// Merge the bounds collected separately for the same camera
+        void merge(const VisibleObjectsBoundsInfo& rhs);
 
     };
 
@@ -164,6 +169,17 @@ namespace Ogre {
             _OgreExport bool operator()(const Light* a, const Light* b) const;
         };
 
+        /// Counters of the render state calls seen by the render state cache, see setRenderStateCaching
+        struct RenderStateStatistics
+        {
+            /// Calls issued to the render system
+            size_t applied;
+            /// Calls skipped, as they would not have changed the state
+            size_t skipped;
+
+            RenderStateStatistics() : applied(0), skipped(0) {}
+        };
+
         /// Describes the stage of rendering when performing complex illumination
         enum IlluminationRenderStage
         {
@@ -211,6 +227,29 @@ namespace Ogre {
             Real skyBoxDistance;
         };
 
+        /** Generational handle to a MovableObject created by createMovableObjectHandle.
+        @remarks
+            Resolving and destroying an object through its handle is O(1) and
+            involves no string operations. A handle becomes stale once its object
+            is destroyed and never resolves to an object created later in the
+            same slot.
+        */
+        struct MovableObjectHandle
+        {
+            uint32 type;
+            uint32 index;
+            uint32 generation;
+
+            MovableObjectHandle() : type(0), index(0), generation(0) {}
+            /// Whether this is a default constructed handle, not referring to any object
+            bool isNull() const { return generation == 0; }
+            bool operator==(const MovableObjectHandle& rhs) const
+            {
+                return type == rhs.type && index == rhs.index && generation == rhs.generation;
+            }
+            bool operator!=(const MovableObjectHandle& rhs) const { return !(*this == rhs); }
+        };
+
         /** Class that allows listening in on the various stages of SceneManager
             processing, so that custom behaviour can be implemented from outside.
         */
@@ -532,6 +571,75 @@ namespace Ogre {
         bool mFlipCullingOnNegativeScale;
         CullingMode mPassCullingMode;
 
+        /// A render state value as last issued to the render system
+        template <typename T> struct CachedRenderState
+        {
+            T value;
+            /// RenderStateCache::generation the value was issued in, stale if different
+            uint32 generation;
+            CachedRenderState() : value(), generation(0) {}
+        };
+        /// Shadow of the render system state set by _setPass and renderSingleObject,
+        /// see setRenderStateCaching
+        struct RenderStateCache
+        {
+            bool enabled;
+            /// Bumped by _markRenderStateDirty, which invalidates all values
+            uint32 generation;
+            RenderStateStatistics statistics;
+
+            CachedRenderState<GpuProgram*> programs[GPT_COUNT];
+            CachedRenderState<std::tuple<ColourValue, ColourValue, ColourValue, ColourValue, Real,
+                                         TrackVertexColourType> > surfaceParams;
+            CachedRenderState<bool> lightingEnabled;
+            CachedRenderState<std::tuple<FogMode, ColourValue, Real, Real, Real> > fog;
+            CachedRenderState<ColourBlendState> blendState;
+            CachedRenderState<float> lineWidth;
+            CachedRenderState<std::tuple<Real, bool, Real, Real, Real, Real, Real> > pointParams;
+            CachedRenderState<bool> pointSprites;
+            CachedRenderState<CompareFunction> depthFunction;
+            CachedRenderState<bool> depthCheck;
+            CachedRenderState<bool> depthWrite;
+            CachedRenderState<std::pair<float, float> > depthBias;
+            CachedRenderState<std::tuple<CompareFunction, unsigned char, bool> > alphaReject;
+            CachedRenderState<CullingMode> cullingMode;
+            CachedRenderState<ShadeOptions> shading;
+            CachedRenderState<PolygonMode> polygonMode;
+            CachedRenderState<bool> normaliseNormals;
+
+            RenderStateCache() : enabled(false), generation(1) {}
+
+            /** Whether a state has to be issued to the render system to become value.
+                Records value as issued if so.
+            */
+            template <typename T> bool update(CachedRenderState<T>& state, const T& value)
+            {
+                if (!enabled)
+                    return true;
+                if (state.generation == generation && state.value == value)
+                {
+                    ++statistics.skipped;
+                    return false;
+                }
+                state.value = value;
+                state.generation = generation;
+                ++statistics.applied;
+                return true;
+            }
+            /// Records a value issued to the render system without going through update
+            template <typename T> void store(CachedRenderState<T>& state, const T& value)
+            {
+                state.value = value;
+                state.generation = generation;
+            }
+            /// Forgets a state the render system may have changed on its own
+            template <typename T> void invalidate(CachedRenderState<T>& state)
+            {
+                state.generation = 0;
+            }
+        };
+        RenderStateCache mRenderStateCache;
+
     protected:
 
         /** Visible objects bounding box list.
@@ -572,15 +680,87 @@ namespace Ogre {
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter;
 
+        /** Uniform world space grid over the lights affecting the frustum.
+        @remarks
+            Lets _populateLightList test only the lights binned in the cells
+            touched by the query sphere, rather than every light affecting the
+            frustum. It is rebuilt whenever the lights affecting the frustum
+            change, i.e. at most once per camera and frame.
+        */
+        struct LightClusterGrid
+        {
+            /// Below this many lights affecting the frustum a plain loop is cheaper
+            static const size_t MIN_LIGHTS = 16;
+            /// Maximum number of cells along each axis
+            static const int MAX_CELLS = 16;
+
+            Vector3 origin;
+            Vector3 invCellSize;
+            int dims[3];
+            /// Offset of each cell in cellLights, plus the total at the end
+            std::vector<uint32> cellStart;
+            /// Indices into the lights affecting the frustum, grouped by cell
+            std::vector<uint32> cellLights;
+            /// Lights tested for every query: directional and very large ones
+            std::vector<uint32> globalLights;
+            /// State of the lights affecting the frustum the grid was built for
+            ulong lightsDirtyCounter;
+            size_t numLights;
+            bool valid;
+
+            LightClusterGrid();
+            void build(const LightList& lights);
+            /// Sorted indices of the lights possibly reaching the sphere
+            void query(const Sphere& sphere, std::vector<uint32>& indices) const;
+        private:
+            void getCellRange(const Vector3& min, const Vector3& max, int lo[3], int hi[3]) const;
+        };
+        LightClusterGrid mLightClusterGrid;
+        std::vector<uint32> mLightClusterIndices;
+
         typedef std::map<String, MovableObject*> MovableObjectMap;
+        typedef std::vector<MovableObject*> MovableObjectList;
         /// Simple structure to hold MovableObject map and a mutex to go with it.
         struct MovableObjectCollection
         {
+                    /// Named objects, this is the name index
                     MovableObjectMap map;
+                    /// Objects created by handle, densely packed in no particular order
+                    MovableObjectList anonymous;
+                    /// Handle slot of each entry in anonymous
+                    std::vector<uint32> anonymousSlots;
+                    /// Generation and position in anonymous, or the next free slot if unused
+                    struct Slot
+                    {
+                        uint32 generation;
+                        uint32 position;
+                    };
+                    std::vector<Slot> slots;
+                    uint32 freeSlot;
+                    /// Index in mMovableObjectCollectionList, stored in handles
+                    uint32 type;
                     OGRE_MUTEX(mutex);
+
+                    explicit MovableObjectCollection(uint32 _type) : freeSlot(~0u), type(_type) {}
+
+                    /// Add an object created by handle and return its handle
+                    MovableObjectHandle addAnonymous(MovableObject* m);
+                    /// Object referred to by the handle or NULL if the handle is stale
+                    MovableObject* getAnonymous(const MovableObjectHandle& h) const
+                    {
+                        return h.index < slots.size() && slots[h.index].generation == h.generation
+                                   ? anonymous[slots[h.index].position]
+                                   : NULL;
+                    }
+                    /// Remove the object at the given position in anonymous
+                    void removeAnonymous(size_t position);
+                    /// Remove all objects created by handle, invalidating their handles
+                    void clearAnonymous();
         };
         typedef std::map<String, MovableObjectCollection*> MovableObjectCollectionMap;
         MovableObjectCollectionMap mMovableObjectCollectionMap;
+        /// Collections indexed by MovableObjectHandle::type
+        std::vector<MovableObjectCollection*> mMovableObjectCollectionList;
         NameGenerator mMovableNameGenerator;
         /** Gets the movable object collection for the given type name.
         @remarks
@@ -592,9 +772,80 @@ namespace Ogre {
             This method throw exception if the collection does not exist.
         */
         const MovableObjectCollection* getMovableObjectCollection(const String& typeName) const;
+        /// Unlinks an extracted object from the query broadphase and this manager
+        void releaseMovableObject(MovableObject* m);
         /// Mutex over the collection of MovableObject types
         OGRE_MUTEX(mMovableObjectCollectionMapMutex);
 
+        /** Bounding volume hierarchy over the movable objects in the scene,
+            backing the default scene queries.
+        @remarks
+            Only the objects in the collections of this manager are tracked.
+            Scene nodes record themselves when they move, enter the scene
+            graph or get objects attached, and _updateSceneGraph refreshes the
+            objects below the recorded nodes only, so queries see the scene as
+            of the last update like the cached world bounds do. Objects
+            leaving the scene are dropped right away. Each box covers both the
+            world bounds and the bounding sphere of an object, as the default
+            sphere query tests the latter.
+        */
+        struct QueryBroadphase
+        {
+            /// Proxy of objects with infinite bounds, which are kept out of the tree
+            static const int INFINITE_PROXY = -2;
+            /// Proxy of tracked objects which are not in the scene
+            static const int NO_PROXY = -3;
+
+            DynamicAABBTree tree;
+            /// Objects with infinite bounds, reported by every query
+            std::vector<MovableObject*> infiniteObjects;
+            /// Nodes to refresh the objects of, entries of destroyed nodes are NULL
+            std::vector<SceneNode*> movedNodes;
+            /// Scratch buffer for the tree queries
+            std::vector<void*> result;
+            SceneManager* owner;
+            /// Rank given to the next tracked object
+            uint32 nextOrder;
+
+            QueryBroadphase() : owner(0), nextOrder(0) {}
+
+            /// Whether the object is in the collections of the owner
+            bool isTracked(const MovableObject* m) const;
+            /// Start tracking an object of the collections
+            void add(MovableObject* m);
+            /// Stop tracking an object
+            void remove(MovableObject* m);
+            /// Drop the proxies of an object and its child objects, which left the scene
+            void unlink(MovableObject* m);
+            /// Record a node whose objects and descendants need a refresh
+            void addMovedNode(SceneNode* node);
+            /// Forget a destroyed node
+            void removeMovedNode(SceneNode* node);
+            /// Forget all recorded nodes
+            void clearMovedNodes(void);
+            /// Refresh the objects below the recorded nodes, after their transforms were updated
+            void update(void);
+            /// Objects possibly intersecting the volume, in the order they started being tracked
+            void find(const AxisAlignedBox& box, std::vector<MovableObject*>& objects);
+            /// @overload
+            void find(const Sphere& sphere, std::vector<MovableObject*>& objects);
+            /// @overload
+            void find(const Ray& ray, std::vector<MovableObject*>& objects);
+            /// @overload
+            void find(const PlaneBoundedVolume& volume, std::vector<MovableObject*>& objects);
+            /// Objects possibly intersecting any of the volumes, each reported once
+            void find(const PlaneBoundedVolumeList& volumes, std::vector<MovableObject*>& objects);
+        private:
+            /// Drop the proxy of an object, which stays tracked
+            void drop(MovableObject* m);
+            void updateNode(SceneNode* node);
+            void updateObject(MovableObject* m);
+            void appendResult(std::vector<MovableObject*>& objects);
+        };
+        QueryBroadphase mQueryBroadphase;
+        /// Scratch buffer for the batched queries
+        std::vector<MovableObject*> mQueryCandidates;
+
         /** Internal method for initialising the render queue.
         @remarks
             Subclasses can use this to install their own RenderQueue implementation.
@@ -648,6 +899,16 @@ namespace Ogre {
             ShadowCamLightMapping mShadowCamLightMapping;
             // Array defining shadow texture index in light list.
             std::vector<size_t> mShadowTextureIndexLightList;
+            // Shadow textures which are set up but not rendered yet, see setConcurrentCulling
+            struct DeferredShadowUpdate
+            {
+                DeferredShadowUpdate(Light* l, RenderTarget* t, Camera* c)
+                    : light(l), target(t), camera(c) {}
+                Light* light;
+                RenderTarget* target;
+                Camera* camera;
+            };
+            std::vector<DeferredShadowUpdate> mDeferredShadowUpdates;
 
             std::unique_ptr<Rectangle2D> mFullScreenQuad;
 
@@ -774,6 +1035,133 @@ namespace Ogre {
         /// Flag indicating whether SceneNodes will be rendered as a set of 3 axes
         bool mDisplayNodes;
 
+        /** Runs batches of independent jobs on the worker threads of the Root WorkQueue.
+        @remarks
+            The calling thread takes part in the processing and run() only returns once
+            all jobs of the batch are complete. Therefore a batch also finishes if the
+            WorkQueue was not started yet or is not threaded.
+        */
+        struct _OgreExport WorkerJobs : public WorkQueue::RequestHandler
+        {
+            typedef std::function<void(size_t)> Job;
+
+            WorkerJobs();
+            ~WorkerJobs();
+
+            /** Calls job(i) for every i in [0, count) and waits until all calls returned.
+            @remarks
+                The calls happen in no particular order and on any thread. The first
+                exception thrown by a job is rethrown on the calling thread. Must not be
+                called from within a job.
+            */
+            void run(size_t count, const Job& job);
+
+            /// Number of threads taking part in run(), including the calling one
+            size_t getConcurrency() const;
+
+            WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+        private:
+            /// Process jobs of the given batch until none are left
+            void processJobs(uint32 batch);
+
+            WorkQueue* mQueue;
+            uint16 mChannel;
+
+            const Job* mJob;
+            size_t mJobCount;
+            size_t mNextJob;
+            size_t mJobsDone;
+            uint32 mBatch;
+            std::exception_ptr mException;
+
+            OGRE_WQ_MUTEX(mJobMutex);
+            OGRE_WQ_THREAD_SYNCHRONISER(mJobsDoneSync);
+        } mWorkerJobs;
+
+        /// Whether _updateSceneGraph distributes the update over mWorkerJobs
+        bool mParallelSceneGraphUpdate;
+        /// Scratch lists for updateSceneGraphParallel
+        Node::PendingUpdateList mPendingNodeUpdates, mPendingNodeUpdatesNext;
+        std::vector<SceneNode*> mUpdatedUpperNodes;
+
+        /** Internal method updating the scene graph with mWorkerJobs.
+        @remarks
+            The top of the tree is updated on the calling thread until there are enough
+            independent sub-trees to keep the workers busy. These are then updated in
+            parallel, after which the bounds of the top nodes are merged bottom-up.
+        */
+        void updateSceneGraphParallel(void);
+
+        /// Whether _cullCameras does anything, see setConcurrentCulling
+        bool mConcurrentCulling;
+        /// Changes whenever _updateSceneGraph changed something or nodes entered or left the graph
+        uint32 mSceneGraphVersion;
+
+        /// Scene nodes found visible by _cullCameras, used by the next _findVisibleObjects
+        struct CulledNodes
+        {
+            CulledNodes() : farDistance(0), sceneGraphVersion(0), pending(false) {}
+
+            std::vector<SceneNode*> nodes;
+            /// Culling planes and scene graph the nodes were found for
+            Plane planes[6];
+            Real farDistance;
+            uint32 sceneGraphVersion;
+            /// Whether the nodes were not used by _findVisibleObjects yet
+            bool pending;
+
+            /// Records the state of cam, which also brings its planes up to date
+            void capture(const Camera* cam, uint32 version);
+            /// Whether the nodes are still what cam would find
+            bool isValidFor(const Camera* cam, uint32 version) const;
+        };
+        typedef std::map<const Camera*, CulledNodes> CulledNodesMap;
+        CulledNodesMap mCulledNodes;
+
+        /// Whether _findVisibleObjects queues static objects on mWorkerJobs, see setParallelRenderQueueBuild
+        bool mParallelRenderQueueBuild;
+        /// A block of visible nodes queued by one job of findVisibleObjectsParallel
+        struct RenderQueueChunk
+        {
+            std::unique_ptr<RenderQueue> queue;
+            VisibleObjectsBoundsInfo bounds;
+            /// Objects the job could not queue
+            std::vector<MovableObject*> deferredObjects;
+            /// Nodes showing their bounding box, which is created on demand
+            std::vector<SceneNode*> deferredNodes;
+        };
+        std::vector<RenderQueueChunk> mRenderQueueChunks;
+        /// Scratch list of visible nodes for findVisibleObjectsParallel
+        std::vector<SceneNode*> mVisibleNodes;
+
+        /// Whether skeletons are updated on mWorkerJobs, see setParallelAnimationUpdate
+        bool mParallelAnimationUpdate;
+        /// Scratch list of entities for updateAnimationsParallel
+        std::vector<Entity*> mAnimatedEntities;
+
+        /** Internal method updating the bone matrices of the animated entities with mWorkerJobs.
+        @remarks
+            Called once per frame after the scene animations were applied. The entities
+            update the rest of their animation as usual when they are queued for rendering.
+        */
+        void updateAnimationsParallel(void);
+
+        /// List the main scene renders are recorded into, see setRenderCommandList
+        RenderCommandList* mRenderCommandList;
+        /// mRenderCommandList while recording inside _renderScene, null otherwise
+        RenderCommandList* mActiveCommandList;
+
+        /** Internal method queueing the objects of the visible nodes with mWorkerJobs.
+        @remarks
+            The nodes are split into fixed size blocks, each queued into its own
+            thread local RenderQueue. These are merged into the main queue in order,
+            so the result does not depend on the number of threads. Objects and nodes
+            which cannot be queued on a worker are queued by the calling thread
+            after their block was merged.
+        */
+        void findVisibleObjectsParallel(Camera* cam, const std::vector<SceneNode*>& nodes,
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+
         /// Storage of animations, lookup by name
         AnimationList mAnimationsList;
         OGRE_MUTEX(mAnimationsListMutex);
@@ -1061,6 +1449,8 @@ namespace Ogre {
         void useLights(const LightList& lights, ushort limit, bool fixedFunction);
         void setViewMatrix(const Affine3& m);
         void bindGpuProgram(GpuProgram* prog);
+        /// Unbinds the program of type, if one is bound
+        void unbindGpuProgram(GpuProgramType type);
         void updateGpuProgramParameters(const Pass* p);
 
 
@@ -1825,6 +2215,110 @@ namespace Ogre {
         */
         virtual void _updateSceneGraph(Camera* cam);
 
+        /** Sets whether _updateSceneGraph distributes the scene graph update over the worker
+            threads of the Root WorkQueue.
+        @remarks
+            Independent sub-trees of the scene graph are then updated in parallel and their
+            world bounds are merged afterwards. The result is identical to the serial update,
+            but Node::Listener callbacks and MovableObject::_notifyMoved are called from worker
+            threads and in an unspecified order. They must therefore not modify the scene graph
+            or any state shared between nodes.
+        @par
+            Only pays off for large scene graphs and a WorkQueue with several worker threads,
+            see DefaultWorkQueueBase::setWorkerThreadCount. SceneManagers whose SceneNode
+            subclasses update a shared spatial structure while they are updated, like the
+            OctreeSceneManager, do not support this and keep updating serially, see
+            supportsParallelNodeUpdate. Disabled by default.
+        */
+        void setParallelSceneGraphUpdate(bool enabled) { mParallelSceneGraphUpdate = enabled; }
+        /// @copydoc setParallelSceneGraphUpdate
+        bool getParallelSceneGraphUpdate(void) const { return mParallelSceneGraphUpdate; }
+
+        /** Returns whether the SceneNodes of this SceneManager can be updated from several
+            threads at once.
+        @remarks
+            SceneManagers whose SceneNode subclasses update a shared structure in
+            SceneNode::_update or SceneNode::_updateBounds must return false, so
+            setParallelSceneGraphUpdate falls back to the serial update.
+        */
+        virtual bool supportsParallelNodeUpdate(void) const { return true; }
+
+        /** Sets whether texture shadow rendering culls all shadow cameras and the main camera
+            in parallel.
+        @remarks
+            Otherwise each camera traverses the scene graph on its own when it is rendered. When
+            enabled, the shadow cameras are all set up first and then passed to _cullCameras
+            together with the main camera. Queueing the visible objects still happens when each
+            camera is rendered, as it notifies the objects of the current camera.
+        @par
+            Only pays off with several shadow textures and a WorkQueue with worker threads. Only
+            the scene graph traversal of SceneManager::_findVisibleObjects uses the result;
+            SceneManagers which override it, like the OctreeSceneManager, do not benefit.
+            Disabled by default.
+        */
+        void setConcurrentCulling(bool enabled) { mConcurrentCulling = enabled; }
+        /// @copydoc setConcurrentCulling
+        bool getConcurrentCulling(void) const { return mConcurrentCulling; }
+
+        /** Finds the visible scene nodes for several cameras at once, using the worker
+            threads of the Root WorkQueue.
+        @remarks
+            The next _findVisibleObjects call for each camera then only visits these nodes,
+            unless the camera or the scene graph changed in between. Does nothing unless
+            setConcurrentCulling is enabled.
+        */
+        void _cullCameras(Camera* const* cameras, size_t count);
+
+        /** Sets whether _findVisibleObjects fills the render queue using the worker threads
+            of the Root WorkQueue.
+        @remarks
+            The visible scene nodes are split into blocks, each queued into a thread local
+            RenderQueue, which are then merged into the main queue in a fixed order. Only
+            static objects with valid recorded queue entries are queued on the workers (see
+            MovableObject::setStatic), for those that means computing LOD and bounds and
+            replaying their entries. Their MovableObject::Listener::objectRendering may
+            therefore be called from a worker thread. All other objects are queued by the
+            calling thread after the merge.
+        @par
+            Not used while nodes or bounding boxes are displayed for all nodes, with additive
+            shadows that are not integrated, while LOD listeners are registered or if the
+            RenderQueue has a RenderableListener. Only the scene graph
+            traversal of SceneManager::_findVisibleObjects uses it; SceneManagers which
+            override it do not benefit. Disabled by default.
+        */
+        void setParallelRenderQueueBuild(bool enabled) { mParallelRenderQueueBuild = enabled; }
+        /// @copydoc setParallelRenderQueueBuild
+        bool getParallelRenderQueueBuild(void) const { return mParallelRenderQueueBuild; }
+
+        /** Sets whether the skeletons of animated entities are updated using the worker threads
+            of the Root WorkQueue.
+        @remarks
+            Once per frame, before the scene graph is updated, the animation states of all
+            skinned entities which were rendered in the previous frame are applied to their
+            skeletons and the bone matrices are computed in parallel. Entities which share
+            their skeleton instance or have objects attached to bones are updated as usual.
+        @par
+            Vertex animation, software skinning and binding the blended buffers still happen
+            on the calling thread when the entity is queued for rendering, as these lock
+            hardware buffers. Skeletal animations must not be modified from other threads
+            meanwhile. Only pays off for many animated entities and a WorkQueue with several
+            worker threads. Disabled by default.
+        */
+        void setParallelAnimationUpdate(bool enabled) { mParallelAnimationUpdate = enabled; }
+        /// @copydoc setParallelAnimationUpdate
+        bool getParallelAnimationUpdate(void) const { return mParallelAnimationUpdate; }
+
+        /** Sets a list the render system work of the following scene renders is recorded into.
+        @remarks
+            The list is cleared at the start of each _renderScene call that does not render
+            shadow textures, so it holds the commands of the last camera rendered. The
+            rendering itself is still performed as usual. Pass 0 to stop recording.
+        @see RenderCommandList::execute
+        */
+        void setRenderCommandList(RenderCommandList* list) { mRenderCommandList = list; }
+        /// @copydoc setRenderCommandList
+        RenderCommandList* getRenderCommandList(void) const { return mRenderCommandList; }
+
         /** Internal method which parses the scene to find visible objects to render.
             @remarks
                 If you're implementing a custom scene manager, this is the most important method to
@@ -2565,6 +3059,68 @@ namespace Ogre {
         /** Destroys a scene query of any type. */
         void destroyQuery(SceneQuery* query);
 
+        /** Finds the movable objects hit by each ray of a batch.
+        @remarks
+            Gives the same results as a default RaySceneQuery sorted by distance
+            for every ray, but the broadphase update and all scratch memory are
+            shared by the whole batch.
+        @param rays Array of numRays rays
+        @param numRays Number of rays
+        @param results Resized to numRays, receives the objects hit by each ray
+        @param mask The query mask, see SceneQuery::setQueryMask
+        @param typeMask The query type mask, see SceneQuery::setQueryTypeMask
+        */
+        void executeRayQueries(const Ray* rays, size_t numRays,
+                               std::vector<RaySceneQueryResult>& results, uint32 mask = 0xFFFFFFFF,
+                               uint32 typeMask = 0xFFFFFFFF & ~FX_TYPE_MASK & ~LIGHT_TYPE_MASK);
+        /** Finds the movable objects within each sphere of a batch.
+        @remarks
+            Gives the same results as a default SphereSceneQuery for every
+            sphere, see executeRayQueries.
+        @param spheres Array of numSpheres spheres
+        @param numSpheres Number of spheres
+        @param results Resized to numSpheres, receives the objects within each sphere
+        @param mask The query mask, see SceneQuery::setQueryMask
+        @param typeMask The query type mask, see SceneQuery::setQueryTypeMask
+        */
+        void executeSphereQueries(const Sphere* spheres, size_t numSpheres,
+                                  std::vector<SceneQueryResultMovableList>& results,
+                                  uint32 mask = 0xFFFFFFFF,
+                                  uint32 typeMask = 0xFFFFFFFF & ~FX_TYPE_MASK & ~LIGHT_TYPE_MASK);
+
+        /** Internal method collecting the movable objects whose bounds may
+            intersect the box, used by the default scene queries.
+        @remarks
+            The objects are looked up in a bounding volume hierarchy kept over
+            all movable objects in the scene. The result is conservative, so
+            callers still have to do their own exact tests. It reflects the
+            scene as of the last _updateSceneGraph and is in the order the
+            objects were created or injected.
+        */
+        void _findMovableObjectsIn(const AxisAlignedBox& box, std::vector<MovableObject*>& objects);
+        /// @overload
+        void _findMovableObjectsIn(const Sphere& sphere, std::vector<MovableObject*>& objects);
+        /// @overload
+        void _findMovableObjectsIn(const Ray& ray, std::vector<MovableObject*>& objects);
+        /// @overload
+        void _findMovableObjectsIn(const PlaneBoundedVolume& volume, std::vector<MovableObject*>& objects);
+        /// @overload
+        void _findMovableObjectsIn(const PlaneBoundedVolumeList& volumes, std::vector<MovableObject*>& objects);
+        /** Internal method for notifying the manager that an object was attached or
+            detached, so its proxy in the query broadphase is stale. */
+        void _notifyAttachmentChanged(MovableObject* m);
+        /** Internal method for notifying the manager that a scene node moved, so the
+            proxies of the objects below it are stale. */
+        void _notifySceneNodeMoved(SceneNode* node) { mQueryBroadphase.addMovedNode(node); }
+        /// Internal method for notifying the manager that a scene node was destroyed
+        void _notifySceneNodeDestroyed(SceneNode* node) { mQueryBroadphase.removeMovedNode(node); }
+        /** Internal method for notifying the manager that a scene node entered or left the
+            scene graph, so visible nodes found by _cullCameras and the proxies of the
+            objects attached to it are stale. */
+        void _notifySceneGraphChanged(SceneNode* node);
+        /// Internal method for removing a destroyed object from the query broadphase
+        void _removeFromQueryBroadphase(MovableObject* m) { mQueryBroadphase.remove(m); }
+
         typedef MapIterator<CameraList> CameraIterator;
         typedef MapIterator<AnimationList> AnimationIterator;
 
@@ -3165,6 +3721,22 @@ namespace Ogre {
             const String& typeName, const NameValuePairList* params = 0);
         /// @overload
         MovableObject* createMovableObject(const String& typeName, const NameValuePairList* params = 0);
+        /** Create a movable object of the type specified without a name.
+        @remarks
+            The object is not entered in the name index, so creating it and
+            destroying it through the returned handle involves neither string
+            operations nor a tree insertion. Use this for objects that are
+            spawned and despawned frequently.
+        @par
+            The object takes part in scene queries and light lists like any
+            other, but cannot be looked up by name and has an empty name.
+            getMovableObjectIterator does not visit it.
+        @param typeName The type of object to create
+        @param params Optional name/value pair list to give extra parameters to
+            the created object.
+        */
+        MovableObjectHandle createMovableObjectHandle(const String& typeName,
+            const NameValuePairList* params = 0);
         /** Destroys a MovableObject with the name specified, of the type specified.
         @remarks
             The MovableObject will automatically detach itself from any nodes
@@ -3175,8 +3747,16 @@ namespace Ogre {
         @remarks
             The MovableObject will automatically detach itself from any nodes
             on destruction.
+        @note
+            For objects created by createMovableObjectHandle this needs a linear
+            search, destroy them through their handle instead.
         */
         void destroyMovableObject(MovableObject* m);
+        /** Destroys a MovableObject created by createMovableObjectHandle.
+        @remarks
+            Does nothing if the handle is stale.
+        */
+        void destroyMovableObject(const MovableObjectHandle& handle);
         /** Destroy all MovableObjects of a given type. */
         void destroyAllMovableObjectsByType(const String& typeName);
         /** Destroy all MovableObjects. */
@@ -3185,6 +3765,10 @@ namespace Ogre {
         @note Throws an exception if the named instance does not exist
         */
         MovableObject* getMovableObject(const String& name, const String& typeName) const;
+        /** Get the MovableObject referred to by a handle.
+        @return The object or NULL if the handle is stale
+        */
+        MovableObject* getMovableObject(const MovableObjectHandle& handle) const;
         /** Returns whether a movable object instance with the given name exists. */
         bool hasMovableObject(const String& name, const String& typeName) const;
         typedef MapIterator<MovableObjectMap> MovableObjectIterator;
@@ -3192,8 +3776,45 @@ namespace Ogre {
         @note
             The iterator returned from this method is not thread safe, do not use this
             if you are creating or deleting objects of this type in another thread.
+        @note
+            Objects created by createMovableObjectHandle are not visited.
         */
         MovableObjectIterator getMovableObjectIterator(const String& typeName);
+        /** Iterator over the named MovableObject instances of a type in name order,
+            followed by the instances created by handle (internal use only).
+        */
+        class MovableObjectCollectionIterator
+        {
+            MovableObjectMap::iterator mMapIt, mMapEnd;
+            MovableObjectList::iterator mListIt, mListEnd;
+        public:
+            explicit MovableObjectCollectionIterator(MovableObjectCollection& coll)
+                : mMapIt(coll.map.begin()), mMapEnd(coll.map.end()),
+                  mListIt(coll.anonymous.begin()), mListEnd(coll.anonymous.end())
+            {
+            }
+            bool hasMoreElements() const { return mMapIt != mMapEnd || mListIt != mListEnd; }
+            MovableObject* peekNextValue() const { return mMapIt != mMapEnd ? mMapIt->second : *mListIt; }
+            void moveNext()
+            {
+                if (mMapIt != mMapEnd)
+                    ++mMapIt;
+                else
+                    ++mListIt;
+            }
+            MovableObject* getNext()
+            {
+                MovableObject* ret = peekNextValue();
+                moveNext();
+                return ret;
+            }
+        };
+        /** Get an iterator over all MovableObject instances of a given type, including
+            those created by createMovableObjectHandle (internal use only).
+        @note
+            Not thread safe, see getMovableObjectIterator.
+        */
+        MovableObjectCollectionIterator _getMovableObjectCollectionIterator(const String& typeName);
         /** Inject a MovableObject instance created externally.
         @remarks
             This method 'injects' a MovableObject instance created externally into
@@ -3210,7 +3831,8 @@ namespace Ogre {
         @remarks
             Essentially this does the same as destroyMovableObject, but only
             removes the instance from the internal lists, it does not attempt
-            to destroy it.
+            to destroy it. The instance no longer refers to this SceneManager
+            afterwards, so it may outlive it or be injected into another one.
         */
         void extractMovableObject(const String& name, const String& typeName);
         /// @overload
@@ -3219,7 +3841,7 @@ namespace Ogre {
         @remarks
             Essentially this does the same as destroyAllMovableObjectsByType, 
             but only removes the instances from the internal lists, it does not 
-            attempt to destroy them.
+            attempt to destroy them, see extractMovableObject.
         */
         void extractAllMovableObjectsByType(const String& typeName);
 
@@ -3342,6 +3964,33 @@ namespace Ogre {
         */
         void _markGpuParamsDirty(uint16 mask);
 
+        /** Sets whether _setPass and renderSingleObject skip render system calls which
+            would not change the state they last set.
+        @remarks
+            The SceneManager keeps a copy of the blending, depth, alpha rejection, culling,
+            polygon, shading, fog, lighting, point and line state and of the bound GPU
+            programs and compares each pass against it, which avoids relying on the uneven
+            redundancy checks of the render systems. Texture units are always set, as their
+            state can be animated. The copy is discarded at the start of each scene render
+            and for manualRender and _injectRenderWithPass; code which changes render system
+            state by other means in between, e.g. in a RenderQueueListener, must call
+            _markRenderStateDirty. Disabled by default.
+        */
+        void setRenderStateCaching(bool enabled) { mRenderStateCache.enabled = enabled; }
+        /// @copydoc setRenderStateCaching
+        bool getRenderStateCaching(void) const { return mRenderStateCache.enabled; }
+
+        /** Forget the render state last set by _setPass, so everything is set again.
+        @see setRenderStateCaching
+        */
+        void _markRenderStateDirty(void) { ++mRenderStateCache.generation; }
+
+        /// Counters of the render state calls issued and skipped while caching is enabled
+        const RenderStateStatistics& getRenderStateStatistics(void) const
+        { return mRenderStateCache.statistics; }
+        /// Zero the counters of getRenderStateStatistics
+        void resetRenderStateStatistics(void) { mRenderStateCache.statistics = RenderStateStatistics(); }
+
 
         /** Indicates to the SceneManager whether it should suppress the 
             active shadow rendering technique until told otherwise.
@@ -3459,8 +4108,29 @@ namespace Ogre {
         DefaultIntersectionSceneQuery(SceneManager* creator);
         ~DefaultIntersectionSceneQuery();
 
-        /** See IntersectionSceneQuery. */
+        /** See IntersectionSceneQuery.
+        @remarks
+            Uses a sort-and-sweep broadphase along the x axis. The sorted
+            intervals persist between executions, so a scene that only
+            moves a little between frames is re-sorted in close to linear time.
+        */
         void execute(IntersectionSceneQueryListener* listener);
+    protected:
+        struct SweepEntry
+        {
+            MovableObject* object;
+            Vector3 minimum;
+            Vector3 maximum;
+            /// position in the brute force iteration order, used to keep the reporting order
+            uint32 rank;
+        };
+        /// intervals sorted by minimum.x, kept from the last execution
+        std::vector<SweepEntry> mSweepEntries;
+        /// objects passing the masks in this execution, indexed by rank
+        std::vector<MovableObject*> mSweepObjects;
+        /// rank + 1 of the objects in mSweepObjects, 0 once taken by an entry
+        std::unordered_map<MovableObject*, uint32> mSweepRanks;
+        std::vector<std::pair<uint32, uint32> > mSweepPairs;
     };
 
     /** Default implementation of RaySceneQuery. */
@@ -3472,6 +4142,9 @@ namespace Ogre {
 
         /** See RayScenQuery. */
         void execute(RaySceneQueryListener* listener);
+    protected:
+        /// Objects found in the broadphase, kept to reuse the memory
+        std::vector<MovableObject*> mCandidates;
     };
     /** Default implementation of SphereSceneQuery. */
     class _OgreExport DefaultSphereSceneQuery : public SphereSceneQuery
@@ -3482,6 +4155,9 @@ namespace Ogre {
 
         /** See SceneQuery. */
         void execute(SceneQueryListener* listener);
+    protected:
+        /// Objects found in the broadphase, kept to reuse the memory
+        std::vector<MovableObject*> mCandidates;
     };
     /** Default implementation of PlaneBoundedVolumeListSceneQuery. */
     class _OgreExport DefaultPlaneBoundedVolumeListSceneQuery : public PlaneBoundedVolumeListSceneQuery
@@ -3492,6 +4168,9 @@ namespace Ogre {
 
         /** See SceneQuery. */
         void execute(SceneQueryListener* listener);
+    protected:
+        /// Objects found in the broadphase, kept to reuse the memory
+        std::vector<MovableObject*> mCandidates;
     };
     /** Default implementation of AxisAlignedBoxSceneQuery. */
     class _OgreExport DefaultAxisAlignedBoxSceneQuery : public AxisAlignedBoxSceneQuery
@@ -3502,6 +4181,9 @@ namespace Ogre {
 
         /** See RayScenQuery. */
         void execute(SceneQueryListener* listener);
+    protected:
+        /// Objects found in the broadphase, kept to reuse the memory
+        std::vector<MovableObject*> mCandidates;
     };
     
 
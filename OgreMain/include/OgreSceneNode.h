@@ -87,6 +87,26 @@ namespace Ogre {
         */
         virtual void setInSceneGraph(bool inGraph);
 
+        /** Internal method doing the work of _findVisibleObjects, once this node passed
+            the visibility test.
+        @remarks
+            The children are culled in batches using Camera::getVisibility before
+            recursing into the visible ones.
+        */
+        void addVisibleObjects(Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds,
+            bool includeChildren, bool displayNodes, bool onlyShadowCasters);
+
+        /** Appends this node and all visible nodes below it to nodes, in the order
+            addVisibleObjects visits them.
+        @remarks
+            Only reads the scene graph, so this can run for several cameras in parallel.
+        */
+        void collectVisibleNodes(const Camera* cam, std::vector<SceneNode*>& nodes);
+
+        /// Calls f for each child whose world bounds are visible to cam
+        template<typename Function> void forEachVisibleChild(const Camera* cam, const Function& f);
+
         /// Auto tracking target
         SceneNode* mAutoTrackTarget;
         /// Pointer to a Wire Bounding Box for this Node
@@ -104,6 +124,8 @@ namespace Ogre {
             it manually.
         */
         size_t mGlobalIndex;
+        /// Position in the moved nodes of the query broadphase of our creator, or -1
+        int mQueryMovedIndex;
 
         /// Whether to yaw around a fixed axis.
         bool mYawFixed : 1;
@@ -175,12 +197,26 @@ namespace Ogre {
             Only SceneManager should call this!
         */
         void _notifyRootNode(void) { mIsInSceneGraph = true; }
-            
+
+        /** @copydoc Node::needUpdate
+        @remarks
+            Also lets the creator know, so it refreshes the query broadphase entries
+            of the objects below this node.
+        */
+        void needUpdate(bool forceParentUpdate = false);
+
+        /// Internal method used by the query broadphase of the creator
+        int _getQueryMovedIndex(void) const { return mQueryMovedIndex; }
+        /// @copydoc _getQueryMovedIndex
+        void _setQueryMovedIndex(int index) { mQueryMovedIndex = index; }
 
         /** Internal method to update the Node.
             @note
                 Updates this scene node and any relevant children to incorporate transforms etc.
                 Don't call this yourself unless you are writing a SceneManager implementation.
+                The world bounds are only recalculated if anything in this sub-tree changed, see
+                Node::_isUpdatePending. Objects changing their bounds therefore have to notify their
+                node through Node::needUpdate or Node::queueNeedUpdate.
             @param
                 updateChildren If true, the update cascades down to all children. Specify false if you wish to
                 update children separately, e.g. because of a more selective SceneManager implementation.
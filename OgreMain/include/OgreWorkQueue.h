@@ -431,6 +431,9 @@ namespace Ogre
         /** Returns whether the queue is trying to shut down. */
         virtual bool isShuttingDown() const { return mShuttingDown; }
 
+        /** Returns whether the queue was started up and not shut down since. */
+        bool isRunning() const { return mIsRunning; }
+
         /// @copydoc WorkQueue::addRequestHandler
         virtual void addRequestHandler(uint16 channel, RequestHandler* rh);
         /// @copydoc WorkQueue::removeRequestHandler
@@ -43,6 +43,8 @@ namespace Ogre {
         , mInterpolationMode(msDefaultInterpolationMode)
         , mRotationInterpolationMode(msDefaultRotationInterpolationMode)
         , mKeyFrameTimesDirty(false)
+        , mPackedNodeTracksDirty(true)
+        , mUsePackedKeyFrames(false)
         , mUseBaseKeyFrame(false)
         , mBaseKeyFrameTime(0.0f)
         , mBaseKeyFrameAnimationName(BLANKSTRING)
@@ -344,38 +346,98 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, Real weight, 
         Real scale)
+    {
+        _applyToSkeleton(skel, timePos, weight, 0, scale);
+    }
+    //---------------------------------------------------------------------
+    void Animation::apply(Skeleton* skel, Real timePos, float weight,
+      const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        _applyToSkeleton(skel, timePos, weight, blendMask, scale);
+    }
+    //---------------------------------------------------------------------
+    void Animation::_applyToSkeleton(Skeleton* skel, Real timePos, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale, uint* cursor)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
+        TimeIndex timeIndex = cursor ? _getTimeIndex(timePos, *cursor) : _getTimeIndex(timePos);
 
-        NodeTrackList::iterator i;
-        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        if (mInterpolationMode == IM_SPLINE || !mUsePackedKeyFrames)
         {
-            // get bone to apply to 
-            Bone* b = skel->getBone(i->first);
-            i->second->applyToNode(b, timeIndex, weight, scale);
+            // splines and animations without packed key frames are evaluated per track
+            NodeTrackList::iterator i;
+            for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                // get bone to apply to
+                Bone* b = skel->getBone(i->first);
+                Real boneWeight = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+                i->second->applyToNode(b, timeIndex, boneWeight, scale);
+            }
+            return;
         }
 
+        if (mPackedNodeTracksDirty)
+            buildPackedNodeTracks();
 
-    }
-    //---------------------------------------------------------------------
-    void Animation::apply(Skeleton* skel, Real timePos, float weight,
-      const AnimationState::BoneBlendMask* blendMask, Real scale)
-    {
-        _applyBaseKeyFrame();
+        // Sample all tracks at once, the same way as NodeAnimationTrack::getInterpolatedKeyFrame
+        const PackedNodeTracks& packed = mPackedNodeTracks;
+        const Real* times = packed.times.empty() ? 0 : &packed.times[0];
+        Real time = timeIndex.getTimePos();
 
-        // Calculate time index for fast keyframe search
-      TimeIndex timeIndex = _getTimeIndex(timePos);
+        for (size_t i = 0; i < packed.tracks.size(); ++i)
+        {
+            const PackedNodeTracks::Track& track = packed.tracks[i];
+            Bone* b = skel->getBone(track.handle);
+            Real boneWeight = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+            if (!boneWeight)
+                continue;
+
+            if (!track.numKeys || track.track->getListener())
+            {
+                // compressed, or the listener may override the interpolated key frame
+                track.track->applyToNode(b, timeIndex, boneWeight, scale);
+                continue;
+            }
+
+            // Find the key frames around time, see AnimationTrack::getKeyFramesAtTime
+            uint k1, k2 = track.track->_getKeyFrameIndexMap()[timeIndex.getKeyIndex()];
+            Real t2;
+            if (k2 == track.numKeys)
+            {
+                // There is no keyframe after this time, wrap back to first
+                k1 = track.firstKey + k2 - 1;
+                k2 = track.firstKey;
+                t2 = mLength + times[k2];
+            }
+            else
+            {
+                k2 += track.firstKey;
+                t2 = times[k2];
+                k1 = (k2 != track.firstKey && time < t2) ? k2 - 1 : k2;
+            }
+            Real t1 = times[k1];
+            Real t = t1 == t2 ? 0 : (time - t1) / (t2 - t1);
 
-      NodeTrackList::iterator i;
-      for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
-      {
-        // get bone to apply to 
-        Bone* b = skel->getBone(i->first);
-        i->second->applyToNode(b, timeIndex, (*blendMask)[b->getHandle()] * weight, scale);
-      }
+            if (t == 0.0)
+            {
+                // Just use k1
+                track.track->_applyTransform(b, packed.translates[k1], packed.rotations[k1],
+                                             packed.scales[k1], boneWeight, scale);
+                continue;
+            }
+
+            bool shortestPath = track.track->getUseShortestRotationPath();
+            Quaternion rotation = mRotationInterpolationMode == RIM_LINEAR
+                ? Quaternion::nlerp(t, packed.rotations[k1], packed.rotations[k2], shortestPath)
+                : Quaternion::Slerp(t, packed.rotations[k1], packed.rotations[k2], shortestPath);
+            const Vector3& translate = packed.translates[k1];
+            const Vector3& keyScale = packed.scales[k1];
+            track.track->_applyTransform(
+                b, translate + ((packed.translates[k2] - translate) * t), rotation,
+                keyScale + ((packed.scales[k2] - keyScale) * t), boneWeight, scale);
+        }
     }
     //---------------------------------------------------------------------
     void Animation::apply(Entity* entity, Real timePos, Real weight, 
@@ -503,6 +565,18 @@ namespace Ogre {
         return mRotationInterpolationMode;
     }
     //---------------------------------------------------------------------
+    void Animation::setUsePackedKeyFrames(bool usePacked)
+    {
+        mUsePackedKeyFrames = usePacked;
+        mPackedNodeTracksDirty = true;
+        if (!usePacked)
+        {
+            // release the copies
+            PackedNodeTracks empty;
+            std::swap(mPackedNodeTracks, empty);
+        }
+    }
+    //---------------------------------------------------------------------
     void Animation::setDefaultRotationInterpolationMode(RotationInterpolationMode im)
     {
         msDefaultRotationInterpolationMode = im;
@@ -520,6 +594,25 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::reduceNodeKeyFrames(Real translationTolerance, const Radian& rotationTolerance,
+        Real scaleTolerance)
+    {
+        NodeTrackList::iterator i;
+        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->reduceKeyFrames(translationTolerance, rotationTolerance, scaleTolerance);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(void)
+    {
+        NodeTrackList::iterator i;
+        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->compress();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_collectIdentityNodeTracks(TrackHandleList& tracks) const
     {
         NodeTrackList::const_iterator i, iend;
@@ -606,6 +699,7 @@ namespace Ogre {
         Animation* newAnim = OGRE_NEW Animation(newName, mLength);
         newAnim->mInterpolationMode = mInterpolationMode;
         newAnim->mRotationInterpolationMode = mRotationInterpolationMode;
+        newAnim->mUsePackedKeyFrames = mUsePackedKeyFrames;
         
         // Clone all tracks
         for (NodeTrackList::const_iterator i = mNodeTrackList.begin();
@@ -653,6 +747,109 @@ namespace Ogre {
         return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForConcurrentApply(void)
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        if (mPackedNodeTracksDirty && mUsePackedKeyFrames && mInterpolationMode != IM_SPLINE)
+        {
+            buildPackedNodeTracks();
+        }
+
+        if (mInterpolationMode == IM_SPLINE)
+        {
+            NodeTrackList::const_iterator i;
+            for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                i->second->_prepareInterpolation();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    TimeIndex Animation::_getTimeIndex(Real timePos, uint& cursor) const
+    {
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        // Wrap time
+        Real totalAnimationLength = mLength;
+
+        if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
+            timePos = std::fmod( timePos, totalAnimationLength );
+
+        // The cursor is valid if it is the lower bound of timePos. Try the one
+        // of the last call and the next one before searching.
+        size_t count = mKeyFrameTimes.size();
+        for (int step = 0; step < 2; ++step)
+        {
+            size_t index = cursor + step;
+            if (index <= count && (index == count || timePos <= mKeyFrameTimes[index]) &&
+                (index == 0 || mKeyFrameTimes[index - 1] < timePos))
+            {
+                cursor = static_cast<uint>(index);
+                return TimeIndex(timePos, cursor);
+            }
+        }
+
+        KeyFrameTimeList::iterator it =
+            std::lower_bound(mKeyFrameTimes.begin(), mKeyFrameTimes.end(), timePos);
+        cursor = static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it));
+        return TimeIndex(timePos, cursor);
+    }
+    //-----------------------------------------------------------------------
+    void Animation::buildPackedNodeTracks(void)
+    {
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        PackedNodeTracks& packed = mPackedNodeTracks;
+        packed.tracks.clear();
+        packed.times.clear();
+        packed.translates.clear();
+        packed.rotations.clear();
+        packed.scales.clear();
+
+        NodeTrackList::const_iterator i;
+        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            NodeAnimationTrack* track = i->second;
+            unsigned short numKeys = track->getNumKeyFrames();
+            // applyToNode does nothing for these
+            if (!numKeys)
+                continue;
+
+            PackedNodeTracks::Track t = {track, i->first, static_cast<uint>(packed.times.size()), numKeys};
+            if (track->isCompressed())
+            {
+                // decoded when sampled, a copy would defeat the compression
+                t.numKeys = 0;
+                packed.tracks.push_back(t);
+                continue;
+            }
+            packed.tracks.push_back(t);
+
+            for (unsigned short k = 0; k < numKeys; ++k)
+            {
+                const TransformKeyFrame* kf = track->getNodeKeyFrame(k);
+                packed.times.push_back(kf->getTime());
+                packed.translates.push_back(kf->getTranslate());
+                packed.rotations.push_back(kf->getRotation());
+                packed.scales.push_back(kf->getScale());
+            }
+        }
+
+        mPackedNodeTracksDirty = false;
+    }
+    //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
     {
         NodeTrackList::const_iterator i;
@@ -42,6 +42,7 @@ namespace Ogre
         , mWeight(rhs.mWeight)
         , mEnabled(rhs.mEnabled)
         , mLoop(rhs.mLoop)
+        , mKeyFrameCursor(0)
   {
         mParent->_notifyDirty();
     }
@@ -57,6 +58,7 @@ namespace Ogre
         , mWeight(weight)
         , mEnabled(enabled)
         , mLoop(true)
+        , mKeyFrameCursor(0)
     {
         mParent->_notifyDirty();
     }
@@ -41,6 +41,70 @@ namespace Ogre {
                 return kf->getTime() < kf2->getTime();
             }
         };
+
+        // Compressed node tracks store the three smallest components of a rotation, in
+        // 15 bits each, and use the top bits for the index and sign of the largest one
+        const Real MAX_SMALLEST_COMPONENT = 0.70710678f;
+        const Real ROTATION_STEPS = 32767;
+        // Translations and scales use 16 bits per component
+        const Real VECTOR_STEPS = 65535;
+
+        void encodeRotation(const Quaternion& q, uint16* out)
+        {
+            Quaternion n = q;
+            n.normalise();
+            Real c[4] = {n.w, n.x, n.y, n.z};
+            int largest = 0;
+            for (int i = 1; i < 4; ++i)
+            {
+                if (Math::Abs(c[i]) > Math::Abs(c[largest]))
+                    largest = i;
+            }
+
+            for (int i = 0, j = 0; i < 4; ++i)
+            {
+                if (i == largest)
+                    continue;
+                Real v = (c[i] / MAX_SMALLEST_COMPONENT + 1) * 0.5f * ROTATION_STEPS;
+                out[j++] = static_cast<uint16>(Math::Clamp<Real>(std::floor(v + 0.5f), 0, ROTATION_STEPS));
+            }
+            out[0] |= (largest & 1) << 15;
+            out[1] |= (largest >> 1) << 15;
+            if (c[largest] < 0)
+                out[2] |= 0x8000;
+        }
+
+        Quaternion decodeRotation(const uint16* in)
+        {
+            int largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+            Real c[4];
+            Real sum = 0;
+            for (int i = 0, j = 0; i < 4; ++i)
+            {
+                if (i == largest)
+                    continue;
+                c[i] = ((in[j++] & 0x7fff) / ROTATION_STEPS * 2 - 1) * MAX_SMALLEST_COMPONENT;
+                sum += c[i] * c[i];
+            }
+            c[largest] = Math::Sqrt(std::max<Real>(1 - sum, 0));
+            if (in[2] & 0x8000)
+                c[largest] = -c[largest];
+            return Quaternion(c[0], c[1], c[2], c[3]);
+        }
+
+        void encodeVector(const Vector3& v, const Vector3& base, const Vector3& step, uint16* out)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                Real q = step[i] > 0 ? std::floor((v[i] - base[i]) / step[i] + 0.5f) : 0;
+                out[i] = static_cast<uint16>(Math::Clamp<Real>(q, 0, VECTOR_STEPS));
+            }
+        }
+
+        Vector3 decodeVector(const uint16* in, const Vector3& base, const Vector3& step)
+        {
+            return base + Vector3(in[0], in[1], in[2]) * step;
+        }
     }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -353,7 +417,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     NodeAnimationTrack::NodeAnimationTrack(Animation* parent, unsigned short handle)
         : AnimationTrack(parent, handle), mTargetNode(0)
-        , mSplines(0), mSplineBuildNeeded(false)
+        , mCompressed(0), mSplines(0), mSplineBuildNeeded(false)
         , mUseShortestRotationPath(true)
     {
     }
@@ -361,16 +425,178 @@ namespace Ogre {
     NodeAnimationTrack::NodeAnimationTrack(Animation* parent, unsigned short handle,
         Node* targetNode)
         : AnimationTrack(parent, handle), mTargetNode(targetNode)
-        , mSplines(0), mSplineBuildNeeded(false)
+        , mCompressed(0), mSplines(0), mSplineBuildNeeded(false)
         , mUseShortestRotationPath(true)
     {
     }
     //---------------------------------------------------------------------
     NodeAnimationTrack::~NodeAnimationTrack()
     {
+        OGRE_DELETE_T(mCompressed, CompressedKeyFrames, MEMCATEGORY_ANIMATION);
         OGRE_DELETE_T(mSplines, Splines, MEMCATEGORY_ANIMATION);
     }
     //---------------------------------------------------------------------
+    NodeAnimationTrack::CompressedKeyFrames::CompressedKeyFrames() : stride(3), translateOffset(0), scaleOffset(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    unsigned short NodeAnimationTrack::getNumKeyFrames(void) const
+    {
+        if (mCompressed)
+            return static_cast<unsigned short>(mCompressed->times.size());
+
+        return AnimationTrack::getNumKeyFrames();
+    }
+    //---------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::getKeyFrame(unsigned short index) const
+    {
+        if (mCompressed)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "Compressed tracks have no keyframe objects, use getNodeKeyFrameCopy or decompress",
+                "NodeAnimationTrack::getKeyFrame");
+        }
+
+        return AnimationTrack::getKeyFrame(index);
+    }
+    //---------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1,
+        KeyFrame** keyFrame2, unsigned short* firstKeyIndex) const
+    {
+        if (mCompressed)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "Compressed tracks have no keyframe objects, use getInterpolatedKeyFrame or decompress",
+                "NodeAnimationTrack::getKeyFramesAtTime");
+        }
+
+        return AnimationTrack::getKeyFramesAtTime(timeIndex, keyFrame1, keyFrame2, firstKeyIndex);
+    }
+    //---------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyFrameIndicesAtTime(const TimeIndex& timeIndex,
+        unsigned short& index1, unsigned short& index2) const
+    {
+        // Same as AnimationTrack::getKeyFramesAtTime
+        const std::vector<Real>& times = mCompressed->times;
+        Real timePos = timeIndex.getTimePos();
+
+        // Find first keyframe after or on current time
+        size_t i;
+        if (timeIndex.hasKeyIndex())
+        {
+            // Global keyframe index available, map to local keyframe index directly.
+            assert(timeIndex.getKeyIndex() < mKeyFrameIndexMap.size());
+            i = mKeyFrameIndexMap[timeIndex.getKeyIndex()];
+        }
+        else
+        {
+            // Wrap time
+            Real totalAnimationLength = mParent->getLength();
+            if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
+                timePos = std::fmod( timePos, totalAnimationLength );
+
+            i = std::lower_bound(times.begin(), times.end(), timePos) - times.begin();
+        }
+
+        Real t1, t2;
+        if (i == times.size())
+        {
+            // There is no keyframe after this time, wrap back to first
+            index2 = 0;
+            t2 = mParent->getLength() + times[0];
+
+            // Use last keyframe as previous keyframe
+            --i;
+        }
+        else
+        {
+            index2 = static_cast<unsigned short>(i);
+            t2 = times[i];
+
+            // Find last keyframe before or on current time
+            if (i != 0 && timePos < times[i])
+            {
+                --i;
+            }
+        }
+
+        index1 = static_cast<unsigned short>(i);
+        t1 = times[i];
+
+        return t1 == t2 ? 0 : (timePos - t1) / (t2 - t1);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::decodeKeyFrame(unsigned short index, Vector3& translate,
+        Quaternion& rotation, Vector3& scale) const
+    {
+        const CompressedKeyFrames* c = mCompressed;
+        const uint16* values = &c->values[index * c->stride];
+        rotation = decodeRotation(values);
+        translate = c->translateOffset ? decodeVector(values + c->translateOffset,
+            c->translateBase, c->translateStep) : c->translateBase;
+        scale = c->scaleOffset ? decodeVector(values + c->scaleOffset,
+            c->scaleBase, c->scaleStep) : c->scaleBase;
+    }
+    //---------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::createKeyFrame(Real timePos)
+    {
+        decompress();
+        return AnimationTrack::createKeyFrame(timePos);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::removeKeyFrame(unsigned short index)
+    {
+        decompress();
+        AnimationTrack::removeKeyFrame(index);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::removeAllKeyFrames(void)
+    {
+        OGRE_DELETE_T(mCompressed, CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+        mCompressed = 0;
+        AnimationTrack::removeAllKeyFrames();
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_collectKeyFrameTimes(std::vector<Real>& keyFrameTimes)
+    {
+        if (!mCompressed)
+        {
+            AnimationTrack::_collectKeyFrameTimes(keyFrameTimes);
+            return;
+        }
+
+        const std::vector<Real>& times = mCompressed->times;
+        for (size_t i = 0; i < times.size(); ++i)
+        {
+            std::vector<Real>::iterator it =
+                std::lower_bound(keyFrameTimes.begin(), keyFrameTimes.end(), times[i]);
+            if (it == keyFrameTimes.end() || *it != times[i])
+            {
+                keyFrameTimes.insert(it, times[i]);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_buildKeyFrameIndexMap(const std::vector<Real>& keyFrameTimes)
+    {
+        if (!mCompressed)
+        {
+            AnimationTrack::_buildKeyFrameIndexMap(keyFrameTimes);
+            return;
+        }
+
+        const std::vector<Real>& times = mCompressed->times;
+        mKeyFrameIndexMap.resize(keyFrameTimes.size() + 1);
+
+        size_t i = 0;
+        for (size_t j = 0; j <= keyFrameTimes.size(); ++j)
+        {
+            mKeyFrameIndexMap[j] = static_cast<ushort>(i);
+            while (j < keyFrameTimes.size() && i < times.size() && times[i] <= keyFrameTimes[j])
+                ++i;
+        }
+    }
+    //---------------------------------------------------------------------
     void NodeAnimationTrack::getInterpolatedKeyFrame(const TimeIndex& timeIndex, KeyFrame* kf) const
     {
         if (mListener)
@@ -386,10 +612,42 @@ namespace Ogre {
         TransformKeyFrame *k1, *k2;
         unsigned short firstKeyIndex;
 
+        if (mCompressed)
+        {
+            // Decode locally rather than into the copies, so that several threads may
+            // sample this track
+            TransformKeyFrame decoded1(0, 0), decoded2(0, 0);
+            unsigned short secondKeyIndex;
+            Real t = getKeyFrameIndicesAtTime(timeIndex, firstKeyIndex, secondKeyIndex);
+
+            Vector3 translate, scale;
+            Quaternion rotation;
+            decodeKeyFrame(firstKeyIndex, translate, rotation, scale);
+            decoded1.setTranslate(translate);
+            decoded1.setRotation(rotation);
+            decoded1.setScale(scale);
+            if (t != 0.0)
+            {
+                decodeKeyFrame(secondKeyIndex, translate, rotation, scale);
+                decoded2.setTranslate(translate);
+                decoded2.setRotation(rotation);
+                decoded2.setScale(scale);
+            }
+            interpolateKeyFrames(&decoded1, &decoded2, firstKeyIndex, t, kret);
+            return;
+        }
+
         Real t = this->getKeyFramesAtTime(timeIndex, &kBase1, &kBase2, &firstKeyIndex);
         k1 = static_cast<TransformKeyFrame*>(kBase1);
         k2 = static_cast<TransformKeyFrame*>(kBase2);
 
+        interpolateKeyFrames(k1, k2, firstKeyIndex, t, kret);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::interpolateKeyFrames(const TransformKeyFrame* k1,
+        const TransformKeyFrame* k2, unsigned short firstKeyIndex, Real t,
+        TransformKeyFrame* kret) const
+    {
         if (t == 0.0)
         {
             // Just use k1
@@ -475,15 +733,20 @@ namespace Ogre {
         Real scl)
     {
         // Nothing to do if no keyframes or zero weight or no node
-        if (mKeyFrames.empty() || !weight || !node)
+        if ((mCompressed ? mCompressed->times.empty() : mKeyFrames.empty()) || !weight || !node)
             return;
 
         TransformKeyFrame kf(0, timeIndex.getTimePos());
         getInterpolatedKeyFrame(timeIndex, &kf);
 
+        _applyTransform(node, kf.getTranslate(), kf.getRotation(), kf.getScale(), weight, scl);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_applyTransform(Node* node, const Vector3& translate,
+        const Quaternion& rotation, const Vector3& keyScale, Real weight, Real scl) const
+    {
         // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
-        Vector3 translate = kf.getTranslate() * weight * scl;
-        node->translate(translate);
+        node->translate(translate * weight * scl);
 
         // interpolate between no-rotation and full rotation, to point 'weight', so 0 = no rotate, 1 = full
         Quaternion rotate;
@@ -491,15 +754,15 @@ namespace Ogre {
             mParent->getRotationInterpolationMode();
         if (rim == Animation::RIM_LINEAR)
         {
-            rotate = Quaternion::nlerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
+            rotate = Quaternion::nlerp(weight, Quaternion::IDENTITY, rotation, mUseShortestRotationPath);
         }
         else //if (rim == Animation::RIM_SPHERICAL)
         {
-            rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
+            rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, rotation, mUseShortestRotationPath);
         }
         node->rotate(rotate);
 
-        Vector3 scale = kf.getScale();
+        Vector3 scale = keyScale;
         // Not sure how to modify scale for cumulative anims... leave it alone
         //scale = ((Vector3::UNIT_SCALE - kf.getScale()) * weight) + Vector3::UNIT_SCALE;
         if (scale != Vector3::UNIT_SCALE)
@@ -533,6 +796,19 @@ namespace Ogre {
         splines->rotationSpline.clear();
         splines->scaleSpline.clear();
 
+        if (mCompressed)
+        {
+            Vector3 translate, scale;
+            Quaternion rotation;
+            for (unsigned short k = 0; k < mCompressed->times.size(); ++k)
+            {
+                decodeKeyFrame(k, translate, rotation, scale);
+                splines->positionSpline.addPoint(translate);
+                splines->rotationSpline.addPoint(rotation);
+                splines->scaleSpline.addPoint(scale);
+            }
+        }
+
         KeyFrameList::const_iterator i, iend;
         iend = mKeyFrames.end(); // precall to avoid overhead
         for (i = mKeyFrames.begin(); i != iend; ++i)
@@ -566,22 +842,28 @@ namespace Ogre {
     void NodeAnimationTrack::_keyFrameDataChanged(void) const
     {
         mSplineBuildNeeded = true;
+        mParent->_keyFrameDataChanged();
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_prepareInterpolation(void) const
+    {
+        if (mSplineBuildNeeded && mParent->getInterpolationMode() == Animation::IM_SPLINE)
+            buildInterpolationSplines();
     }
     //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
     {
-        KeyFrameList::const_iterator i = mKeyFrames.begin();
-        for (; i != mKeyFrames.end(); ++i)
+        for (unsigned short k = 0; k < getNumKeyFrames(); ++k)
         {
             // look for keyframes which have any component which is non-zero
             // Since exporters can be a little inaccurate sometimes we use a
             // tolerance value rather than looking for nothing
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
-            Vector3 trans = kf->getTranslate();
-            Vector3 scale = kf->getScale();
+            TransformKeyFrame kf = getNodeKeyFrameCopy(k);
+            Vector3 trans = kf.getTranslate();
+            Vector3 scale = kf.getScale();
             Vector3 axis;
             Radian angle;
-            kf->getRotation().ToAngleAxis(angle, axis);
+            kf.getRotation().ToAngleAxis(angle, axis);
             Real tolerance = 1e-3f;
             if (!trans.positionEquals(Vector3::ZERO, tolerance) ||
                 !scale.positionEquals(Vector3::UNIT_SCALE, tolerance) ||
@@ -601,6 +883,9 @@ namespace Ogre {
         // NB only eliminate middle keys from sequences of 5+ identical keyframes
         // since we need to preserve the boundary keys in place, and we need
         // 2 at each end to preserve tangents for spline interpolation
+        if (mCompressed)
+            return;
+
         Vector3 lasttrans = Vector3::ZERO;
         Vector3 lastscale = Vector3::ZERO;
         Quaternion lastorientation;
@@ -666,6 +951,34 @@ namespace Ogre {
     {
         return static_cast<TransformKeyFrame*>(getKeyFrame(index));
     }
+    //--------------------------------------------------------------------------
+    TransformKeyFrame NodeAnimationTrack::getNodeKeyFrameCopy(unsigned short index) const
+    {
+        Vector3 translate, scale;
+        Quaternion rotation;
+        Real time;
+        if (mCompressed)
+        {
+            assert(index < mCompressed->times.size());
+            time = mCompressed->times[index];
+            decodeKeyFrame(index, translate, rotation, scale);
+        }
+        else
+        {
+            const TransformKeyFrame* kf = getNodeKeyFrame(index);
+            time = kf->getTime();
+            translate = kf->getTranslate();
+            rotation = kf->getRotation();
+            scale = kf->getScale();
+        }
+
+        // no parent, so changing the copy does not notify this track
+        TransformKeyFrame copy(0, time);
+        copy.setTranslate(translate);
+        copy.setRotation(rotation);
+        copy.setScale(scale);
+        return copy;
+    }
     //---------------------------------------------------------------------
     NodeAnimationTrack* NodeAnimationTrack::_clone(Animation* newParent) const
     {
@@ -673,12 +986,19 @@ namespace Ogre {
             newParent->createNodeTrack(mHandle, mTargetNode);
         newTrack->mUseShortestRotationPath = mUseShortestRotationPath;
         populateClone(newTrack);
+        if (mCompressed)
+        {
+            newTrack->mCompressed = OGRE_NEW_T(CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+            *newTrack->mCompressed = *mCompressed;
+        }
         return newTrack;
     }
     //--------------------------------------------------------------------------
     void NodeAnimationTrack::_applyBaseKeyFrame(const KeyFrame* b)
     {
         const TransformKeyFrame* base = static_cast<const TransformKeyFrame*>(b);
+        bool compressed = isCompressed();
+        decompress();
         
         for (KeyFrameList::iterator i = mKeyFrames.begin(); i != mKeyFrames.end(); ++i)
         {
@@ -687,7 +1007,162 @@ namespace Ogre {
             kf->setRotation(base->getRotation().Inverse() * kf->getRotation());
             kf->setScale(kf->getScale() * (Vector3::UNIT_SCALE / base->getScale()));
         }
-            
+
+        if (compressed)
+            compress();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::reduceKeyFrames(Real translationTolerance,
+        const Radian& rotationTolerance, Real scaleTolerance)
+    {
+        bool compressed = isCompressed();
+        decompress();
+
+        size_t numKeys = mKeyFrames.size();
+        if (numKeys > 2)
+        {
+            bool nlerp = mParent->getRotationInterpolationMode() == Animation::RIM_LINEAR;
+            std::vector<bool> keep(numKeys, false);
+            keep.front() = keep.back() = true;
+
+            // Extend the segment from first for as long as interpolating between its ends
+            // reproduces all keyframes within it, then start the next one at its end
+            size_t first = 0;
+            for (size_t last = 2; last < numKeys; ++last)
+            {
+                const TransformKeyFrame* k1 = static_cast<TransformKeyFrame*>(mKeyFrames[first]);
+                const TransformKeyFrame* k2 = static_cast<TransformKeyFrame*>(mKeyFrames[last]);
+                Real duration = k2->getTime() - k1->getTime();
+                for (size_t k = first + 1; k < last; ++k)
+                {
+                    const TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(mKeyFrames[k]);
+                    Real t = duration > 0 ? (kf->getTime() - k1->getTime()) / duration : 0;
+                    Quaternion rotation = nlerp
+                        ? Quaternion::nlerp(t, k1->getRotation(), k2->getRotation(), mUseShortestRotationPath)
+                        : Quaternion::Slerp(t, k1->getRotation(), k2->getRotation(), mUseShortestRotationPath);
+                    Vector3 translate = k1->getTranslate() + (k2->getTranslate() - k1->getTranslate()) * t;
+                    Vector3 scale = k1->getScale() + (k2->getScale() - k1->getScale()) * t;
+
+                    if (translate.distance(kf->getTranslate()) > translationTolerance ||
+                        !rotation.equals(kf->getRotation(), rotationTolerance) ||
+                        scale.distance(kf->getScale()) > scaleTolerance)
+                    {
+                        keep[last - 1] = true;
+                        first = last - 1;
+                        break;
+                    }
+                }
+            }
+
+            KeyFrameList keyFrames;
+            for (size_t k = 0; k < numKeys; ++k)
+            {
+                if (keep[k])
+                    keyFrames.push_back(mKeyFrames[k]);
+                else
+                    OGRE_DELETE mKeyFrames[k];
+            }
+
+            if (keyFrames.size() != numKeys)
+            {
+                mKeyFrames.swap(keyFrames);
+                _keyFrameDataChanged();
+                mParent->_keyFrameListChanged();
+            }
+        }
+
+        if (compressed)
+            compress();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::compress(void)
+    {
+        if (mCompressed)
+            return;
+
+        CompressedKeyFrames* c = OGRE_NEW_T(CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+        size_t numKeys = mKeyFrames.size();
+
+        // Ranges of the translations and scales
+        Vector3 translateMin(Vector3::ZERO), translateMax(Vector3::ZERO);
+        Vector3 scaleMin(Vector3::UNIT_SCALE), scaleMax(Vector3::UNIT_SCALE);
+        for (size_t k = 0; k < numKeys; ++k)
+        {
+            const TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(mKeyFrames[k]);
+            if (k == 0)
+            {
+                translateMin = translateMax = kf->getTranslate();
+                scaleMin = scaleMax = kf->getScale();
+            }
+            translateMin.makeFloor(kf->getTranslate());
+            translateMax.makeCeil(kf->getTranslate());
+            scaleMin.makeFloor(kf->getScale());
+            scaleMax.makeCeil(kf->getScale());
+        }
+        c->translateBase = translateMin;
+        c->translateStep = (translateMax - translateMin) / VECTOR_STEPS;
+        c->scaleBase = scaleMin;
+        c->scaleStep = (scaleMax - scaleMin) / VECTOR_STEPS;
+        c->stride = 3;
+        c->translateOffset = c->translateStep != Vector3::ZERO ? c->stride : 0;
+        c->stride += c->translateOffset ? 3 : 0;
+        c->scaleOffset = c->scaleStep != Vector3::ZERO ? c->stride : 0;
+        c->stride += c->scaleOffset ? 3 : 0;
+
+        c->times.reserve(numKeys);
+        c->values.resize(numKeys * c->stride);
+        for (size_t k = 0; k < numKeys; ++k)
+        {
+            const TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(mKeyFrames[k]);
+            uint16* values = &c->values[k * c->stride];
+            c->times.push_back(kf->getTime());
+            encodeRotation(kf->getRotation(), values);
+            if (c->translateOffset)
+                encodeVector(kf->getTranslate(), c->translateBase, c->translateStep,
+                             values + c->translateOffset);
+            if (c->scaleOffset)
+                encodeVector(kf->getScale(), c->scaleBase, c->scaleStep, values + c->scaleOffset);
+            OGRE_DELETE mKeyFrames[k];
+        }
+        KeyFrameList().swap(mKeyFrames);
+        mCompressed = c;
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::decompress(void)
+    {
+        if (!mCompressed)
+            return;
+
+        unsigned short numKeys = getNumKeyFrames();
+        mKeyFrames.reserve(numKeys);
+        Vector3 translate, scale;
+        Quaternion rotation;
+        for (unsigned short k = 0; k < numKeys; ++k)
+        {
+            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(createKeyFrameImpl(mCompressed->times[k]));
+            decodeKeyFrame(k, translate, rotation, scale);
+            kf->setTranslate(translate);
+            kf->setRotation(rotation);
+            kf->setScale(scale);
+            mKeyFrames.push_back(kf);
+        }
+        OGRE_DELETE_T(mCompressed, CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+        mCompressed = 0;
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //--------------------------------------------------------------------------
+    size_t NodeAnimationTrack::calculateKeyFrameSize(void) const
+    {
+        if (!mCompressed)
+            return mKeyFrames.size() * (sizeof(TransformKeyFrame) + sizeof(KeyFrame*));
+
+        return sizeof(CompressedKeyFrames) + mCompressed->times.size() * sizeof(Real) +
+               mCompressed->values.size() * sizeof(uint16);
     }
     //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
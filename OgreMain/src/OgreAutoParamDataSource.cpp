@@ -41,16 +41,15 @@ namespace Ogre {
          mWorldMatrixDirty(true),
          mViewMatrixDirty(true),
          mProjMatrixDirty(true),
-         mWorldViewMatrixDirty(true),
-         mViewProjMatrixDirty(true),
-         mWorldViewProjMatrixDirty(true),
-         mInverseWorldMatrixDirty(true),
-         mInverseWorldViewMatrixDirty(true),
-         mInverseViewMatrixDirty(true),
-         mInverseTransposeWorldMatrixDirty(true),
-         mInverseTransposeWorldViewMatrixDirty(true),
          mCameraPositionDirty(true),
-         mCameraPositionObjectSpaceDirty(true),
+         mCameraViewDirty(true),
+         mCameraProjDirty(true),
+         mViewMatrixIdentity(false),
+         mProjMatrixIdentity(false),
+         mWorldVersion(1),
+         mViewVersion(1),
+         mProjVersion(1),
+         mVersionedWorldMatrix(Affine3::IDENTITY),
          mAmbientLight(ColourValue::Black),
          mPassNumber(0),
          mSceneDepthRangeDirty(true),
@@ -79,6 +78,49 @@ namespace Ogre {
             mShadowCamDepthRangesDirty[i] = false;
         }
 
+        // zero versions never match, so everything is computed on first use
+        DerivedStamp stale = {0, 0, 0};
+        mWorldViewMatrixStamp = stale;
+        mViewProjMatrixStamp = stale;
+        mWorldViewProjMatrixStamp = stale;
+        mInverseWorldMatrixStamp = stale;
+        mInverseWorldViewMatrixStamp = stale;
+        mInverseViewMatrixStamp = stale;
+        mInverseTransposeWorldMatrixStamp = stale;
+        mInverseTransposeWorldViewMatrixStamp = stale;
+        mCameraPositionObjectSpaceStamp = stale;
+        resetCacheStatistics();
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::resetCacheStatistics()
+    {
+        mCacheStatistics.hits = 0;
+        mCacheStatistics.misses = 0;
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::updateWorldVersion() const
+    {
+        if (mWorldMatrixArray[0] != mVersionedWorldMatrix)
+        {
+            mVersionedWorldMatrix = mWorldMatrixArray[0];
+            ++mWorldVersion;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    inline bool AutoParamDataSource::isDerivedCurrent(DerivedStamp& stamp, uint32 world, uint32 view,
+                                               uint32 proj) const
+    {
+        if (stamp.world == world && stamp.view == view && stamp.proj == proj)
+        {
+            ++mCacheStatistics.hits;
+            return true;
+        }
+
+        stamp.world = world;
+        stamp.view = view;
+        stamp.proj = proj;
+        ++mCacheStatistics.misses;
+        return false;
     }
     //-----------------------------------------------------------------------------
 	const Camera* AutoParamDataSource::getCurrentCamera() const
@@ -102,18 +144,10 @@ namespace Ogre {
     void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
     {
         mCurrentRenderable = rend;
+        // the derived matrices are validated against the versions of these
         mWorldMatrixDirty = true;
         mViewMatrixDirty = true;
         mProjMatrixDirty = true;
-        mWorldViewMatrixDirty = true;
-        mViewProjMatrixDirty = true;
-        mWorldViewProjMatrixDirty = true;
-        mInverseWorldMatrixDirty = true;
-        mInverseViewMatrixDirty = true;
-        mInverseWorldViewMatrixDirty = true;
-        mInverseTransposeWorldMatrixDirty = true;
-        mInverseTransposeWorldViewMatrixDirty = true;
-        mCameraPositionObjectSpaceDirty = true;
         mLodCameraPositionObjectSpaceDirty = true;
         for(size_t i = 0; i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
         {
@@ -125,18 +159,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
     {
+        // the camera position is used without going through the view matrix
+        if (cam != mCurrentCamera || useCameraRelative != mCameraRelativeRendering ||
+            cam->getDerivedPosition() != mCameraRelativePosition)
+            ++mViewVersion;
+
         mCurrentCamera = cam;
         mCameraRelativeRendering = useCameraRelative;
         mCameraRelativePosition = cam->getDerivedPosition();
         mViewMatrixDirty = true;
         mProjMatrixDirty = true;
-        mWorldViewMatrixDirty = true;
-        mViewProjMatrixDirty = true;
-        mWorldViewProjMatrixDirty = true;
-        mInverseViewMatrixDirty = true;
-        mInverseWorldViewMatrixDirty = true;
-        mInverseTransposeWorldViewMatrixDirty = true;
-        mCameraPositionObjectSpaceDirty = true;
+        mCameraViewDirty = true;
+        mCameraProjDirty = true;
         mCameraPositionDirty = true;
         mLodCameraPositionObjectSpaceDirty = true;
         mLodCameraPositionDirty = true;
@@ -262,6 +296,7 @@ namespace Ogre {
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
+        updateWorldVersion();
     }
     //-----------------------------------------------------------------------------
     const Affine3& AutoParamDataSource::getWorldMatrix(void) const
@@ -279,6 +314,7 @@ namespace Ogre {
                 }
             }
             mWorldMatrixDirty = false;
+            updateWorldVersion();
         }
         return mWorldMatrixArray[0];
     }
@@ -301,29 +337,41 @@ namespace Ogre {
     {
         if (mViewMatrixDirty)
         {
-            if (mCurrentRenderable && mCurrentRenderable->getUseIdentityView())
-                mViewMatrix = Affine3::IDENTITY;
+            // only refetch from the camera if it changed or the renderable needs the other variant
+            bool identity = mCurrentRenderable && mCurrentRenderable->getUseIdentityView();
+            mViewMatrixDirty = false;
+            if (!mCameraViewDirty && identity == mViewMatrixIdentity)
+                return mViewMatrix;
+
+            Affine3 view;
+            if (identity)
+                view = Affine3::IDENTITY;
             else
             {
-                mViewMatrix = mCurrentCamera->getViewMatrix(true);
+                view = mCurrentCamera->getViewMatrix(true);
                 if (mCameraRelativeRendering)
                 {
-                    mViewMatrix.setTrans(Vector3::ZERO);
+                    view.setTrans(Vector3::ZERO);
                 }
 
             }
-            mViewMatrixDirty = false;
+            if (view != mViewMatrix)
+            {
+                mViewMatrix = view;
+                ++mViewVersion;
+            }
+            mViewMatrixIdentity = identity;
+            mCameraViewDirty = false;
         }
         return mViewMatrix;
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getViewProjectionMatrix(void) const
     {
-        if (mViewProjMatrixDirty)
-        {
-            mViewProjMatrix = getProjectionMatrix() * getViewMatrix();
-            mViewProjMatrixDirty = false;
-        }
+        const Matrix4& proj = getProjectionMatrix();
+        const Affine3& view = getViewMatrix();
+        if (!isDerivedCurrent(mViewProjMatrixStamp, 0, mViewVersion, mProjVersion))
+            mViewProjMatrix = proj * view;
         return mViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
@@ -333,97 +381,97 @@ namespace Ogre {
         {
             // NB use API-independent projection matrix since GPU programs
             // bypass the API-specific handedness and use right-handed coords
-            if (mCurrentRenderable && mCurrentRenderable->getUseIdentityProjection())
+            bool identity = mCurrentRenderable && mCurrentRenderable->getUseIdentityProjection();
+            mProjMatrixDirty = false;
+            if (!mCameraProjDirty && identity == mProjMatrixIdentity)
+                return mProjectionMatrix;
+
+            Matrix4 proj;
+            if (identity)
             {
                 // Use identity projection matrix, still need to take RS depth into account.
                 RenderSystem* rs = Root::getSingleton().getRenderSystem();
-                rs->_convertProjectionMatrix(Matrix4::IDENTITY, mProjectionMatrix, true);
+                rs->_convertProjectionMatrix(Matrix4::IDENTITY, proj, true);
             }
             else
             {
-                mProjectionMatrix = mCurrentCamera->getProjectionMatrixWithRSDepth();
+                proj = mCurrentCamera->getProjectionMatrixWithRSDepth();
             }
             if (mCurrentRenderTarget && mCurrentRenderTarget->requiresTextureFlipping())
             {
                 // Because we're not using setProjectionMatrix, this needs to be done here
                 // Invert transformed y
-                mProjectionMatrix[1][0] = -mProjectionMatrix[1][0];
-                mProjectionMatrix[1][1] = -mProjectionMatrix[1][1];
-                mProjectionMatrix[1][2] = -mProjectionMatrix[1][2];
-                mProjectionMatrix[1][3] = -mProjectionMatrix[1][3];
+                proj[1][0] = -proj[1][0];
+                proj[1][1] = -proj[1][1];
+                proj[1][2] = -proj[1][2];
+                proj[1][3] = -proj[1][3];
             }
-            mProjMatrixDirty = false;
+            if (proj != mProjectionMatrix)
+            {
+                mProjectionMatrix = proj;
+                ++mProjVersion;
+            }
+            mProjMatrixIdentity = identity;
+            mCameraProjDirty = false;
         }
         return mProjectionMatrix;
     }
     //-----------------------------------------------------------------------------
     const Affine3& AutoParamDataSource::getWorldViewMatrix(void) const
     {
-        if (mWorldViewMatrixDirty)
-        {
-            mWorldViewMatrix = getViewMatrix() * getWorldMatrix();
-            mWorldViewMatrixDirty = false;
-        }
+        const Affine3& view = getViewMatrix();
+        const Affine3& world = getWorldMatrix();
+        if (!isDerivedCurrent(mWorldViewMatrixStamp, mWorldVersion, mViewVersion, 0))
+            mWorldViewMatrix = view * world;
         return mWorldViewMatrix;
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getWorldViewProjMatrix(void) const
     {
-        if (mWorldViewProjMatrixDirty)
-        {
-            mWorldViewProjMatrix = getProjectionMatrix() * getWorldViewMatrix();
-            mWorldViewProjMatrixDirty = false;
-        }
+        const Matrix4& proj = getProjectionMatrix();
+        const Affine3& worldView = getWorldViewMatrix();
+        if (!isDerivedCurrent(mWorldViewProjMatrixStamp, mWorldVersion, mViewVersion, mProjVersion))
+            mWorldViewProjMatrix = proj * worldView;
         return mWorldViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
     const Affine3& AutoParamDataSource::getInverseWorldMatrix(void) const
     {
-        if (mInverseWorldMatrixDirty)
-        {
-            mInverseWorldMatrix = getWorldMatrix().inverse();
-            mInverseWorldMatrixDirty = false;
-        }
+        const Affine3& world = getWorldMatrix();
+        if (!isDerivedCurrent(mInverseWorldMatrixStamp, mWorldVersion, 0, 0))
+            mInverseWorldMatrix = world.inverse();
         return mInverseWorldMatrix;
     }
     //-----------------------------------------------------------------------------
     const Affine3& AutoParamDataSource::getInverseWorldViewMatrix(void) const
     {
-        if (mInverseWorldViewMatrixDirty)
-        {
-            mInverseWorldViewMatrix = getWorldViewMatrix().inverse();
-            mInverseWorldViewMatrixDirty = false;
-        }
+        const Affine3& worldView = getWorldViewMatrix();
+        if (!isDerivedCurrent(mInverseWorldViewMatrixStamp, mWorldVersion, mViewVersion, 0))
+            mInverseWorldViewMatrix = worldView.inverse();
         return mInverseWorldViewMatrix;
     }
     //-----------------------------------------------------------------------------
     const Affine3& AutoParamDataSource::getInverseViewMatrix(void) const
     {
-        if (mInverseViewMatrixDirty)
-        {
-            mInverseViewMatrix = getViewMatrix().inverse();
-            mInverseViewMatrixDirty = false;
-        }
+        const Affine3& view = getViewMatrix();
+        if (!isDerivedCurrent(mInverseViewMatrixStamp, 0, mViewVersion, 0))
+            mInverseViewMatrix = view.inverse();
         return mInverseViewMatrix;
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getInverseTransposeWorldMatrix(void) const
     {
-        if (mInverseTransposeWorldMatrixDirty)
-        {
-            mInverseTransposeWorldMatrix = getInverseWorldMatrix().transpose();
-            mInverseTransposeWorldMatrixDirty = false;
-        }
+        const Affine3& inverseWorld = getInverseWorldMatrix();
+        if (!isDerivedCurrent(mInverseTransposeWorldMatrixStamp, mWorldVersion, 0, 0))
+            mInverseTransposeWorldMatrix = inverseWorld.transpose();
         return mInverseTransposeWorldMatrix;
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getInverseTransposeWorldViewMatrix(void) const
     {
-        if (mInverseTransposeWorldViewMatrixDirty)
-        {
-            mInverseTransposeWorldViewMatrix = getInverseWorldViewMatrix().transpose();
-            mInverseTransposeWorldViewMatrixDirty = false;
-        }
+        const Affine3& inverseWorldView = getInverseWorldViewMatrix();
+        if (!isDerivedCurrent(mInverseTransposeWorldViewMatrixStamp, mWorldVersion, mViewVersion, 0))
+            mInverseTransposeWorldViewMatrix = inverseWorldView.transpose();
         return mInverseTransposeWorldViewMatrix;
     }
     //-----------------------------------------------------------------------------
@@ -447,18 +495,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     const Vector4& AutoParamDataSource::getCameraPositionObjectSpace(void) const
     {
-        if (mCameraPositionObjectSpaceDirty)
+        const Affine3& inverseWorld = getInverseWorldMatrix();
+        if (!isDerivedCurrent(mCameraPositionObjectSpaceStamp, mWorldVersion, mViewVersion, 0))
         {
             if (mCameraRelativeRendering)
             {
-                mCameraPositionObjectSpace = Vector4(getInverseWorldMatrix() * Vector3::ZERO);
+                mCameraPositionObjectSpace = Vector4(inverseWorld * Vector3::ZERO);
             }
             else
             {
                 mCameraPositionObjectSpace =
-                    Vector4(getInverseWorldMatrix() * mCurrentCamera->getDerivedPosition());
+                    Vector4(inverseWorld * mCurrentCamera->getDerivedPosition());
             }
-            mCameraPositionObjectSpaceDirty = false;
         }
         return mCameraPositionObjectSpace;
     }
@@ -807,6 +855,9 @@ namespace Ogre {
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
         mCurrentRenderTarget = target;
+        // texture flipping is applied to the projection matrix
+        mProjMatrixDirty = true;
+        mCameraProjDirty = true;
     }
     //-----------------------------------------------------------------------------
     const RenderTarget* AutoParamDataSource::getCurrentRenderTarget(void) const
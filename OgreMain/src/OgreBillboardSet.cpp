@@ -146,10 +146,16 @@ namespace Ogre {
         Vector3 newMin = position - vecAdjust;
         Vector3 newMax = position + vecAdjust;
 
-        mAABB.merge(newMin);
-        mAABB.merge(newMax);
+        if (!mAABB.contains(AxisAlignedBox(newMin, newMax)))
+        {
+            mAABB.merge(newMin);
+            mAABB.merge(newMax);
+
+            mBoundingRadius = Math::boundingRadiusFromAABB(mAABB);
 
-        mBoundingRadius = Math::boundingRadiusFromAABB(mAABB);
+            if (mParentNode)
+                mParentNode->needUpdate();
+        }
 
         return newBill;
     }
@@ -528,6 +534,9 @@ namespace Ogre {
     {
         mAABB = box;
         mBoundingRadius = radius;
+
+        if (mParentNode)
+            mParentNode->needUpdate();
     }
     //-----------------------------------------------------------------------
     void BillboardSet::_updateBounds(void)
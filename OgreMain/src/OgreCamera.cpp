@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "OgreViewport.h"
 #include "OgreMovablePlane.h"
 
+#include <typeinfo>
+
 namespace Ogre {
 
     String Camera::msMovableType = "Camera";
@@ -872,6 +874,25 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::getVisibility(const AxisAlignedBox* const* bounds, size_t numBounds,
+                               bool* visible) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->getVisibility(bounds, numBounds, visible);
+        }
+        else if (typeid(*this) != typeid(Camera))
+        {
+            // subclasses may cull differently in isVisible, like the PCZCamera
+            for (size_t i = 0; i < numBounds; ++i)
+                visible[i] = isVisible(*bounds[i]);
+        }
+        else
+        {
+            calculateVisibility(bounds, numBounds, visible);
+        }
+    }
+    //-----------------------------------------------------------------------
     bool Camera::isVisible(const Sphere& bound, FrustumPlane* culledBy) const
     {
         if (mCullFrustum)
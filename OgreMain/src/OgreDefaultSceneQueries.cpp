@@ -42,80 +42,103 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
     {
-        // Iterate over all movable types
+        // Gather the candidates in the order the brute force search visits them
+        mSweepObjects.clear();
+        mSweepRanks.clear();
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
         while(factIt.hasMoreElements())
         {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
+            SceneManager::MovableObjectCollectionIterator objIt = 
+                mParentSceneMgr->_getMovableObjectCollectionIterator(
                     factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
+            while (objIt.hasMoreElements())
             {
-                MovableObject* a = objItA.getNext();
+                MovableObject* o = objIt.getNext();
                 // skip entire section if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
+                if (!(o->getTypeFlags() & mQueryTypeMask))
                     break;
 
-                // Skip if a does not pass the mask
-                if (!(a->getQueryFlags() & mQueryMask) ||
-                    !a->isInScene())
+                if (!(o->getQueryFlags() & mQueryMask) || !o->isInScene() ||
+                    o->getWorldBoundingBox().isNull())
                     continue;
 
-                // Check against later objects in the same group
-                SceneManager::MovableObjectIterator objItB = objItA;
-                while (objItB.hasMoreElements())
-                {
-                    MovableObject* b = objItB.getNext();
-
-                    // Apply mask to b (both must pass)
-                    if ((b->getQueryFlags() & mQueryMask) && 
-                        b->isInScene())
-                    {
-                        const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                        const AxisAlignedBox& box2 = b->getWorldBoundingBox();
-
-                        if (box1.intersects(box2))
-                        {
-                            if (!listener->queryResult(a, b)) return;
-                        }
-                    }
-                }
-                // Check  against later groups
-                Root::MovableObjectFactoryIterator factItLater = factIt;
-                while (factItLater.hasMoreElements())
-                {
-                    SceneManager::MovableObjectIterator objItC = 
-                        mParentSceneMgr->getMovableObjectIterator(
-                            factItLater.getNext()->getType());
-                    while (objItC.hasMoreElements())
-                    {
-                        MovableObject* c = objItC.getNext();
-                        // skip entire section if type doesn't match
-                        if (!(c->getTypeFlags() & mQueryTypeMask))
-                            break;
-
-                        // Apply mask to c (both must pass)
-                        if ((c->getQueryFlags() & mQueryMask) &&
-                            c->isInScene())
-                        {
-                            const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                            const AxisAlignedBox& box2 = c->getWorldBoundingBox();
-
-                            if (box1.intersects(box2))
-                            {
-                                if (!listener->queryResult(a, c)) return;
-                            }
-                        }
-                    }
+                mSweepObjects.push_back(o);
+                mSweepRanks[o] = uint32(mSweepObjects.size());
+            }
+        }
 
-                }
+        // Refresh the entries kept from the last execution. Entries are looked up by
+        // pointer only, as their objects may have been destroyed since.
+        size_t numEntries = 0;
+        for (size_t i = 0; i < mSweepEntries.size(); ++i)
+        {
+            auto it = mSweepRanks.find(mSweepEntries[i].object);
+            if (it == mSweepRanks.end() || it->second == 0)
+                continue;
+            mSweepEntries[numEntries] = mSweepEntries[i];
+            mSweepEntries[numEntries++].rank = it->second - 1;
+            it->second = 0;
+        }
+        mSweepEntries.resize(numEntries);
+        for (size_t i = 0; i < mSweepObjects.size(); ++i)
+        {
+            if (mSweepRanks[mSweepObjects[i]] == 0)
+                continue;
+            SweepEntry entry = {mSweepObjects[i], Vector3::ZERO, Vector3::ZERO, uint32(i)};
+            mSweepEntries.push_back(entry);
+        }
 
+        const Real inf = std::numeric_limits<Real>::infinity();
+        for (SweepEntry& entry : mSweepEntries)
+        {
+            const AxisAlignedBox& box = entry.object->getWorldBoundingBox();
+            if (box.isInfinite())
+            {
+                entry.minimum = Vector3(-inf);
+                entry.maximum = Vector3(inf);
             }
+            else
+            {
+                entry.minimum = box.getMinimum();
+                entry.maximum = box.getMaximum();
+            }
+        }
 
+        // Insertion sort, as the order barely changes between executions
+        for (size_t i = 1; i < mSweepEntries.size(); ++i)
+        {
+            if (mSweepEntries[i - 1].minimum.x <= mSweepEntries[i].minimum.x)
+                continue;
+            SweepEntry entry = mSweepEntries[i];
+            size_t j = i;
+            for (; j > 0 && mSweepEntries[j - 1].minimum.x > entry.minimum.x; --j)
+                mSweepEntries[j] = mSweepEntries[j - 1];
+            mSweepEntries[j] = entry;
+        }
 
+        // Sweep along x, testing only the intervals that overlap there
+        mSweepPairs.clear();
+        for (size_t i = 0; i < mSweepEntries.size(); ++i)
+        {
+            const SweepEntry& a = mSweepEntries[i];
+            for (size_t j = i + 1; j < mSweepEntries.size() && mSweepEntries[j].minimum.x <= a.maximum.x; ++j)
+            {
+                const SweepEntry& b = mSweepEntries[j];
+                if (a.maximum.y < b.minimum.y || b.maximum.y < a.minimum.y ||
+                    a.maximum.z < b.minimum.z || b.maximum.z < a.minimum.z)
+                    continue;
+                mSweepPairs.push_back(std::minmax(a.rank, b.rank));
+            }
         }
 
+        // Report in the order of the brute force search
+        std::sort(mSweepPairs.begin(), mSweepPairs.end());
+        for (const auto& p : mSweepPairs)
+        {
+            if (!listener->queryResult(mSweepObjects[p.first], mSweepObjects[p.second]))
+                return;
+        }
     }
     //---------------------------------------------------------------------
     DefaultAxisAlignedBoxSceneQuery::
@@ -132,27 +155,17 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
+        // Only test the objects the broadphase finds near the box
+        mParentSceneMgr->_findMovableObjectsIn(mAABB, mCandidates);
+        for (size_t i = 0; i < mCandidates.size(); ++i)
         {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
+            MovableObject* a = mCandidates[i];
+            if ((a->getTypeFlags() & mQueryTypeMask) &&
+                (a->getQueryFlags() & mQueryMask) && 
+                a->isInScene() &&
+                mAABB.intersects(a->getWorldBoundingBox()))
             {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-
-                if ((a->getQueryFlags() & mQueryMask) && 
-                    a->isInScene() &&
-                    mAABB.intersects(a->getWorldBoundingBox()))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
+                if (!listener->queryResult(a)) return;
             }
         }
     }
@@ -170,42 +183,25 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultRaySceneQuery::execute(RaySceneQueryListener* listener)
     {
-        // Note that because we have no scene partitioning, we actually
-        // perform a complete scene search even if restricted results are
-        // requested; smarter scene manager queries can utilise the paritioning 
-        // of the scene in order to reduce the number of intersection tests 
-        // required to fulfil the query
-
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
+        // Only test the objects the broadphase finds along the ray
+        mParentSceneMgr->_findMovableObjectsIn(mRay, mCandidates);
+        for (size_t i = 0; i < mCandidates.size(); ++i)
         {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
+            MovableObject* a = mCandidates[i];
+            if ((a->getTypeFlags() & mQueryTypeMask) &&
+                (a->getQueryFlags() & mQueryMask) &&
+                a->isInScene())
             {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+                // Do ray / box test
+                std::pair<bool, Real> result =
+                    mRay.intersects(a->getWorldBoundingBox());
 
-                if( (a->getQueryFlags() & mQueryMask) &&
-                    a->isInScene())
+                if (result.first)
                 {
-                    // Do ray / box test
-                    std::pair<bool, Real> result =
-                        mRay.intersects(a->getWorldBoundingBox());
-
-                    if (result.first)
-                    {
-                        if (!listener->queryResult(a, result.second)) return;
-                    }
+                    if (!listener->queryResult(a, result.second)) return;
                 }
             }
         }
-
     }
     //---------------------------------------------------------------------
     DefaultSphereSceneQuery::
@@ -223,32 +219,23 @@ namespace Ogre {
     {
         Sphere testSphere;
 
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
+        // Only test the objects the broadphase finds near the sphere
+        mParentSceneMgr->_findMovableObjectsIn(mSphere, mCandidates);
+        for (size_t i = 0; i < mCandidates.size(); ++i)
         {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-                // Skip unattached
-                if (!a->isInScene() || 
-                    !(a->getQueryFlags() & mQueryMask))
-                    continue;
+            MovableObject* a = mCandidates[i];
+            // Skip unattached
+            if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                !a->isInScene() || 
+                !(a->getQueryFlags() & mQueryMask))
+                continue;
 
-                // Do sphere / sphere test
-                testSphere.setCenter(a->getParentNode()->_getDerivedPosition());
-                testSphere.setRadius(a->getBoundingRadius());
-                if (mSphere.intersects(testSphere))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
+            // Do sphere / sphere test
+            testSphere.setCenter(a->getParentNode()->_getDerivedPosition());
+            testSphere.setRadius(a->getBoundingRadius());
+            if (mSphere.intersects(testSphere))
+            {
+                if (!listener->queryResult(a)) return;
             }
         }
     }
@@ -267,34 +254,26 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
+        // Only test the objects the broadphase finds in any of the volumes
+        mParentSceneMgr->_findMovableObjectsIn(mVolumes, mCandidates);
+        for (size_t i = 0; i < mCandidates.size(); ++i)
         {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+            MovableObject* a = mCandidates[i];
+            if (!(a->getTypeFlags() & mQueryTypeMask))
+                continue;
 
-                PlaneBoundedVolumeList::iterator pi, piend;
-                piend = mVolumes.end();
-                for (pi = mVolumes.begin(); pi != piend; ++pi)
+            PlaneBoundedVolumeList::iterator pi, piend;
+            piend = mVolumes.end();
+            for (pi = mVolumes.begin(); pi != piend; ++pi)
+            {
+                PlaneBoundedVolume& vol = *pi;
+                // Do AABB / plane volume test
+                if ((a->getQueryFlags() & mQueryMask) && 
+                    a->isInScene() && 
+                    vol.intersects(a->getWorldBoundingBox()))
                 {
-                    PlaneBoundedVolume& vol = *pi;
-                    // Do AABB / plane volume test
-                    if ((a->getQueryFlags() & mQueryMask) && 
-                        a->isInScene() && 
-                        vol.intersects(a->getWorldBoundingBox()))
-                    {
-                        if (!listener->queryResult(a)) return;
-                        break;
-                    }
+                    if (!listener->queryResult(a)) return;
+                    break;
                 }
             }
         }
@@ -0,0 +1,427 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreDynamicAABBTree.h"
+#include "OgrePlaneBoundedVolume.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Half the surface area, which is all the insertion cost needs
+        Real halfArea(const Vector3& min, const Vector3& max)
+        {
+            Vector3 d = max - min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        Real mergedHalfArea(Vector3 min, Vector3 max, const Vector3& min2, const Vector3& max2)
+        {
+            min.makeFloor(min2);
+            max.makeCeil(max2);
+            return halfArea(min, max);
+        }
+
+        struct AllTest
+        {
+            int operator()(const Vector3&, const Vector3&) const { return 2; }
+        };
+
+        struct BoxTest
+        {
+            Vector3 min, max;
+            int operator()(const Vector3& nmin, const Vector3& nmax) const
+            {
+                return nmin.x <= max.x && nmin.y <= max.y && nmin.z <= max.z &&
+                       nmax.x >= min.x && nmax.y >= min.y && nmax.z >= min.z;
+            }
+        };
+
+        struct SphereTest
+        {
+            const Sphere& sphere;
+            int operator()(const Vector3& nmin, const Vector3& nmax) const
+            {
+                return Math::intersects(sphere, AxisAlignedBox(nmin, nmax));
+            }
+        };
+
+        struct RayTest
+        {
+            const Ray& ray;
+            int operator()(const Vector3& nmin, const Vector3& nmax) const
+            {
+                return Math::intersects(ray, AxisAlignedBox(nmin, nmax)).first;
+            }
+        };
+
+        struct VolumeTest
+        {
+            const PlaneBoundedVolume& volume;
+            int operator()(const Vector3& nmin, const Vector3& nmax) const
+            {
+                Vector3 centre = (nmin + nmax) * 0.5f;
+                Vector3 halfSize = (nmax - nmin) * 0.5f;
+                int ret = 2;
+                for (const Plane& plane : volume.planes)
+                {
+                    Plane::Side side = plane.getSide(centre, halfSize);
+                    if (side == volume.outside)
+                        return 0;
+                    if (side == Plane::BOTH_SIDE)
+                        ret = 1;
+                }
+                return ret;
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    DynamicAABBTree::DynamicAABBTree(Real margin)
+        : mRoot(NULL_NODE), mFreeList(NULL_NODE), mProxyCount(0), mMargin(margin)
+    {
+    }
+    //-----------------------------------------------------------------------
+    int DynamicAABBTree::allocateNode(void)
+    {
+        if (mFreeList == NULL_NODE)
+        {
+            TreeNode node;
+            node.parent = NULL_NODE;
+            mNodes.push_back(node);
+            mFreeList = int(mNodes.size() - 1);
+        }
+
+        int node = mFreeList;
+        TreeNode& n = mNodes[node];
+        mFreeList = n.parent;
+        n.userData = 0;
+        n.parent = NULL_NODE;
+        n.child1 = NULL_NODE;
+        n.child2 = NULL_NODE;
+        n.height = 0;
+        return node;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::freeNode(int node)
+    {
+        mNodes[node].parent = mFreeList;
+        mNodes[node].height = -1;
+        mFreeList = node;
+    }
+    //-----------------------------------------------------------------------
+    int DynamicAABBTree::createProxy(const AxisAlignedBox& box, void* userData)
+    {
+        OgreAssertDbg(box.isFinite(), "only finite boxes can be stored");
+        int proxy = allocateNode();
+        TreeNode& n = mNodes[proxy];
+        Vector3 margin = box.getSize() * mMargin;
+        n.min = box.getMinimum() - margin;
+        n.max = box.getMaximum() + margin;
+        n.userData = userData;
+
+        insertLeaf(proxy);
+        ++mProxyCount;
+        return proxy;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::destroyProxy(int proxy)
+    {
+        OgreAssertDbg(mNodes[proxy].isLeaf(), "not a proxy");
+        removeLeaf(proxy);
+        freeNode(proxy);
+        --mProxyCount;
+    }
+    //-----------------------------------------------------------------------
+    bool DynamicAABBTree::moveProxy(int proxy, const AxisAlignedBox& box)
+    {
+        OgreAssertDbg(box.isFinite(), "only finite boxes can be stored");
+        TreeNode& n = mNodes[proxy];
+        const Vector3& min = box.getMinimum();
+        const Vector3& max = box.getMaximum();
+        if (n.min.x <= min.x && n.min.y <= min.y && n.min.z <= min.z &&
+            max.x <= n.max.x && max.y <= n.max.y && max.z <= n.max.z)
+            return false;
+
+        removeLeaf(proxy);
+        Vector3 margin = box.getSize() * mMargin;
+        n.min = min - margin;
+        n.max = max + margin;
+        insertLeaf(proxy);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::clear(void)
+    {
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mProxyCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::refit(int node)
+    {
+        TreeNode& n = mNodes[node];
+        const TreeNode& c1 = mNodes[n.child1];
+        const TreeNode& c2 = mNodes[n.child2];
+        n.min = c1.min;
+        n.min.makeFloor(c2.min);
+        n.max = c1.max;
+        n.max.makeCeil(c2.max);
+        n.height = 1 + std::max(c1.height, c2.height);
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::insertLeaf(int leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // descend to the sibling whose merge with the leaf costs the least
+        // surface area, including the growth of all ancestors on the way
+        Vector3 leafMin = mNodes[leaf].min;
+        Vector3 leafMax = mNodes[leaf].max;
+        int index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const TreeNode& n = mNodes[index];
+            Real area = halfArea(n.min, n.max);
+            Real combinedArea = mergedHalfArea(n.min, n.max, leafMin, leafMax);
+
+            // cost of making a new parent for this node and the leaf
+            Real cost = 2 * combinedArea;
+            // minimum cost of pushing the leaf further down
+            Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real childCost[2];
+            int children[2] = {n.child1, n.child2};
+            for (int i = 0; i < 2; ++i)
+            {
+                const TreeNode& c = mNodes[children[i]];
+                Real mergedArea = mergedHalfArea(c.min, c.max, leafMin, leafMax);
+                childCost[i] = (c.isLeaf() ? mergedArea : mergedArea - halfArea(c.min, c.max)) +
+                               inheritanceCost;
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+
+            index = childCost[0] < childCost[1] ? children[0] : children[1];
+        }
+
+        int sibling = index;
+        int oldParent = mNodes[sibling].parent;
+        int newParent = allocateNode();
+        TreeNode& p = mNodes[newParent];
+        p.parent = oldParent;
+        p.child1 = sibling;
+        p.child2 = leaf;
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+        refit(newParent);
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+
+        // refit and rebalance the ancestors
+        for (index = oldParent; index != NULL_NODE; index = mNodes[index].parent)
+        {
+            index = balance(index);
+            refit(index);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::removeLeaf(int leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int parent = mNodes[leaf].parent;
+        int grandParent = mNodes[parent].parent;
+        int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        // replace the parent by the sibling
+        freeNode(parent);
+        mNodes[sibling].parent = grandParent;
+        if (grandParent == NULL_NODE)
+        {
+            mRoot = sibling;
+            return;
+        }
+
+        if (mNodes[grandParent].child1 == parent)
+            mNodes[grandParent].child1 = sibling;
+        else
+            mNodes[grandParent].child2 = sibling;
+
+        for (int index = grandParent; index != NULL_NODE; index = mNodes[index].parent)
+        {
+            index = balance(index);
+            refit(index);
+        }
+    }
+    //-----------------------------------------------------------------------
+    int DynamicAABBTree::balance(int iA)
+    {
+        TreeNode& A = mNodes[iA];
+        if (A.isLeaf() || A.height < 2)
+            return iA;
+
+        int iB = A.child1;
+        int iC = A.child2;
+        TreeNode& B = mNodes[iB];
+        TreeNode& C = mNodes[iC];
+        int imbalance = C.height - B.height;
+
+        if (imbalance > 1 || imbalance < -1)
+        {
+            // rotate the higher child up, A takes its lower grandchild
+            int iUp = imbalance > 1 ? iC : iB;
+            TreeNode& up = mNodes[iUp];
+            int iF = up.child1;
+            int iG = up.child2;
+            int iKeep = mNodes[iF].height > mNodes[iG].height ? iF : iG;
+            int iMove = iKeep == iF ? iG : iF;
+
+            up.child1 = iA;
+            up.child2 = iKeep;
+            up.parent = A.parent;
+            A.parent = iUp;
+
+            if (up.parent != NULL_NODE)
+            {
+                if (mNodes[up.parent].child1 == iA)
+                    mNodes[up.parent].child1 = iUp;
+                else
+                    mNodes[up.parent].child2 = iUp;
+            }
+            else
+            {
+                mRoot = iUp;
+            }
+
+            if (iUp == iC)
+                A.child2 = iMove;
+            else
+                A.child1 = iMove;
+            mNodes[iMove].parent = iA;
+
+            refit(iA);
+            refit(iUp);
+            return iUp;
+        }
+
+        return iA;
+    }
+    //-----------------------------------------------------------------------
+    template <typename Test>
+    void DynamicAABBTree::collect(const Test& test, std::vector<void*>& result) const
+    {
+        if (mRoot == NULL_NODE)
+            return;
+
+        // the tree is balanced, so this is plenty even for billions of proxies
+        int stack[256];
+        bool inside[256];
+        int top = 0;
+        stack[top] = mRoot;
+        inside[top++] = false;
+
+        while (top > 0)
+        {
+            --top;
+            const TreeNode& n = mNodes[stack[top]];
+            bool in = inside[top];
+            if (!in)
+            {
+                int t = test(n.min, n.max);
+                if (t == 0)
+                    continue;
+                in = t == 2;
+            }
+
+            if (n.isLeaf())
+            {
+                result.push_back(n.userData);
+            }
+            else
+            {
+                OgreAssertDbg(top + 2 <= 256, "tree too high");
+                stack[top] = n.child2;
+                inside[top++] = in;
+                stack[top] = n.child1;
+                inside[top++] = in;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::query(const AxisAlignedBox& box, std::vector<void*>& result) const
+    {
+        if (box.isNull())
+            return;
+        if (box.isInfinite())
+        {
+            collect(AllTest(), result);
+            return;
+        }
+        BoxTest test = {box.getMinimum(), box.getMaximum()};
+        collect(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::query(const Sphere& sphere, std::vector<void*>& result) const
+    {
+        SphereTest test = {sphere};
+        collect(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::query(const Ray& ray, std::vector<void*>& result) const
+    {
+        RayTest test = {ray};
+        collect(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::query(const PlaneBoundedVolume& volume, std::vector<void*>& result) const
+    {
+        VolumeTest test = {volume};
+        collect(test, result);
+    }
+}
@@ -55,6 +55,7 @@ namespace Ogre {
           mBoneWorldMatrices(NULL),
           mBoneMatrices(NULL),
           mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max()),
+          mFrameAnimationLastNeeded(std::numeric_limits<unsigned long>::max()),
           mFrameBonesLastUpdated(NULL),
           mSharedSkeletonEntities(NULL),
         mSoftwareAnimationRequests(0),
@@ -367,6 +368,10 @@ namespace Ogre {
     {
         MovableObject::_notifyCurrentCamera(cam);
 
+        // Reloading the mesh recreates the sub entities in _updateRenderQueue
+        if (mMesh->getStateCount() != mMeshStateCount)
+            notifyStaticDirty();
+
         // Calculate the LOD
         if (mParentNode)
         {
@@ -398,6 +403,8 @@ namespace Ogre {
             cam->getSceneManager()->_notifyEntityMeshLodChanged(evt);
 
             // Change LOD index
+            if (mMeshLodIndex != evt.newLodIndex)
+                notifyStaticDirty();
             mMeshLodIndex = evt.newLodIndex;
 
             // Now do material LOD
@@ -442,6 +449,8 @@ namespace Ogre {
                 cam->getSceneManager()->_notifyEntityMaterialLodChanged(subEntEvt);
 
                 // Change LOD index
+                if ((*i)->mMaterialLodIndex != subEntEvt.newLodIndex)
+                    notifyStaticDirty();
                 (*i)->mMaterialLodIndex = subEntEvt.newLodIndex;
 #endif
                 // Also invalidate any camera distance cache
@@ -829,6 +838,7 @@ namespace Ogre {
             return;
 
         Root& root = Root::getSingleton();
+        mFrameAnimationLastNeeded = root.getNextFrameNumber();
         bool hwAnimation = isHardwareAnimationEnabled();
         bool isNeedUpdateHardwareAnim = hwAnimation && !mCurrentHWAnimationState;
         bool forcedSwAnimation = getSoftwareAnimationRequests()>0;
@@ -1374,6 +1384,34 @@ namespace Ogre {
             (mAnimationState->hasEnabledAnimationState() || getSkeleton()->hasManualBones());
     }
     //-----------------------------------------------------------------------
+    bool Entity::_prepareBoneMatricesUpdate(void)
+    {
+        if (!mInitialised || !hasSkeleton() || sharesSkeletonInstance() || !mChildObjectList.empty())
+            return false;
+
+        // Only entities which were rendered last frame, so invisible ones are skipped
+        if (mFrameAnimationLastNeeded + 1 != Root::getSingleton().getNextFrameNumber())
+            return false;
+
+        bool animationDirty = (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
+                              mSkeletonInstance->getManualBonesDirty();
+        if (!animationDirty)
+            return false;
+
+        if (!mSkipAnimStateUpdates)
+        {
+            EnabledAnimationStateList::const_iterator i;
+            const EnabledAnimationStateList& states = mAnimationState->getEnabledAnimationStates();
+            for (i = states.begin(); i != states.end(); ++i)
+            {
+                Animation* anim = mSkeletonInstance->_getAnimationImpl((*i)->getAnimationName());
+                if (anim)
+                    anim->_prepareForConcurrentApply();
+            }
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
     VertexData* Entity::_getSkelAnimVertexData(void) const
     {
         assert (mSkelAnimVertexData && "Not software skinned or has no shared vertex data!");
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreHardwareVertexBuffer.h"
 #include "OgreMovablePlane.h"
+#include "OgreOptimisedUtil.h"
+
+#include <typeinfo>
 
 namespace Ogre {
 
@@ -248,6 +251,78 @@ namespace Ogre {
         return true;
     }
 
+    //-----------------------------------------------------------------------
+    void Frustum::getVisibility(const AxisAlignedBox* const* bounds, size_t numBounds,
+                                bool* visible) const
+    {
+        // subclasses may cull differently in isVisible
+        if (typeid(*this) != typeid(Frustum))
+        {
+            for (size_t i = 0; i < numBounds; ++i)
+                visible[i] = isVisible(*bounds[i]);
+            return;
+        }
+
+        calculateVisibility(bounds, numBounds, visible);
+    }
+    //-----------------------------------------------------------------------
+    void Frustum::calculateVisibility(const AxisAlignedBox* const* bounds, size_t numBounds,
+                                      bool* visible) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        // Skip far plane if infinite view frustum
+        Plane planes[6];
+        size_t numPlanes = 0;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                continue;
+            planes[numPlanes++] = mFrustumPlanes[plane];
+        }
+
+        // Test in chunks of boxes converted to centre / half size arrays
+        const size_t CHUNK_SIZE = 32;
+        OGRE_SIMD_ALIGNED_DECL(Real, centres[3][CHUNK_SIZE]);
+        OGRE_SIMD_ALIGNED_DECL(Real, halfSizes[3][CHUNK_SIZE]);
+        const Real* centrePtrs[3] = {centres[0], centres[1], centres[2]};
+        const Real* halfSizePtrs[3] = {halfSizes[0], halfSizes[1], halfSizes[2]};
+        char chunkVisible[CHUNK_SIZE];
+        size_t indices[CHUNK_SIZE];
+
+        size_t i = 0;
+        while (i < numBounds)
+        {
+            size_t count = 0;
+            for (; i < numBounds && count < CHUNK_SIZE; ++i)
+            {
+                const AxisAlignedBox& bound = *bounds[i];
+                // Null boxes always invisible, infinite boxes always visible
+                if (!bound.isFinite())
+                {
+                    visible[i] = bound.isInfinite();
+                    continue;
+                }
+
+                Vector3 centre = bound.getCenter();
+                Vector3 halfSize = bound.getHalfSize();
+                centres[0][count] = centre.x;
+                centres[1][count] = centre.y;
+                centres[2][count] = centre.z;
+                halfSizes[0][count] = halfSize.x;
+                halfSizes[1][count] = halfSize.y;
+                halfSizes[2][count] = halfSize.z;
+                indices[count++] = i;
+            }
+
+            OptimisedUtil::getImplementation()->calculateBoxVisibility(
+                planes, numPlanes, centrePtrs, halfSizePtrs, chunkVisible, count);
+
+            for (size_t n = 0; n < count; ++n)
+                visible[indices[n]] = chunkVisible[n] != 0;
+        }
+    }
     //-----------------------------------------------------------------------
     bool Frustum::isVisible(const Vector3& vert, FrustumPlane* culledBy) const
     {
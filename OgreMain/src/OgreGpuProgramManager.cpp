@@ -30,8 +30,14 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreStreamSerialiser.h"
 
+#if OGRE_NO_ZIP_ARCHIVE == 0
+#include <zlib.h>
+#endif
+
 namespace Ogre {
     static uint32 CACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("OGPC"); // Ogre Gpu Program cache
+    /// MicrocodeEntry flag marking data compressed with zlib
+    static const uint32 MICROCODE_DEFLATED = 1;
 
     //-----------------------------------------------------------------------
     template<> GpuProgramManager* Singleton<GpuProgramManager>::msSingleton = 0;
@@ -57,6 +63,9 @@ namespace Ogre {
         mResourceType = "GpuProgram";
         mSaveMicrocodesToCache = false;
         mCacheDirty = false;
+        mCacheDataStart = 0;
+        mCacheGeneration = 0;
+        mCacheMaxAge = 0;
 
         // subclasses should register with resource group manager
     }
@@ -247,12 +256,75 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool GpuProgramManager::isMicrocodeAvailableInCache( uint32 id ) const
     {
-        return mMicrocodeCache.find(id) != mMicrocodeCache.end();
+        OGRE_LOCK_AUTO_MUTEX;
+        auto foundIter = mMicrocodeCache.find(id);
+        if (foundIter == mMicrocodeCache.end())
+            return false;
+
+        MicrocodeEntry& entry = foundIter->second;
+        if (!entry.microcode && !readMicrocode(entry))
+        {
+            mMicrocodeCache.erase(foundIter);
+            mCacheDirty = true;
+            return false;
+        }
+        entry.lastUsed = mCacheGeneration;
+        return true;
     }
     //---------------------------------------------------------------------
     const GpuProgramManager::Microcode & GpuProgramManager::getMicrocodeFromCache( uint32 id ) const
     {
-        return mMicrocodeCache.find(id)->second;
+        OGRE_LOCK_AUTO_MUTEX;
+        auto foundIter = mMicrocodeCache.find(id);
+        if (foundIter == mMicrocodeCache.end())
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
+                        "No microcode " + StringConverter::toString(id) + " in the cache",
+                        "GpuProgramManager::getMicrocodeFromCache");
+
+        MicrocodeEntry& entry = foundIter->second;
+        if (!entry.microcode && !readMicrocode(entry))
+        {
+            mMicrocodeCache.erase(foundIter);
+            mCacheDirty = true;
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                        "Cannot read microcode " + StringConverter::toString(id) + " from the cache",
+                        "GpuProgramManager::getMicrocodeFromCache");
+        }
+        entry.lastUsed = mCacheGeneration;
+        return entry.microcode;
+    }
+    //---------------------------------------------------------------------
+    bool GpuProgramManager::readMicrocode(MicrocodeEntry& entry) const
+    {
+        Microcode microcode(OGRE_NEW MemoryDataStream(entry.size));
+        mCacheStream->seek(mCacheDataStart + entry.offset);
+        if (entry.flags & MICROCODE_DEFLATED)
+        {
+#if OGRE_NO_ZIP_ARCHIVE == 0
+            std::vector<uchar> stored(entry.storedSize);
+            uLongf size = entry.size;
+            if (mCacheStream->read(stored.data(), stored.size()) != stored.size() ||
+                uncompress(microcode->getPtr(), &size, stored.data(), entry.storedSize) != Z_OK ||
+                size != entry.size)
+            {
+                LogManager::getSingleton().logWarning("Corrupt Microcode Cache entry");
+                return false;
+            }
+#else
+            LogManager::getSingleton().logWarning(
+                "Cannot read compressed Microcode Cache entry without zlib support");
+            return false;
+#endif
+        }
+        else if (entry.storedSize != entry.size ||
+                 mCacheStream->read(microcode->getPtr(), entry.size) != entry.size)
+        {
+            LogManager::getSingleton().logWarning("Corrupt Microcode Cache entry");
+            return false;
+        }
+
+        entry.microcode = microcode;
+        return true;
     }
     //---------------------------------------------------------------------
     GpuProgramManager::Microcode GpuProgramManager::createMicrocode( size_t size ) const
@@ -262,22 +334,26 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void GpuProgramManager::addMicrocodeToCache( uint32 id, const GpuProgramManager::Microcode & microcode )
     {   
+        OGRE_LOCK_AUTO_MUTEX;
         auto foundIter = mMicrocodeCache.find(id);
         if ( foundIter == mMicrocodeCache.end() )
         {
-            mMicrocodeCache.insert(make_pair(id, microcode));
+            foundIter = mMicrocodeCache.insert(std::make_pair(id, MicrocodeEntry())).first;
             // if cache is modified, mark it as dirty.
             mCacheDirty = true;
         }
-        else
-        {
-            foundIter->second = microcode;
 
-        }       
+        MicrocodeEntry& entry = foundIter->second;
+        entry.microcode = microcode;
+        entry.offset = entry.storedSize = 0;
+        entry.size = static_cast<uint32>(microcode->size());
+        entry.flags = 0;
+        entry.lastUsed = mCacheGeneration;
     }
     //---------------------------------------------------------------------
     void GpuProgramManager::removeMicrocodeFromCache( uint32 id )
     {
+        OGRE_LOCK_AUTO_MUTEX;
         auto foundIter = mMicrocodeCache.find(id);
 
         if (foundIter != mMicrocodeCache.end())
@@ -298,33 +374,122 @@ namespace Ogre {
                 "Unable to write to stream " + stream->getName(),
                 "GpuProgramManager::saveMicrocodeCache");
         }
-        
+
+        OGRE_LOCK_AUTO_MUTEX;
+
+        // gather the stored data first, as the index needs the sizes
+        struct StoredEntry
+        {
+            uint32 id;
+            const MicrocodeEntry* entry;
+            std::vector<uchar> data;
+            uint32 flags;
+        };
+        std::vector<StoredEntry> entries;
+        entries.reserve(mMicrocodeCache.size());
+        // reading the unused entries moves the stream when saving over the source
+        size_t streamPos = stream->tell();
+        for ( const auto& it : mMicrocodeCache )
+        {
+            const MicrocodeEntry& entry = it.second;
+            if (mCacheMaxAge && mCacheGeneration - entry.lastUsed >= mCacheMaxAge)
+                continue;
+
+            StoredEntry stored = {it.first, &entry, std::vector<uchar>(), entry.flags};
+            if (!entry.microcode)
+            {
+                // not used this session, copy as stored
+                stored.data.resize(entry.storedSize);
+                mCacheStream->seek(mCacheDataStart + entry.offset);
+                if (mCacheStream->read(stored.data.data(), entry.storedSize) != entry.storedSize)
+                {
+                    LogManager::getSingleton().logWarning("Corrupt Microcode Cache entry");
+                    continue;
+                }
+            }
+            else
+            {
+                const uchar* src = entry.microcode->getPtr();
+                stored.flags = 0;
+#if OGRE_NO_ZIP_ARCHIVE == 0
+                uLongf size = compressBound(entry.size);
+                stored.data.resize(size);
+                if (compress(stored.data.data(), &size, src, entry.size) == Z_OK && size < entry.size)
+                {
+                    stored.data.resize(size);
+                    stored.flags = MICROCODE_DEFLATED;
+                }
+                else
+#endif
+                {
+                    stored.data.assign(src, src + entry.size);
+                }
+            }
+            entries.push_back(std::move(stored));
+        }
+        if (stream == mCacheStream)
+            stream->seek(streamPos);
+
         StreamSerialiser serialiser(stream);
-        serialiser.writeChunkBegin(CACHE_CHUNK_ID, 2);
+        serialiser.writeChunkBegin(CACHE_CHUNK_ID, 3);
 
-        // write the size of the array
-        uint32 sizeOfArray = static_cast<uint32>(mMicrocodeCache.size());
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        String renderSystem = rs ? rs->getName() : BLANKSTRING;
+        serialiser.write(&renderSystem);
+        serialiser.write(&mCacheGeneration);
+
+        // write the index, the data follows in the same order
+        uint32 sizeOfArray = static_cast<uint32>(entries.size());
         serialiser.write(&sizeOfArray);
-        
-        // loop the array and save it
-        for ( const auto& entry : mMicrocodeCache )
+        uint32 offset = 0;
+        for ( const auto& stored : entries )
         {
-            // saves the id of the shader
-            serialiser.write(&entry.first);
-
-            // saves the microcode
-            const Microcode & microcodeOfShader = entry.second;
-            uint32 microcodeLength = static_cast<uint32>(microcodeOfShader->size());
-            serialiser.write(&microcodeLength);
-            serialiser.writeData(microcodeOfShader->getPtr(), 1, microcodeLength);
+            uint32 index[6] = {stored.id,          offset,      static_cast<uint32>(stored.data.size()),
+                               stored.entry->size, stored.flags, stored.entry->lastUsed};
+            serialiser.write(index, 6);
+            offset += index[2];
         }
 
+        for ( const auto& stored : entries )
+            serialiser.writeData(stored.data.data(), 1, stored.data.size());
+
         serialiser.writeChunkEnd(CACHE_CHUNK_ID);
+
+        if (!mCacheStream || (stream != mCacheStream && (stream->getName().empty() ||
+                                                          stream->getName() != mCacheStream->getName())))
+            return;
+
+        // saved over the source, so keep the entries that were not used yet in memory
+        MemoryDataStreamPtr data(OGRE_NEW MemoryDataStream(std::max<size_t>(offset, 1)));
+        std::set<uint32> kept;
+        offset = 0;
+        for ( const auto& stored : entries )
+        {
+            MicrocodeEntry& entry = mMicrocodeCache[stored.id];
+            if (!entry.microcode)
+            {
+                memcpy(data->getPtr() + offset, stored.data.data(), stored.data.size());
+                entry.offset = offset;
+                kept.insert(stored.id);
+            }
+            offset += static_cast<uint32>(stored.data.size());
+        }
+        for (auto it = mMicrocodeCache.begin(); it != mMicrocodeCache.end();)
+        {
+            if (!it->second.microcode && !kept.count(it->first))
+                it = mMicrocodeCache.erase(it);
+            else
+                ++it;
+        }
+        mCacheStream = data;
+        mCacheDataStart = 0;
     }
     //---------------------------------------------------------------------
     void GpuProgramManager::loadMicrocodeCache( DataStreamPtr stream )
     {
+        OGRE_LOCK_AUTO_MUTEX;
         mMicrocodeCache.clear();
+        mCacheStream.reset();
 
         StreamSerialiser serialiser(stream);
         const StreamSerialiser::Chunk* chunk;
@@ -340,11 +505,74 @@ namespace Ogre {
             return;
         }
 
-        if(chunk->id != CACHE_CHUNK_ID || chunk->version != 2)
+        if(chunk->id != CACHE_CHUNK_ID || (chunk->version != 2 && chunk->version != 3))
         {
             LogManager::getSingleton().logWarning("Invalid Microcode Cache");
             return;
         }
+
+        if (chunk->version == 2)
+        {
+            loadMicrocodeCacheV2(serialiser);
+            return;
+        }
+
+        String renderSystem;
+        serialiser.read(&renderSystem);
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        if (rs && rs->getName() != renderSystem)
+        {
+            LogManager::getSingleton().logMessage("Discarding Microcode Cache of " + renderSystem);
+            mCacheDirty = true;
+            return;
+        }
+
+        serialiser.read(&mCacheGeneration);
+        ++mCacheGeneration;
+
+        uint32 sizeOfArray = 0;
+        serialiser.read(&sizeOfArray);
+
+        // microcodes are decoded on first lookup
+        size_t dataSize = 0;
+        for ( uint32 i = 0 ; i < sizeOfArray ; i++ )
+        {
+            uint32 index[6];
+            serialiser.read(index, 6);
+
+            MicrocodeEntry entry;
+            entry.offset = index[1];
+            entry.storedSize = index[2];
+            entry.size = index[3];
+            entry.flags = index[4];
+            entry.lastUsed = index[5];
+            mMicrocodeCache.insert(std::make_pair(index[0], entry));
+            dataSize = std::max<size_t>(dataSize, size_t(entry.offset) + entry.storedSize);
+        }
+
+        // keep the stream, the data block follows the index
+        mCacheStream = stream;
+        mCacheDataStart = stream->tell();
+        size_t streamSize = stream->size();
+        if (streamSize && mCacheDataStart + dataSize > streamSize)
+        {
+            LogManager::getSingleton().logWarning("Truncated Microcode Cache");
+            for (auto it = mMicrocodeCache.begin(); it != mMicrocodeCache.end();)
+            {
+                if (mCacheDataStart + it->second.offset + it->second.storedSize > streamSize)
+                    it = mMicrocodeCache.erase(it);
+                else
+                    ++it;
+            }
+        }
+        serialiser.readChunkEnd(CACHE_CHUNK_ID);
+
+        // if cache is not modified, mark it as clean.
+        mCacheDirty = false;
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::loadMicrocodeCacheV2(StreamSerialiser& serialiser)
+    {
         // write the size of the array
         uint32 sizeOfArray = 0;
         serialiser.read(&sizeOfArray);
@@ -364,13 +592,18 @@ namespace Ogre {
             microcodeOfShader->seek(0);
             serialiser.readData(microcodeOfShader->getPtr(), 1, microcodeLength);
 
-            mMicrocodeCache.insert(make_pair(id, microcodeOfShader));
+            MicrocodeEntry entry;
+            entry.microcode = microcodeOfShader;
+            entry.offset = entry.storedSize = 0;
+            entry.size = microcodeLength;
+            entry.flags = 0;
+            entry.lastUsed = mCacheGeneration;
+            mMicrocodeCache.insert(std::make_pair(id, entry));
         }
         serialiser.readChunkEnd(CACHE_CHUNK_ID);
 
-        // if cache is not modified, mark it as clean.
-        mCacheDirty = false;
-        
+        // rewrite in the current format
+        mCacheDirty = true;
     }
     //---------------------------------------------------------------------
 
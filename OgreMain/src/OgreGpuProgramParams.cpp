@@ -368,6 +368,7 @@ namespace Ogre
         :mName(name)
         , mFrameLastUpdated(Root::getSingleton().getNextFrameNumber())
         , mVersion(0), mDirty(false)
+        , mDirtyBegin(0), mDirtyEnd(0)
     {
 
     }
@@ -432,6 +433,9 @@ namespace Ogre
         mNamedConstants.map[name] = def;
 
         ++mVersion;
+
+        if (mHardwareBuffer)
+            createHardwareBuffer();
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::removeConstantDefinition(const String& name)
@@ -484,6 +488,9 @@ namespace Ogre
             }
 
             ++mVersion;
+
+            if (mHardwareBuffer)
+                createHardwareBuffer();
         }
 
     }
@@ -497,6 +504,11 @@ namespace Ogre
         mFloatConstants.clear();
         mDoubleConstants.clear();
         mIntConstants.clear();
+
+        ++mVersion;
+
+        if (mHardwareBuffer)
+            createHardwareBuffer();
     }
     //---------------------------------------------------------------------
     GpuConstantDefinitionIterator GpuSharedParameters::getConstantDefinitionIterator(void) const
@@ -572,8 +584,11 @@ namespace Ogre
         if (i != mNamedConstants.map.end())
         {
             const GpuConstantDefinition& def = i->second;
-            memcpy(&mFloatConstants[def.physicalIndex], val,
-                   sizeof(float) * std::min(count, def.elementSize * def.arraySize));
+            count = std::min(count, def.elementSize * def.arraySize);
+            memcpy(&mFloatConstants[def.physicalIndex], val, sizeof(float) * count);
+            markDirtyRange(def.physicalIndex * sizeof(float),
+                           (def.physicalIndex + count) * sizeof(float));
+            return;
         }
 
         _markDirty();
@@ -595,7 +610,8 @@ namespace Ogre
             }
         }
 
-        _markDirty();
+        // not part of the uniform buffer
+        markDirtyRange(0, 0);
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::setNamedConstant(const String& name, const int *val, size_t count)
@@ -608,7 +624,8 @@ namespace Ogre
                    sizeof(int) * std::min(count, def.elementSize * def.arraySize));
         }
 
-        _markDirty();
+        // not part of the uniform buffer
+        markDirtyRange(0, 0);
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::setNamedConstant(const String& name, const uint *val, size_t count)
@@ -621,18 +638,79 @@ namespace Ogre
                    sizeof(uint) * std::min(count, def.elementSize * def.arraySize));
         }
 
-        _markDirty();
+        // not part of the uniform buffer
+        markDirtyRange(0, 0);
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::_markClean()
     {
         mDirty = false;
+        mDirtyBegin = mDirtyEnd = 0;
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::_markDirty()
+    {
+        markDirtyRange(0, mFloatConstants.size() * sizeof(float));
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::markDirtyRange(size_t begin, size_t end)
     {
         mFrameLastUpdated = Root::getSingleton().getNextFrameNumber();
         mDirty = true;
+        if (begin == end)
+            return;
+
+        if (mDirtyBegin == mDirtyEnd)
+        {
+            mDirtyBegin = begin;
+            mDirtyEnd = end;
+        }
+        else
+        {
+            mDirtyBegin = std::min(mDirtyBegin, begin);
+            mDirtyEnd = std::max(mDirtyEnd, end);
+        }
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::enableUniformBuffer()
+    {
+        if (mHardwareBuffer)
+            return;
+
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        if (!rs || !rs->getCapabilities() ||
+            !rs->getCapabilities()->hasCapability(RSC_SHARED_PARAMETER_BUFFERS))
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                        "The render system does not bind shared parameter buffers",
+                        "GpuSharedParameters::enableUniformBuffer");
+
+        createHardwareBuffer();
+        // programs using this set must stop copying the float constants
+        ++mVersion;
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::createHardwareBuffer()
+    {
+        // whole vec4s like std140 uniform blocks, and zero sized buffers are not supported
+        size_t sizeBytes = (std::max<size_t>(mFloatConstants.size(), 1) + 3) / 4 * 4 * sizeof(float);
+        mHardwareBuffer = HardwareBufferManager::getSingleton().createUniformBuffer(
+            sizeBytes, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, false, mName);
+        _markDirty();
+    }
+    //---------------------------------------------------------------------
+    size_t GpuSharedParameters::_upload()
+    {
+        size_t bytes = 0;
+        if (mHardwareBuffer && mDirtyBegin != mDirtyEnd)
+        {
+            bytes = mDirtyEnd - mDirtyBegin;
+            mHardwareBuffer->writeData(mDirtyBegin, bytes,
+                                       reinterpret_cast<const uchar*>(mFloatConstants.data()) +
+                                           mDirtyBegin,
+                                       bytes == mHardwareBuffer->getSizeInBytes());
+        }
+        _markClean();
+        return bytes;
     }
     
 
@@ -652,12 +730,18 @@ namespace Ogre
 
         mCopyDataList.clear();
 
+        // the render system binds the uniform buffer instead
+        bool copyFloats = !mSharedParams->_getHardwareBuffer();
+
         const GpuConstantDefinitionMap& sharedmap = mSharedParams->getConstantDefinitions().map;
         for (GpuConstantDefinitionMap::const_iterator i = sharedmap.begin(); i != sharedmap.end(); ++i)
         {
             const String& pName = i->first;
             const GpuConstantDefinition& shareddef = i->second;
 
+            if (shareddef.isFloat() && !copyFloats)
+                continue;
+
             const GpuConstantDefinition* instdef = mParams->_findNamedConstantDefinition(pName, false);
             if (instdef)
             {
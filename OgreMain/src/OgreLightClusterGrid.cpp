@@ -0,0 +1,167 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+namespace Ogre {
+//-----------------------------------------------------------------------
+SceneManager::LightClusterGrid::LightClusterGrid()
+    : lightsDirtyCounter(0), numLights(0), valid(false)
+{
+    dims[0] = dims[1] = dims[2] = 0;
+}
+//-----------------------------------------------------------------------
+void SceneManager::LightClusterGrid::getCellRange(const Vector3& min, const Vector3& max,
+                                                  int lo[3], int hi[3]) const
+{
+    // clamping keeps the mapping monotonic, so overlapping boxes always share a cell
+    for (int i = 0; i < 3; ++i)
+    {
+        Real last = Real(dims[i] - 1);
+        lo[i] = int(Math::Clamp<Real>(Math::Floor((min[i] - origin[i]) * invCellSize[i]), 0, last));
+        hi[i] = int(Math::Clamp<Real>(Math::Floor((max[i] - origin[i]) * invCellSize[i]), 0, last));
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::LightClusterGrid::build(const LightList& lights)
+{
+    cellStart.clear();
+    cellLights.clear();
+    globalLights.clear();
+    numLights = lights.size();
+    valid = true;
+
+    // size the grid by the light positions, lights reaching beyond it still
+    // end up in the border cells
+    AxisAlignedBox bounds;
+    for (LightList::const_iterator i = lights.begin(); i != lights.end(); ++i)
+    {
+        if ((*i)->getType() != Light::LT_DIRECTIONAL)
+            bounds.merge((*i)->getDerivedPosition());
+    }
+
+    Vector3 extent = bounds.getSize();
+    Real maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+    if (maxExtent <= 0)
+    {
+        dims[0] = dims[1] = dims[2] = 0;
+        for (uint32 i = 0; i < lights.size(); ++i)
+            globalLights.push_back(i);
+        return;
+    }
+
+    Real cellSize = maxExtent / MAX_CELLS;
+    origin = bounds.getMinimum();
+    for (int i = 0; i < 3; ++i)
+    {
+        dims[i] = Math::Clamp(int(Math::Ceil(extent[i] / cellSize)), 1, int(MAX_CELLS));
+        invCellSize[i] = 1 / cellSize;
+    }
+    size_t numCells = size_t(dims[0]) * dims[1] * dims[2];
+
+    // count the lights per cell first, then fill
+    cellStart.resize(numCells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (uint32 l = 0; l < lights.size(); ++l)
+        {
+            const Light* light = lights[l];
+            if (light->getType() == Light::LT_DIRECTIONAL)
+            {
+                if (pass == 0)
+                    globalLights.push_back(l);
+                continue;
+            }
+
+            const Vector3& pos = light->getDerivedPosition();
+            Vector3 range(light->getAttenuationRange());
+            int lo[3], hi[3];
+            getCellRange(pos - range, pos + range, lo, hi);
+
+            // binning lights covering most of the grid would not pay off
+            size_t covered = size_t(hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1);
+            if (covered * 2 > numCells)
+            {
+                if (pass == 0)
+                    globalLights.push_back(l);
+                continue;
+            }
+
+            for (int z = lo[2]; z <= hi[2]; ++z)
+                for (int y = lo[1]; y <= hi[1]; ++y)
+                    for (int x = lo[0]; x <= hi[0]; ++x)
+                    {
+                        size_t cell = (size_t(z) * dims[1] + y) * dims[0] + x;
+                        if (pass == 0)
+                            ++cellStart[cell + 1];
+                        else
+                            cellLights[cellStart[cell]++] = l;
+                    }
+        }
+
+        if (pass == 0)
+        {
+            for (size_t c = 0; c < numCells; ++c)
+                cellStart[c + 1] += cellStart[c];
+            cellLights.resize(cellStart[numCells]);
+        }
+        else
+        {
+            // filling advanced each start to the next cell's start
+            for (size_t c = numCells; c > 0; --c)
+                cellStart[c] = cellStart[c - 1];
+            cellStart[0] = 0;
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::LightClusterGrid::query(const Sphere& sphere, std::vector<uint32>& indices) const
+{
+    indices.assign(globalLights.begin(), globalLights.end());
+
+    if (!cellStart.empty())
+    {
+        Vector3 radius(sphere.getRadius());
+        int lo[3], hi[3];
+        getCellRange(sphere.getCenter() - radius, sphere.getCenter() + radius, lo, hi);
+
+        for (int z = lo[2]; z <= hi[2]; ++z)
+            for (int y = lo[1]; y <= hi[1]; ++y)
+                for (int x = lo[0]; x <= hi[0]; ++x)
+                {
+                    size_t cell = (size_t(z) * dims[1] + y) * dims[0] + x;
+                    indices.insert(indices.end(), cellLights.begin() + cellStart[cell],
+                                   cellLights.begin() + cellStart[cell + 1]);
+                }
+    }
+
+    // restore the order of the lights affecting the frustum
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+}
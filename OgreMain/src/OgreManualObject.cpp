@@ -831,6 +831,14 @@ namespace Ogre {
         mUseIdentityView = useIdentityView;
     }
     //-----------------------------------------------------------------------
+    void ManualObject::setBoundingBox(const AxisAlignedBox& box)
+    {
+        mAABB = box;
+
+        if (mParentNode)
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
     ManualObject::ManualObjectSection* ManualObject::getSection(unsigned int inIndex) const
     {
         if (inIndex >= mSectionList.size())
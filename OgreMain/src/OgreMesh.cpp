@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreTangentSpaceCalc.h"
 #include "OgreLodStrategyManager.h"
 #include "OgrePixelCountLodStrategy.h"
+#include "OgreEntity.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -416,6 +417,30 @@ namespace Ogre {
                 mBoundRadius = mBoundRadius + (mBoundRadius * MeshManager::getSingleton().getBoundsPaddingFactor());
             }
         }
+
+        notifyBoundsChanged();
+    }
+    //-----------------------------------------------------------------------
+    void Mesh::notifyBoundsChanged(void)
+    {
+        // Entities of a mesh which is still being loaded are not initialised yet
+        if (!isLoaded() || !Root::getSingletonPtr())
+            return;
+
+        // Their nodes only update their bounds when asked to
+        const SceneManagerEnumerator::Instances& sceneManagers = Root::getSingleton().getSceneManagers();
+        for (SceneManagerEnumerator::Instances::const_iterator i = sceneManagers.begin();
+             i != sceneManagers.end(); ++i)
+        {
+            SceneManager::MovableObjectCollectionIterator it =
+                i->second->_getMovableObjectCollectionIterator(EntityFactory::FACTORY_TYPE_NAME);
+            while (it.hasMoreElements())
+            {
+                Entity* ent = static_cast<Entity*>(it.getNext());
+                if (ent->getMesh().get() == this && ent->getParentSceneNode())
+                    ent->getParentSceneNode()->needUpdate();
+            }
+        }
     }
     //-----------------------------------------------------------------------
     void Mesh::_setBoundingSphereRadius(Real radius)
@@ -451,6 +476,8 @@ namespace Ogre {
             // Pad out the sphere a little too
             mBoundRadius = mBoundRadius + (mBoundRadius * MeshManager::getSingleton().getBoundsPaddingFactor());
         }
+
+        notifyBoundsChanged();
     }
     void Mesh::_calcBoundsFromVertexBuffer(VertexData* vertexData, AxisAlignedBox& outAABB, Real& outRadius, bool extendOnly /*= false*/)
     {
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreLight.h"
 #include "OgreEntity.h"
 #include "OgreLodListener.h"
+#include "OgreRenderQueue.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -54,6 +55,7 @@ namespace Ogre {
         , mRenderQueueIDSet(false)
         , mRenderQueuePrioritySet(false)
         , mRenderingDisabled(false)
+        , mStatic(false)
         , mRenderQueueID(RENDER_QUEUE_MAIN)
         , mRenderQueuePriority(100)
         , mUpperDistance(0)
@@ -63,6 +65,9 @@ namespace Ogre {
         , mVisibilityFlags(msDefaultVisibilityFlags)
         , mLightListUpdated(0)
         , mLightMask(0xFFFFFFFF)
+        , mQueryProxy(DynamicAABBTree::NULL_NODE)
+        , mQueryOrder(0)
+        , mStaticEntries(0)
     {
         if (Root::getSingletonPtr())
             mMinPixelSize = Root::getSingleton().getDefaultMinPixelSize();
@@ -76,6 +81,10 @@ namespace Ogre {
             mListener->objectDestroyed(this);
         }
 
+        // before detaching, so the manager is not asked about a partly destroyed object
+        if (mQueryProxy != DynamicAABBTree::NULL_NODE && mManager)
+            mManager->_removeFromQueryBroadphase(this);
+
         if (mParentNode)
         {
             // detach from parent
@@ -92,6 +101,8 @@ namespace Ogre {
                 static_cast<SceneNode*>(mParentNode)->detachObject(this);
             }
         }
+
+        OGRE_DELETE mStaticEntries;
     }
     //-----------------------------------------------------------------------
     void MovableObject::_notifyAttached(Node* parent, bool isTagPoint)
@@ -103,6 +114,9 @@ namespace Ogre {
         mParentNode = parent;
         mParentIsTagPoint = isTagPoint;
 
+        if (mManager && different)
+            mManager->_notifyAttachmentChanged(this);
+
         // Mark light list being dirty, simply decrease
         // counter by one for minimise overhead
         --mLightListUpdated;
@@ -269,6 +283,7 @@ namespace Ogre {
         assert(queueID <= RENDER_QUEUE_MAX && "Render queue out of range!");
         mRenderQueueID = queueID;
         mRenderQueueIDSet = true;
+        notifyStaticDirty();
     }
 
     //-----------------------------------------------------------------------
@@ -279,6 +294,27 @@ namespace Ogre {
         mRenderQueuePrioritySet = true;
 
     }
+    //-----------------------------------------------------------------------
+    void MovableObject::setStatic(bool isStatic)
+    {
+        mStatic = isStatic;
+
+        if (mStatic && !mStaticEntries)
+        {
+            mStaticEntries = OGRE_NEW StaticRenderQueueEntries();
+        }
+        else if (!mStatic)
+        {
+            OGRE_DELETE mStaticEntries;
+            mStaticEntries = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void MovableObject::notifyStaticDirty(void)
+    {
+        if (mStaticEntries)
+            mStaticEntries->generation = 0;
+    }
 
     //-----------------------------------------------------------------------
     const Affine3& MovableObject::_getParentNodeFullTransform(void) const
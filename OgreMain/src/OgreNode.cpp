@@ -194,6 +194,35 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Node::_updateSelf(bool parentHasChanged, PendingUpdateList& pending)
+    {
+        // same as _update, but the children are handed back to the caller
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            for (ChildNodeMap::iterator it = mChildren.begin(); it != mChildren.end(); ++it)
+            {
+                pending.push_back(std::make_pair(*it, true));
+            }
+        }
+        else
+        {
+            for (ChildUpdateSet::iterator it = mChildrenToUpdate.begin(); it != mChildrenToUpdate.end(); ++it)
+            {
+                pending.push_back(std::make_pair(*it, false));
+            }
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+    }
+    //-----------------------------------------------------------------------
     void Node::_updateFromParent(void) const
     {
         updateFromParentImpl();
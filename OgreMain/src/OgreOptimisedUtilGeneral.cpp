@@ -91,6 +91,15 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* const* centres,
+            const Real* const* halfSizes,
+            char* visible,
+            size_t numBoxes);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -364,6 +373,31 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::calculateBoxVisibility(
+        const Plane* planes,
+        size_t numPlanes,
+        const Real* const* centres,
+        const Real* const* halfSizes,
+        char* visible,
+        size_t numBoxes)
+    {
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            Vector3 centre(centres[0][i], centres[1][i], centres[2][i]);
+            Vector3 halfSize(halfSizes[0][i], halfSizes[1][i], halfSizes[2][i]);
+
+            visible[i] = true;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                if (planes[p].getSide(centre, halfSize) == Plane::NEGATIVE_SIDE)
+                {
+                    visible[i] = false;
+                    break;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
@@ -129,6 +129,15 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateBoxVisibility(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* const* centres,
+            const Real* const* halfSizes,
+            char* visible,
+            size_t numBoxes);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -268,6 +277,26 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* const* centres,
+            const Real* const* halfSizes,
+            char* visible,
+            size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->calculateBoxVisibility(
+                planes,
+                numPlanes,
+                centres,
+                halfSizes,
+                visible,
+                numBoxes);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2131,6 +2160,85 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::calculateBoxVisibility(
+        const Plane* planes,
+        size_t numPlanes,
+        const Real* const* centres,
+        const Real* const* halfSizes,
+        char* visible,
+        size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        // Mask used to changes sign of single precision floating point values.
+        OGRE_SIMD_ALIGNED_DECL(static const uint32, msSignMask[4]) =
+        {
+            0x80000000, 0x80000000, 0x80000000, 0x80000000,
+        };
+        const __m128 signMask = *(const __m128*)msSignMask;
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        size_t i = 0;
+        for (size_t n = 0; n < numIterations; ++n, i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(centres[0] + i);
+            __m128 cy = _mm_loadu_ps(centres[1] + i);
+            __m128 cz = _mm_loadu_ps(centres[2] + i);
+            __m128 hx = _mm_loadu_ps(halfSizes[0] + i);
+            __m128 hy = _mm_loadu_ps(halfSizes[1] + i);
+            __m128 hz = _mm_loadu_ps(halfSizes[2] + i);
+
+            // Accumulate culled flags of all planes, in the same operation order
+            // as Plane::getSide(const Vector3&, const Vector3&)
+            __m128 culled = _mm_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                __m128 nx = _mm_set_ps1(planes[p].normal.x);
+                __m128 ny = _mm_set_ps1(planes[p].normal.y);
+                __m128 nz = _mm_set_ps1(planes[p].normal.z);
+
+                // dist = normal.dotProduct(centre) + d
+                __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)),
+                    _mm_set_ps1(planes[p].d));
+
+                // maxAbsDist = normal.absDotProduct(halfSize)
+                __m128 maxAbsDist = _mm_add_ps(_mm_add_ps(
+                    _mm_andnot_ps(signMask, _mm_mul_ps(nx, hx)),
+                    _mm_andnot_ps(signMask, _mm_mul_ps(ny, hy))),
+                    _mm_andnot_ps(signMask, _mm_mul_ps(nz, hz)));
+
+                culled = _mm_or_ps(culled, _mm_cmplt_ps(dist, _mm_xor_ps(maxAbsDist, signMask)));
+            }
+
+            // Store result
+            uint32 mask = _mm_movemask_ps(culled);
+            visible[i + 0] = !(mask & 1);
+            visible[i + 1] = !(mask & 2);
+            visible[i + 2] = !(mask & 4);
+            visible[i + 3] = !(mask & 8);
+        }
+
+        // Dealing with remaining boxes
+        for (size_t n = 0; n < numBoxes; ++n, ++i)
+        {
+            Vector3 centre(centres[0][i], centres[1][i], centres[2][i]);
+            Vector3 halfSize(halfSizes[0][i], halfSizes[1][i], halfSizes[2][i]);
+
+            visible[i] = true;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                if (planes[p].getSide(centre, halfSize) == Plane::NEGATIVE_SIDE)
+                {
+                    visible[i] = false;
+                    break;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
@@ -1165,6 +1165,8 @@ namespace Ogre {
         mAABB = aabb;
         mBoundingRadius = Math::boundingRadiusFromAABB(mAABB);
 
+        if (mParentNode)
+            mParentNode->needUpdate();
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::setBoundsAutoUpdated(bool autoUpdate, Real stopIn)
@@ -0,0 +1,121 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgrePoolAllocator.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct SizeClassPool
+        {
+            OGRE_WQ_MUTEX(mutex);
+            FreeBlock* freeList;
+            size_t allocated;
+        };
+
+        const size_t CHUNK_SIZE = 64 * 1024;
+        const size_t NUM_POOLS = PoolAllocator::MAX_POOLED_SIZE / PoolAllocator::ALIGNMENT;
+
+        SizeClassPool* getPools()
+        {
+            // never destroyed, objects may still be released during static destruction
+            static SizeClassPool* pools = new SizeClassPool[NUM_POOLS]();
+            return pools;
+        }
+
+        size_t getPoolIndex(size_t size)
+        {
+            return size ? (size - 1) / PoolAllocator::ALIGNMENT : 0;
+        }
+    }
+    //---------------------------------------------------------------------
+    void* PoolAllocator::allocate(size_t size)
+    {
+        if (size > MAX_POOLED_SIZE)
+            return ::operator new(size);
+
+        size_t index = getPoolIndex(size);
+        SizeClassPool& pool = getPools()[index];
+        OGRE_WQ_LOCK_MUTEX(pool.mutex);
+        if (!pool.freeList)
+        {
+            // carve a new chunk into blocks, kept in address order
+            size_t blockSize = (index + 1) * ALIGNMENT;
+            size_t count = std::max<size_t>(CHUNK_SIZE / blockSize, 1);
+            char* chunk = static_cast<char*>(::operator new(count * blockSize));
+            FreeBlock* next = 0;
+            for (size_t i = count; i > 0; --i)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * blockSize);
+                block->next = next;
+                next = block;
+            }
+            pool.freeList = next;
+        }
+
+        FreeBlock* block = pool.freeList;
+        pool.freeList = block->next;
+        ++pool.allocated;
+        return block;
+    }
+    //---------------------------------------------------------------------
+    void PoolAllocator::deallocate(void* p, size_t size)
+    {
+        if (!p)
+            return;
+
+        if (size > MAX_POOLED_SIZE)
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        SizeClassPool& pool = getPools()[getPoolIndex(size)];
+        OGRE_WQ_LOCK_MUTEX(pool.mutex);
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = pool.freeList;
+        pool.freeList = block;
+        --pool.allocated;
+    }
+    //---------------------------------------------------------------------
+    size_t PoolAllocator::getAllocatedBlockCount(size_t size)
+    {
+        if (size > MAX_POOLED_SIZE)
+            return 0;
+
+        SizeClassPool& pool = getPools()[getPoolIndex(size)];
+        OGRE_WQ_LOCK_MUTEX(pool.mutex);
+        return pool.allocated;
+    }
+}
@@ -0,0 +1,247 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreEntity.h"
+
+namespace Ogre {
+namespace {
+    /// Box covering the world bounds and the bounding sphere of the object
+    AxisAlignedBox getQueryBounds(MovableObject* m)
+    {
+        // also caches the bounds of objects attached to bones, which the node update does not
+        AxisAlignedBox box = m->getWorldBoundingBox(true);
+        if (!box.isInfinite())
+        {
+            // the default sphere query tests a sphere around the node position
+            Real radius = m->getBoundingRadius();
+            const Vector3& pos = m->getParentNode()->_getDerivedPosition();
+            box.merge(AxisAlignedBox(pos - radius, pos + radius));
+        }
+        return box;
+    }
+
+    /// Order in which the objects started being tracked
+    bool compareQueryOrder(const MovableObject* a, const MovableObject* b)
+    {
+        return a->_getQueryOrder() < b->_getQueryOrder();
+    }
+
+    /// Calls f for the objects attached to the bones of an entity
+    template<typename Function> void forEachChildObject(MovableObject* m, const Function& f)
+    {
+        if (m->getMovableType() != EntityFactory::FACTORY_TYPE_NAME)
+            return;
+        Entity::ChildObjectListIterator it = static_cast<Entity*>(m)->getAttachedObjectIterator();
+        while (it.hasMoreElements())
+            f(it.getNext());
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::add(MovableObject* m)
+{
+    if (m->_getQueryProxy() == DynamicAABBTree::NULL_NODE)
+    {
+        m->_setQueryProxy(NO_PROXY);
+        m->_setQueryOrder(nextOrder++);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::remove(MovableObject* m)
+{
+    drop(m);
+    m->_setQueryProxy(DynamicAABBTree::NULL_NODE);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::unlink(MovableObject* m)
+{
+    if (isTracked(m))
+        drop(m);
+    forEachChildObject(m, [this](MovableObject* child) { unlink(child); });
+}
+//-----------------------------------------------------------------------
+bool SceneManager::QueryBroadphase::isTracked(const MovableObject* m) const
+{
+    // objects of other managers may be attached to our nodes
+    return m->_getManager() == owner && m->_getQueryProxy() != DynamicAABBTree::NULL_NODE;
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::drop(MovableObject* m)
+{
+    int proxy = m->_getQueryProxy();
+    if (proxy == INFINITE_PROXY)
+    {
+        std::vector<MovableObject*>::iterator i =
+            std::find(infiniteObjects.begin(), infiniteObjects.end(), m);
+        assert(i != infiniteObjects.end());
+        *i = infiniteObjects.back();
+        infiniteObjects.pop_back();
+    }
+    else if (proxy >= 0)
+    {
+        tree.destroyProxy(proxy);
+    }
+    m->_setQueryProxy(NO_PROXY);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::addMovedNode(SceneNode* node)
+{
+    if (node->_getQueryMovedIndex() >= 0)
+        return;
+    node->_setQueryMovedIndex(int(movedNodes.size()));
+    movedNodes.push_back(node);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::removeMovedNode(SceneNode* node)
+{
+    movedNodes[node->_getQueryMovedIndex()] = NULL;
+    node->_setQueryMovedIndex(-1);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::clearMovedNodes(void)
+{
+    for (size_t i = 0; i < movedNodes.size(); ++i)
+    {
+        if (movedNodes[i])
+            movedNodes[i]->_setQueryMovedIndex(-1);
+    }
+    movedNodes.clear();
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::update(void)
+{
+    for (size_t i = 0; i < movedNodes.size(); ++i)
+    {
+        SceneNode* node = movedNodes[i];
+        if (!node || !node->isInSceneGraph())
+            continue;
+
+        // nodes below another recorded node are refreshed along with it
+        bool recordedAncestor = false;
+        for (Node* n = node->getParent(); n && !recordedAncestor; n = n->getParent())
+            recordedAncestor = static_cast<SceneNode*>(n)->_getQueryMovedIndex() >= 0;
+        if (!recordedAncestor)
+            updateNode(node);
+    }
+    clearMovedNodes();
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::updateNode(SceneNode* node)
+{
+    const SceneNode::ObjectMap& objects = node->getAttachedObjects();
+    for (size_t i = 0; i < objects.size(); ++i)
+        updateObject(objects[i]);
+
+    const Node::ChildNodeMap& children = node->getChildren();
+    for (size_t i = 0; i < children.size(); ++i)
+        updateNode(static_cast<SceneNode*>(children[i]));
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::updateObject(MovableObject* m)
+{
+    forEachChildObject(m, [this](MovableObject* child) { updateObject(child); });
+
+    if (!isTracked(m))
+        return;
+
+    int proxy = m->_getQueryProxy();
+    if (!m->isInScene())
+    {
+        drop(m);
+        return;
+    }
+
+    AxisAlignedBox box = getQueryBounds(m);
+    if (box.isInfinite())
+    {
+        if (proxy == INFINITE_PROXY)
+            return;
+        drop(m);
+        infiniteObjects.push_back(m);
+        m->_setQueryProxy(INFINITE_PROXY);
+    }
+    else if (proxy < 0)
+    {
+        drop(m);
+        m->_setQueryProxy(tree.createProxy(box, m));
+    }
+    else
+    {
+        tree.moveProxy(proxy, box);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::appendResult(std::vector<MovableObject*>& objects)
+{
+    objects.clear();
+    for (size_t i = 0; i < result.size(); ++i)
+        objects.push_back(static_cast<MovableObject*>(result[i]));
+    objects.insert(objects.end(), infiniteObjects.begin(), infiniteObjects.end());
+    std::sort(objects.begin(), objects.end(), compareQueryOrder);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::find(const AxisAlignedBox& box, std::vector<MovableObject*>& objects)
+{
+    result.clear();
+    tree.query(box, result);
+    appendResult(objects);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::find(const Sphere& sphere, std::vector<MovableObject*>& objects)
+{
+    result.clear();
+    tree.query(sphere, result);
+    appendResult(objects);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::find(const Ray& ray, std::vector<MovableObject*>& objects)
+{
+    result.clear();
+    tree.query(ray, result);
+    appendResult(objects);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::find(const PlaneBoundedVolume& volume, std::vector<MovableObject*>& objects)
+{
+    result.clear();
+    tree.query(volume, result);
+    appendResult(objects);
+}
+//-----------------------------------------------------------------------
+void SceneManager::QueryBroadphase::find(const PlaneBoundedVolumeList& volumes, std::vector<MovableObject*>& objects)
+{
+    result.clear();
+    for (size_t i = 0; i < volumes.size(); ++i)
+        tree.query(volumes[i], result);
+    if (volumes.size() > 1)
+    {
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    appendResult(objects);
+}
+}
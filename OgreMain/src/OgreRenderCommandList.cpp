@@ -0,0 +1,375 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreRenderCommandList.h"
+#include "OgreRenderSystem.h"
+#include "OgreRenderSystemCapabilities.h"
+#include "OgreGpuProgram.h"
+#include "OgreTextureManager.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    RenderCommandList::RenderCommandList() : mComplete(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::clear()
+    {
+        mCommands.clear();
+        mPassStates.clear();
+        mTextureUnits.clear();
+        mMatrices.clear();
+        mObjectStates.clear();
+        mLights.clear();
+        mParameters.clear();
+        mFloatConstants.clear();
+        mDoubleConstants.clear();
+        mIntConstants.clear();
+        mDraws.clear();
+        mComplete = true;
+
+        // keep the copies the last recording used, so the next one reuses them
+        for (ParameterCopyMap::iterator i = mParameterCopies.begin(); i != mParameterCopies.end();)
+        {
+            if (i->second.used)
+            {
+                i->second.used = false;
+                ++i;
+            }
+            else
+            {
+                mParameterCopies.erase(i++);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::addCommand(CommandType type, size_t index)
+    {
+        Command cmd = {type, static_cast<uint32>(index)};
+        mCommands.push_back(cmd);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::setPass(const Pass* pass, FogMode fogMode, const ColourValue& fogColour,
+                                    Real fogDensity, Real fogStart, Real fogEnd, CullingMode cullingMode)
+    {
+        PassState state;
+        for (int i = 0; i < GPT_COUNT; ++i)
+        {
+            GpuProgramType type = static_cast<GpuProgramType>(i);
+            state.programs[i] =
+                pass->hasGpuProgram(type) ? pass->getGpuProgram(type)->_getBindingDelegate() : 0;
+        }
+
+        const GpuProgram* vprog = state.programs[GPT_VERTEX_PROGRAM] ? pass->getVertexProgram().get() : 0;
+        state.surfaceAndLightStates = !vprog || vprog->getPassSurfaceAndLightStates();
+        state.lightingEnabled = pass->getLightingEnabled();
+        state.ambient = pass->getAmbient();
+        state.diffuse = pass->getDiffuse();
+        state.specular = pass->getSpecular();
+        state.emissive = pass->getSelfIllumination();
+        state.shininess = pass->getShininess();
+        state.vertexColourTracking = pass->getVertexColourTracking();
+
+        state.fogMode = fogMode;
+        state.fogColour = fogColour;
+        state.fogDensity = fogDensity;
+        state.fogStart = fogStart;
+        state.fogEnd = fogEnd;
+
+        state.blendState = pass->getBlendState();
+        state.lineWidth = pass->getLineWidth();
+        state.pointSize = pass->getPointSize();
+        state.pointAttenuationEnabled = pass->isPointAttenuationEnabled();
+        state.pointAttenuation[0] = pass->getPointAttenuationConstant();
+        state.pointAttenuation[1] = pass->getPointAttenuationLinear();
+        state.pointAttenuation[2] = pass->getPointAttenuationQuadratic();
+        state.pointMinSize = pass->getPointMinSize();
+        state.pointMaxSize = pass->getPointMaxSize();
+        state.pointSpritesEnabled = pass->getPointSpritesEnabled();
+
+        // _setPass bound the shadow and compositor textures already, so this is what
+        // RenderSystem::_setTextureUnitSettings would apply now
+        state.firstTextureUnit = static_cast<uint32>(mTextureUnits.size());
+        state.numTextureUnits = static_cast<uint32>(pass->getNumTextureUnitStates());
+        for (TextureUnitState* tus : pass->getTextureUnitStates())
+        {
+            TextureUnit unit;
+            unit.texture = tus->_getTexturePtr();
+            if (!unit.texture || tus->isTextureLoadFailing())
+                unit.texture = TextureManager::getSingleton()._getWarningTexture();
+            unit.bindingType = tus->getBindingType();
+            unit.coordSet = tus->getTextureCoordSet();
+            unit.sampler = tus->getSampler();
+            unit.colourBlendMode = tus->getColourBlendMode();
+            unit.alphaBlendMode = tus->getAlphaBlendMode();
+            unit.coordCalculation = TEXCALC_NONE;
+            unit.projector = 0;
+            // the last effect wins, as in _setTextureUnitSettings
+            for (const auto& effect : tus->getEffects())
+            {
+                if (effect.second.type == TextureUnitState::ET_ENVIRONMENT_MAP)
+                {
+                    switch (effect.second.subtype)
+                    {
+                    case TextureUnitState::ENV_CURVED:
+                        unit.coordCalculation = TEXCALC_ENVIRONMENT_MAP;
+                        break;
+                    case TextureUnitState::ENV_PLANAR:
+                        unit.coordCalculation = TEXCALC_ENVIRONMENT_MAP_PLANAR;
+                        break;
+                    case TextureUnitState::ENV_REFLECTION:
+                        unit.coordCalculation = TEXCALC_ENVIRONMENT_MAP_REFLECTION;
+                        break;
+                    case TextureUnitState::ENV_NORMAL:
+                        unit.coordCalculation = TEXCALC_ENVIRONMENT_MAP_NORMAL;
+                        break;
+                    }
+                    unit.projector = 0;
+                }
+                else if (effect.second.type == TextureUnitState::ET_PROJECTIVE_TEXTURE)
+                {
+                    unit.coordCalculation = TEXCALC_PROJECTIVE_TEXTURE;
+                    unit.projector = effect.second.frustum;
+                }
+            }
+            unit.transform = tus->getTextureTransform();
+            mTextureUnits.push_back(unit);
+        }
+
+        state.depthFunction = pass->getDepthFunction();
+        state.depthCheck = pass->getDepthCheckEnabled();
+        state.depthWrite = pass->getDepthWriteEnabled();
+        state.depthBiasConstant = pass->getDepthBiasConstant();
+        state.depthBiasSlopeScale = pass->getDepthBiasSlopeScale();
+        state.alphaRejectFunction = pass->getAlphaRejectFunction();
+        state.alphaRejectValue = pass->getAlphaRejectValue();
+        state.alphaToCoverage = pass->isAlphaToCoverageEnabled();
+        state.cullingMode = cullingMode;
+        state.shading = pass->getShadingMode();
+        state.polygonMode = pass->getPolygonMode();
+
+        addCommand(CT_SET_PASS, mPassStates.size());
+        mPassStates.push_back(state);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::setWorldMatrix(const Matrix4& m)
+    {
+        addCommand(CT_SET_WORLD_MATRIX, mMatrices.size());
+        mMatrices.push_back(m);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::setViewMatrix(const Matrix4& m)
+    {
+        addCommand(CT_SET_VIEW_MATRIX, mMatrices.size());
+        mMatrices.push_back(m);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::setProjectionMatrix(const Matrix4& m)
+    {
+        addCommand(CT_SET_PROJECTION_MATRIX, mMatrices.size());
+        mMatrices.push_back(m);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::setObjectState(CullingMode cullingMode, PolygonMode polygonMode,
+                                           bool normaliseNormals)
+    {
+        ObjectState state = {cullingMode, polygonMode, normaliseNormals};
+        addCommand(CT_SET_OBJECT_STATE, mObjectStates.size());
+        mObjectStates.push_back(state);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::useLights(const LightList& lights, unsigned short limit)
+    {
+        addCommand(CT_USE_LIGHTS, mLights.size());
+        mLights.push_back(Lights());
+        mLights.back().lights = lights;
+        mLights.back().limit = limit;
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::bindParameters(GpuProgramType type, const GpuProgramParametersPtr& params,
+                                           uint16 variabilityMask)
+    {
+        const FloatConstantList& floats = params->getFloatConstantList();
+        const DoubleConstantList& doubles = params->getDoubleConstantList();
+        const IntConstantList& ints = params->getIntConstantList();
+
+        ParameterCopy& copy = mParameterCopies[params.get()];
+        if (!copy.params || copy.params->getFloatConstantList().size() != floats.size() ||
+            copy.params->getDoubleConstantList().size() != doubles.size() ||
+            copy.params->getIntConstantList().size() != ints.size())
+        {
+            copy.params.reset(OGRE_NEW GpuProgramParameters(*params));
+            copy.source = params;
+        }
+        copy.used = true;
+
+        Parameters recorded = {type, variabilityMask, copy.params,
+                               static_cast<uint32>(mFloatConstants.size()),
+                               static_cast<uint32>(mDoubleConstants.size()),
+                               static_cast<uint32>(mIntConstants.size())};
+        mFloatConstants.insert(mFloatConstants.end(), floats.begin(), floats.end());
+        mDoubleConstants.insert(mDoubleConstants.end(), doubles.begin(), doubles.end());
+        mIntConstants.insert(mIntConstants.end(), ints.begin(), ints.end());
+
+        addCommand(CT_BIND_PARAMETERS, mParameters.size());
+        mParameters.push_back(recorded);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::render(const RenderOperation& op, size_t iterationCount)
+    {
+        Draw draw = {op, iterationCount};
+        addCommand(CT_RENDER, mDraws.size());
+        mDraws.push_back(draw);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::applyPassState(RenderSystem* rs, const PassState& state) const
+    {
+        const RenderSystemCapabilities* caps = rs->getCapabilities();
+
+        // same order as SceneManager::_setPass
+        for (int i = 0; i < GPT_COUNT; ++i)
+        {
+            GpuProgramType type = static_cast<GpuProgramType>(i);
+            if (state.programs[i])
+                rs->bindGpuProgram(state.programs[i]);
+            else if (rs->isGpuProgramBound(type))
+                rs->unbindGpuProgram(type);
+        }
+
+        if (state.surfaceAndLightStates)
+        {
+            if (state.lightingEnabled)
+                rs->_setSurfaceParams(state.ambient, state.diffuse, state.specular, state.emissive,
+                                      state.shininess, state.vertexColourTracking);
+            rs->setLightingEnabled(state.lightingEnabled);
+        }
+
+        rs->_setFog(state.fogMode, state.fogColour, state.fogDensity, state.fogStart, state.fogEnd);
+        rs->setColourBlendState(state.blendState);
+        if (caps->hasCapability(RSC_WIDE_LINES))
+            rs->_setLineWidth(state.lineWidth);
+        rs->_setPointParameters(state.pointSize, state.pointAttenuationEnabled,
+                                state.pointAttenuation[0], state.pointAttenuation[1],
+                                state.pointAttenuation[2], state.pointMinSize, state.pointMaxSize);
+        if (caps->hasCapability(RSC_POINT_SPRITES))
+            rs->_setPointSpritesEnabled(state.pointSpritesEnabled);
+
+        // as RenderSystem::_setTextureUnitSettings
+        bool separateVertexTextures = caps->hasCapability(RSC_VERTEX_TEXTURE_FETCH) &&
+                                      !caps->getVertexTextureUnitsShared();
+        for (uint32 i = 0; i < state.numTextureUnits; ++i)
+        {
+            const TextureUnit& unit = mTextureUnits[state.firstTextureUnit + i];
+            if (separateVertexTextures && unit.bindingType == TextureUnitState::BT_VERTEX)
+            {
+                rs->_setVertexTexture(i, unit.texture);
+                rs->_setTexture(i, true, TexturePtr());
+            }
+            else
+            {
+                if (separateVertexTextures)
+                    rs->_setVertexTexture(i, TexturePtr());
+                rs->_setTexture(i, true, unit.texture);
+            }
+            rs->_setTextureCoordSet(i, unit.coordSet);
+            rs->_setSampler(i, *unit.sampler);
+            rs->_setTextureBlendMode(i, unit.colourBlendMode);
+            rs->_setTextureBlendMode(i, unit.alphaBlendMode);
+            rs->_setTextureCoordCalculation(i, unit.coordCalculation, unit.projector);
+            rs->_setTextureMatrix(i, unit.transform);
+        }
+        rs->_disableTextureUnitsFrom(state.numTextureUnits);
+
+        rs->_setDepthBufferFunction(state.depthFunction);
+        rs->_setDepthBufferCheckEnabled(state.depthCheck);
+        rs->_setDepthBufferWriteEnabled(state.depthWrite);
+        rs->_setDepthBias(state.depthBiasConstant, state.depthBiasSlopeScale);
+        rs->_setAlphaRejectSettings(state.alphaRejectFunction, state.alphaRejectValue,
+                                    state.alphaToCoverage);
+        rs->_setCullingMode(state.cullingMode);
+        rs->setShadingType(state.shading);
+        rs->_setPolygonMode(state.polygonMode);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::execute(RenderSystem* rs) const
+    {
+        OgreAssert(mComplete, "the list recorded state it cannot replay");
+
+        for (const Command& cmd : mCommands)
+        {
+            switch (cmd.type)
+            {
+            case CT_SET_PASS:
+                applyPassState(rs, mPassStates[cmd.index]);
+                break;
+            case CT_SET_WORLD_MATRIX:
+                rs->_setWorldMatrix(mMatrices[cmd.index]);
+                break;
+            case CT_SET_VIEW_MATRIX:
+                rs->_setViewMatrix(mMatrices[cmd.index]);
+                break;
+            case CT_SET_PROJECTION_MATRIX:
+                rs->_setProjectionMatrix(mMatrices[cmd.index]);
+                break;
+            case CT_SET_OBJECT_STATE:
+            {
+                const ObjectState& state = mObjectStates[cmd.index];
+                rs->_setCullingMode(state.cullingMode);
+                rs->_setPolygonMode(state.polygonMode);
+                rs->setNormaliseNormals(state.normaliseNormals);
+                break;
+            }
+            case CT_USE_LIGHTS:
+                rs->_useLights(mLights[cmd.index].lights, mLights[cmd.index].limit);
+                break;
+            case CT_BIND_PARAMETERS:
+            {
+                // restore the recorded constants into the copy, then upload it
+                const Parameters& recorded = mParameters[cmd.index];
+                GpuProgramParameters* params = recorded.copy.get();
+                if (!params->getFloatConstantList().empty())
+                    memcpy(params->getFloatPointer(0), &mFloatConstants[recorded.floatOffset],
+                           params->getFloatConstantList().size() * sizeof(float));
+                if (!params->getDoubleConstantList().empty())
+                    memcpy(params->getDoublePointer(0), &mDoubleConstants[recorded.doubleOffset],
+                           params->getDoubleConstantList().size() * sizeof(double));
+                if (!params->getIntConstantList().empty())
+                    memcpy(params->getIntPointer(0), &mIntConstants[recorded.intOffset],
+                           params->getIntConstantList().size() * sizeof(int));
+                rs->bindGpuProgramParameters(recorded.type, recorded.copy, recorded.variabilityMask);
+                break;
+            }
+            case CT_RENDER:
+                rs->setCurrentPassIterationCount(mDraws[cmd.index].iterationCount);
+                rs->_render(mDraws[cmd.index].op);
+                break;
+            }
+        }
+    }
+}
@@ -40,6 +40,10 @@ namespace Ogre {
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
         , mRenderableListener(0)
+        , mStaticGeneration(1)
+        , mStaticRecording(0)
+        , mStaticOwner(this)
+        , mDeferredObjects(0)
     {
         // Create the 'main' queue up-front since we'll always need that
         mGroups[RENDER_QUEUE_MAIN].reset(new RenderQueueGroup(this, mSplitPassesByLightingType,
@@ -95,6 +99,12 @@ namespace Ogre {
             // tell material it's been used (incase changed)
             pTech->getParent()->touch();
         }
+
+        if (mStaticRecording)
+        {
+            StaticRenderQueueEntries::Entry entry = {pRend, pTech, priority, groupID};
+            mStaticRecording->entries.push_back(entry);
+        }
         
         pGroup->addRenderable(pRend, pTech, priority);
 
@@ -106,6 +116,14 @@ namespace Ogre {
         SceneManagerEnumerator::SceneManagerIterator scnIt =
             SceneManagerEnumerator::getSingleton().getSceneManagerIterator();
 
+        // Recorded static entries may point at passes which are about to be
+        // deleted or at priority groups which are about to be destroyed
+        bool invalidateStatic = destroyPassMaps;
+        {
+            OGRE_LOCK_MUTEX(Pass::msPassGraveyardMutex);
+            invalidateStatic |= !Pass::getPassGraveyard().empty();
+        }
+
         // Note: We clear dirty passes from all RenderQueues in all 
         // SceneManagers, because the following recalculation of pass hashes
         // also considers all RenderQueues and could become inconsistent, otherwise.
@@ -114,6 +132,9 @@ namespace Ogre {
             SceneManager* sceneMgr = scnIt.getNext();
             RenderQueue* queue = sceneMgr->getRenderQueue();
 
+            if (invalidateStatic)
+                ++queue->mStaticGeneration;
+
             for (size_t i = 0; i < RENDER_QUEUE_MAX; ++i)
             {
                 if(queue->mGroups[i])
@@ -242,6 +263,14 @@ namespace Ogre {
         bool onlyShadowCasters, 
         VisibleObjectsBoundsInfo* visibleBounds)
     {
+        if (mDeferredObjects && !(mo->isStatic() && hasValidStaticEntries(mo)))
+        {
+            // Only static objects with recorded entries may be queued here, before
+            // notifying them, so the owning thread notifies the others only once
+            mDeferredObjects->push_back(mo);
+            return;
+        }
+
         mo->_notifyCurrentCamera(cam);
         if (mo->isVisible())
         {
@@ -250,7 +279,10 @@ namespace Ogre {
 
             if (!onlyShadowCasters || mo->getCastShadows())
             {
-                mo -> _updateRenderQueue( this );
+                if (mo->isStatic() && !mRenderableListener)
+                    addStaticObject(mo);
+                else
+                    mo -> _updateRenderQueue( this );
                 if (visibleBounds)
                 {
                     visibleBounds->merge(mo->getWorldBoundingBox(true), 
@@ -268,6 +300,71 @@ namespace Ogre {
         }
 
     }
+    //---------------------------------------------------------------------
+    bool RenderQueue::hasValidStaticEntries(MovableObject* mo) const
+    {
+        const StaticRenderQueueEntries* rec = mo->_getStaticRenderQueueEntries();
+        return rec->queue == mStaticOwner && rec->generation == mStaticOwner->mStaticGeneration &&
+               rec->schemeIndex == MaterialManager::getSingleton()._getActiveSchemeIndex() &&
+               rec->defaultQueueGroup == mDefaultQueueGroup &&
+               rec->defaultPriority == mDefaultRenderablePriority;
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::addStaticObject(MovableObject* mo)
+    {
+        StaticRenderQueueEntries* rec = mo->_getStaticRenderQueueEntries();
+        if (hasValidStaticEntries(mo))
+        {
+            // Nothing changed, skip the technique lookups
+            std::vector<StaticRenderQueueEntries::Entry>::const_iterator i, iend;
+            iend = rec->entries.end();
+            for (i = rec->entries.begin(); i != iend; ++i)
+            {
+                getQueueGroup(i->groupID)->addRenderable(i->renderable, i->technique, i->priority);
+            }
+            return;
+        }
+
+        // Recording calls back into the object, thread local queues defer these
+        assert(!mDeferredObjects);
+        rec->entries.clear();
+        mStaticRecording = rec;
+        mo->_updateRenderQueue(this);
+        mStaticRecording = 0;
+
+        rec->queue = this;
+        rec->generation = mStaticGeneration;
+        rec->schemeIndex = MaterialManager::getSingleton()._getActiveSchemeIndex();
+        rec->defaultQueueGroup = mDefaultQueueGroup;
+        rec->defaultPriority = mDefaultRenderablePriority;
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::_prepareThreadLocal(const RenderQueue* parent,
+        std::vector<MovableObject*>* deferred)
+    {
+        mDefaultQueueGroup = parent->mDefaultQueueGroup;
+        mDefaultRenderablePriority = parent->mDefaultRenderablePriority;
+        mSplitPassesByLightingType = parent->mSplitPassesByLightingType;
+        mSplitNoShadowPasses = parent->mSplitNoShadowPasses;
+        mShadowCastersCannotBeReceivers = parent->mShadowCastersCannotBeReceivers;
+        mRenderableListener = 0;
+        mStaticOwner = parent;
+        mDeferredObjects = deferred;
 
-}
+        for (size_t i = 0; i < RENDER_QUEUE_MAX; ++i)
+        {
+            if (parent->mGroups[i])
+            {
+                RenderQueueGroup* group = getQueueGroup(i);
+                group->_copySettings(parent->mGroups[i].get());
+                group->clear();
+            }
+            else
+            {
+                // created again with the defaults, like merge would in parent
+                mGroups[i].reset();
+            }
+        }
+    }
 
+}
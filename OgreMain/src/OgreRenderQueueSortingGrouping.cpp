@@ -30,10 +30,8 @@ THE SOFTWARE.
 
 namespace Ogre {
     // Init statics
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
+    RadixSort<QueuedRenderableCollection::SortedRenderablePassList,
+        QueuedRenderableCollection::SortedRenderablePass, uint64> QueuedRenderableCollection::msRadixSorter;
 
 
     //-----------------------------------------------------------------------
@@ -205,43 +203,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderPriorityGroup::clear(void)
     {
-        // Delete queue groups which are using passes which are to be
-        // deleted, we won't need these any more and they clutter up 
-        // the list and can cause problems with future clones
-        {
-            // Hmm, a bit hacky but least obtrusive for now
-                    OGRE_LOCK_MUTEX(Pass::msPassGraveyardMutex);
-            const Pass::PassSet& graveyardList = Pass::getPassGraveyard();
-            Pass::PassSet::const_iterator gi, giend;
-            giend = graveyardList.end();
-            for (gi = graveyardList.begin(); gi != giend; ++gi)
-            {
-                removePassEntry(*gi);
-            }
-        }
-
-        // Now remove any dirty passes, these will have their hashes recalculated
-        // by the parent queue after all groups have been processed
-        // If we don't do this, the std::map will become inconsistent for new insterts
-        {
-            // Hmm, a bit hacky but least obtrusive for now
-                    OGRE_LOCK_MUTEX(Pass::msDirtyHashListMutex);
-            const Pass::PassSet& dirtyList = Pass::getDirtyHashList();
-            Pass::PassSet::const_iterator di, diend;
-            diend = dirtyList.end();
-            for (di = dirtyList.begin(); di != diend; ++di)
-            {
-                removePassEntry(*di);
-            }
-        }
-        // NB we do NOT clear the graveyard or the dirty list here, because 
-        // it needs to be acted on for all groups, the parent queue takes 
-        // care of this afterwards
-
-        // Now empty the remaining collections
-        // Note that groups don't get deleted, just emptied hence the difference
-        // between the pass groups which are removed above, and clearing done
-        // here
+        // Collections keep no per pass state between frames, so passes which
+        // are destroyed or get their hash recalculated need no special care
         mSolidsBasic.clear();
         mSolidsDecal.clear();
         mSolidsDiffuseSpecular.clear();
@@ -271,6 +234,55 @@ namespace Ogre {
         mTransparents.merge( rhs->mTransparents );
     }
     //-----------------------------------------------------------------------
+    void RenderPriorityGroup::_copySettings(const RenderPriorityGroup* rhs)
+    {
+        mSplitPassesByLightingType = rhs->mSplitPassesByLightingType;
+        mSplitNoShadowPasses = rhs->mSplitNoShadowPasses;
+        mShadowCastersNotReceivers = rhs->mShadowCastersNotReceivers;
+
+        mSolidsBasic.copyOrganisationModes(rhs->mSolidsBasic);
+        mSolidsDiffuseSpecular.copyOrganisationModes(rhs->mSolidsDiffuseSpecular);
+        mSolidsDecal.copyOrganisationModes(rhs->mSolidsDecal);
+        mSolidsNoShadowReceive.copyOrganisationModes(rhs->mSolidsNoShadowReceive);
+        mTransparentsUnsorted.copyOrganisationModes(rhs->mTransparentsUnsorted);
+        mTransparents.copyOrganisationModes(rhs->mTransparents);
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueueGroup::_copySettings(const RenderQueueGroup* rhs)
+    {
+        mSplitPassesByLightingType = rhs->mSplitPassesByLightingType;
+        mSplitNoShadowPasses = rhs->mSplitNoShadowPasses;
+        mShadowCastersNotReceivers = rhs->mShadowCastersNotReceivers;
+        mShadowsEnabled = rhs->mShadowsEnabled;
+        mOrganisationMode = rhs->mOrganisationMode;
+
+        PriorityMap::iterator i = mPriorityGroups.begin();
+        while (i != mPriorityGroups.end())
+        {
+            if (rhs->mPriorityGroups.find(i->first) == rhs->mPriorityGroups.end())
+            {
+                OGRE_DELETE i->second;
+                mPriorityGroups.erase(i++);
+            }
+            else
+                ++i;
+        }
+
+        PriorityMap::const_iterator j, jend = rhs->mPriorityGroups.end();
+        for (j = rhs->mPriorityGroups.begin(); j != jend; ++j)
+        {
+            RenderPriorityGroup*& pPriorityGrp = mPriorityGroups[j->first];
+            if (!pPriorityGrp)
+            {
+                pPriorityGrp = OGRE_NEW RenderPriorityGroup(this,
+                    mSplitPassesByLightingType,
+                    mSplitNoShadowPasses,
+                    mShadowCastersNotReceivers);
+            }
+            pPriorityGrp->_copySettings(j->second);
+        }
+    }
+    //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
         :mOrganisationMode(0)
     {
@@ -279,97 +291,89 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::clear(void)
     {
-        PassGroupRenderableMap::iterator i, iend;
-        iend = mGrouped.end();
-        for (i = mGrouped.begin(); i != iend; ++i)
-        {
-            // Clear the list associated with this pass, but leave the pass entry
-            i->second.clear();
-        }
-
-        // Clear sorted list
+        // Memory stays allocated
+        mGrouped.clear();
         mSortedDescending.clear();
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
     {
-        PassGroupRenderableMap::iterator i;
-
-        i = mGrouped.find(p);
-        if (i != mGrouped.end())
+        struct UsesPass
         {
-            // erase from map
-            mGrouped.erase(i);
-        }
+            Pass* pass;
+            bool operator()(const SortedRenderablePass& e) const { return e.rp.pass == pass; }
+        } usesPass = {p};
+
+        mGrouped.erase(std::remove_if(mGrouped.begin(), mGrouped.end(), usesPass), mGrouped.end());
+        mSortedDescending.erase(
+            std::remove_if(mSortedDescending.begin(), mSortedDescending.end(), usesPass),
+            mSortedDescending.end());
+    }
+    //-----------------------------------------------------------------------
+    uint64 QueuedRenderableCollection::buildGroupKey(const Pass* pass)
+    {
+        // Sort by passHash, which is pass, then texture unit changes. The low bits
+        // keep passes which end up with the same hash apart.
+        uint32 passBits = static_cast<uint32>(reinterpret_cast<size_t>(pass) >> 4);
+        return (uint64(pass->getHash()) << 32) | passBits;
+    }
+    //-----------------------------------------------------------------------
+    uint64 QueuedRenderableCollection::buildDepthKey(const RenderablePass& rp, const Camera* cam)
+    {
+        // Map the float to an unsigned integer with the same ordering, then flip
+        // it to sort DESCENDING by depth (i.e. far objects first)
+        union { float f; uint32 u; } depth;
+        depth.f = static_cast<float>(rp.renderable->getSquaredViewDepth(cam));
+        uint32 depthBits = (depth.u & 0x80000000) ? ~depth.u : (depth.u | 0x80000000);
+
+        // Same depth, sort by pass hash
+        return (uint64(~depthBits) << 32) | rp.pass->getHash();
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::sortByKey(SortedRenderablePassList& list)
+    {
+        // The radix sort is O(kN) with up to 8 byte passes plus the histogram
+        // pass, but skips bytes which are equal for all keys. stable_sort wins for
+        // small lists; take a stab at 2000 items like before.
+        if (list.size() > 2000)
+            msRadixSorter.sort(list, RadixSortFunctorKey());
+        else
+            std::stable_sort(list.begin(), list.end(), KeyLess());
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::sort(const Camera* cam)
     {
+        if (mOrganisationMode & OM_PASS_GROUP)
+        {
+            for (SortedRenderablePassList::iterator i = mGrouped.begin(); i != mGrouped.end(); ++i)
+                i->key = buildGroupKey(i->rp.pass);
+            sortByKey(mGrouped);
+        }
+
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
         if (mOrganisationMode & OM_SORT_DESCENDING)
         {
-            
-            // We can either use a stable_sort and the 'less' implementation,
-            // or a 2-pass radix sort (once by pass, then by distance, since
-            // radix sorting is inherently stable this will work)
-            // We use stable_sort if the number of items is 512 or less, since
-            // the complexity of the radix sort is approximately O(10N), since 
-            // each sort is O(5N) (1 pass histograms, 4 passes sort)
-            // Since stable_sort has a worst-case performance of O(N(logN)^2)
-            // the performance tipping point is from about 1500 items, but in
-            // stable_sorts best-case scenario O(NlogN) it would be much higher.
-            // Take a stab at 2000 items.
-            
-            if (mSortedDescending.size() > 2000)
-            {
-                // sort by pass
-                msRadixSorter1.sort(mSortedDescending, RadixSortFunctorPass());
-                // sort by depth
-                msRadixSorter2.sort(mSortedDescending, RadixSortFunctorDistance(cam));
-            }
-            else
-            {
-                std::stable_sort(
-                    mSortedDescending.begin(), mSortedDescending.end(), 
-                    DepthSortDescendingLess(cam));
-            }
+            for (SortedRenderablePassList::iterator i = mSortedDescending.begin();
+                 i != mSortedDescending.end(); ++i)
+                i->key = buildDepthKey(i->rp, cam);
+            sortByKey(mSortedDescending);
         }
-
-        // Nothing needs to be done for pass groups, they auto-organise
-
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
     {
-        // ascending and descending sort both set bit 1
+        // Keys are built on sort, once pass hashes are final
         if (mOrganisationMode & OM_SORT_DESCENDING)
         {
-            mSortedDescending.push_back(RenderablePass(rend, pass));
+            mSortedDescending.push_back(SortedRenderablePass(rend, pass));
         }
 
         if (mOrganisationMode & OM_PASS_GROUP)
         {
-            PassGroupRenderableMap::iterator i = mGrouped.find(pass);
-            if (i == mGrouped.end())
-            {
-                std::pair<PassGroupRenderableMap::iterator, bool> retPair;
-                // Create new pass entry, build a new list
-                // Note that this pass and list are never destroyed until the 
-                // engine shuts down, or a pass is destroyed or has it's hash
-                // recalculated, although the lists will be cleared
-                retPair = mGrouped.insert(
-                    PassGroupRenderableMap::value_type(pass, RenderableList()));
-                assert(retPair.second && 
-                    "Error inserting new pass entry into PassGroupRenderableMap");
-                i = retPair.first;
-            }
-            // Insert renderable
-            i->second.push_back(rend);
-            
+            mGrouped.push_back(SortedRenderablePass(rend, pass));
         }
-        
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::acceptVisitor(
@@ -409,28 +413,29 @@ namespace Ogre {
     void QueuedRenderableCollection::acceptVisitorGrouped(
         QueuedRenderableVisitor* visitor) const
     {
-        PassGroupRenderableMap::const_iterator ipass, ipassend;
-        ipassend = mGrouped.end();
-        for (ipass = mGrouped.begin(); ipass != ipassend; ++ipass)
+        // Entries are sorted by pass, hand each run over as one group
+        SortedRenderablePassList::const_iterator i = mGrouped.begin(), iend = mGrouped.end();
+        while (i != iend)
         {
-            // Fast bypass if this group is now empty
-            if (ipass->second.empty()) continue;
-
-            visitor->visit(ipass->first, const_cast<RenderableList&>(ipass->second));
-        } 
+            Pass* pass = i->rp.pass;
+            mGroupScratch.clear();
+            for (; i != iend && i->rp.pass == pass; ++i)
+                mGroupScratch.push_back(i->rp.renderable);
 
+            visitor->visit(pass, mGroupScratch);
+        }
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::acceptVisitorDescending(
         QueuedRenderableVisitor* visitor) const
     {
         // List is already in descending order, so iterate forward
-        RenderablePassList::const_iterator i, iend;
+        SortedRenderablePassList::const_iterator i, iend;
 
         iend = mSortedDescending.end();
         for (i = mSortedDescending.begin(); i != iend; ++i)
         {
-            visitor->visit(const_cast<RenderablePass*>(&(*i)));
+            visitor->visit(const_cast<RenderablePass*>(&i->rp));
         }
     }
     //-----------------------------------------------------------------------
@@ -438,12 +443,12 @@ namespace Ogre {
         QueuedRenderableVisitor* visitor) const
     {
         // List is in descending order, so iterate in reverse
-        RenderablePassList::const_reverse_iterator i, iend;
+        SortedRenderablePassList::const_reverse_iterator i, iend;
 
         iend = mSortedDescending.rend();
         for (i = mSortedDescending.rbegin(); i != iend; ++i)
         {
-            visitor->visit(const_cast<RenderablePass*>(&(*i)));
+            visitor->visit(const_cast<RenderablePass*>(&i->rp));
         }
 
     }
@@ -451,30 +456,8 @@ namespace Ogre {
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
-
-        PassGroupRenderableMap::const_iterator srcGroup;
-        for( srcGroup = rhs.mGrouped.begin(); srcGroup != rhs.mGrouped.end(); ++srcGroup )
-        {
-            PassGroupRenderableMap::iterator dstGroup = mGrouped.find( srcGroup->first );
-            if (dstGroup == mGrouped.end())
-            {
-                std::pair<PassGroupRenderableMap::iterator, bool> retPair;
-                // Create new pass entry, build a new list
-                // Note that this pass and list are never destroyed until the 
-                // engine shuts down, or a pass is destroyed or has it's hash
-                // recalculated, although the lists will be cleared
-                retPair = mGrouped.insert(
-                    PassGroupRenderableMap::value_type(srcGroup->first, RenderableList()));
-                assert(retPair.second && 
-                    "Error inserting new pass entry into PassGroupRenderableMap");
-                dstGroup = retPair.first;
-            }
-
-            // Insert renderable
-            dstGroup->second.insert( dstGroup->second.end(), srcGroup->second.begin(), srcGroup->second.end() );
-        }
+        mGrouped.insert( mGrouped.end(), rhs.mGrouped.begin(), rhs.mGrouped.end() );
     }
 
 
 }
-
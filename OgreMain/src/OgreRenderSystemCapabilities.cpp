@@ -246,6 +246,9 @@ namespace Ogre {
         pLog->logMessage(
             " * Wide Lines: "
             + StringConverter::toString(hasCapability(RSC_WIDE_LINES), true));
+        pLog->logMessage(
+            " * Shared parameter buffers: "
+            + StringConverter::toString(hasCapability(RSC_SHARED_PARAMETER_BUFFERS), true));
         pLog->logMessage(
             " * Hardware Gamma: "
             + StringConverter::toString(hasCapability(RSC_HW_GAMMA), true));
@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "OgreRenderTexture.h"
 #include "OgreLodListener.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreRenderCommandList.h"
 
 // This class implements the most basic scene manager
 
@@ -84,6 +85,13 @@ mLightsDirtyCounter(0),
 mMovableNameGenerator("Ogre/MO"),
 mShadowRenderer(this),
 mDisplayNodes(false),
+mParallelSceneGraphUpdate(false),
+mConcurrentCulling(false),
+mSceneGraphVersion(0),
+mParallelRenderQueueBuild(false),
+mParallelAnimationUpdate(false),
+mRenderCommandList(0),
+mActiveCommandList(0),
 mShowBoundingBoxes(false),
 mActiveCompositorChain(0),
 mLateMaterialResolving(false),
@@ -102,6 +110,7 @@ mLastLightLimit(0),
 mGpuParamsDirty((uint16)GPV_ALL)
 {
     mShadowCasterQueryListener.reset(new ShadowCasterSceneQueryListener(this));
+    mQueryBroadphase.owner = this;
 
     Root *root = Root::getSingletonPtr();
     if (root)
@@ -124,6 +133,8 @@ SceneManager::~SceneManager()
     mShadowRenderer.destroyShadowTextures();
     clearScene();
     destroyAllCameras();
+    // the root node is destroyed after the broadphase
+    mQueryBroadphase.clearMovedNodes();
 
     // clear down movable object collection map
     {
@@ -134,6 +145,7 @@ SceneManager::~SceneManager()
             OGRE_DELETE_T(i->second, MovableObjectCollection, MEMCATEGORY_SCENE_CONTROL);
         }
         mMovableObjectCollectionMap.clear();
+        mMovableObjectCollectionList.clear();
     }
 }
 //-----------------------------------------------------------------------
@@ -259,6 +271,7 @@ void SceneManager::destroyCamera(const String& name)
         CamVisibleObjectsMap::iterator camVisObjIt = mCamVisibleObjectsMap.find( i->second );
         if ( camVisObjIt != mCamVisibleObjectsMap.end() )
             mCamVisibleObjectsMap.erase( camVisObjIt );
+        mCulledNodes.erase(i->second);
 
         // Remove light-shadow cam mapping entry
         auto camLightIt = mShadowRenderer.mShadowCamLightMapping.find( i->second );
@@ -353,9 +366,6 @@ bool SceneManager::lightLess::operator()(const Light* a, const Light* b) const
 void SceneManager::_populateLightList(const Vector3& position, Real radius, 
                                       LightList& destList, uint32 lightMask)
 {
-    // Really basic trawl of the lights, then sort
-    // Subclasses could do something smarter
-
     // Pick up the lights that affecting frustum only, which should has been
     // cached, so better than take all lights in the scene into account.
     const LightList& candidateLights = _getLightsAffectingFrustum();
@@ -364,29 +374,56 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
     destList.clear();
     destList.reserve(candidateLights.size());
 
-    LightList::const_iterator it;
-    for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
+    Sphere sphere(position, radius);
+    if (candidateLights.size() >= LightClusterGrid::MIN_LIGHTS)
     {
-        Light* lt = *it;
-        // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
-        if(!(lt->getLightMask() & lightMask))
-            continue; //skip this light
-
-        // Calc squared distance
-        lt->_calcTempSquareDist(position);
+        if (!mLightClusterGrid.valid || mLightClusterGrid.lightsDirtyCounter != mLightsDirtyCounter ||
+            mLightClusterGrid.numLights != candidateLights.size())
+        {
+            mLightClusterGrid.build(candidateLights);
+            mLightClusterGrid.lightsDirtyCounter = mLightsDirtyCounter;
+        }
 
-        if (lt->getType() == Light::LT_DIRECTIONAL)
+        // only test the lights sharing a cell with the sphere, in the original order
+        mLightClusterGrid.query(sphere, mLightClusterIndices);
+        for (size_t i = 0; i < mLightClusterIndices.size(); ++i)
         {
-            // Always included
-            destList.push_back(lt);
+            Light* lt = candidateLights[mLightClusterIndices[i]];
+            if (!(lt->getLightMask() & lightMask))
+                continue;
+
+            lt->_calcTempSquareDist(position);
+            // directional lights are always in range
+            if (lt->isInLightRange(sphere))
+                destList.push_back(lt);
         }
-        else
+    }
+    else
+    {
+        LightList::const_iterator it;
+        for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
         {
-            // only add in-range lights
-            if (lt->isInLightRange(Sphere(position,radius)))
+            Light* lt = *it;
+            // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
+            if(!(lt->getLightMask() & lightMask))
+                continue; //skip this light
+
+            // Calc squared distance
+            lt->_calcTempSquareDist(position);
+
+            if (lt->getType() == Light::LT_DIRECTIONAL)
             {
+                // Always included
                 destList.push_back(lt);
             }
+            else
+            {
+                // only add in-range lights
+                if (lt->isInLightRange(sphere))
+                {
+                    destList.push_back(lt);
+                }
+            }
         }
     }
 
@@ -918,10 +955,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     else
     {
         // Unbind program?
-        if (mDestRenderSystem->isGpuProgramBound(GPT_VERTEX_PROGRAM))
-        {
-            mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
-        }
+        unbindGpuProgram(GPT_VERTEX_PROGRAM);
         // Set fixed-function vertex parameters
     }
 
@@ -933,10 +967,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     else
     {
         // Unbind program?
-        if (mDestRenderSystem->isGpuProgramBound(GPT_GEOMETRY_PROGRAM))
-        {
-            mDestRenderSystem->unbindGpuProgram(GPT_GEOMETRY_PROGRAM);
-        }
+        unbindGpuProgram(GPT_GEOMETRY_PROGRAM);
     }
     if (pass->hasTessellationHullProgram())
     {
@@ -946,10 +977,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     else
     {
         // Unbind program?
-        if (mDestRenderSystem->isGpuProgramBound(GPT_HULL_PROGRAM))
-        {
-            mDestRenderSystem->unbindGpuProgram(GPT_HULL_PROGRAM);
-        }
+        unbindGpuProgram(GPT_HULL_PROGRAM);
     }
 
     if (pass->hasTessellationDomainProgram())
@@ -960,10 +988,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     else
     {
         // Unbind program?
-        if (mDestRenderSystem->isGpuProgramBound(GPT_DOMAIN_PROGRAM))
-        {
-            mDestRenderSystem->unbindGpuProgram(GPT_DOMAIN_PROGRAM);
-        }
+        unbindGpuProgram(GPT_DOMAIN_PROGRAM);
     }
 
     if (pass->hasComputeProgram())
@@ -974,16 +999,18 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     else
     {
         // Unbind program?
-        if (mDestRenderSystem->isGpuProgramBound(GPT_COMPUTE_PROGRAM))
-        {
-            mDestRenderSystem->unbindGpuProgram(GPT_COMPUTE_PROGRAM);
-        }
+        unbindGpuProgram(GPT_COMPUTE_PROGRAM);
     }
 
     if (passSurfaceAndLightParams)
     {
         // Set surface reflectance properties, only valid if lighting is enabled
-        if (pass->getLightingEnabled())
+        if (pass->getLightingEnabled() &&
+            mRenderStateCache.update(mRenderStateCache.surfaceParams,
+                                     std::make_tuple(pass->getAmbient(), pass->getDiffuse(),
+                                                     pass->getSpecular(), pass->getSelfIllumination(),
+                                                     pass->getShininess(),
+                                                     pass->getVertexColourTracking())))
         {
             mDestRenderSystem->_setSurfaceParams(
                 pass->getAmbient(),
@@ -995,7 +1022,8 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         }
 
         // Dynamic lighting enabled?
-        mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
+        if (mRenderStateCache.update(mRenderStateCache.lightingEnabled, pass->getLightingEnabled()))
+            mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
     }
 
     // Using a fragment program?
@@ -1016,10 +1044,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     else
     {
         // Unbind program?
-        if (mDestRenderSystem->isGpuProgramBound(GPT_FRAGMENT_PROGRAM))
-        {
-            mDestRenderSystem->unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
-        }
+        unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
         // Set fixed-function fragment settings
     }
 
@@ -1046,35 +1071,52 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 
     if (passFogParams)
     {
-        mDestRenderSystem->_setFog(newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
+        if (mRenderStateCache.update(mRenderStateCache.fog,
+                                     std::make_tuple(newFogMode, newFogColour, newFogDensity,
+                                                     newFogStart, newFogEnd)))
+            mDestRenderSystem->_setFog(newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
     }
     else
     {
         // In D3D9, it applies to shaders prior to version vs_3_0 and ps_3_0.
-        mDestRenderSystem->_setFog(FOG_NONE);
+        if (mRenderStateCache.update(mRenderStateCache.fog,
+                                     std::make_tuple(FOG_NONE, ColourValue::White, Real(1), Real(0),
+                                                     Real(1))))
+            mDestRenderSystem->_setFog(FOG_NONE);
     }
     mAutoParamDataSource->setFog(newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
 
     // The rest of the settings are the same no matter whether we use programs or not
 
     // Set scene blending
-    mDestRenderSystem->setColourBlendState(pass->getBlendState());
+    if (mRenderStateCache.update(mRenderStateCache.blendState, pass->getBlendState()))
+        mDestRenderSystem->setColourBlendState(pass->getBlendState());
 
     // Line width
-    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_WIDE_LINES))
+    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_WIDE_LINES) &&
+        mRenderStateCache.update(mRenderStateCache.lineWidth, pass->getLineWidth()))
         mDestRenderSystem->_setLineWidth(pass->getLineWidth());
 
     // Set point parameters
-    mDestRenderSystem->_setPointParameters(
-        pass->getPointSize(),
-        pass->isPointAttenuationEnabled(),
-        pass->getPointAttenuationConstant(),
-        pass->getPointAttenuationLinear(),
-        pass->getPointAttenuationQuadratic(),
-        pass->getPointMinSize(),
-        pass->getPointMaxSize());
-
-    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_POINT_SPRITES))
+    if (mRenderStateCache.update(mRenderStateCache.pointParams,
+                                 std::make_tuple(pass->getPointSize(), pass->isPointAttenuationEnabled(),
+                                                 pass->getPointAttenuationConstant(),
+                                                 pass->getPointAttenuationLinear(),
+                                                 pass->getPointAttenuationQuadratic(),
+                                                 pass->getPointMinSize(), pass->getPointMaxSize())))
+    {
+        mDestRenderSystem->_setPointParameters(
+            pass->getPointSize(),
+            pass->isPointAttenuationEnabled(),
+            pass->getPointAttenuationConstant(),
+            pass->getPointAttenuationLinear(),
+            pass->getPointAttenuationQuadratic(),
+            pass->getPointMinSize(),
+            pass->getPointMaxSize());
+    }
+
+    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_POINT_SPRITES) &&
+        mRenderStateCache.update(mRenderStateCache.pointSprites, pass->getPointSpritesEnabled()))
         mDestRenderSystem->_setPointSpritesEnabled(pass->getPointSpritesEnabled());
 
     mAutoParamDataSource->setPointParameters(
@@ -1176,14 +1218,26 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 
     // Set up non-texture related material settings
     // Depth buffer settings
-    mDestRenderSystem->_setDepthBufferFunction(pass->getDepthFunction());
-    mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
-    mDestRenderSystem->_setDepthBufferWriteEnabled(pass->getDepthWriteEnabled());
-    mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), pass->getDepthBiasSlopeScale());
+    if (mRenderStateCache.update(mRenderStateCache.depthFunction, pass->getDepthFunction()))
+        mDestRenderSystem->_setDepthBufferFunction(pass->getDepthFunction());
+    if (mRenderStateCache.update(mRenderStateCache.depthCheck, pass->getDepthCheckEnabled()))
+        mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
+    if (mRenderStateCache.update(mRenderStateCache.depthWrite, pass->getDepthWriteEnabled()))
+        mDestRenderSystem->_setDepthBufferWriteEnabled(pass->getDepthWriteEnabled());
+    if (mRenderStateCache.update(mRenderStateCache.depthBias,
+                                 std::make_pair(pass->getDepthBiasConstant(),
+                                                pass->getDepthBiasSlopeScale())))
+        mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), pass->getDepthBiasSlopeScale());
     // Alpha-reject settings
-    mDestRenderSystem->_setAlphaRejectSettings(pass->getAlphaRejectFunction(),
-                                               pass->getAlphaRejectValue(),
-                                               pass->isAlphaToCoverageEnabled());
+    if (mRenderStateCache.update(mRenderStateCache.alphaReject,
+                                 std::make_tuple(pass->getAlphaRejectFunction(),
+                                                 pass->getAlphaRejectValue(),
+                                                 pass->isAlphaToCoverageEnabled())))
+    {
+        mDestRenderSystem->_setAlphaRejectSettings(pass->getAlphaRejectFunction(),
+                                                   pass->getAlphaRejectValue(),
+                                                   pass->isAlphaToCoverageEnabled());
+    }
 
     // Culling mode
     if (isShadowTechniqueTextureBased() && mIlluminationStage == IRS_RENDER_TO_TEXTURE &&
@@ -1196,14 +1250,26 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     {
         mPassCullingMode = pass->getCullingMode();
     }
-    mDestRenderSystem->_setCullingMode(mPassCullingMode);
-    mDestRenderSystem->setShadingType(pass->getShadingMode());
-    mDestRenderSystem->_setPolygonMode(pass->getPolygonMode());
+    if (mRenderStateCache.update(mRenderStateCache.cullingMode, mPassCullingMode))
+        mDestRenderSystem->_setCullingMode(mPassCullingMode);
+    if (mRenderStateCache.update(mRenderStateCache.shading, pass->getShadingMode()))
+        mDestRenderSystem->setShadingType(pass->getShadingMode());
+    if (mRenderStateCache.update(mRenderStateCache.polygonMode, pass->getPolygonMode()))
+        mDestRenderSystem->_setPolygonMode(pass->getPolygonMode());
 
     mAutoParamDataSource->setPassNumber( pass->getIndex() );
     // mark global params as dirty
     mGpuParamsDirty |= (uint16)GPV_GLOBAL;
 
+    if (mActiveCommandList)
+    {
+        if (passFogParams)
+            mActiveCommandList->setPass(pass, newFogMode, newFogColour, newFogDensity, newFogStart,
+                                        newFogEnd, mPassCullingMode);
+        else
+            mActiveCommandList->setPass(pass, FOG_NONE, ColourValue::White, 1, 0, 1, mPassCullingMode);
+    }
+
     return pass;
 }
 //-----------------------------------------------------------------------
@@ -1322,6 +1388,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     {
         // Update animations
         _applySceneAnimations();
+        if (mParallelAnimationUpdate)
+            updateAnimationsParallel();
         updateDirtyInstanceManagers();
         mLastFrameNumber = thisFrameNumber;
     }
@@ -1455,8 +1523,20 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     // Set rasterisation mode
     mDestRenderSystem->_setPolygonMode(camera->getPolygonMode());
 
+    // other scene managers or listeners may have changed the render state
+    _markRenderStateDirty();
+
+    // Record the main render, shadow textures are rendered separately
+    if (mRenderCommandList && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+    {
+        mActiveCommandList = mRenderCommandList;
+        mActiveCommandList->clear();
+    }
+
     // Set initial camera state
     mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
+    if (mActiveCommandList)
+        mActiveCommandList->setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
     
     mCachedViewMatrix = mCameraInProgress->getViewMatrix(true);
 
@@ -1474,6 +1554,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         OgreProfileGroup("_renderVisibleObjects", OGREPROF_RENDERING);
         _renderVisibleObjects();
     }
+    mActiveCommandList = 0;
 
     // End frame
     mDestRenderSystem->_endFrame();
@@ -1515,6 +1596,8 @@ void SceneManager::_releaseManualHardwareResources()
         OGRE_LOCK_MUTEX(coll->mutex);
         for(MovableObjectMap::iterator i = coll->map.begin(), i_end = coll->map.end(); i != i_end; ++i)
             i->second->_releaseManualHardwareResources();
+        for(MovableObjectList::iterator i = coll->anonymous.begin(); i != coll->anonymous.end(); ++i)
+            (*i)->_releaseManualHardwareResources();
     }
 }
 //-----------------------------------------------------------------------
@@ -1539,6 +1622,8 @@ void SceneManager::_restoreManualHardwareResources()
         OGRE_LOCK_MUTEX(coll->mutex);
         for(MovableObjectMap::iterator i = coll->map.begin(), i_end = coll->map.end(); i != i_end; ++i)
             i->second->_restoreManualHardwareResources();
+        for(MovableObjectList::iterator i = coll->anonymous.begin(); i != coll->anonymous.end(); ++i)
+            (*i)->_restoreManualHardwareResources();
     }
 }
 //-----------------------------------------------------------------------
@@ -1683,20 +1768,212 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    // nodes found visible before would be stale
+    if (getRootSceneNode()->_isUpdatePending(false))
+        ++mSceneGraphVersion;
+
+    if (mParallelSceneGraphUpdate && supportsParallelNodeUpdate())
+        updateSceneGraphParallel();
+    else
+        getRootSceneNode()->_update(true, false);
+
+    if (!mQueryBroadphase.movedNodes.empty())
+        mQueryBroadphase.update();
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphParallel(void)
+{
+    // aim for a few sub-trees per thread so uneven sub-trees balance out
+    size_t targetSubtrees = mWorkerJobs.getConcurrency() * 4;
+
+    mUpdatedUpperNodes.clear();
+    mPendingNodeUpdates.clear();
+    mPendingNodeUpdates.push_back(std::make_pair(getRootSceneNode(), false));
+
+    // update the top of the tree breadth first on this thread, until there are
+    // enough independent sub-trees. Parents are always updated before their children.
+    while (!mPendingNodeUpdates.empty() && mPendingNodeUpdates.size() < targetSubtrees)
+    {
+        mPendingNodeUpdatesNext.clear();
+        for (Node::PendingUpdateList::iterator i = mPendingNodeUpdates.begin();
+             i != mPendingNodeUpdates.end(); ++i)
+        {
+            // static sub-trees keep their bounds, see SceneNode::_update
+            if (i->first->_isUpdatePending(i->second))
+                mUpdatedUpperNodes.push_back(static_cast<SceneNode*>(i->first));
+            i->first->_updateSelf(i->second, mPendingNodeUpdatesNext);
+        }
+        std::swap(mPendingNodeUpdates, mPendingNodeUpdatesNext);
+    }
+
+    const Node::PendingUpdateList& subtrees = mPendingNodeUpdates;
+    mWorkerJobs.run(subtrees.size(), [&subtrees](size_t i) {
+        subtrees[i].first->_update(true, subtrees[i].second);
+    });
+
+    // the upper nodes were collected parent first, so merging the bounds in
+    // reverse order sees all children up to date, like SceneNode::_update does
+    for (std::vector<SceneNode*>::reverse_iterator i = mUpdatedUpperNodes.rbegin();
+         i != mUpdatedUpperNodes.rend(); ++i)
+    {
+        (*i)->_updateBounds();
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    // Use the nodes found by _cullCameras, if they are still valid
+    const std::vector<SceneNode*>* culledNodes = NULL;
+    CulledNodesMap::iterator culled = mCulledNodes.find(cam);
+    if (culled != mCulledNodes.end() && culled->second.pending)
+    {
+        culled->second.pending = false;
+        if (culled->second.isValidFor(cam, mSceneGraphVersion))
+            culledNodes = &culled->second.nodes;
+    }
+
+    // Splitting by illumination stage compiles the illumination passes on demand
+    bool splitByLightingType = isShadowTechniqueAdditive() && !isShadowTechniqueIntegrated();
+    if (mParallelRenderQueueBuild && !mDisplayNodes && !mShowBoundingBoxes && !splitByLightingType &&
+        mLodListeners.empty() && !getRenderQueue()->getRenderableListener())
+    {
+        if (!culledNodes)
+        {
+            mVisibleNodes.clear();
+            if (cam->isVisible(getRootSceneNode()->_getWorldAABB()))
+                getRootSceneNode()->collectVisibleNodes(cam, mVisibleNodes);
+            culledNodes = &mVisibleNodes;
+        }
+        findVisibleObjectsParallel(cam, *culledNodes, visibleBounds, onlyShadowCasters);
+        return;
+    }
+
+    if (culledNodes)
+    {
+        for (std::vector<SceneNode*>::const_iterator i = culledNodes->begin();
+             i != culledNodes->end(); ++i)
+        {
+            (*i)->addVisibleObjects(cam, getRenderQueue(), visibleBounds, false,
+                mDisplayNodes, onlyShadowCasters);
+        }
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
 
 }
 //-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsParallel(Camera* cam, const std::vector<SceneNode*>& nodes,
+    VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    // Fixed size blocks, so the merged queue is the same for any number of threads
+    const size_t NODES_PER_CHUNK = 64;
+    size_t chunkCount = (nodes.size() + NODES_PER_CHUNK - 1) / NODES_PER_CHUNK;
+    if (mRenderQueueChunks.size() < chunkCount)
+        mRenderQueueChunks.resize(chunkCount);
+
+    RenderQueue* queue = getRenderQueue();
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        RenderQueueChunk& chunk = mRenderQueueChunks[i];
+        if (!chunk.queue)
+            chunk.queue.reset(OGRE_NEW RenderQueue());
+        chunk.queue->_prepareThreadLocal(queue, &chunk.deferredObjects);
+        chunk.bounds.reset();
+        chunk.deferredObjects.clear();
+        chunk.deferredNodes.clear();
+    }
+
+    // bring the cached camera state up to date here, the jobs only read it
+    cam->getViewMatrix(true);
+    cam->getLodCamera()->getDerivedPosition();
+
+    std::vector<RenderQueueChunk>& chunks = mRenderQueueChunks;
+    mWorkerJobs.run(chunkCount, [&](size_t i) {
+        RenderQueueChunk& chunk = chunks[i];
+        size_t end = std::min(nodes.size(), (i + 1) * NODES_PER_CHUNK);
+        for (size_t n = i * NODES_PER_CHUNK; n < end; ++n)
+        {
+            if (nodes[n]->getShowBoundingBox())
+                chunk.deferredNodes.push_back(nodes[n]);
+            else
+                nodes[n]->addVisibleObjects(cam, chunk.queue.get(), visibleBounds ? &chunk.bounds : NULL,
+                    false, false, onlyShadowCasters);
+        }
+    });
+
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        RenderQueueChunk& chunk = chunks[i];
+        queue->merge(chunk.queue.get());
+        if (visibleBounds)
+            visibleBounds->merge(chunk.bounds);
+
+        std::vector<MovableObject*>::const_iterator o;
+        for (o = chunk.deferredObjects.begin(); o != chunk.deferredObjects.end(); ++o)
+            queue->processVisibleObject(*o, cam, onlyShadowCasters, visibleBounds);
+
+        std::vector<SceneNode*>::const_iterator n;
+        for (n = chunk.deferredNodes.begin(); n != chunk.deferredNodes.end(); ++n)
+            (*n)->addVisibleObjects(cam, queue, visibleBounds, false, false, onlyShadowCasters);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_cullCameras(Camera* const* cameras, size_t count)
+{
+    if (!mConcurrentCulling)
+        return;
+
+    // prepare the entries and camera planes here, the jobs only read them
+    std::vector<CulledNodes*> entries(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        entries[i] = &mCulledNodes[cameras[i]];
+        entries[i]->capture(cameras[i], mSceneGraphVersion);
+        entries[i]->nodes.clear();
+    }
+
+    SceneNode* root = getRootSceneNode();
+    mWorkerJobs.run(count, [cameras, &entries, root](size_t i) {
+        if (cameras[i]->isVisible(root->_getWorldAABB()))
+            root->collectVisibleNodes(cameras[i], entries[i]->nodes);
+    });
+
+    for (size_t i = 0; i < count; ++i)
+        entries[i]->pending = true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::CulledNodes::capture(const Camera* cam, uint32 version)
+{
+    for (unsigned short i = 0; i < 6; ++i)
+        planes[i] = cam->getFrustumPlane(i);
+    const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+    farDistance = frustum->getFarClipDistance();
+    sceneGraphVersion = version;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::CulledNodes::isValidFor(const Camera* cam, uint32 version) const
+{
+    if (version != sceneGraphVersion)
+        return false;
+
+    const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+    if (frustum->getFarClipDistance() != farDistance)
+        return false;
+
+    for (unsigned short i = 0; i < 6; ++i)
+    {
+        if (cam->getFrustumPlane(i) != planes[i])
+            return false;
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
 void SceneManager::_renderVisibleObjects(void)
 {
     RenderQueueInvocationSequence* invocationSequence = 
@@ -1990,6 +2267,8 @@ void SceneManager::setWorldTransform(Renderable* rend, bool fixedFunction)
     if (fixedFunction)
     {
         mDestRenderSystem->_setWorldMatrix(mAutoParamDataSource->getWorldMatrix());
+        if (mActiveCommandList)
+            mActiveCommandList->setWorldMatrix(mAutoParamDataSource->getWorldMatrix());
     }
 
     // Issue view / projection changes if any
@@ -2021,6 +2300,9 @@ void SceneManager::issueRenderWithLights(Renderable* rend, const Pass* pass,
         if (pLightListToUse->empty())
             return;
 
+        if (mActiveCommandList)
+            mActiveCommandList->_markIncomplete();
+
         if (pass->getLightScissoringEnabled())
             scissored = buildAndSetScissor(*pLightListToUse, mCameraInProgress);
 
@@ -2082,6 +2364,8 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
         if (pTex->hasViewRelativeTextureCoordinateGeneration())
         {
             mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
+            if (mActiveCommandList)
+                mActiveCommandList->_markIncomplete();
         }
         ++unit;
     }
@@ -2089,11 +2373,10 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
     // Sort out normalisation
     // Assume first world matrix representative - shaders that use multiple
     // matrices should control renormalisation themselves
-    if ((pass->getNormaliseNormals() || mNormaliseNormalsOnScale) &&
-        mAutoParamDataSource->getWorldMatrix().linear().hasScale())
-        mDestRenderSystem->setNormaliseNormals(true);
-    else
-        mDestRenderSystem->setNormaliseNormals(false);
+    bool normaliseNormals = (pass->getNormaliseNormals() || mNormaliseNormalsOnScale) &&
+                            mAutoParamDataSource->getWorldMatrix().linear().hasScale();
+    if (mRenderStateCache.update(mRenderStateCache.normaliseNormals, normaliseNormals))
+        mDestRenderSystem->setNormaliseNormals(normaliseNormals);
 
     // Sort out negative scaling
     // Assume first world matrix representative
@@ -2119,7 +2402,10 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
         // this also copes with returning from negative scale in previous render op
         // for same pass
         if (cullMode != mDestRenderSystem->_getCullingMode())
+        {
             mDestRenderSystem->_setCullingMode(cullMode);
+            mRenderStateCache.store(mRenderStateCache.cullingMode, cullMode);
+        }
     }
 
     // Set up the solid / wireframe override
@@ -2136,7 +2422,12 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
             reqMode = camPolyMode;
         }
     }
-    mDestRenderSystem->_setPolygonMode(reqMode);
+    if (mRenderStateCache.update(mRenderStateCache.polygonMode, reqMode))
+        mDestRenderSystem->_setPolygonMode(reqMode);
+
+    if (mActiveCommandList)
+        mActiveCommandList->setObjectState(mDestRenderSystem->_getCullingMode(), reqMode,
+                                           normaliseNormals);
 
     if (!doLightIteration)
     {
@@ -2236,6 +2527,8 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                     // Have to set TU on rendersystem right now, although
                     // autoparams will be set later
                     mDestRenderSystem->_setTextureUnitSettings(tuindex, *tu);
+                    if (mActiveCommandList)
+                        mActiveCommandList->_markIncomplete();
                 }
             }
             // Did we run out of lights before slots? e.g. 5 lights, 2 per iteration
@@ -2314,6 +2607,11 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
             mDestRenderSystem->setDeriveDepthBias(true,
                 depthBiasBase, pass->getIterationDepthBias(),
                 pass->getDepthBiasSlopeScale());
+            // which changes the bias per iteration, so the cached one is unknown
+            mRenderStateCache.invalidate(mRenderStateCache.depthBias);
+
+            if (mActiveCommandList)
+                mActiveCommandList->_markIncomplete();
         }
         else
         {
@@ -2570,11 +2868,42 @@ void SceneManager::_applySceneAnimations(void)
     }
 }
 //---------------------------------------------------------------------
+void SceneManager::updateAnimationsParallel(void)
+{
+    MovableObjectCollection* entities =
+        getMovableObjectCollection(EntityFactory::FACTORY_TYPE_NAME);
+
+    mAnimatedEntities.clear();
+    {
+        OGRE_LOCK_MUTEX(entities->mutex);
+
+        // the shared animation data is built here, so the workers only write to their entity
+        MovableObjectCollectionIterator it(*entities);
+        while(it.hasMoreElements())
+        {
+            Entity* ent = static_cast<Entity*>(it.getNext());
+            if (ent->isInScene() && ent->_prepareBoneMatricesUpdate())
+                mAnimatedEntities.push_back(ent);
+        }
+    }
+
+    // a few entities per job, a single skeleton is too little work to be worth a job
+    const size_t ENTITIES_PER_JOB = 8;
+    const std::vector<Entity*>& animated = mAnimatedEntities;
+    size_t jobCount = (animated.size() + ENTITIES_PER_JOB - 1) / ENTITIES_PER_JOB;
+    mWorkerJobs.run(jobCount, [&animated](size_t job) {
+        size_t end = std::min(animated.size(), (job + 1) * ENTITIES_PER_JOB);
+        for (size_t i = job * ENTITIES_PER_JOB; i < end; ++i)
+            animated[i]->_updateBoneMatrices();
+    });
+}
+//---------------------------------------------------------------------
 void SceneManager::manualRender(RenderOperation* rend, 
                                 Pass* pass, Viewport* vp, const Affine3& worldMatrix,
                                 const Affine3& viewMatrix, const Matrix4& projMatrix,
                                 bool doBeginEndFrame) 
 {
+    _markRenderStateDirty();
     if (vp)
         setViewport(vp);
 
@@ -2614,6 +2943,7 @@ void SceneManager::manualRender(Renderable* rend, const Pass* pass, Viewport* vp
     const Matrix4& projMatrix,bool doBeginEndFrame,
     bool lightScissoringClipping, bool doLightIteration, const LightList* manualLightList)
 {
+    _markRenderStateDirty();
     if (vp)
         setViewport(vp);
 
@@ -2673,6 +3003,8 @@ void SceneManager::useRenderableViewProjMode(const Renderable* pRend, bool fixed
             Matrix4 mat;
             mDestRenderSystem->_convertProjectionMatrix(Matrix4::IDENTITY, mat);
             mDestRenderSystem->_setProjectionMatrix(mat);
+            if (mActiveCommandList)
+                mActiveCommandList->setProjectionMatrix(mat);
         }
         mGpuParamsDirty |= (uint16)GPV_GLOBAL;
 
@@ -2698,7 +3030,11 @@ void SceneManager::resetViewProjMode(bool fixedFunction)
     {
         // Coming back from flat projection
         if (fixedFunction)
+        {
             mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
+            if (mActiveCommandList)
+                mActiveCommandList->setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
+        }
         mGpuParamsDirty |= (uint16)GPV_GLOBAL;
 
         mResetIdentityProj = false;
@@ -3072,9 +3408,9 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
 
         // Pre-allocate memory
         mTestLightInfos.clear();
-        mTestLightInfos.reserve(lights->map.size());
+        mTestLightInfos.reserve(lights->map.size() + lights->anonymous.size());
 
-        MovableObjectIterator it(lights->map.begin(), lights->map.end());
+        MovableObjectCollectionIterator it(*lights);
 
         while(it.hasMoreElements())
         {
@@ -3782,6 +4118,7 @@ void SceneManager::_resumeRendering(SceneManager::RenderContext* context)
 
     // Set rasterisation mode
     mDestRenderSystem->_setPolygonMode(mCameraInProgress->getPolygonMode());
+    _markRenderStateDirty();
 
     // Set initial camera state
     mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
@@ -4053,6 +4390,119 @@ void SceneManager::destroyQuery(SceneQuery* query)
     OGRE_DELETE query;
 }
 //---------------------------------------------------------------------
+void SceneManager::_findMovableObjectsIn(const AxisAlignedBox& box, std::vector<MovableObject*>& objects)
+{
+    mQueryBroadphase.find(box, objects);
+}
+//---------------------------------------------------------------------
+void SceneManager::_findMovableObjectsIn(const Sphere& sphere, std::vector<MovableObject*>& objects)
+{
+    mQueryBroadphase.find(sphere, objects);
+}
+//---------------------------------------------------------------------
+void SceneManager::_findMovableObjectsIn(const Ray& ray, std::vector<MovableObject*>& objects)
+{
+    mQueryBroadphase.find(ray, objects);
+}
+//---------------------------------------------------------------------
+void SceneManager::_findMovableObjectsIn(const PlaneBoundedVolume& volume, std::vector<MovableObject*>& objects)
+{
+    mQueryBroadphase.find(volume, objects);
+}
+//---------------------------------------------------------------------
+void SceneManager::_findMovableObjectsIn(const PlaneBoundedVolumeList& volumes, std::vector<MovableObject*>& objects)
+{
+    mQueryBroadphase.find(volumes, objects);
+}
+//---------------------------------------------------------------------
+void SceneManager::_notifyAttachmentChanged(MovableObject* m)
+{
+    if (!mQueryBroadphase.isTracked(m))
+        return;
+
+    // refreshed by the next scene graph update, objects of nodes of other managers are not tracked
+    SceneNode* node = m->isInScene() ? m->getParentSceneNode() : NULL;
+    if (node && node->getCreator() == this)
+        mQueryBroadphase.addMovedNode(node);
+    else
+        mQueryBroadphase.unlink(m);
+}
+//---------------------------------------------------------------------
+void SceneManager::_notifySceneGraphChanged(SceneNode* node)
+{
+    ++mSceneGraphVersion;
+
+    if (node->isInSceneGraph())
+    {
+        mQueryBroadphase.addMovedNode(node);
+        return;
+    }
+
+    // the children are notified on their own
+    const SceneNode::ObjectMap& objects = node->getAttachedObjects();
+    for (size_t i = 0; i < objects.size(); ++i)
+        mQueryBroadphase.unlink(objects[i]);
+}
+//---------------------------------------------------------------------
+void SceneManager::executeRayQueries(const Ray* rays, size_t numRays,
+                                     std::vector<RaySceneQueryResult>& results, uint32 mask,
+                                     uint32 typeMask)
+{
+    results.resize(numRays);
+    for (size_t i = 0; i < numRays; ++i)
+    {
+        RaySceneQueryResult& result = results[i];
+        result.clear();
+
+        _findMovableObjectsIn(rays[i], mQueryCandidates);
+        for (size_t j = 0; j < mQueryCandidates.size(); ++j)
+        {
+            MovableObject* a = mQueryCandidates[j];
+            if (!(a->getTypeFlags() & typeMask) || !(a->getQueryFlags() & mask) || !a->isInScene())
+                continue;
+
+            std::pair<bool, Real> hit = rays[i].intersects(a->getWorldBoundingBox());
+            if (hit.first)
+            {
+                RaySceneQueryResultEntry entry;
+                entry.distance = hit.second;
+                entry.movable = a;
+                entry.worldFragment = 0;
+                result.push_back(entry);
+            }
+        }
+        std::sort(result.begin(), result.end());
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::executeSphereQueries(const Sphere* spheres, size_t numSpheres,
+                                        std::vector<SceneQueryResultMovableList>& results,
+                                        uint32 mask, uint32 typeMask)
+{
+    Sphere testSphere;
+
+    results.resize(numSpheres);
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        SceneQueryResultMovableList& result = results[i];
+        result.clear();
+
+        _findMovableObjectsIn(spheres[i], mQueryCandidates);
+        for (size_t j = 0; j < mQueryCandidates.size(); ++j)
+        {
+            MovableObject* a = mQueryCandidates[j];
+            if (!(a->getTypeFlags() & typeMask) || !(a->getQueryFlags() & mask) || !a->isInScene())
+                continue;
+
+            // Do sphere / sphere test, like DefaultSphereSceneQuery
+            testSphere.setCenter(a->getParentNode()->_getDerivedPosition());
+            testSphere.setRadius(a->getBoundingRadius());
+            if (spheres[i].intersects(testSphere))
+                result.push_back(a);
+        }
+    }
+}
+//---------------------------------------------------------------------
 SceneManager::MovableObjectCollection* 
 SceneManager::getMovableObjectCollection(const String& typeName)
 {
@@ -4064,8 +4514,10 @@ SceneManager::getMovableObjectCollection(const String& typeName)
     if (i == mMovableObjectCollectionMap.end())
     {
         // create
-        MovableObjectCollection* newCollection = OGRE_NEW_T(MovableObjectCollection, MEMCATEGORY_SCENE_CONTROL)();
+        MovableObjectCollection* newCollection = OGRE_NEW_T(MovableObjectCollection, MEMCATEGORY_SCENE_CONTROL)(
+            static_cast<uint32>(mMovableObjectCollectionList.size()));
         mMovableObjectCollectionMap[typeName] = newCollection;
+        mMovableObjectCollectionList.push_back(newCollection);
         return newCollection;
     }
     else
@@ -4120,6 +4572,7 @@ MovableObject* SceneManager::createMovableObject(const String& name,
 
         MovableObject* newObj = factory->createInstance(name, this, params);
         objectMap->map[name] = newObj;
+        mQueryBroadphase.add(newObj);
         return newObj;
     }
 
@@ -4131,6 +4584,24 @@ MovableObject* SceneManager::createMovableObject(const String& typeName, const N
     return createMovableObject(name, typeName, params);
 }
 //---------------------------------------------------------------------
+SceneManager::MovableObjectHandle SceneManager::createMovableObjectHandle(const String& typeName,
+                                                                          const NameValuePairList* params)
+{
+    if (typeName == "Camera")
+    {
+        OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Cameras must be named",
+                    "SceneManager::createMovableObjectHandle");
+    }
+    MovableObjectFactory* factory =
+        Root::getSingleton().getMovableObjectFactory(typeName);
+    MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
+
+    OGRE_LOCK_MUTEX(objectMap->mutex);
+    MovableObject* newObj = factory->createInstance(BLANKSTRING, this, params);
+    mQueryBroadphase.add(newObj);
+    return objectMap->addAnonymous(newObj);
+}
+//---------------------------------------------------------------------
 void SceneManager::destroyMovableObject(const String& name, const String& typeName)
 {
     // Nasty hack to make generalised Camera functions work without breaking add-on SMs
@@ -4155,6 +4626,24 @@ void SceneManager::destroyMovableObject(const String& name, const String& typeNa
     }
 }
 //---------------------------------------------------------------------
+void SceneManager::destroyMovableObject(const MovableObjectHandle& handle)
+{
+    MovableObjectCollection* objectMap;
+    {
+            OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex);
+        if (handle.type >= mMovableObjectCollectionList.size())
+            return;
+        objectMap = mMovableObjectCollectionList[handle.type];
+    }
+
+    OGRE_LOCK_MUTEX(objectMap->mutex);
+    if (MovableObject* m = objectMap->getAnonymous(handle))
+    {
+        objectMap->removeAnonymous(objectMap->slots[handle.index].position);
+        m->_getCreator()->destroyInstance(m);
+    }
+}
+//---------------------------------------------------------------------
 void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
 {
     // Nasty hack to make generalised Camera functions work without breaking add-on SMs
@@ -4179,6 +4668,12 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
             }
         }
         objectMap->map.clear();
+
+        for (MovableObjectList::iterator j = objectMap->anonymous.begin(); j != objectMap->anonymous.end(); ++j)
+        {
+            factory->destroyInstance(*j);
+        }
+        objectMap->clearAnonymous();
     }
 }
 //---------------------------------------------------------------------
@@ -4209,8 +4704,13 @@ void SceneManager::destroyAllMovableObjects(void)
                     factory->destroyInstance(i->second);
                 }
             }
+            for (MovableObjectList::iterator j = coll->anonymous.begin(); j != coll->anonymous.end(); ++j)
+            {
+                factory->destroyInstance(*j);
+            }
         }
         coll->map.clear();
+        coll->clearAnonymous();
     }
 
 }
@@ -4239,6 +4739,20 @@ MovableObject* SceneManager::getMovableObject(const String& name, const String&
     
 }
 //-----------------------------------------------------------------------
+MovableObject* SceneManager::getMovableObject(const MovableObjectHandle& handle) const
+{
+    const MovableObjectCollection* objectMap;
+    {
+            OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex);
+        if (handle.type >= mMovableObjectCollectionList.size())
+            return NULL;
+        objectMap = mMovableObjectCollectionList[handle.type];
+    }
+
+    OGRE_LOCK_MUTEX(objectMap->mutex);
+    return objectMap->getAnonymous(handle);
+}
+//-----------------------------------------------------------------------
 bool SceneManager::hasMovableObject(const String& name, const String& typeName) const
 {
     // Nasty hack to make generalised Camera functions work without breaking add-on SMs
@@ -4268,11 +4782,31 @@ SceneManager::getMovableObjectIterator(const String& typeName)
     return MovableObjectIterator(objectMap->map.begin(), objectMap->map.end());
 }
 //---------------------------------------------------------------------
+SceneManager::MovableObjectCollectionIterator
+SceneManager::_getMovableObjectCollectionIterator(const String& typeName)
+{
+    return MovableObjectCollectionIterator(*getMovableObjectCollection(typeName));
+}
+//---------------------------------------------------------------------
 void SceneManager::destroyMovableObject(MovableObject* m)
 {
     if(!m)
         OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Cannot destroy a null MovableObject.", "SceneManager::destroyMovableObject");
 
+    if (m->getName().empty())
+    {
+        MovableObjectCollection* objectMap = getMovableObjectCollection(m->getMovableType());
+        OGRE_LOCK_MUTEX(objectMap->mutex);
+        MovableObjectList::iterator i =
+            std::find(objectMap->anonymous.begin(), objectMap->anonymous.end(), m);
+        if (i != objectMap->anonymous.end())
+        {
+            objectMap->removeAnonymous(i - objectMap->anonymous.begin());
+            m->_getCreator()->destroyInstance(m);
+            return;
+        }
+    }
+
     destroyMovableObject(m->getName(), m->getMovableType());
 }
 //---------------------------------------------------------------------
@@ -4284,6 +4818,14 @@ void SceneManager::injectMovableObject(MovableObject* m)
 
         objectMap->map[m->getName()] = m;
     }
+
+    // drop the proxy of the manager the object was extracted from
+    SceneManager* previous = m->_getManager();
+    if (previous && previous != this)
+        previous->_removeFromQueryBroadphase(m);
+    m->_notifyManager(this);
+    mQueryBroadphase.add(m);
+    _notifyAttachmentChanged(m);
 }
 //---------------------------------------------------------------------
 void SceneManager::extractMovableObject(const String& name, const String& typeName)
@@ -4295,6 +4837,7 @@ void SceneManager::extractMovableObject(const String& name, const String& typeNa
         if (mi != objectMap->map.end())
         {
             // no delete
+            releaseMovableObject(mi->second);
             objectMap->map.erase(mi);
         }
     }
@@ -4303,6 +4846,20 @@ void SceneManager::extractMovableObject(const String& name, const String& typeNa
 //---------------------------------------------------------------------
 void SceneManager::extractMovableObject(MovableObject* m)
 {
+    if (m->getName().empty())
+    {
+        MovableObjectCollection* objectMap = getMovableObjectCollection(m->getMovableType());
+        OGRE_LOCK_MUTEX(objectMap->mutex);
+        MovableObjectList::iterator i =
+            std::find(objectMap->anonymous.begin(), objectMap->anonymous.end(), m);
+        if (i != objectMap->anonymous.end())
+        {
+            releaseMovableObject(m);
+            objectMap->removeAnonymous(i - objectMap->anonymous.begin());
+            return;
+        }
+    }
+
     extractMovableObject(m->getName(), m->getMovableType());
 }
 //---------------------------------------------------------------------
@@ -4312,14 +4869,75 @@ void SceneManager::extractAllMovableObjectsByType(const String& typeName)
     {
             OGRE_LOCK_MUTEX(objectMap->mutex);
         // no deletion
+        MovableObjectCollectionIterator it(*objectMap);
+        while (it.hasMoreElements())
+            releaseMovableObject(it.getNext());
         objectMap->map.clear();
+        objectMap->clearAnonymous();
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::releaseMovableObject(MovableObject* m)
+{
+    // the object may be destroyed after this manager or injected into another one
+    mQueryBroadphase.remove(m);
+    m->_notifyManager(0);
+}
+//---------------------------------------------------------------------
+SceneManager::MovableObjectHandle SceneManager::MovableObjectCollection::addAnonymous(MovableObject* m)
+{
+    uint32 index = freeSlot;
+    if (index == ~0u)
+    {
+        index = static_cast<uint32>(slots.size());
+        Slot slot = {1, 0};
+        slots.push_back(slot);
+    }
+    else
+    {
+        freeSlot = slots[index].position;
     }
+
+    slots[index].position = static_cast<uint32>(anonymous.size());
+    anonymous.push_back(m);
+    anonymousSlots.push_back(index);
+
+    MovableObjectHandle handle;
+    handle.type = type;
+    handle.index = index;
+    handle.generation = slots[index].generation;
+    return handle;
+}
+//---------------------------------------------------------------------
+void SceneManager::MovableObjectCollection::removeAnonymous(size_t position)
+{
+    uint32 index = anonymousSlots[position];
+
+    // move the last object into the gap to keep the list dense
+    anonymous[position] = anonymous.back();
+    anonymousSlots[position] = anonymousSlots.back();
+    slots[anonymousSlots[position]].position = static_cast<uint32>(position);
+    anonymous.pop_back();
+    anonymousSlots.pop_back();
+
+    // 0 is reserved for null handles
+    if (++slots[index].generation == 0)
+        slots[index].generation = 1;
+    slots[index].position = freeSlot;
+    freeSlot = index;
+}
+//---------------------------------------------------------------------
+void SceneManager::MovableObjectCollection::clearAnonymous()
+{
+    while (!anonymous.empty())
+        removeAnonymous(anonymous.size() - 1);
 }
 //---------------------------------------------------------------------
 void SceneManager::_injectRenderWithPass(Pass *pass, Renderable *rend, bool shadowDerivation,
     bool doLightIteration, const LightList* manualLightList)
 {
     // render something as if it came from the current queue
+    _markRenderStateDirty();
     const Pass *usedPass = _setPass(pass, false, shadowDerivation);
     renderSingleObject(rend, usedPass, false, doLightIteration, manualLightList);
 }
@@ -4448,6 +5066,8 @@ void SceneManager::_handleLodEvents()
 void SceneManager::setViewMatrix(const Affine3& m)
 {
     mDestRenderSystem->_setViewMatrix(m);
+    if (mActiveCommandList)
+        mActiveCommandList->setViewMatrix(m);
     if (mDestRenderSystem->areFixedFunctionLightsInViewSpace())
     {
         // reset light hash if we've got lights already set
@@ -4475,6 +5095,8 @@ void SceneManager::useLights(const LightList& lights, ushort limit, bool fixedFu
     {
         mDestRenderSystem->_useLights(lights, limit);
         mLastLightLimit = limit;
+        if (mActiveCommandList)
+            mActiveCommandList->useLights(lights, limit);
     }
 }
 //---------------------------------------------------------------------
@@ -4485,7 +5107,17 @@ void SceneManager::bindGpuProgram(GpuProgram* prog)
     // Hash == 1 is almost impossible to achieve otherwise
     mLastLightHash = 1;
     mGpuParamsDirty = (uint16)GPV_ALL;
-    mDestRenderSystem->bindGpuProgram(prog);
+    if (mRenderStateCache.update(mRenderStateCache.programs[prog->getType()], prog))
+        mDestRenderSystem->bindGpuProgram(prog);
+}
+//---------------------------------------------------------------------
+void SceneManager::unbindGpuProgram(GpuProgramType type)
+{
+    if (mRenderStateCache.update(mRenderStateCache.programs[type], (GpuProgram*)NULL) &&
+        mDestRenderSystem->isGpuProgramBound(type))
+    {
+        mDestRenderSystem->unbindGpuProgram(type);
+    }
 }
 //---------------------------------------------------------------------
 void SceneManager::_markGpuParamsDirty(uint16 mask)
@@ -4511,6 +5143,9 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
             {
                 mDestRenderSystem->bindGpuProgramParameters(t, pass->getGpuProgramParameters(t),
                                                             mGpuParamsDirty);
+                if (mActiveCommandList)
+                    mActiveCommandList->bindParameters(t, pass->getGpuProgramParameters(t),
+                                                       mGpuParamsDirty);
             }
         }
 
@@ -4533,6 +5168,8 @@ void SceneManager::_issueRenderOp(Renderable* rend, const Pass* pass)
         rend->getRenderOperation(ro);
 
         mDestRenderSystem->_render(ro);
+        if (mActiveCommandList)
+            mActiveCommandList->render(ro, pass ? pass->getPassIterationCount() : 1);
     }
 
     rend->postRender(this, mDestRenderSystem);
@@ -4566,6 +5203,16 @@ void VisibleObjectsBoundsInfo::merge(const AxisAlignedBox& boxBounds, const Sphe
     maxDistanceInFrustum = std::max(maxDistanceInFrustum, camDistToCenter + sphereBounds.getRadius());
 }
 //---------------------------------------------------------------------
+void VisibleObjectsBoundsInfo::merge(const VisibleObjectsBoundsInfo& rhs)
+{
+    aabb.merge(rhs.aabb);
+    receiverAabb.merge(rhs.receiverAabb);
+    minDistance = std::min(minDistance, rhs.minDistance);
+    maxDistance = std::max(maxDistance, rhs.maxDistance);
+    minDistanceInFrustum = std::min(minDistanceInFrustum, rhs.minDistanceInFrustum);
+    maxDistanceInFrustum = std::max(maxDistanceInFrustum, rhs.maxDistanceInFrustum);
+}
+//---------------------------------------------------------------------
 void VisibleObjectsBoundsInfo::mergeNonRenderedButInFrustum(const AxisAlignedBox& boxBounds, 
                                   const Sphere& sphereBounds, const Camera* cam)
 {
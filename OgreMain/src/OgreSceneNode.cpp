@@ -38,6 +38,7 @@ namespace Ogre {
         , mCreator(creator)
         , mAutoTrackTarget(0)
         , mGlobalIndex(-1)
+        , mQueryMovedIndex(-1)
         , mYawFixed(false)
         , mIsInSceneGraph(false)
         , mShowBoundingBox(false)
@@ -55,12 +56,29 @@ namespace Ogre {
             (*itr)->_notifyAttached((SceneNode*)0);
         }
         mObjectsByName.clear();
+
+        if (mQueryMovedIndex >= 0)
+            mCreator->_notifySceneNodeDestroyed(this);
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::needUpdate(bool forceParentUpdate)
+    {
+        Node::needUpdate(forceParentUpdate);
+
+        if (mIsInSceneGraph && mQueryMovedIndex < 0 && mCreator)
+            mCreator->_notifySceneNodeMoved(this);
     }
     //-----------------------------------------------------------------------
     void SceneNode::_update(bool updateChildren, bool parentHasChanged)
     {
+        // Static sub-trees keep their bounds, everything that could change them
+        // (moving, attaching, object bounds changes) flags the path up to the root
+        bool boundsOutOfDate = _isUpdatePending(parentHasChanged);
+
         Node::_update(updateChildren, parentHasChanged);
-        _updateBounds();
+
+        if (boundsOutOfDate)
+            _updateBounds();
     }
     //-----------------------------------------------------------------------
     void SceneNode::setParent(Node* parent)
@@ -83,6 +101,8 @@ namespace Ogre {
         if (inGraph != mIsInSceneGraph)
         {
             mIsInSceneGraph = inGraph;
+            if (mCreator)
+                mCreator->_notifySceneGraphChanged(this);
             // Tell children
             for (ChildNodeMap::iterator child = mChildren.begin(); child != mChildren.end(); ++child)
             {
@@ -263,6 +283,46 @@ namespace Ogre {
         if (!cam->isVisible(mWorldAABB))
             return;
 
+        addVisibleObjects(cam, queue, visibleBounds, includeChildren, displayNodes, onlyShadowCasters);
+    }
+    //-----------------------------------------------------------------------
+    template<typename Function>
+    void SceneNode::forEachVisibleChild(const Camera* cam, const Function& f)
+    {
+        // Cull the children in batches, then call f for the visible ones
+        const size_t BATCH_SIZE = 32;
+        const AxisAlignedBox* bounds[BATCH_SIZE];
+        bool visible[BATCH_SIZE];
+
+        for (size_t first = 0; first < mChildren.size(); first += BATCH_SIZE)
+        {
+            size_t count = std::min(BATCH_SIZE, mChildren.size() - first);
+            for (size_t i = 0; i < count; ++i)
+                bounds[i] = &static_cast<SceneNode*>(mChildren[first + i])->mWorldAABB;
+
+            cam->getVisibility(bounds, count, visible);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (visible[i])
+                    f(static_cast<SceneNode*>(mChildren[first + i]));
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::collectVisibleNodes(const Camera* cam, std::vector<SceneNode*>& nodes)
+    {
+        // same order as addVisibleObjects visits the nodes
+        nodes.push_back(this);
+        forEachVisibleChild(cam, [&](SceneNode* sceneChild) {
+            sceneChild->collectVisibleNodes(cam, nodes);
+        });
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::addVisibleObjects(Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool includeChildren,
+        bool displayNodes, bool onlyShadowCasters)
+    {
         // Add all entities
         ObjectMap::iterator iobj;
         ObjectMap::iterator iobjend = mObjectsByName.end();
@@ -275,14 +335,10 @@ namespace Ogre {
 
         if (includeChildren)
         {
-            ChildNodeMap::iterator child, childend;
-            childend = mChildren.end();
-            for (child = mChildren.begin(); child != childend; ++child)
-            {
-                SceneNode* sceneChild = static_cast<SceneNode*>(*child);
-                sceneChild->_findVisibleObjects(cam, queue, visibleBounds, includeChildren, 
+            forEachVisibleChild(cam, [&](SceneNode* sceneChild) {
+                sceneChild->addVisibleObjects(cam, queue, visibleBounds, includeChildren,
                     displayNodes, onlyShadowCasters);
-            }
+            });
         }
 
         if (displayNodes)
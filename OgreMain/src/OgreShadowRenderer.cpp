@@ -187,6 +187,7 @@ void SceneManager::ShadowRenderer::renderAdditiveStencilShadowedQueueGroupObject
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            mSceneManager->_markRenderStateDirty();
 
             if (scissored == CLIPPED_SOME)
                 mSceneManager->resetScissor();
@@ -268,6 +269,7 @@ void SceneManager::ShadowRenderer::renderModulativeStencilShadowedQueueGroupObje
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            mSceneManager->_markRenderStateDirty();
         }
 
     }// for each light
@@ -833,6 +835,9 @@ void SceneManager::ShadowRenderer::prepareShadowTextures(Camera* cam, Viewport*
         ci = mShadowTextureCameras.begin();
         mShadowTextureIndexLightList.clear();
         size_t shadowTextureIndex = 0;
+        // with concurrent culling the targets are updated once all cameras are set up
+        bool deferUpdates = mSceneManager->getConcurrentCulling();
+        mDeferredShadowUpdates.clear();
         for (i = lightList->begin(), si = mShadowTextures.begin();
             i != iend && si != siend; ++i)
         {
@@ -888,7 +893,10 @@ void SceneManager::ShadowRenderer::prepareShadowTextures(Camera* cam, Viewport*
                 mSceneManager->fireShadowTexturesPreCaster(light, texCam, j);
 
                 // Update target
-                shadowRTT->update();
+                if (deferUpdates)
+                    mDeferredShadowUpdates.push_back(DeferredShadowUpdate(light, shadowRTT, texCam));
+                else
+                    shadowRTT->update();
 
                 ++si; // next shadow texture
                 ++ci; // next camera
@@ -898,6 +906,21 @@ void SceneManager::ShadowRenderer::prepareShadowTextures(Camera* cam, Viewport*
             mShadowTextureIndexLightList.push_back(shadowTextureIndex);
             shadowTextureIndex += textureCountPerLight;
         }
+
+        if (deferUpdates)
+        {
+            // the main camera is rendered right after, so cull it as well
+            std::vector<Camera*> cameras(1, cam);
+            for (size_t k = 0; k < mDeferredShadowUpdates.size(); ++k)
+                cameras.push_back(mDeferredShadowUpdates[k].camera);
+            mSceneManager->_cullCameras(&cameras[0], cameras.size());
+
+            for (size_t k = 0; k < mDeferredShadowUpdates.size(); ++k)
+            {
+                mShadowTextureCurrentCasterLightList[0] = mDeferredShadowUpdates[k].light;
+                mDeferredShadowUpdates[k].target->update();
+            }
+        }
     }
     catch (Exception&)
     {
@@ -1019,6 +1042,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
     mDestRenderSystem->_disableTextureUnitsFrom(0);
     mDestRenderSystem->_setDepthBufferParams(true, false, CMPF_LESS);
     mDestRenderSystem->setStencilCheckEnabled(true);
+    mSceneManager->_markRenderStateDirty();
 
     // Figure out the near clip volume
     const PlaneBoundedVolume& nearClipVol =
@@ -1129,6 +1153,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
                 mShadowDebugPass->getFragmentProgramParameters()->setNamedConstant(
                     "shadowColor", zfailAlgo ? ColourValue(0.7, 0.0, 0.2) : ColourValue(0.0, 0.7, 0.2));
             }
+            mSceneManager->_markRenderStateDirty();
             mSceneManager->_setPass(mShadowDebugPass);
             renderShadowVolumeObjects(iShadowRenderables, mShadowDebugPass, &lightList, flags,
                 true, false, false);
@@ -1143,6 +1168,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
     mDestRenderSystem->setStencilCheckEnabled(false);
 
     mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
+    mSceneManager->_markRenderStateDirty();
 
     if (scissored == CLIPPED_SOME)
     {
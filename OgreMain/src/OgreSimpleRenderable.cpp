@@ -97,6 +97,9 @@ namespace Ogre {
     void SimpleRenderable::setBoundingBox( const AxisAlignedBox& box )
     {
         mBox = box;
+
+        if (mParentNode)
+            mParentNode->needUpdate();
     }
 
     const AxisAlignedBox& SimpleRenderable::getBoundingBox(void) const
@@ -240,16 +240,10 @@ namespace Ogre {
             // tolerate state entries for animations we're not aware of
             if (anim)
             {
-              if(animState->hasBlendMask())
-              {
-                anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
-              }
-              else
-              {
-                anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
-              }
+                // the state remembers the key frames, so playing it on is O(1)
+                anim->_applyToSkeleton(this, animState->getTimePosition(),
+                    animState->getWeight() * weightFactor, animState->getBlendMask(),
+                    linked ? linked->scale : 1.0f, &animState->_getKeyFrameCursor());
             }
         }
 
@@ -590,11 +584,11 @@ namespace Ogre {
 
                 for (unsigned short ki = 0; ki < track->getNumKeyFrames(); ++ki)
                 {
-                    TransformKeyFrame* key = track->getNodeKeyFrame(ki);
+                    TransformKeyFrame key = track->getNodeKeyFrameCopy(ki);
                     of << "    -- KeyFrame " << ki << " --" << std::endl;
-                    of << "    Time index: " << key->getTime(); 
-                    of << "    Translation: " << key->getTranslate() << std::endl;
-                    q = key->getRotation();
+                    of << "    Time index: " << key.getTime(); 
+                    of << "    Translation: " << key.getTranslate() << std::endl;
+                    q = key.getRotation();
                     of << "    Rotation: " << q;
                     q.ToAngleAxis(angle, axis);
                     of << " = " << angle.valueRadians() << " radians around axis " << axis << std::endl;
@@ -945,21 +939,21 @@ namespace Ogre {
                     ushort numKeyFrames = srcTrack->getNumKeyFrames();
                     for (ushort k = 0; k < numKeyFrames; ++k)
                     {
-                        const TransformKeyFrame* srcKeyFrame = srcTrack->getNodeKeyFrame(k);
-                        TransformKeyFrame* dstKeyFrame = dstTrack->createNodeKeyFrame(srcKeyFrame->getTime());
+                        const TransformKeyFrame srcKeyFrame = srcTrack->getNodeKeyFrameCopy(k);
+                        TransformKeyFrame* dstKeyFrame = dstTrack->createNodeKeyFrame(srcKeyFrame.getTime());
 
                         // Adjust keyframes to match target binding pose
                         if (deltaTransform.isIdentity)
                         {
-                            dstKeyFrame->setTranslate(srcKeyFrame->getTranslate());
-                            dstKeyFrame->setRotation(srcKeyFrame->getRotation());
-                            dstKeyFrame->setScale(srcKeyFrame->getScale());
+                            dstKeyFrame->setTranslate(srcKeyFrame.getTranslate());
+                            dstKeyFrame->setRotation(srcKeyFrame.getRotation());
+                            dstKeyFrame->setScale(srcKeyFrame.getScale());
                         }
                         else
                         {
-                            dstKeyFrame->setTranslate(deltaTransform.translate + srcKeyFrame->getTranslate());
-                            dstKeyFrame->setRotation(deltaTransform.rotate * srcKeyFrame->getRotation());
-                            dstKeyFrame->setScale(deltaTransform.scale * srcKeyFrame->getScale());
+                            dstKeyFrame->setTranslate(deltaTransform.translate + srcKeyFrame.getTranslate());
+                            dstKeyFrame->setRotation(deltaTransform.rotate * srcKeyFrame.getRotation());
+                            dstKeyFrame->setScale(deltaTransform.scale * srcKeyFrame.getScale());
                         }
                     }
                 }
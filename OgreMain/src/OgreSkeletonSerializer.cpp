@@ -304,7 +304,8 @@ namespace Ogre {
         // Write all keyframes
         for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
         {
-            writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            TransformKeyFrame key = track->getNodeKeyFrameCopy(i);
+            writeKeyFrame(pSkel, &key);
         }
         popInnerChunk(mStream);
     }
@@ -419,7 +420,8 @@ namespace Ogre {
         // Nested keyframes
         for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
         {
-            size += calcKeyFrameSize(pSkel, pTrack->getNodeKeyFrame(i));
+            TransformKeyFrame key = pTrack->getNodeKeyFrameCopy(i);
+            size += calcKeyFrameSize(pSkel, &key);
         }
 
         return size;
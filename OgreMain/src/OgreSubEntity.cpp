@@ -95,6 +95,7 @@ namespace Ogre {
 
         // tell parent to reconsider material vertex processing options
         mParentEntity->reevaluateVertexProcessing();
+        mParentEntity->notifyStaticDirty();
     }
     //-----------------------------------------------------------------------
     const MaterialPtr& SubEntity::getMaterial(void) const
@@ -274,6 +275,7 @@ namespace Ogre {
     void SubEntity::setVisible(bool visible)
     {
         mVisible = visible;
+        mParentEntity->notifyStaticDirty();
     }
     //-----------------------------------------------------------------------
     bool SubEntity::isVisible(void) const
@@ -436,6 +438,7 @@ namespace Ogre {
     {
         mRenderQueueIDSet = true;
         mRenderQueueID = queueID;
+        mParentEntity->notifyStaticDirty();
     }
     //-----------------------------------------------------------------------
     void SubEntity::setRenderQueueGroupAndPriority(uint8 queueID, ushort priority)
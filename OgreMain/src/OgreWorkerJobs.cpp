@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+namespace Ogre {
+//-----------------------------------------------------------------------
+SceneManager::WorkerJobs::WorkerJobs()
+    : mQueue(0), mChannel(0), mJob(0), mJobCount(0), mNextJob(0), mJobsDone(0), mBatch(0)
+{
+}
+//-----------------------------------------------------------------------
+SceneManager::WorkerJobs::~WorkerJobs()
+{
+    // only unregister if the queue was not replaced (and destroyed) meanwhile
+    Root* root = Root::getSingletonPtr();
+    if (mQueue && root && root->getWorkQueue() == mQueue)
+        mQueue->removeRequestHandler(mChannel, this);
+}
+//-----------------------------------------------------------------------
+size_t SceneManager::WorkerJobs::getConcurrency() const
+{
+#if OGRE_THREAD_SUPPORT
+    Root* root = Root::getSingletonPtr();
+    DefaultWorkQueueBase* queue =
+        root ? dynamic_cast<DefaultWorkQueueBase*>(root->getWorkQueue()) : 0;
+    // requests to a queue which is not running would only pile up
+    if (queue && queue->isRunning())
+        return queue->getWorkerThreadCount() + 1;
+#endif
+    return 1;
+}
+//-----------------------------------------------------------------------
+void SceneManager::WorkerJobs::run(size_t count, const Job& job)
+{
+    if (count == 0)
+        return;
+
+    {
+        OGRE_WQ_LOCK_MUTEX(mJobMutex);
+        mJob = &job;
+        mJobCount = count;
+        mNextJob = 0;
+        mJobsDone = 0;
+        mException = std::exception_ptr();
+        ++mBatch;
+    }
+
+#if OGRE_THREAD_SUPPORT
+    // the calling thread is one of the participants
+    size_t numRequests = std::min(count, getConcurrency()) - 1;
+    WorkQueue* queue = Root::getSingleton().getWorkQueue();
+    if (numRequests && queue != mQueue)
+    {
+        // the previous queue (if any) was destroyed by Root::setWorkQueue
+        mQueue = queue;
+        mChannel = mQueue->getChannel("Ogre/WorkerJobs");
+        mQueue->addRequestHandler(mChannel, this);
+    }
+
+    std::vector<WorkQueue::RequestID> requests;
+    for (size_t i = 0; i < numRequests; ++i)
+    {
+        WorkQueue::RequestID rid = mQueue->addRequest(mChannel, 0, Any(mBatch));
+        if (rid)
+            requests.push_back(rid);
+    }
+#endif
+
+    // help out and make sure we also finish without any worker
+    processJobs(mBatch);
+
+#if OGRE_THREAD_SUPPORT
+    {
+        OGRE_WQ_LOCK_MUTEX_NAMED(mJobMutex, lock);
+        while (mJobsDone < mJobCount)
+            OGRE_THREAD_WAIT(mJobsDoneSync, mJobMutex, lock);
+    }
+
+    // requests which did not get to a worker yet are obsolete now
+    for (size_t i = 0; i < requests.size(); ++i)
+        mQueue->abortPendingRequest(requests[i]);
+#endif
+
+    mJob = 0;
+    if (mException)
+        std::rethrow_exception(mException);
+}
+//-----------------------------------------------------------------------
+void SceneManager::WorkerJobs::processJobs(uint32 batch)
+{
+    while (true)
+    {
+        size_t index;
+        {
+            OGRE_WQ_LOCK_MUTEX(mJobMutex);
+            if (batch != mBatch || mNextJob >= mJobCount)
+                return;
+            index = mNextJob++;
+        }
+
+        try
+        {
+            (*mJob)(index);
+        }
+        catch (...)
+        {
+            OGRE_WQ_LOCK_MUTEX(mJobMutex);
+            if (!mException)
+                mException = std::current_exception();
+        }
+
+        {
+            OGRE_WQ_LOCK_MUTEX(mJobMutex);
+            if (++mJobsDone == mJobCount)
+                OGRE_THREAD_NOTIFY_ALL(mJobsDoneSync);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+WorkQueue::Response* SceneManager::WorkerJobs::handleRequest(const WorkQueue::Request* req,
+                                                             const WorkQueue* srcQ)
+{
+    processJobs(any_cast<uint32>(req->getData()));
+    return OGRE_NEW WorkQueue::Response(req, true, Any());
+}
+}
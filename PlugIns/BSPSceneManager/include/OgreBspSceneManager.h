@@ -127,6 +127,9 @@ namespace Ogre {
         /// @copydoc SceneManager::getTypeName
         const String& getTypeName(void) const;
 
+        /** Nodes notify the level of moved objects, see BspSceneNode::_update */
+        bool supportsParallelNodeUpdate(void) const { return false; }
+
         /** Specialised from SceneManager to support Quake3 bsp files. */
         void setWorldGeometry(const String& filename);
 
@@ -109,8 +109,9 @@ namespace Ogre {
                         *i, this->_getDerivedPosition());
                 }
             }
+            mIsInSceneGraph = inGraph;
+            mCreator->_notifySceneGraphChanged(this);
         }
-        mIsInSceneGraph = inGraph;
     }
 
 }
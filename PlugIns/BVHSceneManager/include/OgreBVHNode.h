@@ -0,0 +1,80 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHNode_H__
+#define __BVHNode_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneNode.h"
+
+namespace Ogre
+{
+/** \addtogroup Plugins Plugins
+*  @{
+*/
+/** \addtogroup BVH BVHSceneManager
+* Dynamic bounding volume hierarchy for managing scene nodes.
+*  @{
+*/
+/** Specialized SceneNode kept as a leaf of the BVHSceneManager tree.
+@remarks
+    Like OctreeNode, each node only bounds its own attached objects rather
+    than merging in those of its children, which live in the tree themselves.
+*/
+class _OgreBVHPluginExport BVHNode : public SceneNode
+{
+public:
+    /// Proxy value for nodes with infinite bounds, kept outside the tree
+    static const int INFINITE_PROXY = -2;
+
+    BVHNode(SceneManager* creator);
+    BVHNode(SceneManager* creator, const String& name);
+    ~BVHNode();
+
+    /** Overridden to take the node out of the tree when it leaves the scene graph */
+    void setInSceneGraph(bool inGraph);
+
+    /// Proxy of this node in the tree, DynamicAABBTree::NULL_NODE if not in it
+    int _getProxy(void) const { return mProxy; }
+    void _setProxy(int proxy) { mProxy = proxy; }
+
+    /** Adds all the attached objects to the render queue */
+    void _addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+                           VisibleObjectsBoundsInfo* visibleBounds);
+
+protected:
+    /** Determines the bounds from the attached objects only, and moves the
+        node within the tree accordingly. */
+    void _updateBounds(void);
+
+    int mProxy;
+};
+/** @} */
+/** @} */
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHSceneManager_H__
+#define __BVHSceneManager_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneManager.h"
+#include "OgreDynamicAABBTree.h"
+#include "OgrePlaneBoundedVolume.h"
+
+namespace Ogre
+{
+/** \addtogroup Plugins Plugins
+*  @{
+*/
+/** \addtogroup BVH BVHSceneManager
+* Dynamic bounding volume hierarchy for managing scene nodes.
+*  @{
+*/
+class BVHNode;
+
+/** Specialized SceneManager keeping the scene nodes in a dynamic AABB tree.
+@remarks
+    Unlike the octree there is no world size or depth to configure: the
+    tree adapts to the distribution and size of the nodes. Nodes moving
+    within the margin of their fat box cost nothing, other moves are a
+    O(log n) reinsertion.
+*/
+class _OgreBVHPluginExport BVHSceneManager : public SceneManager
+{
+public:
+    using SceneManager::SceneNodeList;
+
+    BVHSceneManager(const String& name);
+    ~BVHSceneManager();
+
+    /// @copydoc SceneManager::getTypeName
+    const String& getTypeName(void) const;
+
+    /** Creates a specialized BVHNode */
+    SceneNode* createSceneNodeImpl(void);
+    /** Creates a specialized BVHNode */
+    SceneNode* createSceneNodeImpl(const String& name);
+
+    /** Culls the tree against the camera frustum rather than walking the scene graph */
+    void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+                             bool onlyShadowCasters);
+
+    /** Nodes update the shared tree, see BVHNode::_updateBounds */
+    bool supportsParallelNodeUpdate(void) const { return false; }
+
+    /** Inserts, moves or removes the node in the tree after its bounds changed */
+    void _updateBVHNode(BVHNode* node);
+    /** Removes the node from the tree */
+    void _removeBVHNode(BVHNode* node);
+
+    /** Finds the nodes whose bounds may intersect the box */
+    void findNodesIn(const AxisAlignedBox& box, SceneNodeList& list);
+    /** Finds the nodes whose bounds may intersect the sphere */
+    void findNodesIn(const Sphere& sphere, SceneNodeList& list);
+    /** Finds the nodes whose bounds may intersect the volume */
+    void findNodesIn(const PlaneBoundedVolume& volume, SceneNodeList& list);
+    /** Finds the nodes whose bounds may intersect the ray */
+    void findNodesIn(const Ray& ray, SceneNodeList& list);
+
+    /// The tree holding all nodes with finite bounds
+    const DynamicAABBTree& getTree(void) const { return mTree; }
+
+    /** Sets the given option for the SceneManager
+    @remarks
+        Options are:
+        "Margin", Real *, fraction of their size by which node bounds are
+        enlarged in the tree, see DynamicAABBTree::setMargin;
+    */
+    bool setOption(const String& key, const void* val);
+    /** Gets the given option for the SceneManager.
+    @remarks
+        See setOption, additionally "ProxyCount" and "Height", size_t * and
+        int * respectively, describe the tree.
+    */
+    bool getOption(const String& key, void* val);
+    bool getOptionKeys(StringVector& refKeys);
+
+    /** Overridden from SceneManager */
+    void clearScene(void);
+
+    AxisAlignedBoxSceneQuery* createAABBQuery(const AxisAlignedBox& box, uint32 mask);
+    SphereSceneQuery* createSphereQuery(const Sphere& sphere, uint32 mask);
+    PlaneBoundedVolumeListSceneQuery* createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes, uint32 mask);
+    RaySceneQuery* createRayQuery(const Ray& ray, uint32 mask);
+
+protected:
+    /// Appends the nodes of the query result and those with infinite bounds
+    void addQueryResult(SceneNodeList& list);
+
+    DynamicAABBTree mTree;
+    /// Nodes with infinite bounds, which would make the tree useless
+    SceneNodeList mInfiniteNodes;
+
+    /// Scratch buffers, reused to avoid allocations every frame
+    std::vector<void*> mQueryResult;
+    SceneNodeList mCandidates;
+    PlaneBoundedVolume mCullVolume;
+};
+
+/// Factory for BVHSceneManager
+class BVHSceneManagerFactory : public SceneManagerFactory
+{
+protected:
+    void initMetaData(void) const;
+public:
+    BVHSceneManagerFactory() {}
+    ~BVHSceneManagerFactory() {}
+    /// Factory type name
+    static const String FACTORY_TYPE_NAME;
+    SceneManager* createInstance(const String& instanceName);
+    void destroyInstance(SceneManager* instance);
+};
+/** @} */
+/** @} */
+}
+
+#endif
@@ -0,0 +1,297 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneManager.h"
+#include "OgreBVHNode.h"
+#include "OgreBVHSceneQuery.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+
+namespace Ogre
+{
+//-----------------------------------------------------------------------
+BVHSceneManager::BVHSceneManager(const String& name) : SceneManager(name)
+{
+}
+//-----------------------------------------------------------------------
+BVHSceneManager::~BVHSceneManager()
+{
+    // nodes remove themselves from the tree, so have to go while it exists
+    clearScene();
+}
+//-----------------------------------------------------------------------
+const String& BVHSceneManager::getTypeName(void) const
+{
+    return BVHSceneManagerFactory::FACTORY_TYPE_NAME;
+}
+//-----------------------------------------------------------------------
+SceneNode* BVHSceneManager::createSceneNodeImpl(void)
+{
+    return OGRE_NEW BVHNode(this);
+}
+//-----------------------------------------------------------------------
+SceneNode* BVHSceneManager::createSceneNodeImpl(const String& name)
+{
+    return OGRE_NEW BVHNode(this, name);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_updateBVHNode(BVHNode* node)
+{
+    const AxisAlignedBox& box = node->_getWorldAABB();
+    int proxy = node->_getProxy();
+
+    if (box.isFinite())
+    {
+        if (proxy == BVHNode::INFINITE_PROXY)
+        {
+            _removeBVHNode(node);
+            proxy = DynamicAABBTree::NULL_NODE;
+        }
+
+        if (proxy == DynamicAABBTree::NULL_NODE)
+            node->_setProxy(mTree.createProxy(box, node));
+        else
+            mTree.moveProxy(proxy, box);
+    }
+    else if (box.isInfinite())
+    {
+        if (proxy == BVHNode::INFINITE_PROXY)
+            return;
+
+        if (proxy != DynamicAABBTree::NULL_NODE)
+            mTree.destroyProxy(proxy);
+
+        mInfiniteNodes.push_back(node);
+        node->_setProxy(BVHNode::INFINITE_PROXY);
+    }
+    else
+    {
+        _removeBVHNode(node);
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_removeBVHNode(BVHNode* node)
+{
+    int proxy = node->_getProxy();
+    if (proxy == BVHNode::INFINITE_PROXY)
+    {
+        SceneNodeList::iterator it = std::find(mInfiniteNodes.begin(), mInfiniteNodes.end(), node);
+        assert(it != mInfiniteNodes.end());
+        *it = mInfiniteNodes.back();
+        mInfiniteNodes.pop_back();
+    }
+    else if (proxy != DynamicAABBTree::NULL_NODE)
+    {
+        mTree.destroyProxy(proxy);
+    }
+    node->_setProxy(DynamicAABBTree::NULL_NODE);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::addQueryResult(SceneNodeList& list)
+{
+    for (auto n : mQueryResult)
+        list.push_back(static_cast<SceneNode*>(n));
+    list.insert(list.end(), mInfiniteNodes.begin(), mInfiniteNodes.end());
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const AxisAlignedBox& box, SceneNodeList& list)
+{
+    mQueryResult.clear();
+    mTree.query(box, mQueryResult);
+    addQueryResult(list);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const Sphere& sphere, SceneNodeList& list)
+{
+    mQueryResult.clear();
+    mTree.query(sphere, mQueryResult);
+    addQueryResult(list);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const PlaneBoundedVolume& volume, SceneNodeList& list)
+{
+    mQueryResult.clear();
+    mTree.query(volume, mQueryResult);
+    addQueryResult(list);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const Ray& ray, SceneNodeList& list)
+{
+    mQueryResult.clear();
+    mTree.query(ray, mQueryResult);
+    addQueryResult(list);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+                                          bool onlyShadowCasters)
+{
+    RenderQueue* queue = getRenderQueue();
+
+    // Cull the tree against the frustum planes, an infinite far plane is left out
+    const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+    const Plane* planes = frustum->getFrustumPlanes();
+    mCullVolume.planes.assign(planes, planes + 6);
+    if (frustum->getFarClipDistance() == 0)
+        mCullVolume.planes.erase(mCullVolume.planes.begin() + FRUSTUM_PLANE_FAR);
+
+    mCandidates.clear();
+    findNodesIn(mCullVolume, mCandidates);
+
+    // Fat boxes are conservative, so test the actual bounds in batches
+    const size_t BATCH_SIZE = 32;
+    const AxisAlignedBox* bounds[BATCH_SIZE];
+    bool visible[BATCH_SIZE];
+
+    for (size_t first = 0; first < mCandidates.size(); first += BATCH_SIZE)
+    {
+        size_t count = std::min(BATCH_SIZE, mCandidates.size() - first);
+        for (size_t i = 0; i < count; ++i)
+            bounds[i] = &mCandidates[first + i]->_getWorldAABB();
+
+        cam->getVisibility(bounds, count, visible);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!visible[i])
+                continue;
+
+            BVHNode* sn = static_cast<BVHNode*>(mCandidates[first + i]);
+            sn->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+
+            if (mDisplayNodes)
+                queue->addRenderable(sn->getDebugRenderable());
+
+            // check if the scene manager or this node wants the bounding box shown.
+            if (sn->getShowBoundingBox() || mShowBoundingBoxes)
+                sn->_addBoundingBoxToQueue(queue);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+bool BVHSceneManager::setOption(const String& key, const void* val)
+{
+    if (key == "Margin")
+    {
+        mTree.setMargin(*static_cast<const Real*>(val));
+        return true;
+    }
+
+    return SceneManager::setOption(key, val);
+}
+//-----------------------------------------------------------------------
+bool BVHSceneManager::getOption(const String& key, void* val)
+{
+    if (key == "Margin")
+    {
+        *static_cast<Real*>(val) = mTree.getMargin();
+        return true;
+    }
+    else if (key == "ProxyCount")
+    {
+        *static_cast<size_t*>(val) = mTree.getProxyCount();
+        return true;
+    }
+    else if (key == "Height")
+    {
+        *static_cast<int*>(val) = mTree.getHeight();
+        return true;
+    }
+
+    return SceneManager::getOption(key, val);
+}
+//-----------------------------------------------------------------------
+bool BVHSceneManager::getOptionKeys(StringVector& refKeys)
+{
+    SceneManager::getOptionKeys(refKeys);
+    refKeys.push_back("Margin");
+    refKeys.push_back("ProxyCount");
+    refKeys.push_back("Height");
+    return true;
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::clearScene(void)
+{
+    SceneManager::clearScene();
+
+    // only the root node is left
+    mTree.clear();
+    mInfiniteNodes.clear();
+    if (mSceneRoot)
+        static_cast<BVHNode*>(mSceneRoot.get())->_setProxy(DynamicAABBTree::NULL_NODE);
+}
+//-----------------------------------------------------------------------
+AxisAlignedBoxSceneQuery* BVHSceneManager::createAABBQuery(const AxisAlignedBox& box, uint32 mask)
+{
+    BVHAxisAlignedBoxSceneQuery* q = OGRE_NEW BVHAxisAlignedBoxSceneQuery(this);
+    q->setBox(box);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+SphereSceneQuery* BVHSceneManager::createSphereQuery(const Sphere& sphere, uint32 mask)
+{
+    BVHSphereSceneQuery* q = OGRE_NEW BVHSphereSceneQuery(this);
+    q->setSphere(sphere);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+PlaneBoundedVolumeListSceneQuery*
+BVHSceneManager::createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes, uint32 mask)
+{
+    BVHPlaneBoundedVolumeListSceneQuery* q = OGRE_NEW BVHPlaneBoundedVolumeListSceneQuery(this);
+    q->setVolumes(volumes);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+RaySceneQuery* BVHSceneManager::createRayQuery(const Ray& ray, uint32 mask)
+{
+    BVHRaySceneQuery* q = OGRE_NEW BVHRaySceneQuery(this);
+    q->setRay(ray);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+const String BVHSceneManagerFactory::FACTORY_TYPE_NAME = "BVHSceneManager";
+//-----------------------------------------------------------------------
+void BVHSceneManagerFactory::initMetaData(void) const
+{
+    mMetaData.typeName = FACTORY_TYPE_NAME;
+    mMetaData.worldGeometrySupported = false;
+}
+//-----------------------------------------------------------------------
+SceneManager* BVHSceneManagerFactory::createInstance(const String& instanceName)
+{
+    return OGRE_NEW BVHSceneManager(instanceName);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManagerFactory::destroyInstance(SceneManager* instance)
+{
+    OGRE_DELETE instance;
+}
+}
@@ -0,0 +1,210 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneQuery.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreEntity.h"
+
+namespace Ogre
+{
+//---------------------------------------------------------------------
+BVHAxisAlignedBoxSceneQuery::BVHAxisAlignedBoxSceneQuery(SceneManager* creator)
+    : DefaultAxisAlignedBoxSceneQuery(creator)
+{
+}
+//---------------------------------------------------------------------
+BVHAxisAlignedBoxSceneQuery::~BVHAxisAlignedBoxSceneQuery()
+{}
+//---------------------------------------------------------------------
+void BVHAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
+{
+    BVHSceneManager::SceneNodeList nodes;
+    static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mAABB, nodes);
+
+    for (auto n : nodes)
+    {
+        for (auto m : n->getAttachedObjects())
+        {
+            if ((m->getQueryFlags() & mQueryMask) &&
+                (m->getTypeFlags() & mQueryTypeMask) &&
+                m->isInScene() &&
+                mAABB.intersects(m->getWorldBoundingBox()))
+            {
+                listener->queryResult(m);
+                // deal with attached objects, since they are not directly attached to nodes
+                if (m->getMovableType() == "Entity")
+                {
+                    Entity* e = static_cast<Entity*>(m);
+                    Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                    while (childIt.hasMoreElements())
+                    {
+                        MovableObject* c = childIt.getNext();
+                        if (c->getQueryFlags() & mQueryMask)
+                            listener->queryResult(c);
+                    }
+                }
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------
+BVHRaySceneQuery::BVHRaySceneQuery(SceneManager* creator) : DefaultRaySceneQuery(creator)
+{
+}
+//---------------------------------------------------------------------
+BVHRaySceneQuery::~BVHRaySceneQuery()
+{}
+//---------------------------------------------------------------------
+void BVHRaySceneQuery::execute(RaySceneQueryListener* listener)
+{
+    BVHSceneManager::SceneNodeList nodes;
+    static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mRay, nodes);
+
+    for (auto n : nodes)
+    {
+        for (auto m : n->getAttachedObjects())
+        {
+            if ((m->getQueryFlags() & mQueryMask) &&
+                (m->getTypeFlags() & mQueryTypeMask) && m->isInScene())
+            {
+                std::pair<bool, Real> result = mRay.intersects(m->getWorldBoundingBox());
+                if (!result.first)
+                    continue;
+
+                listener->queryResult(m, result.second);
+                // deal with attached objects, since they are not directly attached to nodes
+                if (m->getMovableType() == "Entity")
+                {
+                    Entity* e = static_cast<Entity*>(m);
+                    Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                    while (childIt.hasMoreElements())
+                    {
+                        MovableObject* c = childIt.getNext();
+                        if (c->getQueryFlags() & mQueryMask)
+                        {
+                            result = mRay.intersects(c->getWorldBoundingBox());
+                            if (result.first)
+                                listener->queryResult(c, result.second);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------
+BVHSphereSceneQuery::BVHSphereSceneQuery(SceneManager* creator) : DefaultSphereSceneQuery(creator)
+{
+}
+//---------------------------------------------------------------------
+BVHSphereSceneQuery::~BVHSphereSceneQuery()
+{}
+//---------------------------------------------------------------------
+void BVHSphereSceneQuery::execute(SceneQueryListener* listener)
+{
+    BVHSceneManager::SceneNodeList nodes;
+    static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mSphere, nodes);
+
+    for (auto n : nodes)
+    {
+        for (auto m : n->getAttachedObjects())
+        {
+            if ((m->getQueryFlags() & mQueryMask) &&
+                (m->getTypeFlags() & mQueryTypeMask) &&
+                m->isInScene() &&
+                mSphere.intersects(m->getWorldBoundingBox()))
+            {
+                listener->queryResult(m);
+                // deal with attached objects, since they are not directly attached to nodes
+                if (m->getMovableType() == "Entity")
+                {
+                    Entity* e = static_cast<Entity*>(m);
+                    Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                    while (childIt.hasMoreElements())
+                    {
+                        MovableObject* c = childIt.getNext();
+                        if ((c->getQueryFlags() & mQueryMask) &&
+                            mSphere.intersects(c->getWorldBoundingBox()))
+                            listener->queryResult(c);
+                    }
+                }
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------
+BVHPlaneBoundedVolumeListSceneQuery::BVHPlaneBoundedVolumeListSceneQuery(SceneManager* creator)
+    : DefaultPlaneBoundedVolumeListSceneQuery(creator)
+{
+}
+//---------------------------------------------------------------------
+BVHPlaneBoundedVolumeListSceneQuery::~BVHPlaneBoundedVolumeListSceneQuery()
+{}
+//---------------------------------------------------------------------
+void BVHPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
+{
+    std::set<SceneNode*> checkedSceneNodes;
+
+    for (const PlaneBoundedVolume& volume : mVolumes)
+    {
+        BVHSceneManager::SceneNodeList nodes;
+        static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(volume, nodes);
+
+        for (auto n : nodes)
+        {
+            // avoid double-check same scene node
+            if (!checkedSceneNodes.insert(n).second)
+                continue;
+
+            for (auto m : n->getAttachedObjects())
+            {
+                if ((m->getQueryFlags() & mQueryMask) &&
+                    (m->getTypeFlags() & mQueryTypeMask) &&
+                    m->isInScene() &&
+                    volume.intersects(m->getWorldBoundingBox()))
+                {
+                    listener->queryResult(m);
+                    // deal with attached objects, since they are not directly attached to nodes
+                    if (m->getMovableType() == "Entity")
+                    {
+                        Entity* e = static_cast<Entity*>(m);
+                        Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                        while (childIt.hasMoreElements())
+                        {
+                            MovableObject* c = childIt.getNext();
+                            if ((c->getQueryFlags() & mQueryMask) &&
+                                volume.intersects(c->getWorldBoundingBox()))
+                                listener->queryResult(c);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+}
@@ -121,6 +121,9 @@ public:
         VisibleObjectsBoundsInfo* visibleBounds, bool foundvisible, 
         bool onlyShadowCasters);
 
+    /** Nodes move themselves in the shared octree, see OctreeNode::_updateBounds */
+    bool supportsParallelNodeUpdate( void ) const { return false; }
+
     /** Checks the given OctreeNode, and determines if it needs to be moved
     * to a different octant.
     */
@@ -68,8 +68,8 @@ void OctreeIntersectionSceneQuery::execute(IntersectionSceneQueryListener* liste
         Root::getSingleton().getMovableObjectFactoryIterator();
     while(factIt.hasMoreElements())
     {
-        SceneManager::MovableObjectIterator it = 
-            mParentSceneMgr->getMovableObjectIterator(
+        SceneManager::MovableObjectCollectionIterator it = 
+            mParentSceneMgr->_getMovableObjectCollectionIterator(
             factIt.getNext()->getType());
         while( it.hasMoreElements() )
         {
@@ -76,6 +76,9 @@ namespace Ogre
         /// @copydoc SceneManager::getTypeName
         const String& getTypeName(void) const;
 
+        /** Nodes update their zones and portals, see PCZSceneNode::_update */
+        bool supportsParallelNodeUpdate(void) const { return false; }
+
         /** Initializes the manager 
         */
         void init(const String &defaultZoneTypeName,
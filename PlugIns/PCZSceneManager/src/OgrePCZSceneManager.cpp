@@ -622,7 +622,7 @@ namespace Ogre
         {
                 OGRE_LOCK_MUTEX(lights->mutex);
 
-            MovableObjectIterator it(lights->map.begin(), lights->map.end());
+            MovableObjectCollectionIterator it(*lights);
 
             while(it.hasMoreElements())
             {
@@ -743,7 +743,7 @@ namespace Ogre
         {
                     OGRE_LOCK_MUTEX(lights->mutex); // Is locking necessary in destroyZone? I don't know..
 
-            MovableObjectIterator it(lights->map.begin(), lights->map.end());
+            MovableObjectCollectionIterator it(*lights);
 
             while(it.hasMoreElements())
             {
@@ -987,9 +987,9 @@ namespace Ogre
 
             // Pre-allocate memory
             mTestLightInfos.clear();
-            mTestLightInfos.reserve(lights->map.size());
+            mTestLightInfos.reserve(lights->map.size() + lights->anonymous.size());
 
-            MovableObjectIterator it(lights->map.begin(), lights->map.end());
+            MovableObjectCollectionIterator it(*lights);
 
             while(it.hasMoreElements())
             {
@@ -66,8 +66,8 @@ namespace Ogre
             Root::getSingleton().getMovableObjectFactoryIterator();
         while(factIt.hasMoreElements())
         {
-            SceneManager::MovableObjectIterator it = 
-                mParentSceneMgr->getMovableObjectIterator(
+            SceneManager::MovableObjectCollectionIterator it = 
+                mParentSceneMgr->_getMovableObjectCollectionIterator(
                 factIt.getNext()->getType());
             while( it.hasMoreElements() )
             {
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #ifndef __ParticleFXPlugin_H__
 #define __ParticleFXPlugin_H__
 
+#include "OgreParticleFXPrerequisites.h"
 #include "OgrePlugin.h"
 #include "OgreParticleAffectorFactory.h"
 #include "OgreParticleEmitterFactory.h"
@@ -36,7 +37,7 @@ namespace Ogre
 {
 
     /** Plugin instance for ParticleFX Manager */
-    class ParticleFXPlugin : public Plugin
+    class _OgreParticleFXExport ParticleFXPlugin : public Plugin
     {
     public:
         ParticleFXPlugin();
@@ -120,6 +120,8 @@ namespace Ogre {
         Ogre::String getCombinedName(void);
         /// Get the the binary data of a program from the microcode cache
         void getMicrocodeFromCache(uint32 id);
+        /// Write the changes of a shared parameter set with a uniform buffer of its own
+        void uploadSharedParamsBuffer(const GpuSharedParametersPtr& params);
     };
 
 
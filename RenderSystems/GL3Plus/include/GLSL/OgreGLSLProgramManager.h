@@ -66,6 +66,14 @@ namespace Ogre {
 
         GL3PlusRenderSystem* mRenderSystem;
 
+        /** Binding points of the shared parameter sets with a uniform buffer of their own.
+            They are taken from the top of the range, as the buffers of the programs count up from 0. */
+        std::map<const GpuSharedParameters*, GLint> mSharedParamsBindings;
+
+        /// Throws if a uniform block does not have the layout of the buffer of its shared parameter set
+        void checkSharedParamsBlockLayout(GLuint programObject, GLuint blockIndex,
+                                          const GpuSharedParameters& params);
+
         /**  Convert GL uniform size and type to OGRE constant types
              and associate uniform definitions together. */
         void convertGLUniformtoOgreType(GLenum gltype,
@@ -125,6 +133,12 @@ namespace Ogre {
             //GLShaderStorageBufferList& shaderStorageBufferList,
             GLCounterBufferList& counterBufferList);
 
+        /** Binds the uniform buffer of a shared parameter set to the binding point of the set.
+            @see GpuSharedParameters::enableUniformBuffer
+            @return the binding point
+        */
+        GLint _bindSharedParamsBuffer(const GpuSharedParameters& params);
+
         GL3PlusStateCacheManager* getStateCacheManager();
 
         static GLSLProgramManager& getSingleton(void);
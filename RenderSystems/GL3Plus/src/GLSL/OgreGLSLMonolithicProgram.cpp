@@ -373,6 +373,14 @@ namespace Ogre {
     void GLSLMonolithicProgram::updateUniformBlocks(GpuProgramParametersSharedPtr params,
                                                     uint16 mask, GpuProgramType fromProgType)
     {
+        // Sets with a buffer of their own write what changed since their last upload
+        SharedParamsBufferMap::const_iterator currentPair, endPair = mSharedParamsBufferMap.end();
+        for (currentPair = mSharedParamsBufferMap.begin(); currentPair != endPair; ++currentPair)
+        {
+            if (currentPair->first->_getHardwareBuffer())
+                uploadSharedParamsBuffer(currentPair->first);
+        }
+
         // Iterate through the list of uniform buffers and update them as needed
         GLUniformBufferIterator currentBuffer = mGLUniformBufferReferences.begin();
         GLUniformBufferIterator endBuffer = mGLUniformBufferReferences.end();
@@ -32,6 +32,7 @@
 #include "OgreGLSLShader.h"
 #include "OgreRoot.h"
 #include "OgreGLSLExtSupport.h"
+#include "OgreGLSLProgramManager.h"
 
 namespace Ogre {
 
@@ -215,4 +216,18 @@ namespace Ogre {
         compileAndLink();
     }
 
-} // namespace Ogre
+
+    void GLSLProgram::uploadSharedParamsBuffer(const GpuSharedParametersPtr& params)
+    {
+        HardwareUniformBufferSharedPtr& buffer = mSharedParamsBufferMap[params];
+        if (buffer != params->_getHardwareBuffer())
+        {
+            // recreated, as the constant definitions of the set changed
+            GLSLProgramManager::getSingleton()._bindSharedParamsBuffer(*params);
+            buffer = params->_getHardwareBuffer();
+        }
+
+        // the first program using the set this frame writes its changes, the others find it clean
+        params->_upload();
+    }
+}
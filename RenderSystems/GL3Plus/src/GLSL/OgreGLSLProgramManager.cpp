@@ -201,6 +201,71 @@ namespace Ogre {
 
     GLSLProgramManager::~GLSLProgramManager(void) {}
 
+    GLint GLSLProgramManager::_bindSharedParamsBuffer(const GpuSharedParameters& params)
+    {
+        std::map<const GpuSharedParameters*, GLint>::iterator i = mSharedParamsBindings.find(&params);
+        if (i == mSharedParamsBindings.end())
+        {
+            GLint maxBindings = 0;
+            OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings));
+            GLint binding = maxBindings - 1 - GLint(mSharedParamsBindings.size());
+            i = mSharedParamsBindings.insert(std::make_pair(&params, binding)).first;
+        }
+
+        static_cast<GL3PlusHardwareUniformBuffer*>(params._getHardwareBuffer().get())
+            ->setGLBufferBinding(i->second);
+        return i->second;
+    }
+
+
+    void GLSLProgramManager::checkSharedParamsBlockLayout(GLuint programObject, GLuint blockIndex,
+                                                          const GpuSharedParameters& params)
+    {
+        const GpuConstantDefinitionMap& defs = params.getConstantDefinitions().map;
+        std::vector<const char*> names;
+        std::vector<const GpuConstantDefinition*> paramDefs;
+        bool matches = true;
+        for (GpuConstantDefinitionMap::const_iterator i = defs.begin(); i != defs.end(); ++i)
+        {
+            // only the float constants are in the buffer
+            matches = matches && i->second.isFloat();
+            names.push_back(i->first.c_str());
+            paramDefs.push_back(&i->second);
+        }
+
+        GLint blockSize = 0;
+        OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, blockIndex,
+                                                      GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize));
+        matches = matches && size_t(blockSize) <= params._getHardwareBuffer()->getSizeInBytes();
+
+        if (matches && !names.empty())
+        {
+            std::vector<GLuint> indices(names.size());
+            std::vector<GLint> offsets(names.size());
+            OGRE_CHECK_GL_ERROR(glGetUniformIndices(programObject, names.size(), &names[0], &indices[0]));
+            for (size_t i = 0; i < names.size() && matches; ++i)
+            {
+                // members the program does not declare are fine
+                if (indices[i] == GL_INVALID_INDEX)
+                    continue;
+                OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &indices[i],
+                                                          GL_UNIFORM_OFFSET, &offsets[i]));
+                matches = size_t(offsets[i]) == paramDefs[i]->physicalIndex * sizeof(float);
+            }
+        }
+
+        if (!matches)
+        {
+            OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR,
+                        "Uniform block '" + params.getName() +
+                            "' does not match the layout of its shared parameters. Declare it "
+                            "std140, with the members in the order they were defined and each "
+                            "at the offset of its constant in the float constant list",
+                        "GLSLProgramManager::extractUniformsFromProgram");
+        }
+    }
+
+
     GL3PlusStateCacheManager* GLSLProgramManager::getStateCacheManager()
     {
         return mRenderSystem->_getStateCacheManager();
@@ -734,6 +799,17 @@ namespace Ogre {
             {
                 hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(bufferMapi->second.get());
             }
+            else if (blockSharedParams->_getHardwareBuffer())
+            {
+                // The set keeps its float constants in a buffer of its own, shared by all
+                // programs and updated through GpuSharedParameters::_upload.
+                checkSharedParamsBlockLayout(programObject, index, *blockSharedParams);
+                _bindSharedParamsBuffer(*blockSharedParams);
+                hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(
+                    blockSharedParams->_getHardwareBuffer().get());
+                sharedParamsBufferMap.insert(
+                    std::make_pair(blockSharedParams, blockSharedParams->_getHardwareBuffer()));
+            }
             else
             {
                 // Create buffer and add entry to buffer map.
@@ -611,6 +611,13 @@ namespace Ogre
 
         for (; currentPair != endPair; ++currentPair)
         {
+            // Sets with a buffer of their own write what changed since their last upload
+            if (currentPair->first->_getHardwareBuffer())
+            {
+                uploadSharedParamsBuffer(currentPair->first);
+                continue;
+            }
+
             // force const call to get*Pointer
             const GpuSharedParameters* paramsPtr = currentPair->first.get();
 
@@ -470,6 +470,9 @@ namespace Ogre {
         // Check if render to vertex buffer (transform feedback in OpenGL)
         rsc->setCapability(RSC_HWRENDER_TO_VERTEX_BUFFER);
 
+        // Shared parameters are bound as uniform blocks, which are core since GL 3.1
+        rsc->setCapability(RSC_SHARED_PARAMETER_BUFFERS);
+
         if (hasMinGLVersion(4, 3) || checkExtension("GL_KHR_debug"))
             rsc->setCapability(RSC_DEBUG);
 
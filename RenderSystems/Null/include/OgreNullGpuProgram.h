@@ -0,0 +1,120 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullGpuProgram_H__
+#define __NullGpuProgram_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+
+namespace Ogre {
+    /// Low-level program that only keeps its source
+    class _OgreNullExport NullGpuProgram : public GpuProgram
+    {
+    public:
+        NullGpuProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
+                       const String& group, bool isManual, ManualResourceLoader* loader);
+        ~NullGpuProgram();
+    protected:
+        void loadFromSource(void) {}
+        void unloadImpl(void) {}
+    };
+
+    /** High-level program that is accepted without being compiled.
+
+        The program binds itself and has no constant definitions, so named parameters
+        are silently ignored while indexed and auto parameters still go through the usual
+        GpuProgramParameters paths.
+    */
+    class _OgreNullExport NullHighLevelGpuProgram : public HighLevelGpuProgram
+    {
+    public:
+        NullHighLevelGpuProgram(ResourceManager* creator, const String& name,
+                                ResourceHandle handle, const String& group, bool isManual,
+                                ManualResourceLoader* loader, const String& language);
+        ~NullHighLevelGpuProgram();
+
+        const String& getLanguage(void) const { return mLanguage; }
+        bool isSupported(void) const { return !mCompileError; }
+        GpuProgram* _getBindingDelegate(void) { return this; }
+
+        /// Accepts every parameter, as the options of the emulated language are unknown
+        bool setParameter(const String& name, const String& value)
+        {
+            GpuProgram::setParameter(name, value);
+            return true;
+        }
+    protected:
+        void loadFromSource(void) {}
+        void createLowLevelImpl(void) {}
+        void unloadHighLevelImpl(void) {}
+        void populateParameterNames(GpuProgramParametersSharedPtr params)
+        {
+            params->setIgnoreMissingParams(true);
+        }
+        void buildConstantDefinitions() const {}
+
+        String mLanguage;
+    };
+
+    /// Factory for NullHighLevelGpuProgram
+    class _OgreNullExport NullHighLevelGpuProgramFactory : public HighLevelGpuProgramFactory
+    {
+    public:
+        NullHighLevelGpuProgramFactory(const String& language) : mLanguage(language) {}
+        const String& getLanguage(void) const { return mLanguage; }
+        HighLevelGpuProgram* create(ResourceManager* creator, const String& name,
+                                    ResourceHandle handle, const String& group, bool isManual,
+                                    ManualResourceLoader* loader)
+        {
+            return OGRE_NEW NullHighLevelGpuProgram(creator, name, handle, group, isManual,
+                                                    loader, mLanguage);
+        }
+        void destroy(HighLevelGpuProgram* prog) { OGRE_DELETE prog; }
+    private:
+        String mLanguage;
+    };
+
+    /// GpuProgramManager creating NullGpuProgram instances
+    class _OgreNullExport NullGpuProgramManager : public GpuProgramManager
+    {
+    public:
+        NullGpuProgramManager();
+        ~NullGpuProgramManager();
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             const NameValuePairList* params);
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             GpuProgramType gptype, const String& syntaxCode);
+    };
+}
+
+#endif
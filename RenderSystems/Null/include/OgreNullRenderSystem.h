@@ -0,0 +1,206 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderSystem_H__
+#define __NullRenderSystem_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre {
+    /** \addtogroup RenderSystems RenderSystems
+    *  @{
+    */
+    /** \defgroup Null Null
+    * Headless RenderSystem that does no GPU work
+    *  @{
+    */
+    /** RenderSystem that executes the whole frame on the CPU side but never talks to a GPU.
+
+        Vertex and index buffers live in system memory (see DefaultHardwareBufferManager),
+        textures keep their pixels in system memory and programs are accepted without being
+        compiled. Every call the SceneManager makes is counted instead of being executed, so
+        Root::renderOneFrame can be used to measure and regression-test scene update, culling,
+        queueing, auto parameter and compositor cost on machines without a GPU.
+    */
+    class _OgreNullExport NullRenderSystem : public RenderSystem
+    {
+    public:
+        /// Counters of the work submitted to the render system
+        struct Statistics
+        {
+            /// Number of _render calls
+            size_t drawCalls;
+            /// Fixed function, blending, depth, stencil, culling and raster state calls
+            size_t stateChanges;
+            /// Texture and sampler binds
+            size_t textureBinds;
+            /// GPU program binds and unbinds
+            size_t programBinds;
+            /// GPU program parameter uploads
+            size_t parameterUploads;
+            /// Shared parameter sets copied into program parameters
+            size_t sharedParameterCopies;
+            /// Bytes of float constants in the copied shared parameter sets
+            size_t sharedParameterBytes;
+            /// Writes to the uniform buffers of shared parameter sets
+            size_t uniformBufferUploads;
+            /// Bytes written to the uniform buffers of shared parameter sets
+            size_t uniformBufferBytes;
+            /// Render target switches
+            size_t renderTargetChanges;
+            /// Viewport switches
+            size_t viewportChanges;
+            /// Frame buffer clears
+            size_t clears;
+            /// Number of _beginFrame calls
+            size_t frames;
+
+            Statistics() { reset(); }
+            void reset() { memset(this, 0, sizeof(Statistics)); }
+        };
+
+        NullRenderSystem();
+        ~NullRenderSystem();
+
+        const String& getName(void) const;
+        void setConfigOption(const String &name, const String &value);
+        String validateConfigOptions(void) { return BLANKSTRING; }
+        HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+        RenderSystemCapabilities* createRenderSystemCapabilities() const;
+        void initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary);
+
+        void _initialise();
+        void reinitialise(void);
+        void shutdown(void);
+
+        RenderWindow* _createRenderWindow(const String &name, unsigned int width, unsigned int height,
+            bool fullScreen, const NameValuePairList *miscParams = 0);
+        MultiRenderTarget* createMultiRenderTarget(const String & name);
+        DepthBuffer* _createDepthBufferFor(RenderTarget *renderTarget);
+
+        void _setSampler(size_t texUnit, Sampler& s);
+        void _setTexture(size_t unit, bool enabled, const TexturePtr &texPtr);
+        void _setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter);
+        void _setTextureUnitCompareEnabled(size_t unit, bool compare);
+        void _setTextureUnitCompareFunction(size_t unit, CompareFunction function);
+        void _setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy);
+        void _setTextureAddressingMode(size_t unit, const Sampler::UVWAddressingMode& uvw);
+        void _setTextureBorderColour(size_t unit, const ColourValue& colour);
+        void _setTextureMipmapBias(size_t unit, float bias);
+        void _setTextureBlendMode(size_t unit, const LayerBlendModeEx& bm);
+
+        void _useLights(const LightList& lights, unsigned short limit);
+        void _setWorldMatrix(const Matrix4 &m);
+        void _setViewMatrix(const Matrix4 &m);
+        void _setProjectionMatrix(const Matrix4 &m);
+        void _setSurfaceParams(const ColourValue &ambient, const ColourValue &diffuse,
+            const ColourValue &specular, const ColourValue &emissive, Real shininess,
+            TrackVertexColourType tracking = TVC_NONE);
+        void _setSeparateSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+            SceneBlendFactor sourceFactorAlpha, SceneBlendFactor destFactorAlpha,
+            SceneBlendOperation op = SBO_ADD, SceneBlendOperation alphaOp = SBO_ADD);
+        void _setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage);
+        void _setCullingMode(CullingMode mode);
+        void _setDepthBufferParams(bool depthTest = true, bool depthWrite = true,
+            CompareFunction depthFunction = CMPF_LESS_EQUAL);
+        void _setDepthBufferCheckEnabled(bool enabled = true);
+        void _setDepthBufferWriteEnabled(bool enabled = true);
+        void _setDepthBufferFunction(CompareFunction func = CMPF_LESS_EQUAL);
+        void _setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha);
+        void _setDepthBias(float constantBias, float slopeScaleBias = 0.0f);
+        void _setPolygonMode(PolygonMode level);
+        void setStencilCheckEnabled(bool enabled);
+        void setStencilBufferParams(CompareFunction func = CMPF_ALWAYS_PASS,
+            uint32 refValue = 0, uint32 compareMask = 0xFFFFFFFF, uint32 writeMask = 0xFFFFFFFF,
+            StencilOperation stencilFailOp = SOP_KEEP,
+            StencilOperation depthFailOp = SOP_KEEP,
+            StencilOperation passOp = SOP_KEEP,
+            bool twoSidedOperation = false,
+            bool readBackAsTexture = false);
+        void setScissorTest(bool enabled, size_t left = 0, size_t top = 0,
+            size_t right = 800, size_t bottom = 600);
+
+        void _beginFrame(void);
+        void _endFrame(void);
+        void _setViewport(Viewport *vp);
+        void _setRenderTarget(RenderTarget *target);
+        void clearFrameBuffer(unsigned int buffers, const ColourValue& colour = ColourValue::Black,
+            Real depth = 1.0f, unsigned short stencil = 0);
+        void _render(const RenderOperation& op);
+
+        void bindGpuProgram(GpuProgram* prg);
+        void unbindGpuProgram(GpuProgramType gptype);
+        void bindGpuProgramParameters(GpuProgramType gptype,
+            const GpuProgramParametersPtr& params, uint16 variabilityMask);
+        void bindGpuProgramPassIterationParameters(GpuProgramType gptype);
+
+        VertexElementType getColourVertexElementType(void) const { return VET_COLOUR_ABGR; }
+        void _convertProjectionMatrix(const Matrix4& matrix, Matrix4& dest, bool forGpuProgram = false);
+        void _makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+            Matrix4& dest, bool forGpuProgram = false);
+        void _makeProjectionMatrix(Real left, Real right, Real bottom, Real top,
+            Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram = false);
+        void _makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+            Matrix4& dest, bool forGpuProgram = false);
+        void _applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane, bool forGpuProgram);
+
+        // Same conventions as OpenGL
+        Real getHorizontalTexelOffset(void) { return 0.0f; }
+        Real getVerticalTexelOffset(void) { return 0.0f; }
+        Real getMinimumDepthInputValue(void) { return -1.0f; }
+        Real getMaximumDepthInputValue(void) { return 1.0f; }
+
+        void preExtraThreadsStarted() {}
+        void postExtraThreadsStarted() {}
+        void registerThread() {}
+        void unregisterThread() {}
+        unsigned int getDisplayMonitorCount() const { return 1; }
+        void beginProfileEvent(const String &eventName) {}
+        void endProfileEvent(void) {}
+        void markProfileEvent(const String &event) {}
+        bool hasAnisotropicMipMapFilter() const { return true; }
+
+        /// Counters accumulated since construction or the last resetStatistics call
+        const Statistics& getStatistics() const { return mStatistics; }
+        /// Zero all counters
+        void resetStatistics() { mStatistics.reset(); }
+    protected:
+        void initConfigOptions();
+
+        NullGpuProgramManager* mGpuProgramManager;
+        HardwareBufferManager* mHardwareBufferManager;
+        std::vector<NullHighLevelGpuProgramFactory*> mProgramFactories;
+        bool mCapabilitiesInitialised;
+
+        Statistics mStatistics;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,63 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderWindow_H__
+#define __NullRenderWindow_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderWindow.h"
+
+namespace Ogre {
+    /** Window without a native surface.
+
+        It only keeps its dimensions; rendering to it goes through the whole pipeline but
+        produces no pixels, so reading its contents back yields a black image.
+    */
+    class _OgreNullExport NullRenderWindow : public RenderWindow
+    {
+    public:
+        NullRenderWindow();
+        ~NullRenderWindow();
+
+        void create(const String& name, unsigned int widthPt, unsigned int heightPt,
+                bool fullScreen, const NameValuePairList *miscParams);
+        void setFullscreen(bool fullScreen, unsigned int widthPt, unsigned int heightPt);
+        void destroy(void);
+        void resize(unsigned int widthPt, unsigned int heightPt);
+        void reposition(int leftPt, int topPt);
+        bool isClosed(void) const { return mClosed; }
+        void _notifySurfaceDestroyed() {}
+        void _notifySurfaceCreated(void* nativeWindow, void* config = NULL) {}
+
+        void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer = FB_AUTO);
+        bool requiresTextureFlipping() const { return false; }
+    protected:
+        bool mClosed;
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullGpuProgram.h"
+#include "OgreResourceGroupManager.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    NullGpuProgram::NullGpuProgram(ResourceManager* creator, const String& name,
+                                   ResourceHandle handle, const String& group, bool isManual,
+                                   ManualResourceLoader* loader)
+        : GpuProgram(creator, name, handle, group, isManual, loader)
+    {
+        if (createParamDictionary("NullGpuProgram"))
+        {
+            setupBaseParamDictionary();
+        }
+    }
+    //---------------------------------------------------------------------
+    NullGpuProgram::~NullGpuProgram()
+    {
+        // have to call this here rather than in Resource destructor
+        // since calling virtual methods in base destructors causes crash
+        unload();
+    }
+    //---------------------------------------------------------------------
+    NullHighLevelGpuProgram::NullHighLevelGpuProgram(ResourceManager* creator, const String& name,
+                                                     ResourceHandle handle, const String& group,
+                                                     bool isManual, ManualResourceLoader* loader,
+                                                     const String& language)
+        : HighLevelGpuProgram(creator, name, handle, group, isManual, loader), mLanguage(language)
+    {
+        if (createParamDictionary("NullHighLevelGpuProgram"))
+        {
+            setupBaseParamDictionary();
+        }
+    }
+    //---------------------------------------------------------------------
+    NullHighLevelGpuProgram::~NullHighLevelGpuProgram()
+    {
+        // have to call this here rather than in Resource destructor
+        // since calling virtual methods in base destructors causes crash
+        if (isLoaded())
+        {
+            unload();
+        }
+        else
+        {
+            unloadHighLevel();
+        }
+    }
+    //---------------------------------------------------------------------
+    NullGpuProgramManager::NullGpuProgramManager()
+    {
+        // Register with resource group manager
+        ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+    }
+    //---------------------------------------------------------------------
+    NullGpuProgramManager::~NullGpuProgramManager()
+    {
+        // Unregister with resource group manager
+        ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+    }
+    //---------------------------------------------------------------------
+    Resource* NullGpuProgramManager::createImpl(const String& name, ResourceHandle handle,
+                                                const String& group, bool isManual,
+                                                ManualResourceLoader* loader,
+                                                const NameValuePairList* params)
+    {
+        NameValuePairList::const_iterator paramSyntax, paramType;
+
+        if (!params || (paramSyntax = params->find("syntax")) == params->end() ||
+            (paramType = params->find("type")) == params->end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You must supply 'syntax' and 'type' parameters",
+                "NullGpuProgramManager::createImpl");
+        }
+
+        GpuProgram* ret = OGRE_NEW NullGpuProgram(this, name, handle, group, isManual, loader);
+        ret->setSyntaxCode(paramSyntax->second);
+        ret->setParameter("type", paramType->second);
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    Resource* NullGpuProgramManager::createImpl(const String& name, ResourceHandle handle,
+                                                const String& group, bool isManual,
+                                                ManualResourceLoader* loader,
+                                                GpuProgramType gptype, const String& syntaxCode)
+    {
+        GpuProgram* ret = OGRE_NEW NullGpuProgram(this, name, handle, group, isManual, loader);
+        ret->setType(gptype);
+        ret->setSyntaxCode(syntaxCode);
+        return ret;
+    }
+}
@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreStringConverter.h"
+#include "OgreTexture.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    NullHardwarePixelBuffer::NullHardwarePixelBuffer(const String& textureName, uint32 width,
+                                                     uint32 height, uint32 depth, PixelFormat format,
+                                                     int usage, bool hwGamma, uint fsaa)
+        : HardwarePixelBuffer(width, height, depth, format, (Usage)(usage & ~TU_RENDERTARGET), true, false),
+          mBuffer(width, height, depth, format)
+    {
+        mSizeInBytes = PixelUtil::getMemorySize(width, height, depth, format);
+
+        if (usage & TU_RENDERTARGET)
+        {
+            // Create render target for each slice
+            mSliceTRT.reserve(mDepth);
+            for (uint32 zoffset = 0; zoffset < mDepth; ++zoffset)
+            {
+                mSliceNames.push_back("rtt/" + StringConverter::toString((size_t)this) + "/" +
+                                      StringConverter::toString(zoffset) + "/" + textureName);
+                mSliceTRT.push_back(
+                    OGRE_NEW NullRenderTexture(mSliceNames.back(), this, zoffset, hwGamma, fsaa));
+                Root::getSingleton().getRenderSystem()->attachRenderTarget(*mSliceTRT.back());
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    NullHardwarePixelBuffer::~NullHardwarePixelBuffer()
+    {
+        // Look the render targets up by name, as the user might have destroyed them already
+        for (size_t i = 0; i < mSliceNames.size(); ++i)
+            Root::getSingleton().getRenderSystem()->destroyRenderTarget(mSliceNames[i]);
+        delete[] mBuffer.data;
+    }
+    //---------------------------------------------------------------------
+    void NullHardwarePixelBuffer::allocateBuffer()
+    {
+        if (mBuffer.data)
+            return;
+
+        mBuffer.data = new uchar[mSizeInBytes];
+    }
+    //---------------------------------------------------------------------
+    PixelBox NullHardwarePixelBuffer::lockImpl(const Box &lockBox, LockOptions options)
+    {
+        allocateBuffer();
+        mLockedBox = lockBox;
+        return mBuffer.getSubVolume(lockBox);
+    }
+    //---------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitFromMemory(const PixelBox &src, const Box &dstBox)
+    {
+        if (!mBuffer.contains(dstBox))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Destination box out of range",
+                        "NullHardwarePixelBuffer::blitFromMemory");
+        }
+
+        allocateBuffer();
+        PixelBox dst = mBuffer.getSubVolume(dstBox);
+        if (src.getWidth() != dst.getWidth() || src.getHeight() != dst.getHeight() ||
+            src.getDepth() != dst.getDepth())
+        {
+            Image::scale(src, dst);
+        }
+        else
+        {
+            PixelUtil::bulkPixelConversion(src, dst);
+        }
+    }
+    //---------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitToMemory(const Box &srcBox, const PixelBox &dst)
+    {
+        if (!mBuffer.contains(srcBox))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "source box out of range",
+                        "NullHardwarePixelBuffer::blitToMemory");
+        }
+
+        allocateBuffer();
+        PixelBox src = mBuffer.getSubVolume(srcBox);
+        if (src.getWidth() != dst.getWidth() || src.getHeight() != dst.getHeight() ||
+            src.getDepth() != dst.getDepth())
+        {
+            Image::scale(src, dst);
+        }
+        else
+        {
+            PixelUtil::bulkPixelConversion(src, dst);
+        }
+    }
+    //---------------------------------------------------------------------
+    RenderTexture* NullHardwarePixelBuffer::getRenderTarget(size_t zoffset)
+    {
+        if (mSliceTRT.empty())
+        {
+            OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR, "Texture was not created with TU_RENDERTARGET",
+                        "NullHardwarePixelBuffer::getRenderTarget");
+        }
+        assert(zoffset < mDepth);
+        return mSliceTRT[zoffset];
+    }
+    //---------------------------------------------------------------------
+    NullRenderTexture::NullRenderTexture(const String& name, HardwarePixelBuffer* buffer,
+                                         uint32 zoffset, bool hwGamma, uint fsaa)
+        : RenderTexture(buffer, zoffset)
+    {
+        mName = name;
+        mHwGamma = hwGamma;
+        mFSAA = fsaa;
+    }
+    //---------------------------------------------------------------------
+    void NullMultiRenderTarget::bindSurfaceImpl(size_t attachment, RenderTexture* target)
+    {
+        // all surfaces have the same size
+        mWidth = target->getWidth();
+        mHeight = target->getHeight();
+    }
+}
@@ -0,0 +1,599 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullRenderSystem.h"
+#include "OgreNullRenderWindow.h"
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreNullTexture.h"
+#include "OgreNullGpuProgram.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreHardwareOcclusionQuery.h"
+#include "OgreDepthBuffer.h"
+#include "OgreLogManager.h"
+#include "OgreViewport.h"
+
+namespace Ogre {
+    namespace {
+        /// Occlusion query reporting every object as visible
+        class NullHardwareOcclusionQuery : public HardwareOcclusionQuery
+        {
+        public:
+            void beginOcclusionQuery() {}
+            void endOcclusionQuery() {}
+            bool pullOcclusionQuery(unsigned int* NumOfFragments)
+            {
+                *NumOfFragments = mPixelCount = std::numeric_limits<unsigned int>::max();
+                return true;
+            }
+            bool isStillOutstanding(void) { return false; }
+        };
+
+        const char* sProgramLanguages[] = {"glsl", "glsles", "hlsl"};
+    }
+    //---------------------------------------------------------------------
+    NullRenderSystem::NullRenderSystem()
+        : mGpuProgramManager(0), mHardwareBufferManager(0), mCapabilitiesInitialised(false)
+    {
+        LogManager::getSingleton().logMessage(getName() + " created.");
+
+        initConfigOptions();
+    }
+    //---------------------------------------------------------------------
+    NullRenderSystem::~NullRenderSystem()
+    {
+        shutdown();
+    }
+    //---------------------------------------------------------------------
+    const String& NullRenderSystem::getName(void) const
+    {
+        static String strName("Null Rendering Subsystem");
+        return strName;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::initConfigOptions()
+    {
+        RenderSystem::initConfigOptions();
+
+        ConfigOption optVideoMode;
+        optVideoMode.name = "Video Mode";
+        optVideoMode.possibleValues.push_back("640 x 480");
+        optVideoMode.possibleValues.push_back("800 x 600");
+        optVideoMode.possibleValues.push_back("1024 x 768");
+        optVideoMode.possibleValues.push_back("1280 x 720");
+        optVideoMode.possibleValues.push_back("1920 x 1080");
+        optVideoMode.currentValue = optVideoMode.possibleValues[1];
+        optVideoMode.immutable = false;
+        mOptions[optVideoMode.name] = optVideoMode;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::setConfigOption(const String &name, const String &value)
+    {
+        ConfigOptionMap::iterator option = mOptions.find(name);
+        if (option == mOptions.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Option named " + name + " does not exist.",
+                        "NullRenderSystem::setConfigOption");
+        }
+        option->second.currentValue = value;
+    }
+    //---------------------------------------------------------------------
+    HardwareOcclusionQuery* NullRenderSystem::createHardwareOcclusionQuery(void)
+    {
+        HardwareOcclusionQuery* ret = OGRE_NEW NullHardwareOcclusionQuery();
+        mHwOcclusionQueries.push_back(ret);
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    RenderSystemCapabilities* NullRenderSystem::createRenderSystemCapabilities() const
+    {
+        RenderSystemCapabilities* rsc = OGRE_NEW RenderSystemCapabilities();
+
+        rsc->setRenderSystemName(getName());
+        rsc->setDeviceName("Null");
+
+        rsc->setCapability(RSC_FIXED_FUNCTION);
+        rsc->setCapability(RSC_AUTOMIPMAP_COMPRESSED);
+        rsc->setCapability(RSC_ANISOTROPY);
+        rsc->setMaxSupportedAnisotropy(16);
+        rsc->setCapability(RSC_DOT3);
+        rsc->setCapability(RSC_CUBEMAPPING);
+        rsc->setCapability(RSC_HWSTENCIL);
+        rsc->setCapability(RSC_TWO_SIDED_STENCIL);
+        rsc->setCapability(RSC_STENCIL_WRAP);
+        rsc->setStencilBufferBitDepth(8);
+        rsc->setCapability(RSC_32BIT_INDEX);
+        rsc->setCapability(RSC_SCISSOR_TEST);
+        rsc->setCapability(RSC_USER_CLIP_PLANES);
+        rsc->setCapability(RSC_VERTEX_FORMAT_UBYTE4);
+        rsc->setCapability(RSC_INFINITE_FAR_PLANE);
+        rsc->setCapability(RSC_HWOCCLUSION);
+        rsc->setCapability(RSC_HWRENDER_TO_TEXTURE);
+        rsc->setCapability(RSC_HWRENDER_TO_TEXTURE_3D);
+        rsc->setCapability(RSC_RTT_MAIN_DEPTHBUFFER_ATTACHABLE);
+        rsc->setCapability(RSC_RTT_DEPTHBUFFER_RESOLUTION_LESSEQUAL);
+        rsc->setNumMultiRenderTargets(OGRE_MAX_MULTIPLE_RENDER_TARGETS);
+        rsc->setCapability(RSC_MRT_DIFFERENT_BIT_DEPTHS);
+        rsc->setCapability(RSC_ALPHA_TO_COVERAGE);
+        rsc->setCapability(RSC_ADVANCED_BLEND_OPERATIONS);
+        rsc->setCapability(RSC_HW_GAMMA);
+        rsc->setCapability(RSC_NON_POWER_OF_2_TEXTURES);
+        rsc->setCapability(RSC_TEXTURE_1D);
+        rsc->setCapability(RSC_TEXTURE_3D);
+        rsc->setCapability(RSC_TEXTURE_FLOAT);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_DXT);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_BC4_BC5);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_BC6H_BC7);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_ETC1);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_ETC2);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_ASTC);
+        rsc->setCapability(RSC_MIPMAP_LOD_BIAS);
+        rsc->setCapability(RSC_POINT_SPRITES);
+        rsc->setCapability(RSC_POINT_EXTENDED_PARAMETERS);
+        rsc->setMaxPointSize(256);
+        rsc->setCapability(RSC_WIDE_LINES);
+        rsc->setCapability(RSC_SHARED_PARAMETER_BUFFERS);
+        rsc->setCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA);
+        rsc->setNumTextureUnits(OGRE_MAX_TEXTURE_LAYERS);
+        rsc->setNumVertexTextureUnits(OGRE_MAX_TEXTURE_LAYERS);
+        rsc->setVertexTextureUnitsShared(true);
+        rsc->setCapability(RSC_VERTEX_TEXTURE_FETCH);
+        rsc->setNumVertexAttributes(16);
+
+        rsc->setCapability(RSC_VERTEX_PROGRAM);
+        rsc->setVertexProgramConstantFloatCount(4096);
+        rsc->setVertexProgramConstantIntCount(4096);
+        rsc->setVertexProgramConstantBoolCount(4096);
+        rsc->setCapability(RSC_FRAGMENT_PROGRAM);
+        rsc->setFragmentProgramConstantFloatCount(4096);
+        rsc->setFragmentProgramConstantIntCount(4096);
+        rsc->setFragmentProgramConstantBoolCount(4096);
+        rsc->setCapability(RSC_GEOMETRY_PROGRAM);
+        rsc->setGeometryProgramConstantFloatCount(4096);
+        rsc->setGeometryProgramConstantIntCount(4096);
+        rsc->setGeometryProgramConstantBoolCount(4096);
+        rsc->setGeometryProgramNumOutputVertices(1024);
+
+        for (size_t i = 0; i < sizeof(sProgramLanguages) / sizeof(sProgramLanguages[0]); ++i)
+            rsc->addShaderProfile(sProgramLanguages[i]);
+
+        return rsc;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps,
+                                                                  RenderTarget* primary)
+    {
+        if (caps->getRenderSystemName() != getName())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Trying to initialize NullRenderSystem from RenderSystemCapabilities that do not support Null",
+                        "NullRenderSystem::initialiseFromRenderSystemCapabilities");
+        }
+
+        mGpuProgramManager = OGRE_NEW NullGpuProgramManager();
+        for (size_t i = 0; i < sizeof(sProgramLanguages) / sizeof(sProgramLanguages[0]); ++i)
+        {
+            mProgramFactories.push_back(OGRE_NEW NullHighLevelGpuProgramFactory(sProgramLanguages[i]));
+            HighLevelGpuProgramManager::getSingleton().addFactory(mProgramFactories.back());
+        }
+
+        mHardwareBufferManager = OGRE_NEW DefaultHardwareBufferManager();
+
+        Log* defaultLog = LogManager::getSingleton().getDefaultLog();
+        if (defaultLog)
+        {
+            caps->log(defaultLog);
+        }
+
+        mCapabilitiesInitialised = true;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_initialise()
+    {
+        RenderSystem::_initialise();
+
+        mTextureManager = OGRE_NEW NullTextureManager();
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::reinitialise(void)
+    {
+        shutdown();
+        _initialise();
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::shutdown(void)
+    {
+        for (size_t i = 0; i < mProgramFactories.size(); ++i)
+        {
+            // Remove from manager safely
+            if (HighLevelGpuProgramManager::getSingletonPtr())
+                HighLevelGpuProgramManager::getSingleton().removeFactory(mProgramFactories[i]);
+            OGRE_DELETE mProgramFactories[i];
+        }
+        mProgramFactories.clear();
+
+        OGRE_DELETE mGpuProgramManager;
+        mGpuProgramManager = 0;
+
+        OGRE_DELETE mHardwareBufferManager;
+        mHardwareBufferManager = 0;
+
+        OGRE_DELETE mTextureManager;
+        mTextureManager = 0;
+
+        RenderSystem::shutdown();
+
+        mCapabilitiesInitialised = false;
+    }
+    //---------------------------------------------------------------------
+    RenderWindow* NullRenderSystem::_createRenderWindow(const String &name, unsigned int width,
+                                                       unsigned int height, bool fullScreen,
+                                                       const NameValuePairList *miscParams)
+    {
+        if (mRenderTargets.find(name) != mRenderTargets.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Window with name '" + name + "' already exists",
+                        "NullRenderSystem::_createRenderWindow");
+        }
+
+        RenderWindow* win = OGRE_NEW NullRenderWindow();
+        win->create(name, width, height, fullScreen, miscParams);
+        attachRenderTarget(*win);
+
+        if (!mCapabilitiesInitialised)
+        {
+            mRealCapabilities = createRenderSystemCapabilities();
+
+            // use real capabilities if custom capabilities are not available
+            if (!mUseCustomCapabilities)
+                mCurrentCapabilities = mRealCapabilities;
+
+            fireEvent("RenderSystemCapabilitiesCreated");
+
+            initialiseFromRenderSystemCapabilities(mCurrentCapabilities, win);
+        }
+
+        return win;
+    }
+    //---------------------------------------------------------------------
+    MultiRenderTarget* NullRenderSystem::createMultiRenderTarget(const String & name)
+    {
+        MultiRenderTarget* retval = OGRE_NEW NullMultiRenderTarget(name);
+        attachRenderTarget(*retval);
+        return retval;
+    }
+    //---------------------------------------------------------------------
+    DepthBuffer* NullRenderSystem::_createDepthBufferFor(RenderTarget *renderTarget)
+    {
+        return OGRE_NEW DepthBuffer(DepthBuffer::POOL_DEFAULT, 24, renderTarget->getWidth(),
+                                    renderTarget->getHeight(), renderTarget->getFSAA(),
+                                    renderTarget->getFSAAHint(), false);
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setSampler(size_t texUnit, Sampler& s)
+    {
+        mStatistics.textureBinds++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTexture(size_t unit, bool enabled, const TexturePtr &texPtr)
+    {
+        // make sure the texture is loaded, as a real render system would need its contents
+        if (enabled && texPtr)
+            texPtr->touch();
+        mStatistics.textureBinds++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureUnitCompareEnabled(size_t unit, bool compare)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureUnitCompareFunction(size_t unit, CompareFunction function)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureAddressingMode(size_t unit, const Sampler::UVWAddressingMode& uvw)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureBorderColour(size_t unit, const ColourValue& colour)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureMipmapBias(size_t unit, float bias)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setTextureBlendMode(size_t unit, const LayerBlendModeEx& bm)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_useLights(const LightList& lights, unsigned short limit)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setWorldMatrix(const Matrix4 &m)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setViewMatrix(const Matrix4 &m)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setProjectionMatrix(const Matrix4 &m)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setSurfaceParams(const ColourValue &ambient, const ColourValue &diffuse,
+                                             const ColourValue &specular, const ColourValue &emissive,
+                                             Real shininess, TrackVertexColourType tracking)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setSeparateSceneBlending(SceneBlendFactor sourceFactor,
+                                                     SceneBlendFactor destFactor,
+                                                     SceneBlendFactor sourceFactorAlpha,
+                                                     SceneBlendFactor destFactorAlpha,
+                                                     SceneBlendOperation op, SceneBlendOperation alphaOp)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setAlphaRejectSettings(CompareFunction func, unsigned char value,
+                                                   bool alphaToCoverage)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setCullingMode(CullingMode mode)
+    {
+        mCullingMode = mode;
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferParams(bool depthTest, bool depthWrite,
+                                                 CompareFunction depthFunction)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferCheckEnabled(bool enabled)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferWriteEnabled(bool enabled)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferFunction(CompareFunction func)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBias(float constantBias, float slopeScaleBias)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setPolygonMode(PolygonMode level)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::setStencilCheckEnabled(bool enabled)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::setStencilBufferParams(CompareFunction func, uint32 refValue,
+                                                  uint32 compareMask, uint32 writeMask,
+                                                  StencilOperation stencilFailOp,
+                                                  StencilOperation depthFailOp,
+                                                  StencilOperation passOp, bool twoSidedOperation,
+                                                  bool readBackAsTexture)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::setScissorTest(bool enabled, size_t left, size_t top, size_t right,
+                                          size_t bottom)
+    {
+        mStatistics.stateChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_beginFrame(void)
+    {
+        if (!mActiveViewport)
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "Cannot begin frame - no viewport selected.",
+                        "NullRenderSystem::_beginFrame");
+        mStatistics.frames++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_endFrame(void)
+    {
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setViewport(Viewport *vp)
+    {
+        if (!vp)
+        {
+            mActiveViewport = NULL;
+            _setRenderTarget(NULL);
+        }
+        else if (vp != mActiveViewport || vp->_isUpdated())
+        {
+            _setRenderTarget(vp->getTarget());
+            mActiveViewport = vp;
+            vp->_clearUpdatedFlag();
+            mStatistics.viewportChanges++;
+        }
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_setRenderTarget(RenderTarget *target)
+    {
+        mActiveRenderTarget = target;
+        if (!target)
+            return;
+
+        // Depth is automatically managed and there is no depth buffer attached to this RT
+        if (target->getDepthBufferPool() != DepthBuffer::POOL_NO_DEPTH && !target->getDepthBuffer())
+            setDepthBufferFor(target);
+
+        mStatistics.renderTargetChanges++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::clearFrameBuffer(unsigned int buffers, const ColourValue& colour,
+                                            Real depth, unsigned short stencil)
+    {
+        mStatistics.clears++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_render(const RenderOperation& op)
+    {
+        // Call super class
+        RenderSystem::_render(op);
+
+        mStatistics.drawCalls++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::bindGpuProgram(GpuProgram* prg)
+    {
+        RenderSystem::bindGpuProgram(prg);
+        mStatistics.programBinds++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::unbindGpuProgram(GpuProgramType gptype)
+    {
+        RenderSystem::unbindGpuProgram(gptype);
+        mStatistics.programBinds++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::bindGpuProgramParameters(GpuProgramType gptype,
+                                                    const GpuProgramParametersPtr& params,
+                                                    uint16 variabilityMask)
+    {
+        // same CPU side work as the other render systems
+        if (variabilityMask & (uint16)GPV_GLOBAL)
+        {
+            params->_copySharedParams();
+
+            // sets with a uniform buffer are bound instead of copied
+            const GpuProgramParameters::GpuSharedParamUsageList& sharedParams =
+                params->getSharedParameters();
+            for (size_t i = 0; i < sharedParams.size(); ++i)
+            {
+                GpuSharedParameters* shared = sharedParams[i].getSharedParams().get();
+                if (shared->_getHardwareBuffer())
+                {
+                    size_t bytes = shared->_upload();
+                    if (bytes)
+                    {
+                        mStatistics.uniformBufferUploads++;
+                        mStatistics.uniformBufferBytes += bytes;
+                    }
+                }
+                else
+                {
+                    mStatistics.sharedParameterCopies++;
+                    mStatistics.sharedParameterBytes +=
+                        shared->getFloatConstantList().size() * sizeof(float);
+                }
+            }
+        }
+
+        mStatistics.parameterUploads++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::bindGpuProgramPassIterationParameters(GpuProgramType gptype)
+    {
+        mStatistics.parameterUploads++;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_convertProjectionMatrix(const Matrix4& matrix, Matrix4& dest,
+                                                    bool forGpuProgram)
+    {
+        // same conventions as OpenGL
+        dest = matrix;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane,
+                                                 Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "use Frustum::getProjectionMatrixRS",
+                    "NullRenderSystem::_makeProjectionMatrix");
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_makeProjectionMatrix(Real left, Real right, Real bottom, Real top,
+                                                 Real nearPlane, Real farPlane, Matrix4& dest,
+                                                 bool forGpuProgram)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "use Frustum::getProjectionMatrixRS",
+                    "NullRenderSystem::_makeProjectionMatrix");
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane,
+                                            Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "use Frustum::getProjectionMatrixRS",
+                    "NullRenderSystem::_makeOrthoMatrix");
+    }
+    //---------------------------------------------------------------------
+    void NullRenderSystem::_applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane,
+                                                        bool forGpuProgram)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "use Frustum::enableCustomNearClipPlane",
+                    "NullRenderSystem::_applyObliqueDepthProjection");
+    }
+}
@@ -0,0 +1,118 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullRenderWindow.h"
+#include "OgreViewport.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    NullRenderWindow::NullRenderWindow() : mClosed(false)
+    {
+    }
+    //---------------------------------------------------------------------
+    NullRenderWindow::~NullRenderWindow()
+    {
+        destroy();
+    }
+    //---------------------------------------------------------------------
+    void NullRenderWindow::create(const String& name, unsigned int widthPt, unsigned int heightPt,
+            bool fullScreen, const NameValuePairList *miscParams)
+    {
+        mName = name;
+        mWidth = widthPt;
+        mHeight = heightPt;
+        mIsFullScreen = fullScreen;
+        mColourDepth = 32;
+        mLeft = 0;
+        mTop = 0;
+
+        if (miscParams)
+        {
+            NameValuePairList::const_iterator opt;
+            if ((opt = miscParams->find("FSAA")) != miscParams->end())
+                mFSAA = StringConverter::parseUnsignedInt(opt->second);
+            if ((opt = miscParams->find("gamma")) != miscParams->end())
+                mHwGamma = StringConverter::parseBool(opt->second);
+            if ((opt = miscParams->find("left")) != miscParams->end())
+                mLeft = StringConverter::parseInt(opt->second);
+            if ((opt = miscParams->find("top")) != miscParams->end())
+                mTop = StringConverter::parseInt(opt->second);
+        }
+
+        mActive = true;
+        mClosed = false;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderWindow::setFullscreen(bool fullScreen, unsigned int widthPt, unsigned int heightPt)
+    {
+        mIsFullScreen = fullScreen;
+        resize(widthPt, heightPt);
+    }
+    //---------------------------------------------------------------------
+    void NullRenderWindow::destroy(void)
+    {
+        mActive = false;
+        mClosed = true;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderWindow::resize(unsigned int widthPt, unsigned int heightPt)
+    {
+        if (mWidth == widthPt && mHeight == heightPt)
+            return;
+
+        mWidth = widthPt;
+        mHeight = heightPt;
+
+        for (ViewportList::iterator it = mViewportList.begin(); it != mViewportList.end(); ++it)
+            it->second->_updateDimensions();
+    }
+    //---------------------------------------------------------------------
+    void NullRenderWindow::reposition(int leftPt, int topPt)
+    {
+        mLeft = leftPt;
+        mTop = topPt;
+    }
+    //---------------------------------------------------------------------
+    void NullRenderWindow::copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer)
+    {
+        if (src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1 ||
+            dst.getWidth() != src.getWidth() || dst.getHeight() != src.getHeight() ||
+            dst.getDepth() != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.",
+                        "NullRenderWindow::copyContentsToMemory");
+        }
+
+        // nothing is ever drawn
+        size_t rowSize = PixelUtil::getMemorySize(dst.getWidth(), 1, 1, dst.format);
+        size_t rowPitch = PixelUtil::getMemorySize(dst.rowPitch, 1, 1, dst.format);
+        uchar* row = dst.getTopLeftFrontPixelPtr();
+        for (uint32 y = 0; y < dst.getHeight(); ++y, row += rowPitch)
+            memset(row, 0, rowSize);
+    }
+}
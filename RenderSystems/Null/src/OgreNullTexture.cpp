@@ -0,0 +1,114 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullTexture.h"
+#include "OgreBitwise.h"
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreResourceGroupManager.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    NullTexture::NullTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+                             const String& group, bool isManual, ManualResourceLoader* loader)
+        : Texture(creator, name, handle, group, isManual, loader)
+    {
+    }
+    //---------------------------------------------------------------------
+    NullTexture::~NullTexture()
+    {
+        // have to call this here rather than in Resource destructor
+        // since calling virtual methods in base destructors causes crash
+        if (isLoaded())
+        {
+            unload();
+        }
+        else
+        {
+            freeInternalResources();
+        }
+    }
+    //---------------------------------------------------------------------
+    void NullTexture::createInternalResourcesImpl(void)
+    {
+        mFormat = TextureManager::getSingleton().getNativeFormat(mTextureType, mFormat, mUsage);
+
+        // Check requested number of mipmaps, full chain down to 1x1 as with NPOT support
+        uint32 maxMips = Bitwise::mostSignificantBitSet(std::max(mWidth, std::max(mHeight, mDepth)));
+        mNumMipmaps = std::min(mNumRequestedMipmaps, maxMips);
+
+        // Pretend the mipmaps get generated on upload
+        mMipmapsHardwareGenerated = true;
+
+        mSurfaceList.clear();
+        uint32 depth = mDepth;
+        for (size_t face = 0; face < getNumFaces(); face++)
+        {
+            uint32 width = mWidth;
+            uint32 height = mHeight;
+
+            for (uint32 mip = 0; mip <= getNumMipmaps(); mip++)
+            {
+                mSurfaceList.push_back(HardwarePixelBufferSharedPtr(OGRE_NEW NullHardwarePixelBuffer(
+                    mName, width, height, depth, mFormat, mUsage, mHwGamma, mFSAA)));
+
+                if (width > 1)
+                    width = width / 2;
+                if (height > 1)
+                    height = height / 2;
+                if (depth > 1 && mTextureType != TEX_TYPE_2D_ARRAY)
+                    depth = depth / 2;
+            }
+            depth = mDepth;
+        }
+    }
+    //---------------------------------------------------------------------
+    NullTextureManager::NullTextureManager()
+    {
+        // Register with group manager
+        ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+    }
+    //---------------------------------------------------------------------
+    NullTextureManager::~NullTextureManager()
+    {
+        // Unregister with group manager
+        ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+    }
+    //---------------------------------------------------------------------
+    Resource* NullTextureManager::createImpl(const String& name, ResourceHandle handle,
+                                             const String& group, bool isManual,
+                                             ManualResourceLoader* loader,
+                                             const NameValuePairList* createParams)
+    {
+        return OGRE_NEW NullTexture(this, name, handle, group, isManual, loader);
+    }
+    //---------------------------------------------------------------------
+    PixelFormat NullTextureManager::getNativeFormat(TextureType ttype, PixelFormat format, int usage)
+    {
+        // every format is kept as is in system memory
+        return format == PF_UNKNOWN ? PF_BYTE_RGBA : format;
+    }
+}
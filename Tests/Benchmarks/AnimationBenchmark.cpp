@@ -0,0 +1,287 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/** Skeletal animation sampling microbenchmark.
+
+    Applies one animation to a set of skeleton instances at advancing time positions,
+    once track by track with NodeAnimationTrack::applyToNode, once with the packed key
+    frames (see Animation::setUsePackedKeyFrames) of Animation::apply and once with the
+    packed key frames and a key frame cursor per skeleton, as Skeleton::setAnimationState
+    does. A copy of the animation with compressed node tracks is applied the same way,
+    after reducing its key frames if a tolerance is given. The bones are reset before each
+    apply, but not updated. Results are written as JSON, to stdout or to the file given by
+    output=<path>.
+
+    Usage: Test_AnimationBenchmark [skeletons=N] [bones=B] [keys=K] [frames=F]
+        [tolerance=T] [output=path]
+
+    The tolerance is used for translations, scales and, in radians, rotations.
+
+    Every other track has its key frames half a key apart from the others, so there are
+    2*K global key frames. As usual for skeletons, only the root bone has translations.
+*/
+#include "Benchmark.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeletonInstance.h"
+
+using namespace Ogre;
+//--------------------------------------------------------------------------
+namespace
+{
+struct BenchmarkConfig
+{
+    size_t skeletons;
+    size_t bones;
+    size_t keys;
+    size_t frames;
+    Real tolerance;
+
+    BenchmarkConfig() : skeletons(200), bones(60), keys(30), frames(200), tolerance(0) {}
+};
+
+/// In the order the constructor adds them
+enum BenchmarkStage
+{
+    STAGE_PER_TRACK,
+    STAGE_PACKED,
+    STAGE_PACKED_CURSOR,
+    STAGE_COMPRESSED,
+    STAGE_COUNT
+};
+
+class AnimationBenchmark : public Benchmark
+{
+    BenchmarkConfig mConfig;
+
+    Root* mRoot;
+
+    SkeletonPtr mSkeleton;
+    Animation* mAnimation;
+    Animation* mCompressed;
+    std::vector<SkeletonInstance*> mInstances;
+    std::vector<uint> mCursors;
+    bool mIdentical;
+    size_t mKeyFrameBytes;
+    size_t mCompressedKeyFrames;
+    size_t mCompressedBytes;
+    Real mMaxTranslationError;
+    Real mMaxRotationError;
+public:
+    AnimationBenchmark()
+        : Benchmark("Animation"), mRoot(0), mCompressed(0), mIdentical(true), mKeyFrameBytes(0),
+          mCompressedKeyFrames(0), mCompressedBytes(0), mMaxTranslationError(0),
+          mMaxRotationError(0)
+    {
+        addOption("skeletons", mConfig.skeletons);
+        addOption("bones", mConfig.bones);
+        addOption("keys", mConfig.keys);
+        addOption("frames", mConfig.frames);
+        addOption("tolerance", mConfig.tolerance);
+
+        addStage("perTrack");
+        addStage("packed");
+        addStage("packedCursor");
+        addStage("compressed");
+    }
+
+    void setup()
+    {
+        mConfig.skeletons = std::max<size_t>(mConfig.skeletons, 1);
+        mConfig.bones = Math::Clamp<size_t>(mConfig.bones, 1, OGRE_MAX_NUM_BONES);
+        mConfig.keys = std::max<size_t>(mConfig.keys, 2);
+
+        mRoot = OGRE_NEW Root("", "", "");
+        createSkeleton();
+    }
+
+    ~AnimationBenchmark()
+    {
+        for (size_t i = 0; i < mInstances.size(); ++i)
+            OGRE_DELETE mInstances[i];
+        OGRE_DELETE mCompressed;
+        mSkeleton.reset();
+        OGRE_DELETE mRoot;
+    }
+
+    void createSkeleton()
+    {
+        mSkeleton = SkeletonManager::getSingleton().create("bench/skeleton", RGN_DEFAULT, true);
+        Bone* bone = mSkeleton->createBone(0);
+        for (unsigned short i = 1; i < mConfig.bones; ++i)
+        {
+            // short branches off a spine
+            Bone* parent = i % 4 ? bone : mSkeleton->getBone(i - 4);
+            bone = parent->createChild(i, Vector3(0, 10, 0));
+        }
+        mSkeleton->setBindingPose();
+
+        Real length = 2;
+        Real step = length / mConfig.keys;
+        mAnimation = mSkeleton->createAnimation("bench", length);
+        for (unsigned short i = 0; i < mConfig.bones; ++i)
+        {
+            NodeAnimationTrack* track = mAnimation->createNodeTrack(i, mSkeleton->getBone(i));
+            Real offset = i % 2 ? step / 2 : 0;
+            for (size_t k = 0; k < mConfig.keys; ++k)
+            {
+                Real angle = Math::Sin(Radian(Real(k) * 0.3f + i)) * 30;
+                TransformKeyFrame* kf = track->createNodeKeyFrame(offset + k * step);
+                kf->setRotation(Quaternion(Degree(angle), Vector3(1, Real(i % 3), 0).normalisedCopy()));
+                if (i == 0)
+                    kf->setTranslate(Vector3(0, Math::Cos(Radian(Real(k))) * 0.5f, 0));
+                if (i % 8 == 0)
+                    kf->setScale(Vector3(1 + angle / 300));
+            }
+        }
+
+        mCompressed = mAnimation->clone("benchCompressed");
+        mAnimation->setUsePackedKeyFrames(true);
+        if (mConfig.tolerance > 0)
+            mCompressed->reduceNodeKeyFrames(mConfig.tolerance, Radian(mConfig.tolerance),
+                                             mConfig.tolerance);
+        mCompressed->compressNodeTracks();
+        for (unsigned short i = 0; i < mConfig.bones; ++i)
+        {
+            mKeyFrameBytes += mAnimation->getNodeTrack(i)->calculateKeyFrameSize();
+            mCompressedKeyFrames += mCompressed->getNodeTrack(i)->getNumKeyFrames();
+            mCompressedBytes += mCompressed->getNodeTrack(i)->calculateKeyFrameSize();
+        }
+
+        for (size_t i = 0; i < mConfig.skeletons; ++i)
+        {
+            mInstances.push_back(OGRE_NEW SkeletonInstance(mSkeleton));
+            mInstances.back()->load();
+        }
+        mCursors.resize(mConfig.skeletons, 0);
+    }
+
+    Real timeOf(size_t frame, size_t instance) const
+    {
+        return std::fmod(Real(frame) / 60 + Real(instance) * 0.37f, mAnimation->getLength());
+    }
+
+    void run()
+    {
+        // warm up, which also builds the packed key frames
+        for (int s = 0; s < STAGE_COUNT; ++s)
+            runStage(BenchmarkStage(s), 0);
+        checkIdentical();
+
+        for (size_t f = 0; f < mConfig.frames; ++f)
+        {
+            for (int s = 0; s < STAGE_COUNT; ++s)
+            {
+                unsigned long start = mTimer.getMicroseconds();
+                runStage(BenchmarkStage(s), f);
+                addSample(s, mTimer.getMicroseconds() - start);
+            }
+        }
+
+        addCounter("identical", mIdentical);
+        addCounter("keyFrames", mConfig.bones * mConfig.keys);
+        addCounter("keyFrameBytes", mKeyFrameBytes);
+        addCounter("compressedKeyFrames", mCompressedKeyFrames);
+        addCounter("compressedBytes", mCompressedBytes);
+        addCounter("maxTranslationError", mMaxTranslationError);
+        addCounter("maxRotationError", mMaxRotationError);
+    }
+
+    void runStage(BenchmarkStage stage, size_t frame)
+    {
+        for (size_t i = 0; i < mInstances.size(); ++i)
+        {
+            SkeletonInstance* skel = mInstances[i];
+            Real time = timeOf(frame, i);
+            skel->reset();
+            switch (stage)
+            {
+            case STAGE_PER_TRACK:
+                applyPerTrack(skel, time);
+                break;
+            case STAGE_PACKED:
+                mAnimation->apply(skel, time);
+                break;
+            case STAGE_PACKED_CURSOR:
+                mAnimation->_applyToSkeleton(skel, time, 1, NULL, 1, &mCursors[i]);
+                break;
+            default:
+                mCompressed->_applyToSkeleton(skel, time, 1, NULL, 1, &mCursors[i]);
+                break;
+            }
+        }
+    }
+
+    /// What Animation::apply did before the key frames were packed
+    void applyPerTrack(Skeleton* skel, Real time)
+    {
+        TimeIndex timeIndex = mAnimation->_getTimeIndex(time);
+        Animation::NodeTrackIterator it = mAnimation->getNodeTrackIterator();
+        while (it.hasMoreElements())
+        {
+            NodeAnimationTrack* track = it.getNext();
+            track->applyToNode(skel->getBone(track->getHandle()), timeIndex);
+        }
+    }
+
+    void checkIdentical()
+    {
+        for (size_t i = 0; i < mInstances.size(); ++i)
+        {
+            SkeletonInstance* skel = mInstances[i];
+            skel->reset();
+            applyPerTrack(skel, timeOf(1, i));
+            std::vector<std::pair<Vector3, Quaternion> > expected;
+            for (unsigned short b = 0; b < skel->getNumBones(); ++b)
+                expected.push_back(std::make_pair(skel->getBone(b)->getPosition(),
+                                                  skel->getBone(b)->getOrientation()));
+
+            skel->reset();
+            mAnimation->apply(skel, timeOf(1, i));
+            for (unsigned short b = 0; b < skel->getNumBones(); ++b)
+            {
+                if (skel->getBone(b)->getPosition() != expected[b].first ||
+                    skel->getBone(b)->getOrientation() != expected[b].second)
+                    mIdentical = false;
+            }
+
+            skel->reset();
+            mCompressed->apply(skel, timeOf(1, i));
+            for (unsigned short b = 0; b < skel->getNumBones(); ++b)
+            {
+                Real error = skel->getBone(b)->getPosition().distance(expected[b].first);
+                mMaxTranslationError = std::max(mMaxTranslationError, error);
+                const Quaternion& q = skel->getBone(b)->getOrientation();
+                error = std::min((q - expected[b].second).Norm(), (q + expected[b].second).Norm());
+                // the angle between them, for small errors
+                mMaxRotationError = std::max(mMaxRotationError, error * 2);
+            }
+        }
+    }
+};
+}
+//--------------------------------------------------------------------------
+BENCHMARK_MAIN(AnimationBenchmark)
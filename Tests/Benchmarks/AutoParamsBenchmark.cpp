@@ -0,0 +1,267 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/** Auto constant update microbenchmark.
+
+    Times GpuProgramParameters::_updateAutoParams for a typical lit vertex program
+    and fragment program over a set of renderables, once with all variabilities as after
+    a pass change and once with only the per object ones as for further renderables of
+    the same pass. Results are written as JSON, to stdout or to the file given by
+    output=<path>.
+
+    Usage: Test_AutoParamsBenchmark [renderables=N] [pernode=K] [lights=L] [frames=F] [output=path]
+
+    pernode attaches K renderables to each scene node, as for instanced-style scenes
+    drawing many renderables with the same world transform.
+*/
+#include "Benchmark.h"
+#include "OgreNullPlugin.h"
+#include "OgreNullRenderSystem.h"
+
+using namespace Ogre;
+//--------------------------------------------------------------------------
+namespace
+{
+struct BenchmarkConfig
+{
+    size_t renderables;
+    size_t perNode;
+    size_t lights;
+    size_t frames;
+
+    BenchmarkConfig() : renderables(1000), perNode(1), lights(4), frames(200) {}
+};
+
+/// In the order the constructor adds them
+enum BenchmarkStage
+{
+    STAGE_ALL,
+    STAGE_PER_OBJECT,
+    STAGE_COUNT
+};
+
+void addConstant(GpuNamedConstants& defs, const String& name, GpuConstantType type, size_t arraySize = 1)
+{
+    GpuConstantDefinition def;
+    def.constType = type;
+    def.elementSize = GpuConstantDefinition::getElementSize(type, false);
+    def.arraySize = arraySize;
+    def.logicalIndex = defs.map.size();
+    def.physicalIndex = defs.floatBufferSize;
+    def.variability = GPV_GLOBAL;
+    defs.floatBufferSize += def.elementSize * arraySize;
+    defs.map[name] = def;
+}
+
+class AutoParamsBenchmark : public Benchmark
+{
+    BenchmarkConfig mConfig;
+
+    Root* mRoot;
+    NullPlugin* mNullPlugin;
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+    Viewport* mViewport;
+
+    std::vector<Renderable*> mRenderables;
+    LightList mLights;
+    GpuProgramParametersSharedPtr mVertexParams;
+    GpuProgramParametersSharedPtr mFragmentParams;
+    Pass* mPass;
+
+    AutoParamDataSource mSource;
+public:
+    AutoParamsBenchmark() : Benchmark("AutoParams"), mRoot(0), mNullPlugin(0)
+    {
+        addOption("renderables", mConfig.renderables);
+        addOption("pernode", mConfig.perNode);
+        addOption("lights", mConfig.lights);
+        addOption("frames", mConfig.frames);
+
+        addStage("allVariabilities");
+        addStage("perObject");
+    }
+
+    void setup()
+    {
+        mConfig.renderables = std::max<size_t>(mConfig.renderables, 1);
+        mConfig.perNode = std::max<size_t>(mConfig.perNode, 1);
+        mConfig.lights = std::max<size_t>(mConfig.lights, 1);
+
+        mRoot = OGRE_NEW Root("", "", "");
+        mNullPlugin = OGRE_NEW NullPlugin();
+        mRoot->installPlugin(mNullPlugin);
+        mRoot->setRenderSystem(mRoot->getRenderSystemByName("Null Rendering Subsystem"));
+        mRoot->initialise(false);
+        RenderWindow* window = mRoot->createRenderWindow("AutoParamsBenchmark", 1280, 720, false);
+
+        mSceneMgr = mRoot->createSceneManager();
+        mCamera = mSceneMgr->createCamera("Camera");
+        mCamera->setNearClipDistance(1);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 1000))->attachObject(mCamera);
+        mViewport = window->addViewport(mCamera);
+
+        createProgram();
+        createScene();
+
+        mSource.setCurrentSceneManager(mSceneMgr);
+        mSource.setCurrentViewport(mViewport);
+        mSource.setCurrentRenderTarget(window);
+        mSource.setCurrentPass(mPass);
+        mSource.setCurrentLightList(&mLights);
+        mSource.setAmbientLightColour(ColourValue(0.2f, 0.2f, 0.2f));
+    }
+
+    ~AutoParamsBenchmark()
+    {
+        mVertexParams.reset();
+        mFragmentParams.reset();
+        OGRE_DELETE mRoot;
+        OGRE_DELETE mNullPlugin;
+    }
+
+    void createProgram()
+    {
+        GpuNamedConstants vpConstants;
+        addConstant(vpConstants, "worldViewProj", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "world", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "worldView", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "inverseTransposeWorld", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "viewProj", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "view", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "cameraPosition", GCT_FLOAT4);
+        addConstant(vpConstants, "lightPosition", GCT_FLOAT4, mConfig.lights);
+        addConstant(vpConstants, "lightAttenuation", GCT_FLOAT4, mConfig.lights);
+        GpuProgramPtr vp = GpuProgramManager::getSingleton().createProgramFromString(
+            "bench/vp", RGN_DEFAULT, "", GPT_VERTEX_PROGRAM, "glsl");
+        vp->setManualNamedConstants(vpConstants);
+
+        GpuNamedConstants fpConstants;
+        addConstant(fpConstants, "lightDiffuse", GCT_FLOAT4, mConfig.lights);
+        addConstant(fpConstants, "ambient", GCT_FLOAT4);
+        addConstant(fpConstants, "fogColour", GCT_FLOAT4);
+        addConstant(fpConstants, "inverseView", GCT_MATRIX_4X4);
+        GpuProgramPtr fp = GpuProgramManager::getSingleton().createProgramFromString(
+            "bench/fp", RGN_DEFAULT, "", GPT_FRAGMENT_PROGRAM, "glsl");
+        fp->setManualNamedConstants(fpConstants);
+
+        MaterialPtr mat = MaterialManager::getSingleton().create("bench/shaded", RGN_DEFAULT);
+        mPass = mat->getTechnique(0)->getPass(0);
+        mPass->setVertexProgram("bench/vp");
+        mPass->setFragmentProgram("bench/fp");
+
+        mVertexParams = mPass->getVertexProgramParameters();
+        mVertexParams->setNamedAutoConstant("worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+        mVertexParams->setNamedAutoConstant("world", GpuProgramParameters::ACT_WORLD_MATRIX);
+        mVertexParams->setNamedAutoConstant("worldView", GpuProgramParameters::ACT_WORLDVIEW_MATRIX);
+        mVertexParams->setNamedAutoConstant("inverseTransposeWorld",
+                                            GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLD_MATRIX);
+        mVertexParams->setNamedAutoConstant("viewProj", GpuProgramParameters::ACT_VIEWPROJ_MATRIX);
+        mVertexParams->setNamedAutoConstant("view", GpuProgramParameters::ACT_VIEW_MATRIX);
+        mVertexParams->setNamedAutoConstant("cameraPosition",
+                                            GpuProgramParameters::ACT_CAMERA_POSITION_OBJECT_SPACE);
+        mVertexParams->setNamedAutoConstant(
+            "lightPosition", GpuProgramParameters::ACT_LIGHT_POSITION_OBJECT_SPACE_ARRAY, mConfig.lights);
+        mVertexParams->setNamedAutoConstant(
+            "lightAttenuation", GpuProgramParameters::ACT_LIGHT_ATTENUATION_ARRAY, mConfig.lights);
+
+        mFragmentParams = mPass->getFragmentProgramParameters();
+        mFragmentParams->setNamedAutoConstant(
+            "lightDiffuse", GpuProgramParameters::ACT_LIGHT_DIFFUSE_COLOUR_ARRAY, mConfig.lights);
+        mFragmentParams->setNamedAutoConstant("ambient", GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR);
+        mFragmentParams->setNamedAutoConstant("fogColour", GpuProgramParameters::ACT_FOG_COLOUR);
+        mFragmentParams->setNamedAutoConstant("inverseView", GpuProgramParameters::ACT_INVERSE_VIEW_MATRIX);
+    }
+
+    void createScene()
+    {
+        MeshManager::getSingleton().createPlane("bench/plane", RGN_DEFAULT, Plane(Vector3::UNIT_Z, 0),
+                                                 10, 10);
+        SceneNode* node = NULL;
+        for (size_t i = 0; i < mConfig.renderables; ++i)
+        {
+            Entity* ent = mSceneMgr->createEntity("bench/plane");
+            if (i % mConfig.perNode == 0)
+            {
+                size_t n = i / mConfig.perNode;
+                node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                    Vector3(Real(n % 100) * 20, Real(n / 100) * 20, 0),
+                    Quaternion(Degree(Real(n)), Vector3::UNIT_Y));
+                node->setScale(Vector3(1 + (n % 3) * 0.5f));
+            }
+            node->attachObject(ent);
+            mRenderables.push_back(ent->getSubEntity(0));
+        }
+        for (size_t i = 0; i < mConfig.lights; ++i)
+        {
+            Light* light = mSceneMgr->createLight();
+            light->setAttenuation(500, 1, 0.01f, 0);
+            mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(Real(i) * 100, 50, 100))
+                ->attachObject(light);
+            mLights.push_back(light);
+        }
+        mSceneMgr->getRootSceneNode()->_update(true, false);
+    }
+
+    void run()
+    {
+        // warm up, which also lets the parameters prepare their updates
+        runFrame(GPV_ALL);
+        mSource.resetCacheStatistics();
+
+        for (size_t f = 0; f < mConfig.frames; ++f)
+        {
+            unsigned long start = mTimer.getMicroseconds();
+            runFrame(GPV_ALL);
+            addSample(STAGE_ALL, mTimer.getMicroseconds() - start);
+
+            start = mTimer.getMicroseconds();
+            runFrame(GPV_PER_OBJECT);
+            addSample(STAGE_PER_OBJECT, mTimer.getMicroseconds() - start);
+        }
+
+        addCounter("autoConstants",
+                   mVertexParams->getAutoConstantCount() + mFragmentParams->getAutoConstantCount());
+        addCounter("derivedCacheHits", mSource.getCacheStatistics().hits);
+        addCounter("derivedCacheMisses", mSource.getCacheStatistics().misses);
+    }
+
+    /// Same data source updates as SceneManager::renderSingleObject
+    void runFrame(uint16 mask)
+    {
+        mSource.setCurrentCamera(mCamera, false);
+        for (size_t i = 0; i < mRenderables.size(); ++i)
+        {
+            mSource.setCurrentRenderable(mRenderables[i]);
+            mVertexParams->_updateAutoParams(&mSource, mask);
+            mFragmentParams->_updateAutoParams(&mSource, mask);
+        }
+    }
+};
+}
+//--------------------------------------------------------------------------
+BENCHMARK_MAIN(AutoParamsBenchmark)
@@ -0,0 +1,230 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/** BVH scene manager microbenchmark.
+
+    Builds a flat scene of randomly placed boxes in the BVHSceneManager and in the
+    OctreeSceneManager, then per frame moves a fraction of the nodes and culls against a
+    camera, and finally runs sphere queries at random positions. Results are written as
+    JSON, to stdout or to the file given by output=<path>.
+
+    Usage: Test_BVHSceneManagerBenchmark [nodes=N] [frames=F] [queries=Q] [moveevery=M]
+        [output=path]
+
+    Every M-th node is moved per frame, mostly by a small step and every tenth of them to
+    a random position. Stages and counters are prefixed with bvh/ or octree/.
+*/
+#include "Benchmark.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreOctreeSceneManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+#include <random>
+
+using namespace Ogre;
+//--------------------------------------------------------------------------
+namespace
+{
+struct BenchmarkConfig
+{
+    size_t nodes;
+    size_t frames;
+    size_t queries;
+    size_t moveEvery;
+
+    BenchmarkConfig() : nodes(5000), frames(50), queries(200), moveEvery(4) {}
+};
+
+/// Stages of each scene manager, in the order the constructor adds them
+enum BenchmarkStage
+{
+    STAGE_UPDATE,
+    STAGE_CULL,
+    STAGE_SPHERE_QUERY,
+    STAGE_COUNT
+};
+
+/// Object with fixed bounds which counts how often it was queued
+class BoxObject : public MovableObject
+{
+    AxisAlignedBox mBox;
+public:
+    int mQueued;
+
+    BoxObject(const AxisAlignedBox& box) : mBox(box), mQueued(0) {}
+
+    const String& getMovableType(void) const
+    {
+        static const String type = "BoxObject";
+        return type;
+    }
+    const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+    Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+    void _updateRenderQueue(RenderQueue* queue) { ++mQueued; }
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables) {}
+};
+
+/// Counts the query results
+struct ResultCounter : public SceneQueryListener
+{
+    size_t count;
+
+    ResultCounter() : count(0) {}
+    bool queryResult(MovableObject* object) { ++count; return true; }
+    bool queryResult(SceneQuery::WorldFragment* fragment) { return true; }
+};
+
+class BVHSceneManagerBenchmark : public Benchmark
+{
+    BenchmarkConfig mConfig;
+
+    Root* mRoot;
+    HardwareBufferManager* mBufferManager;
+
+    std::mt19937 mRng;
+public:
+    BVHSceneManagerBenchmark() : Benchmark("BVHSceneManager"), mRoot(0), mBufferManager(0)
+    {
+        addOption("nodes", mConfig.nodes);
+        addOption("frames", mConfig.frames);
+        addOption("queries", mConfig.queries);
+        addOption("moveevery", mConfig.moveEvery);
+
+        const char* managers[] = {"bvh", "octree"};
+        for (const char* manager : managers)
+        {
+            addStage(String(manager) + "/update");
+            addStage(String(manager) + "/cull");
+            addStage(String(manager) + "/sphereQuery");
+        }
+    }
+
+    void setup()
+    {
+        mConfig.nodes = std::max<size_t>(mConfig.nodes, 1);
+        mConfig.moveEvery = std::max<size_t>(mConfig.moveEvery, 1);
+
+        mRoot = OGRE_NEW Root("", "", "");
+        // no render system, but the scene managers need buffers and materials
+        mBufferManager = OGRE_NEW DefaultHardwareBufferManager();
+        MaterialManager::getSingleton().initialise();
+    }
+
+    ~BVHSceneManagerBenchmark()
+    {
+        OGRE_DELETE mBufferManager;
+        OGRE_DELETE mRoot;
+    }
+
+    void run()
+    {
+        BVHSceneManager bvh("bvh");
+        OctreeSceneManager octree("octree");
+        run(&bvh, 0);
+        run(&octree, STAGE_COUNT);
+    }
+
+private:
+    Vector3 randomPosition()
+    {
+        std::uniform_real_distribution<Real> pos(-1000, 1000);
+        return Vector3(pos(mRng), pos(mRng) * 0.2f, pos(mRng));
+    }
+
+    /// Runs the stages of one scene manager, which were added from firstStage on
+    void run(SceneManager* sm, size_t firstStage)
+    {
+        // the same scene for every manager
+        mRng.seed(42);
+        size_t visible = 0;
+
+        Camera* cam = sm->createCamera("cam");
+        cam->setNearClipDistance(1);
+        cam->setFarClipDistance(500);
+        cam->setAspectRatio(1.5f);
+        cam->setPosition(Vector3::ZERO);
+        cam->lookAt(Vector3(1, 0.2f, 0.5f));
+
+        std::vector<SceneNode*> nodes;
+        std::vector<BoxObject*> objects;
+        std::uniform_real_distribution<Real> size(0.5f, 5);
+        mTimer.reset();
+        for (size_t i = 0; i < mConfig.nodes; ++i)
+        {
+            Vector3 half(size(mRng), size(mRng), size(mRng));
+            objects.push_back(new BoxObject(AxisAlignedBox(-half, half)));
+            nodes.push_back(sm->getRootSceneNode()->createChildSceneNode(randomPosition()));
+            nodes.back()->attachObject(objects.back());
+        }
+        sm->_updateSceneGraph(cam);
+        addCounter(sm->getName() + "/build_us", mTimer.getMicroseconds());
+
+        std::uniform_real_distribution<Real> step(-1, 1);
+        for (size_t frame = 0; frame < mConfig.frames; ++frame)
+        {
+            unsigned long start = mTimer.getMicroseconds();
+            for (size_t i = 0; i < nodes.size(); i += mConfig.moveEvery)
+            {
+                if (i % (mConfig.moveEvery * 10) == 0)
+                    nodes[i]->setPosition(randomPosition());
+                else
+                    nodes[i]->translate(step(mRng), step(mRng), step(mRng));
+            }
+            sm->_updateSceneGraph(cam);
+            addSample(firstStage + STAGE_UPDATE, mTimer.getMicroseconds() - start);
+
+            for (size_t i = 0; i < objects.size(); ++i)
+                objects[i]->mQueued = 0;
+            start = mTimer.getMicroseconds();
+            sm->_findVisibleObjects(cam, NULL, false);
+            addSample(firstStage + STAGE_CULL, mTimer.getMicroseconds() - start);
+            for (size_t i = 0; i < objects.size(); ++i)
+                visible += objects[i]->mQueued ? 1 : 0;
+        }
+
+        SphereSceneQuery* q = sm->createSphereQuery(Sphere());
+        ResultCounter result;
+        for (size_t i = 0; i < mConfig.queries; ++i)
+        {
+            q->setSphere(Sphere(randomPosition(), 50));
+            unsigned long start = mTimer.getMicroseconds();
+            q->execute(&result);
+            addSample(firstStage + STAGE_SPHERE_QUERY, mTimer.getMicroseconds() - start);
+        }
+        addCounter(sm->getName() + "/visiblePerFrame", mConfig.frames ? visible / mConfig.frames : 0);
+        addCounter(sm->getName() + "/found", result.count);
+        sm->destroyQuery(q);
+
+        sm->clearScene();
+        sm->destroyAllCameras();
+        for (size_t i = 0; i < objects.size(); ++i)
+            delete objects[i];
+    }
+};
+}
+//--------------------------------------------------------------------------
+BENCHMARK_MAIN(BVHSceneManagerBenchmark)
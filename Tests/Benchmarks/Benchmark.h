@@ -0,0 +1,204 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Benchmark_H__
+#define __Benchmark_H__
+
+#include "Ogre.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+/** Common part of the CPU benchmarks.
+
+    A benchmark registers its options and stages in its constructor, builds its scene in
+    setup, which runs after the options were parsed, and records a sample per stage and
+    iteration in run. Options are given as key=value on the command line. The results are
+    written as JSON, to stdout or to the file given by output=<path>.
+*/
+class Benchmark
+{
+public:
+    Benchmark(const Ogre::String& name) : mName(name), mLogManager(0) {}
+
+    virtual ~Benchmark() { OGRE_DELETE mLogManager; }
+
+    void parseOptions(int argc, char** argv)
+    {
+        using namespace Ogre;
+        for (int i = 1; i < argc; ++i)
+        {
+            StringVector kv = StringUtil::split(argv[i], "=", 1);
+            if (kv.size() != 2)
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, String("expected key=value, got ") + argv[i]);
+
+            if (kv[0] == "output")
+            {
+                mOutput = kv[1];
+                continue;
+            }
+
+            size_t o = 0;
+            while (o < mOptions.size() && mOptions[o].key != kv[0])
+                ++o;
+            if (o == mOptions.size())
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "unknown option " + kv[0]);
+            if (!mOptions[o].parse(kv[1]))
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "invalid value for " + kv[0] + ": " + kv[1]);
+        }
+    }
+
+    /// Checks the options and builds the scene, the log is already set up
+    virtual void setup() = 0;
+    virtual void run() = 0;
+
+    void writeResults(std::ostream& os) const
+    {
+        os << "{\n";
+        os << "  \"benchmark\": \"" << mName << "\",\n";
+        os << "  \"version\": \"" << OGRE_VERSION_MAJOR << "." << OGRE_VERSION_MINOR << "."
+           << OGRE_VERSION_PATCH << "\",\n";
+        os << "  \"config\": {";
+        for (size_t i = 0; i < mOptions.size(); ++i)
+            os << (i ? ", " : "") << "\"" << mOptions[i].key << "\": " << mOptions[i].write();
+        os << "},\n";
+        os << "  \"counters\": {";
+        for (size_t i = 0; i < mCounters.size(); ++i)
+            os << (i ? ", " : "") << "\"" << mCounters[i].first << "\": " << mCounters[i].second;
+        os << "},\n";
+        os << "  \"stages\": [\n";
+        for (size_t s = 0; s < mStages.size(); ++s)
+        {
+            std::vector<unsigned long> samples = mStages[s].samples;
+            std::sort(samples.begin(), samples.end());
+            double sum = 0;
+            for (size_t i = 0; i < samples.size(); ++i)
+                sum += samples[i];
+            bool empty = samples.empty();
+            os << "    {\"name\": \"" << mStages[s].name << "\", \"samples\": " << samples.size()
+               << ", \"mean_us\": " << (empty ? 0 : sum / samples.size())
+               << ", \"median_us\": " << (empty ? 0 : samples[samples.size() / 2])
+               << ", \"min_us\": " << (empty ? 0 : samples.front())
+               << ", \"max_us\": " << (empty ? 0 : samples.back()) << "}"
+               << (s + 1 < mStages.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n";
+        os << "}\n";
+    }
+
+    /// Sets up the log and the benchmark, runs it and writes the results
+    int main(int argc, char** argv)
+    {
+        try
+        {
+            parseOptions(argc, argv);
+
+            // keep the log quiet, it would only measure the disk
+            mLogManager = OGRE_NEW Ogre::LogManager();
+            mLogManager->createLog(mName + "Benchmark.log", true, false, true);
+
+            setup();
+            run();
+
+            if (mOutput.empty())
+            {
+                writeResults(std::cout);
+            }
+            else
+            {
+                std::ofstream file(mOutput.c_str());
+                if (!file)
+                    OGRE_EXCEPT(Ogre::Exception::ERR_CANNOT_WRITE_TO_FILE, "cannot open " + mOutput);
+                writeResults(file);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+protected:
+    /// Registers an option, value holds its default
+    template <typename T> void addOption(const Ogre::String& key, T& value)
+    {
+        Option option = {key, [&value](const Ogre::String& str) { return Ogre::StringConverter::parse(str, value); },
+                         [&value]() { return Ogre::StringConverter::toString(value); }};
+        mOptions.push_back(option);
+    }
+
+    /// Adds a stage, returns its index for addSample
+    size_t addStage(const Ogre::String& name)
+    {
+        Stage stage = {name, std::vector<unsigned long>()};
+        mStages.push_back(stage);
+        return mStages.size() - 1;
+    }
+
+    void addSample(size_t stage, unsigned long microseconds) { mStages[stage].samples.push_back(microseconds); }
+
+    /// Adds a counter to the results, value is written as is
+    template <typename T> void addCounter(const Ogre::String& key, const T& value)
+    {
+        mCounters.push_back(std::make_pair(key, Ogre::StringConverter::toString(value)));
+    }
+
+    Ogre::Timer mTimer;
+private:
+    struct Option
+    {
+        Ogre::String key;
+        std::function<bool(const Ogre::String&)> parse;
+        std::function<Ogre::String()> write;
+    };
+    struct Stage
+    {
+        Ogre::String name;
+        std::vector<unsigned long> samples;
+    };
+
+    Ogre::String mName;
+    Ogre::String mOutput;
+    Ogre::LogManager* mLogManager;
+    std::vector<Option> mOptions;
+    std::vector<Stage> mStages;
+    std::vector<std::pair<Ogre::String, Ogre::String> > mCounters;
+};
+
+/// Defines main for the given Benchmark subclass
+#define BENCHMARK_MAIN(Class)                                                                      \
+    int main(int argc, char** argv)                                                                \
+    {                                                                                              \
+        Class benchmark;                                                                           \
+        return benchmark.main(argc, argv);                                                         \
+    }
+
+#endif
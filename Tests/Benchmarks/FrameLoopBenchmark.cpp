@@ -0,0 +1,517 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/** Frame loop CPU benchmark.
+
+    Builds a synthetic scene on top of the Null RenderSystem and times the CPU side
+    stages of a frame separately, then the whole Root::renderOneFrame. Results are
+    written as JSON, to stdout or to the file given by output=<path>.
+
+    Usage: Test_FrameLoopBenchmark [nodes=N] [entities=M] [lights=L] [particles=P]
+                                   [skeletal=S] [frames=F] [warmup=W] [seed=X] [output=path]
+                                   [static=0|1] [parallelqueue=0|1] [statecache=0|1]
+                                   [parallelanim=0|1]
+
+    static=1 marks the cube entities with MovableObject::setStatic, parallelqueue=1
+    enables SceneManager::setParallelRenderQueueBuild, statecache=1
+    SceneManager::setRenderStateCaching and parallelanim=1
+    SceneManager::setParallelAnimationUpdate, which only affects renderOneFrame.
+*/
+#include "Benchmark.h"
+#include "OgreNullPlugin.h"
+#include "OgreNullRenderSystem.h"
+#include "OgreParticleFXPlugin.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleAffector.h"
+#include "OgreSkeletonManager.h"
+#include "OgreControllerManager.h"
+
+#include <random>
+
+using namespace Ogre;
+//--------------------------------------------------------------------------
+namespace
+{
+struct BenchmarkConfig
+{
+    size_t nodes;
+    size_t entities;
+    size_t lights;
+    size_t particleSystems;
+    size_t skeletalEntities;
+    size_t frames;
+    size_t warmupFrames;
+    size_t staticEntities;
+    size_t parallelQueue;
+    size_t stateCache;
+    size_t parallelAnimation;
+    uint32 seed;
+
+    BenchmarkConfig()
+        : nodes(2000), entities(1000), lights(16), particleSystems(20), skeletalEntities(50),
+          frames(100), warmupFrames(10), staticEntities(0), parallelQueue(0),
+          stateCache(0), parallelAnimation(0), seed(1)
+    {
+    }
+};
+
+/// In the order the constructor adds them
+enum BenchmarkStage
+{
+    STAGE_ANIMATION,
+    STAGE_PARTICLES,
+    STAGE_UPDATE_SCENE_GRAPH,
+    STAGE_FIND_VISIBLE_OBJECTS,
+    STAGE_RENDER_QUEUE_SORT,
+    STAGE_UPDATE_AUTO_PARAMS,
+    STAGE_RENDER_ONE_FRAME,
+    STAGE_COUNT
+};
+
+/// Flattens the render queue into renderable / pass pairs
+struct RenderablePassCollector : public QueuedRenderableVisitor
+{
+    std::vector<std::pair<Renderable*, const Pass*> > items;
+
+    void visit(RenderablePass* rp) { items.push_back(std::make_pair(rp->renderable, rp->pass)); }
+    void visit(const Pass* p, RenderableList& rs)
+    {
+        for (RenderableList::iterator it = rs.begin(); it != rs.end(); ++it)
+            items.push_back(std::make_pair(*it, p));
+    }
+};
+
+void addConstant(GpuNamedConstants& defs, const String& name, GpuConstantType type, size_t arraySize = 1)
+{
+    GpuConstantDefinition def;
+    def.constType = type;
+    def.elementSize = GpuConstantDefinition::getElementSize(type, false);
+    def.arraySize = arraySize;
+    def.logicalIndex = defs.map.size();
+    def.physicalIndex = defs.floatBufferSize;
+    def.variability = GPV_GLOBAL;
+    defs.floatBufferSize += def.elementSize * arraySize;
+    defs.map[name] = def;
+}
+
+class FrameLoopBenchmark : public Benchmark
+{
+    BenchmarkConfig mConfig;
+    std::mt19937 mRng;
+
+    Root* mRoot;
+    NullPlugin* mNullPlugin;
+    ParticleFXPlugin* mParticlePlugin;
+    NullRenderSystem* mRenderSystem;
+    RenderWindow* mWindow;
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+    Viewport* mViewport;
+
+    std::vector<SceneNode*> mGroups;
+    std::vector<SceneNode*> mNodes;
+    std::vector<Entity*> mSkinnedEntities;
+    std::vector<AnimationState*> mAnimationStates;
+
+    AutoParamDataSource mAutoParamSource;
+    VisibleObjectsBoundsInfo mVisibleBounds;
+    RenderablePassCollector mCollector;
+
+    size_t mVisibleRenderables;
+    size_t mDrawCalls;
+    size_t mStateChanges;
+public:
+    FrameLoopBenchmark()
+        : Benchmark("FrameLoop"), mRoot(0), mNullPlugin(0), mParticlePlugin(0),
+          mVisibleRenderables(0), mDrawCalls(0), mStateChanges(0)
+    {
+        addOption("nodes", mConfig.nodes);
+        addOption("entities", mConfig.entities);
+        addOption("lights", mConfig.lights);
+        addOption("particles", mConfig.particleSystems);
+        addOption("skeletal", mConfig.skeletalEntities);
+        addOption("frames", mConfig.frames);
+        addOption("warmup", mConfig.warmupFrames);
+        addOption("static", mConfig.staticEntities);
+        addOption("parallelqueue", mConfig.parallelQueue);
+        addOption("statecache", mConfig.stateCache);
+        addOption("parallelanim", mConfig.parallelAnimation);
+        addOption("seed", mConfig.seed);
+
+        addStage("animation");
+        addStage("particles");
+        addStage("updateSceneGraph");
+        addStage("findVisibleObjects");
+        addStage("renderQueueSort");
+        addStage("updateAutoParams");
+        addStage("renderOneFrame");
+    }
+
+    void setup()
+    {
+        mConfig.nodes = std::max<size_t>(mConfig.nodes, 1);
+        mRng.seed(mConfig.seed);
+
+        mRoot = OGRE_NEW Root("", "", "");
+        mNullPlugin = OGRE_NEW NullPlugin();
+        mRoot->installPlugin(mNullPlugin);
+        mParticlePlugin = OGRE_NEW ParticleFXPlugin();
+        mRoot->installPlugin(mParticlePlugin);
+
+        mRenderSystem = static_cast<NullRenderSystem*>(
+            mRoot->getRenderSystemByName("Null Rendering Subsystem"));
+        mRoot->setRenderSystem(mRenderSystem);
+        mRoot->initialise(false);
+        mWindow = mRoot->createRenderWindow("FrameLoopBenchmark", 1280, 720, false);
+
+        mSceneMgr = mRoot->createSceneManager();
+        mSceneMgr->setAmbientLight(ColourValue(0.2f, 0.2f, 0.2f));
+        if (mConfig.parallelQueue || mConfig.parallelAnimation)
+            mRoot->getWorkQueue()->startup();
+        mSceneMgr->setParallelRenderQueueBuild(mConfig.parallelQueue != 0);
+        mSceneMgr->setParallelAnimationUpdate(mConfig.parallelAnimation != 0);
+        mSceneMgr->setRenderStateCaching(mConfig.stateCache != 0);
+        mCamera = mSceneMgr->createCamera("Camera");
+        mCamera->setNearClipDistance(1);
+        mCamera->setFarClipDistance(2500);
+        // looking into the scene from its edge, so about half of it is culled
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 1000))->attachObject(mCamera);
+        mViewport = mWindow->addViewport(mCamera);
+        mCamera->setAspectRatio(Real(mViewport->getActualWidth()) / mViewport->getActualHeight());
+
+        createResources();
+        createScene();
+
+        mAutoParamSource.setCurrentSceneManager(mSceneMgr);
+        mAutoParamSource.setCurrentViewport(mViewport);
+        mAutoParamSource.setCurrentRenderTarget(mWindow);
+        mAutoParamSource.setCurrentCamera(mCamera, false);
+        mAutoParamSource.setMainCamBoundsInfo(&mVisibleBounds);
+        mAutoParamSource.setAmbientLightColour(mSceneMgr->getAmbientLight());
+    }
+
+    ~FrameLoopBenchmark()
+    {
+        OGRE_DELETE mRoot;
+        OGRE_DELETE mParticlePlugin;
+        OGRE_DELETE mNullPlugin;
+    }
+
+    void run()
+    {
+        // a full frame first, so light lists and queue organisation are set up
+        for (size_t i = 0; i < mConfig.warmupFrames; ++i)
+            mRoot->renderOneFrame(1 / 60.0f);
+
+        for (size_t i = 0; i < mConfig.frames; ++i)
+            runStages();
+
+        mSceneMgr->resetRenderStateStatistics();
+        for (size_t i = 0; i < mConfig.frames; ++i)
+        {
+            mRenderSystem->resetStatistics();
+            unsigned long start = mTimer.getMicroseconds();
+            // the skeletons are updated while rendering, see SceneManager::setParallelAnimationUpdate
+            for (size_t j = 0; j < mAnimationStates.size(); ++j)
+                mAnimationStates[j]->addTime(1 / 60.0f);
+            mRoot->renderOneFrame(1 / 60.0f);
+            addSample(STAGE_RENDER_ONE_FRAME, mTimer.getMicroseconds() - start);
+            mDrawCalls += mRenderSystem->getStatistics().drawCalls;
+            mStateChanges += mRenderSystem->getStatistics().stateChanges;
+        }
+
+        size_t frames = std::max<size_t>(mConfig.frames, 1);
+        addCounter("visibleRenderables", mVisibleRenderables / frames);
+        addCounter("drawCalls", mDrawCalls / frames);
+        addCounter("stateChanges", mStateChanges / frames);
+        addCounter("stateChangesSkipped", mSceneMgr->getRenderStateStatistics().skipped / frames);
+    }
+
+private:
+    Vector3 randomPosition()
+    {
+        std::uniform_real_distribution<Real> pos(-1000, 1000);
+        return Vector3(pos(mRng), pos(mRng), pos(mRng));
+    }
+
+    SceneNode* randomNode()
+    {
+        return mNodes[std::uniform_int_distribution<size_t>(0, mNodes.size() - 1)(mRng)];
+    }
+
+    void createResources()
+    {
+        MaterialManager& matMgr = MaterialManager::getSingleton();
+        matMgr.getByName("BaseWhite")->clone("bench/opaque");
+
+        MaterialPtr transparent = matMgr.getByName("BaseWhite")->clone("bench/transparent");
+        transparent->setSceneBlending(SBT_TRANSPARENT_ALPHA);
+        transparent->setDepthWriteEnabled(false);
+
+        // programs are not compiled by the Null RenderSystem, so describe their constants here
+        GpuNamedConstants vpConstants;
+        addConstant(vpConstants, "worldViewProj", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "world", GCT_MATRIX_4X4);
+        addConstant(vpConstants, "cameraPosition", GCT_FLOAT4);
+        addConstant(vpConstants, "lightPosition", GCT_FLOAT4, 8);
+        addConstant(vpConstants, "lightDiffuse", GCT_FLOAT4, 8);
+        addConstant(vpConstants, "lightAttenuation", GCT_FLOAT4, 8);
+        GpuProgramPtr vp = GpuProgramManager::getSingleton().createProgramFromString(
+            "bench/vp", RGN_DEFAULT, "", GPT_VERTEX_PROGRAM, "glsl");
+        vp->setManualNamedConstants(vpConstants);
+
+        GpuNamedConstants fpConstants;
+        addConstant(fpConstants, "ambient", GCT_FLOAT4);
+        addConstant(fpConstants, "fogColour", GCT_FLOAT4);
+        addConstant(fpConstants, "time", GCT_FLOAT1);
+        GpuProgramPtr fp = GpuProgramManager::getSingleton().createProgramFromString(
+            "bench/fp", RGN_DEFAULT, "", GPT_FRAGMENT_PROGRAM, "glsl");
+        fp->setManualNamedConstants(fpConstants);
+
+        MaterialPtr shaded = matMgr.create("bench/shaded", RGN_DEFAULT);
+        Pass* pass = shaded->getTechnique(0)->getPass(0);
+        pass->setVertexProgram("bench/vp");
+        pass->setFragmentProgram("bench/fp");
+        GpuProgramParametersSharedPtr params = pass->getVertexProgramParameters();
+        params->setNamedAutoConstant("worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+        params->setNamedAutoConstant("world", GpuProgramParameters::ACT_WORLD_MATRIX);
+        params->setNamedAutoConstant("cameraPosition", GpuProgramParameters::ACT_CAMERA_POSITION_OBJECT_SPACE);
+        params->setNamedAutoConstant("lightPosition", GpuProgramParameters::ACT_LIGHT_POSITION_OBJECT_SPACE_ARRAY, 8);
+        params->setNamedAutoConstant("lightDiffuse", GpuProgramParameters::ACT_LIGHT_DIFFUSE_COLOUR_ARRAY, 8);
+        params->setNamedAutoConstant("lightAttenuation", GpuProgramParameters::ACT_LIGHT_ATTENUATION_ARRAY, 8);
+        params = pass->getFragmentProgramParameters();
+        params->setNamedAutoConstant("ambient", GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR);
+        params->setNamedAutoConstant("fogColour", GpuProgramParameters::ACT_FOG_COLOUR);
+        params->setNamedAutoConstant("time", GpuProgramParameters::ACT_TIME);
+        shaded->load();
+
+        createSkinnedMesh();
+    }
+
+    /// A subdivided quad bent by a chain of bones
+    void createSkinnedMesh()
+    {
+        const unsigned short numBones = 16;
+        const int xsegments = 4, ysegments = 32;
+
+        SkeletonPtr skel = SkeletonManager::getSingleton().create("bench/skeleton", RGN_DEFAULT, true);
+        Bone* bone = skel->createBone(0);
+        bone->setPosition(0, -50, 0);
+        for (unsigned short i = 1; i < numBones; ++i)
+            bone = bone->createChild(i, Vector3(0, 100.0f / numBones, 0));
+        skel->setBindingPose();
+
+        Animation* anim = skel->createAnimation("wave", 2);
+        for (unsigned short i = 0; i < numBones; ++i)
+        {
+            NodeAnimationTrack* track = anim->createNodeTrack(i, skel->getBone(i));
+            for (int k = 0; k <= 4; ++k)
+            {
+                TransformKeyFrame* kf = track->createNodeKeyFrame(k * 0.5f);
+                kf->setRotation(Quaternion(Degree(Math::Sin(Radian(k * Math::HALF_PI)) * 10), Vector3::UNIT_Z));
+            }
+        }
+
+        MeshPtr mesh = MeshManager::getSingleton().createPlane(
+            "bench/skinned", RGN_DEFAULT, Plane(Vector3::UNIT_Z, 0), 20, 100, xsegments, ysegments);
+        // vertices are generated row by row along the height
+        size_t vertexCount = mesh->sharedVertexData->vertexCount;
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            Real t = Real(v / (xsegments + 1)) * (numBones - 1) / ysegments;
+            unsigned short b0 = static_cast<unsigned short>(t);
+            unsigned short b1 = std::min<unsigned short>(b0 + 1, numBones - 1);
+
+            VertexBoneAssignment vba;
+            vba.vertexIndex = static_cast<unsigned int>(v);
+            vba.boneIndex = b0;
+            vba.weight = 1 - (t - b0);
+            mesh->addBoneAssignment(vba);
+            if (b1 != b0)
+            {
+                vba.boneIndex = b1;
+                vba.weight = t - b0;
+                mesh->addBoneAssignment(vba);
+            }
+        }
+        mesh->_notifySkeleton(skel);
+        mesh->_compileBoneAssignments();
+    }
+
+    void createScene()
+    {
+        // nodes are grouped so that turning the groups dirties the whole graph every frame
+        SceneNode* root = mSceneMgr->getRootSceneNode();
+        for (size_t i = 0; i < mConfig.nodes; ++i)
+        {
+            if (i % 32 == 0)
+                mGroups.push_back(root->createChildSceneNode());
+            mNodes.push_back(mGroups.back()->createChildSceneNode(randomPosition()));
+        }
+
+        const char* materials[] = {"bench/shaded", "bench/opaque", "bench/shaded", "bench/transparent"};
+        for (size_t i = 0; i < mConfig.entities; ++i)
+        {
+            Entity* ent = mSceneMgr->createEntity(SceneManager::PT_CUBE);
+            ent->setMaterialName(materials[i % 4]);
+            ent->setStatic(mConfig.staticEntities != 0);
+            mNodes[i % mNodes.size()]->attachObject(ent);
+        }
+
+        std::uniform_real_distribution<Real> colour(0.2f, 1);
+        for (size_t i = 0; i < mConfig.lights; ++i)
+        {
+            Light* light = mSceneMgr->createLight();
+            light->setDiffuseColour(colour(mRng), colour(mRng), colour(mRng));
+            light->setAttenuation(300, 1, 0.01f, 0);
+            randomNode()->attachObject(light);
+        }
+
+        for (size_t i = 0; i < mConfig.particleSystems; ++i)
+        {
+            ParticleSystem* ps = mSceneMgr->createParticleSystem(200);
+            ps->setMaterialName("bench/transparent");
+            ps->setDefaultDimensions(5, 5);
+            ParticleEmitter* emitter = ps->addEmitter("Point");
+            emitter->setEmissionRate(100);
+            emitter->setTimeToLive(2);
+            emitter->setAngle(Degree(30));
+            emitter->setDirection(Vector3::UNIT_Y);
+            emitter->setParticleVelocity(20, 40);
+            ps->addAffector("LinearForce")->setParameter("force_vector", "0 -20 0");
+            randomNode()->attachObject(ps);
+            ps->fastForward(2);
+        }
+
+        std::uniform_real_distribution<Real> phase(0, 2);
+        for (size_t i = 0; i < mConfig.skeletalEntities; ++i)
+        {
+            Entity* ent = mSceneMgr->createEntity("bench/skinned");
+            ent->setMaterialName("bench/opaque");
+            AnimationState* state = ent->getAnimationState("wave");
+            state->setEnabled(true);
+            state->setLoop(true);
+            state->setTimePosition(phase(mRng));
+            mAnimationStates.push_back(state);
+            mSkinnedEntities.push_back(ent);
+            randomNode()->attachObject(ent);
+        }
+    }
+
+    /// The CPU side of SceneManager::_renderScene, one stage at a time
+    void runStages()
+    {
+        const Real timeStep = 1 / 60.0f;
+        FrameEvent evt;
+        evt.timeSinceLastEvent = evt.timeSinceLastFrame = timeStep;
+        mRoot->_fireFrameStarted(evt);
+        mRoot->_pushCurrentSceneManager(mSceneMgr);
+
+        for (size_t i = 0; i < mGroups.size(); ++i)
+            mGroups[i]->yaw(Degree(0.1f));
+
+        unsigned long start = mTimer.getMicroseconds();
+        for (size_t i = 0; i < mAnimationStates.size(); ++i)
+            mAnimationStates[i]->addTime(timeStep);
+        mSceneMgr->_applySceneAnimations();
+        for (size_t i = 0; i < mSkinnedEntities.size(); ++i)
+            mSkinnedEntities[i]->_updateAnimation();
+        unsigned long end = mTimer.getMicroseconds();
+        addSample(STAGE_ANIMATION, end - start);
+
+        start = end;
+        ControllerManager::getSingleton().updateAllControllers();
+        end = mTimer.getMicroseconds();
+        addSample(STAGE_PARTICLES, end - start);
+
+        start = end;
+        mSceneMgr->_updateSceneGraph(mCamera);
+        end = mTimer.getMicroseconds();
+        addSample(STAGE_UPDATE_SCENE_GRAPH, end - start);
+
+        RenderQueue* queue = mSceneMgr->getRenderQueue();
+        queue->clear();
+        mVisibleBounds.reset();
+        start = mTimer.getMicroseconds();
+        mSceneMgr->_findVisibleObjects(mCamera, &mVisibleBounds, false);
+        end = mTimer.getMicroseconds();
+        addSample(STAGE_FIND_VISIBLE_OBJECTS, end - start);
+
+        start = end;
+        const RenderQueue::RenderQueueGroupMap& groups = queue->_getQueueGroups();
+        for (size_t g = 0; g < RENDER_QUEUE_MAX; ++g)
+        {
+            if (!groups[g])
+                continue;
+            RenderQueueGroup::PriorityMapIterator it = groups[g]->getIterator();
+            while (it.hasMoreElements())
+                it.getNext()->sort(mCamera);
+        }
+        end = mTimer.getMicroseconds();
+        addSample(STAGE_RENDER_QUEUE_SORT, end - start);
+
+        mCollector.items.clear();
+        for (size_t g = 0; g < RENDER_QUEUE_MAX; ++g)
+        {
+            if (!groups[g])
+                continue;
+            RenderQueueGroup::PriorityMapIterator it = groups[g]->getIterator();
+            while (it.hasMoreElements())
+            {
+                RenderPriorityGroup* pg = it.getNext();
+                pg->getSolidsBasic().acceptVisitor(&mCollector, QueuedRenderableCollection::OM_PASS_GROUP);
+                pg->getTransparents().acceptVisitor(&mCollector, QueuedRenderableCollection::OM_SORT_DESCENDING);
+            }
+        }
+        mVisibleRenderables += mCollector.items.size();
+
+        // same data source updates as SceneManager::renderSingleObject
+        start = mTimer.getMicroseconds();
+        mAutoParamSource.setCurrentCamera(mCamera, false);
+        for (size_t i = 0; i < mCollector.items.size(); ++i)
+        {
+            Renderable* rend = mCollector.items[i].first;
+            const Pass* pass = mCollector.items[i].second;
+            if (!pass->isProgrammable())
+                continue;
+            mAutoParamSource.setCurrentRenderable(rend);
+            mAutoParamSource.setCurrentPass(pass);
+            mAutoParamSource.setCurrentLightList(&rend->getLights());
+            pass->_updateAutoParams(&mAutoParamSource, GPV_ALL);
+        }
+        end = mTimer.getMicroseconds();
+        addSample(STAGE_UPDATE_AUTO_PARAMS, end - start);
+
+        mRoot->_popCurrentSceneManager(mSceneMgr);
+        // advances the frame number, so animation and controllers update again
+        mRoot->_fireFrameRenderingQueued(evt);
+        mRoot->_fireFrameEnded(evt);
+    }
+};
+}
+//--------------------------------------------------------------------------
+BENCHMARK_MAIN(FrameLoopBenchmark)
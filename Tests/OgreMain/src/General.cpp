@@ -31,6 +31,9 @@ THE SOFTWARE.
 #include "OgreSceneNode.h"
 #include "OgreEntity.h"
 #include "OgreCamera.h"
+#include "OgreBillboardSet.h"
+#include "OgreManualObject.h"
+#include "OgreSceneManagerEnumerator.h"
 #include "RootWithoutRenderSystemFixture.h"
 #include "OgreStaticPluginLoader.h"
 
@@ -44,6 +47,10 @@ THE SOFTWARE.
 #include "OgreMeshManager.h"
 #include "OgreMesh.h"
 #include "OgreSkeletonManager.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
 #include "OgreCompositorManager.h"
 
 #include <random>
@@ -72,6 +79,135 @@ TEST(SceneManager,removeAndDestroyAllChildren)
     sm->getRootSceneNode()->removeAndDestroyAllChildren();
 }
 
+TEST(SceneManager, movableObjectHandles)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    SceneManager::MovableObjectHandle h1 = sm->createMovableObjectHandle("Light");
+    SceneManager::MovableObjectHandle h2 = sm->createMovableObjectHandle("Light");
+    Light* named = sm->createLight("named");
+
+    MovableObject* obj = sm->getMovableObject(h1);
+    ASSERT_TRUE(obj);
+    EXPECT_EQ(obj->getMovableType(), "Light");
+    EXPECT_TRUE(obj->getName().empty());
+    EXPECT_TRUE(SceneManager::MovableObjectHandle().isNull());
+    EXPECT_FALSE(sm->getMovableObject(SceneManager::MovableObjectHandle()));
+
+    // only named objects are public
+    SceneManager::MovableObjectIterator it = sm->getMovableObjectIterator("Light");
+    EXPECT_EQ(it.peekNextKey(), "named");
+    EXPECT_EQ(it.getNext(), named);
+    EXPECT_FALSE(it.hasMoreElements());
+
+    // named objects first, then the ones created by handle
+    SceneManager::MovableObjectCollectionIterator all =
+        sm->_getMovableObjectCollectionIterator("Light");
+    EXPECT_EQ(all.getNext(), named);
+    EXPECT_EQ(all.getNext(), obj);
+    EXPECT_EQ(all.getNext(), sm->getMovableObject(h2));
+    EXPECT_FALSE(all.hasMoreElements());
+
+    // the slot is reused, but the old handle stays stale
+    sm->destroyMovableObject(h1);
+    EXPECT_FALSE(sm->getMovableObject(h1));
+    SceneManager::MovableObjectHandle h3 = sm->createMovableObjectHandle("Light");
+    EXPECT_EQ(h3.index, h1.index);
+    EXPECT_NE(h3, h1);
+    EXPECT_FALSE(sm->getMovableObject(h1));
+    EXPECT_TRUE(sm->getMovableObject(h3));
+    sm->destroyMovableObject(h1);
+    EXPECT_TRUE(sm->getMovableObject(h3));
+
+    sm->destroyMovableObject(sm->getMovableObject(h2));
+    EXPECT_FALSE(sm->getMovableObject(h2));
+    EXPECT_TRUE(sm->getMovableObject(h3));
+
+    sm->destroyAllMovableObjects();
+    EXPECT_FALSE(sm->getMovableObject(h3));
+    EXPECT_FALSE(sm->hasLight("named"));
+}
+
+TEST(SceneManager, pooledAllocation)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    SceneNode* rootNode = sm->getRootSceneNode();
+    size_t nodes = PoolAllocator::getAllocatedBlockCount(sizeof(SceneNode));
+    size_t lights = PoolAllocator::getAllocatedBlockCount(sizeof(Light));
+
+    std::vector<SceneNode*> created;
+    for (int i = 0; i < 10; ++i)
+        created.push_back(rootNode->createChildSceneNode());
+    EXPECT_EQ(PoolAllocator::getAllocatedBlockCount(sizeof(SceneNode)), nodes + 10);
+    for (SceneNode* n : created)
+        n->attachObject(sm->createLight());
+
+    // a destroyed node's block is the next one handed out
+    SceneNode* last = created.back();
+    sm->destroySceneNode(last);
+    EXPECT_EQ(PoolAllocator::getAllocatedBlockCount(sizeof(SceneNode)), nodes + 9);
+    EXPECT_EQ(sm->createSceneNode(), last);
+
+    sm->clearScene();
+    EXPECT_EQ(PoolAllocator::getAllocatedBlockCount(sizeof(SceneNode)), nodes);
+    EXPECT_EQ(PoolAllocator::getAllocatedBlockCount(sizeof(Light)), lights);
+}
+
+typedef RootWithoutRenderSystemFixture FrustumTests;
+TEST_F(FrustumTests, getVisibility)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    Camera* cam = sm->createCamera("cam");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    camNode->lookAt(Vector3(1, 1, -1), Node::TS_PARENT);
+    cam->setNearClipDistance(1);
+
+    minstd_rand rng;
+    std::vector<AxisAlignedBox> boxes(1001);
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        Vector3 min(Real(rng() % 400) - 200, Real(rng() % 400) - 200, Real(rng() % 400) - 200);
+        boxes[i].setExtents(min, min + Vector3(1 + rng() % 50, 1 + rng() % 50, 1 + rng() % 50));
+    }
+    boxes[3].setNull();
+    boxes[7].setInfinite();
+
+    std::vector<const AxisAlignedBox*> bounds;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        bounds.push_back(&boxes[i]);
+    std::unique_ptr<bool[]> visible(new bool[boxes.size()]);
+
+    // finite and infinite far plane
+    for (Real farDist : {Real(100), Real(0)})
+    {
+        cam->setFarClipDistance(farDist);
+        cam->getVisibility(bounds.data(), bounds.size(), visible.get());
+        for (size_t i = 0; i < boxes.size(); ++i)
+            EXPECT_EQ(cam->isVisible(boxes[i]), visible[i]) << i;
+    }
+
+    // subclasses overriding isVisible, like portal culling, are respected
+    struct CullAllCamera : public Camera
+    {
+        CullAllCamera(SceneManager* sm) : Camera("cullAll", sm) {}
+        bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const
+        {
+            return false;
+        }
+    } cullAll(sm);
+    cullAll.getVisibility(bounds.data(), bounds.size(), visible.get());
+    EXPECT_EQ(visible.get() + boxes.size(), std::find(visible.get(), visible.get() + boxes.size(), true));
+
+    Frustum cullFrustum;
+    cam->setCullingFrustum(&cullFrustum);
+    cam->getVisibility(bounds.data(), bounds.size(), visible.get());
+    for (size_t i = 0; i < boxes.size(); ++i)
+        EXPECT_EQ(cullFrustum.isVisible(boxes[i]), visible[i]) << i;
+    cam->setCullingFrustum(NULL);
+}
+
 static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vector3& min,
                                      const Vector3& max, SceneManager* mgr)
 {
@@ -153,6 +289,66 @@ TEST_F(SceneQueryTest,Intersection)
     // printf("\n");
 }
 
+namespace
+{
+struct PairCollector : public IntersectionSceneQueryListener
+{
+    std::vector<SceneQueryMovableObjectPair> pairs;
+    bool queryResult(MovableObject* a, MovableObject* b) { pairs.push_back(std::make_pair(a, b)); return true; }
+    bool queryResult(MovableObject* a, SceneQuery::WorldFragment* b) { return true; }
+};
+}
+
+TEST_F(SceneQueryTest, IntersectionMatchesBruteForce)
+{
+    Entity* ent = mSceneMgr->getEntity("501");
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 1500; ++i)
+    {
+        entities.push_back(ent->clone(StringConverter::toString(1000 + i)));
+        mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(entities.back());
+    }
+
+    minstd_rand rng;
+    std::uniform_real_distribution<Real> pos(-2500, 2500), step(-100, 100);
+    for (Entity* e : entities)
+        e->getParentSceneNode()->setPosition(pos(rng), pos(rng), pos(rng));
+
+    IntersectionSceneQuery* query = mSceneMgr->createIntersectionQuery();
+    query->setQueryTypeMask(SceneManager::ENTITY_TYPE_MASK);
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        // move things a bit and destroy a few, so the kept state has to follow
+        for (Entity* e : entities)
+            e->getParentSceneNode()->translate(step(rng), step(rng), step(rng));
+        mSceneMgr->destroyEntity(entities.back());
+        entities.pop_back();
+        entities[frame]->detachFromParent();
+        entities.erase(entities.begin() + frame);
+        mSceneMgr->_updateSceneGraph(mCamera);
+
+        std::vector<MovableObject*> objects;
+        SceneManager::MovableObjectIterator it = mSceneMgr->getMovableObjectIterator("Entity");
+        while (it.hasMoreElements())
+        {
+            MovableObject* o = it.getNext();
+            if (o->isInScene())
+                objects.push_back(o);
+        }
+        std::vector<SceneQueryMovableObjectPair> expected;
+        for (size_t i = 0; i < objects.size(); ++i)
+            for (size_t j = i + 1; j < objects.size(); ++j)
+                if (objects[i]->getWorldBoundingBox().intersects(objects[j]->getWorldBoundingBox()))
+                    expected.push_back(std::make_pair(objects[i], objects[j]));
+
+        PairCollector collector;
+        query->execute(&collector);
+        EXPECT_GT(expected.size(), 0u);
+        EXPECT_EQ(expected, collector.pairs);
+    }
+    mSceneMgr->destroyQuery(query);
+}
+
 TEST_F(SceneQueryTest, Ray) {
     RaySceneQuery* rayQuery = mSceneMgr->createRayQuery(mCamera->getCameraToViewportRay(0.5, 0.5));
     rayQuery->setSortByDistance(true, 2);
@@ -163,6 +359,438 @@ TEST_F(SceneQueryTest, Ray) {
     ASSERT_EQ("397", results[1].movable->getName());
 }
 
+namespace
+{
+struct QueryCollector : public SceneQueryListener
+{
+    std::vector<MovableObject*> objects;
+    bool queryResult(MovableObject* object) { objects.push_back(object); return true; }
+    bool queryResult(SceneQuery::WorldFragment* fragment) { return true; }
+};
+
+struct NodeUpdateCounter : public Node::Listener
+{
+    int updates;
+    NodeUpdateCounter() : updates(0) {}
+    void nodeUpdated(const Node*) { ++updates; }
+};
+
+void expectBroadphaseMatchesBruteForce(SceneManager* sm, minstd_rand& rng)
+{
+    std::uniform_real_distribution<Real> pos(-2500, 2500), radius(50, 500);
+    for (int i = 0; i < 10; ++i)
+    {
+        Vector3 centre(pos(rng), pos(rng), pos(rng));
+        Real r = radius(rng);
+        Ray ray(centre, Vector3(pos(rng), pos(rng), pos(rng)));
+        Sphere sphere(centre, r);
+        AxisAlignedBox box(centre - r, centre + r);
+
+        // in the order the entities were created, as of the last scene graph update
+        std::vector<MovableObject*> onRay, inSphere, inBox;
+        for (int n = -1; n < 500; ++n)
+        {
+            String name = StringConverter::toString(n < 0 ? 501 : n);
+            if (!sm->hasEntity(name))
+                continue;
+            MovableObject* m = sm->getEntity(name);
+            if (!m->isInScene())
+                continue;
+            if (ray.intersects(m->getWorldBoundingBox()).first)
+                onRay.push_back(m);
+            if (sphere.intersects(Sphere(m->getParentNode()->_getDerivedPosition(), m->getBoundingRadius())))
+                inSphere.push_back(m);
+            if (box.intersects(m->getWorldBoundingBox()))
+                inBox.push_back(m);
+        }
+
+        RaySceneQuery* rayQuery = sm->createRayQuery(ray);
+        std::vector<MovableObject*> rayResult;
+        for (const RaySceneQueryResultEntry& e : rayQuery->execute())
+            rayResult.push_back(e.movable);
+        sm->destroyQuery(rayQuery);
+
+        QueryCollector sphereResult, boxResult;
+        SphereSceneQuery* sphereQuery = sm->createSphereQuery(sphere);
+        sphereQuery->execute(&sphereResult);
+        sm->destroyQuery(sphereQuery);
+        AxisAlignedBoxSceneQuery* boxQuery = sm->createAABBQuery(box);
+        boxQuery->execute(&boxResult);
+        sm->destroyQuery(boxQuery);
+
+        EXPECT_EQ(onRay, rayResult);
+        EXPECT_EQ(inSphere, sphereResult.objects);
+        EXPECT_EQ(inBox, boxResult.objects);
+    }
+}
+}
+
+TEST_F(SceneQueryTest, BroadphaseMatchesBruteForce)
+{
+    minstd_rand rng;
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+
+    // moved nodes are picked up by the next scene graph update
+    std::uniform_real_distribution<Real> pos(-2500, 2500);
+    for (int i = 0; i < 100; ++i)
+        mSceneMgr->getEntity(StringConverter::toString(i))->getParentSceneNode()->setPosition(
+            pos(rng), pos(rng), pos(rng));
+    mSceneMgr->_updateSceneGraph(mCamera);
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+
+    // as are the descendants of moved nodes
+    SceneNode* parent = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    for (int i = 400; i < 450; ++i)
+    {
+        SceneNode* node = mSceneMgr->getEntity(StringConverter::toString(i))->getParentSceneNode();
+        node->getParentSceneNode()->removeChild(node);
+        parent->addChild(node);
+    }
+    mSceneMgr->_updateSceneGraph(mCamera);
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+
+    // queries do not update the scene graph themselves
+    NodeUpdateCounter counter;
+    SceneNode* child = mSceneMgr->getEntity("400")->getParentSceneNode();
+    child->setListener(&counter);
+    parent->translate(1000, -500, 250);
+    SphereSceneQuery* early = mSceneMgr->createSphereQuery(Sphere(Vector3::ZERO, 10));
+    early->execute();
+    mSceneMgr->destroyQuery(early);
+    EXPECT_EQ(counter.updates, 0);
+    mSceneMgr->_updateSceneGraph(mCamera);
+    EXPECT_EQ(counter.updates, 1);
+    child->setListener(NULL);
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+
+    // detached and destroyed objects are dropped right away
+    for (int i = 100; i < 150; ++i)
+        mSceneMgr->getEntity(StringConverter::toString(i))->detachFromParent();
+    for (int i = 150; i < 200; ++i)
+        mSceneMgr->destroyEntity(StringConverter::toString(i));
+    mSceneMgr->destroySceneNode(mSceneMgr->getEntity("200")->getParentSceneNode());
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+
+    // extracted objects are dropped as well and may move to another manager
+    Entity* extracted = mSceneMgr->getEntity("300");
+    mSceneMgr->extractMovableObject(extracted);
+    EXPECT_FALSE(extracted->_getManager());
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+
+    SceneManager* other = mRoot->createSceneManager();
+    extracted->detachFromParent();
+    other->injectMovableObject(extracted);
+    EXPECT_EQ(extracted->_getManager(), other);
+    other->getRootSceneNode()->createChildSceneNode()->attachObject(extracted);
+    other->_updateSceneGraph(NULL);
+    QueryCollector found;
+    SphereSceneQuery* query = other->createSphereQuery(Sphere(Vector3::ZERO, 10));
+    query->execute(&found);
+    other->destroyQuery(query);
+    ASSERT_EQ(found.objects.size(), 1u);
+    EXPECT_EQ(found.objects[0], extracted);
+
+    // destroys the extracted entity
+    mRoot->destroySceneManager(other);
+    expectBroadphaseMatchesBruteForce(mSceneMgr, rng);
+}
+
+TEST_F(SceneQueryTest, Batched)
+{
+    minstd_rand rng;
+    std::uniform_real_distribution<Real> pos(-2500, 2500);
+    std::vector<Ray> rays;
+    std::vector<Sphere> spheres;
+    for (int i = 0; i < 20; ++i)
+    {
+        Vector3 origin(pos(rng), pos(rng), pos(rng));
+        rays.push_back(Ray(origin, Vector3(pos(rng), pos(rng), pos(rng))));
+        spheres.push_back(Sphere(origin, 300));
+    }
+
+    std::vector<RaySceneQueryResult> rayResults;
+    std::vector<SceneQueryResultMovableList> sphereResults;
+    mSceneMgr->executeRayQueries(&rays[0], rays.size(), rayResults);
+    mSceneMgr->executeSphereQueries(&spheres[0], spheres.size(), sphereResults);
+    ASSERT_EQ(rays.size(), rayResults.size());
+    ASSERT_EQ(spheres.size(), sphereResults.size());
+
+    RaySceneQuery* rayQuery = mSceneMgr->createRayQuery(Ray());
+    rayQuery->setSortByDistance(true);
+    SphereSceneQuery* sphereQuery = mSceneMgr->createSphereQuery(Sphere());
+    size_t hits = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        rayQuery->setRay(rays[i]);
+        std::set<std::pair<Real, MovableObject*> > expected, actual;
+        for (const RaySceneQueryResultEntry& e : rayQuery->execute())
+            expected.insert(std::make_pair(e.distance, e.movable));
+        for (size_t j = 0; j < rayResults[i].size(); ++j)
+        {
+            actual.insert(std::make_pair(rayResults[i][j].distance, rayResults[i][j].movable));
+            if (j > 0)
+                EXPECT_LE(rayResults[i][j - 1].distance, rayResults[i][j].distance);
+        }
+        EXPECT_EQ(expected, actual);
+        hits += expected.size();
+
+        sphereQuery->setSphere(spheres[i]);
+        const SceneQueryResultMovableList& movables = sphereQuery->execute().movables;
+        EXPECT_EQ(std::set<MovableObject*>(movables.begin(), movables.end()),
+                  std::set<MovableObject*>(sphereResults[i].begin(), sphereResults[i].end()));
+    }
+    EXPECT_GT(hits, 0u);
+    mSceneMgr->destroyQuery(rayQuery);
+    mSceneMgr->destroyQuery(sphereQuery);
+}
+
+namespace
+{
+struct LightListSceneManager : public DefaultSceneManager
+{
+    LightListSceneManager() : DefaultSceneManager("LightList") {}
+    using SceneManager::findLightsAffectingFrustum;
+};
+}
+
+typedef RootWithoutRenderSystemFixture LightListTests;
+TEST_F(LightListTests, ClusteredMatchesBruteForce)
+{
+    LightListSceneManager sm;
+    std::minstd_rand rng(3);
+    std::uniform_real_distribution<Real> pos(-500, 500), range(10, 100);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        Light* l = sm.createLight();
+        // some lights reaching the whole scene
+        l->setAttenuation(i % 50 == 0 ? 2000 : range(rng), 1, 0, 0);
+        l->setLightMask(i % 3 ? 1 : 2);
+        sm.getRootSceneNode()->createChildSceneNode(Vector3(pos(rng), pos(rng), pos(rng)))->attachObject(l);
+    }
+    sm.createLight()->setType(Light::LT_DIRECTIONAL);
+
+    Camera* cam = sm.createCamera("cam");
+    sm.getRootSceneNode()->attachObject(cam);
+    cam->setFarClipDistance(0);
+    sm._updateSceneGraph(cam);
+    sm.findLightsAffectingFrustum(cam);
+
+    const LightList& frustumLights = sm._getLightsAffectingFrustum();
+    ASSERT_GE(frustumLights.size(), 16u);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        Vector3 p(pos(rng), pos(rng), pos(rng));
+        Real radius = range(rng);
+        uint32 mask = i % 2 ? 1 : 0xFFFFFFFF;
+
+        LightList expected;
+        for (Light* l : frustumLights)
+        {
+            l->_calcTempSquareDist(p);
+            if ((l->getLightMask() & mask) && l->isInLightRange(Sphere(p, radius)))
+                expected.push_back(l);
+        }
+        std::stable_sort(expected.begin(), expected.end(), SceneManager::lightLess());
+
+        LightList lights;
+        sm._populateLightList(p, radius, lights, mask);
+        EXPECT_TRUE(lights == expected);
+    }
+}
+
+typedef RootWithoutRenderSystemFixture SceneGraphUpdate;
+TEST_F(SceneGraphUpdate, StaticBranchBounds)
+{
+    SceneManager* sm = mRoot->createSceneManager();
+    SceneNode* root = sm->getRootSceneNode();
+    SceneNode* moving = root->createChildSceneNode()->createChildSceneNode(Vector3(10, 0, 0));
+    SceneNode* fixed = root->createChildSceneNode(Vector3(-10, 0, 0));
+    moving->attachObject(sm->createEntity("sphere.mesh"));
+    fixed->attachObject(sm->createEntity("sphere.mesh"));
+
+    sm->_updateSceneGraph(NULL);
+    AxisAlignedBox initialBounds = root->_getWorldAABB();
+    AxisAlignedBox fixedBounds = fixed->_getWorldAABB();
+
+    // nothing moved
+    sm->_updateSceneGraph(NULL);
+    EXPECT_EQ(root->_getWorldAABB(), initialBounds);
+
+    moving->translate(Vector3(1000, 0, 0));
+    sm->_updateSceneGraph(NULL);
+    EXPECT_TRUE(root->_getWorldAABB().contains(moving->_getWorldAABB()));
+    EXPECT_EQ(fixed->_getWorldAABB(), fixedBounds);
+
+    // bounds shrink again
+    moving->translate(Vector3(-1000, 0, 0));
+    sm->_updateSceneGraph(NULL);
+    EXPECT_EQ(root->_getWorldAABB(), initialBounds);
+
+    // objects changing their bounds update their nodes
+    BillboardSet* bbs = sm->createBillboardSet();
+    fixed->attachObject(bbs);
+    sm->_updateSceneGraph(NULL);
+    bbs->setBounds(AxisAlignedBox(-500, -1, -1, 1, 1, 1), 500);
+    sm->_updateSceneGraph(NULL);
+    EXPECT_EQ(fixed->_getWorldAABB().getMinimum().x, -510);
+
+    // billboards created after the first frame grow the bounds
+    SceneNode* billboards = root->createChildSceneNode(Vector3(0, 100, 0));
+    bbs = sm->createBillboardSet();
+    bbs->setDefaultDimensions(2, 2);
+    billboards->attachObject(bbs);
+    sm->_updateSceneGraph(NULL);
+    bbs->createBillboard(Vector3(0, 0, 300));
+    sm->_updateSceneGraph(NULL);
+    EXPECT_EQ(billboards->_getWorldAABB(), AxisAlignedBox(-2, 98, 298, 2, 102, 302));
+    EXPECT_EQ(root->_getWorldAABB().getMaximum().z, 302);
+
+    ManualObject* manual = sm->createManualObject();
+    billboards->attachObject(manual);
+    sm->_updateSceneGraph(NULL);
+    manual->setBoundingBox(AxisAlignedBox(0, 0, 0, 1, 1, 400));
+    sm->_updateSceneGraph(NULL);
+    EXPECT_EQ(root->_getWorldAABB().getMaximum().z, 400);
+
+    MeshPtr mesh = MeshManager::getSingleton().getByName("sphere.mesh");
+    mesh->_setBounds(AxisAlignedBox(-1, -1, -1, 500, 1, 1), false);
+    sm->_updateSceneGraph(NULL);
+    EXPECT_EQ(moving->_getWorldAABB().getMaximum().x, 510);
+    EXPECT_EQ(root->_getWorldAABB().getMaximum().x, 510);
+}
+
+TEST_F(SceneGraphUpdate, ParallelMatchesSerial)
+{
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* sms[] = {mRoot->createSceneManager(), mRoot->createSceneManager()};
+    sms[1]->setParallelSceneGraphUpdate(true);
+
+    std::vector<SceneNode*> nodes[2];
+    for (int s = 0; s < 2; ++s)
+    {
+        // we want the same random hierarchy in both
+        minstd_rand rng;
+        nodes[s].push_back(sms[s]->getRootSceneNode());
+        for (int i = 0; i < 2000; ++i)
+        {
+            SceneNode* parent = nodes[s][rng() % nodes[s].size()];
+            SceneNode* node = parent->createChildSceneNode(
+                Vector3(rng() % 100, rng() % 100, rng() % 100),
+                Quaternion(Degree(Real(rng() % 360)), Vector3::UNIT_Y));
+            node->setScale(Vector3(1 + rng() % 3));
+            node->setInheritScale(rng() % 4 != 0);
+            if (i % 3 == 0)
+                node->attachObject(sms[s]->createEntity("sphere.mesh"));
+            nodes[s].push_back(node);
+        }
+        sms[s]->_updateSceneGraph(NULL);
+
+        // only update some branches the second time
+        for (int i = 0; i < 50; ++i)
+            nodes[s][1 + rng() % (nodes[s].size() - 1)]->translate(Vector3(rng() % 10, 0, 0));
+        sms[s]->_updateSceneGraph(NULL);
+    }
+
+    for (size_t i = 0; i < nodes[0].size(); ++i)
+    {
+        ASSERT_EQ(nodes[0][i]->_getDerivedPosition(), nodes[1][i]->_getDerivedPosition());
+        ASSERT_EQ(nodes[0][i]->_getDerivedOrientation(), nodes[1][i]->_getDerivedOrientation());
+        ASSERT_EQ(nodes[0][i]->_getDerivedScale(), nodes[1][i]->_getDerivedScale());
+        ASSERT_EQ(nodes[0][i]->_getWorldAABB(), nodes[1][i]->_getWorldAABB());
+    }
+}
+
+namespace
+{
+struct QueuedRenderables : public RenderQueue::RenderableListener
+{
+    std::vector<Renderable*> renderables;
+    bool renderableQueued(Renderable* rend, uint8, ushort, Technique**, RenderQueue*)
+    {
+        renderables.push_back(rend);
+        // without a RenderSystem there are no techniques to queue with
+        return false;
+    }
+};
+
+std::vector<Renderable*> findVisibleRenderables(SceneManager* sm, Camera* cam)
+{
+    QueuedRenderables listener;
+    sm->getRenderQueue()->clear();
+    sm->getRenderQueue()->setRenderableListener(&listener);
+    VisibleObjectsBoundsInfo bounds;
+    sm->_findVisibleObjects(cam, &bounds, false);
+    sm->getRenderQueue()->setRenderableListener(NULL);
+    return listener.renderables;
+}
+}
+
+TEST_F(SceneGraphUpdate, ConcurrentCulling)
+{
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* sm = mRoot->createSceneManager();
+    minstd_rand rng;
+    std::vector<SceneNode*> nodes(1, sm->getRootSceneNode());
+    for (int i = 0; i < 1000; ++i)
+    {
+        SceneNode* node = nodes[rng() % nodes.size()]->createChildSceneNode(
+            Vector3(Real(rng() % 200) - 100, Real(rng() % 200) - 100, Real(rng() % 200) - 100));
+        if (i % 2 == 0)
+            node->attachObject(sm->createEntity("sphere.mesh"));
+        nodes.push_back(node);
+    }
+
+    Camera* cameras[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        cameras[i] = sm->createCamera(StringConverter::toString(i));
+        SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 500));
+        camNode->yaw(Degree(Real(i * 10)));
+        camNode->attachObject(cameras[i]);
+    }
+    sm->_updateSceneGraph(NULL);
+
+    std::vector<Renderable*> expected[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        expected[i] = findVisibleRenderables(sm, cameras[i]);
+        EXPECT_FALSE(expected[i].empty());
+    }
+
+    // disabled, so nothing is culled ahead of time
+    sm->_cullCameras(cameras, 3);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(expected[i], findVisibleRenderables(sm, cameras[i]));
+
+    sm->setConcurrentCulling(true);
+    sm->_cullCameras(cameras, 3);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(expected[i], findVisibleRenderables(sm, cameras[i]));
+
+    // moving a camera or the scene in between must not use the stale nodes
+    sm->_cullCameras(cameras, 3);
+    cameras[0]->getParentSceneNode()->yaw(Degree(90));
+    nodes[1]->translate(Vector3(0, 0, 1000));
+    sm->_updateSceneGraph(NULL);
+    sm->setConcurrentCulling(false);
+    std::vector<Renderable*> moved[3];
+    for (int i = 0; i < 3; ++i)
+        moved[i] = findVisibleRenderables(sm, cameras[i]);
+
+    sm->setConcurrentCulling(true);
+    sm->_cullCameras(cameras, 3);
+    cameras[0]->getParentSceneNode()->yaw(Degree(-90));
+    nodes[1]->translate(Vector3(0, 0, -1000));
+    sm->_updateSceneGraph(NULL);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(expected[i], findVisibleRenderables(sm, cameras[i]));
+    EXPECT_NE(expected[0], moved[0]);
+}
+
 TEST(MaterialSerializer, Basic)
 {
     Root root;
@@ -267,4 +895,226 @@ TEST_F(TextureTests, Blank)
     EXPECT_EQ(tus->getIsAlpha(), false);
     EXPECT_EQ(tus->getGamma(), 1.0f);
     EXPECT_EQ(tus->isHardwareGammaEnabled(), false);
-}
\ No newline at end of file
+}
+typedef RootWithoutRenderSystemFixture AnimationTests;
+TEST_F(AnimationTests, PackedKeyFrames)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("packed", RGN_DEFAULT, true);
+    Bone* bone = skel->createBone(0);
+    for (unsigned short i = 1; i < 4; ++i)
+        bone = bone->createChild(i, Vector3(0, 10, 0));
+    skel->setBindingPose();
+
+    // tracks with differing key frame times, one of them without key frames
+    Animation* anim = skel->createAnimation("walk", 3);
+    for (unsigned short i = 0; i < 3; ++i)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(i, skel->getBone(i));
+        for (int k = 0; k < 4 + i; ++k)
+        {
+            TransformKeyFrame* kf = track->createNodeKeyFrame(Real(k) * (0.7f - i * 0.1f) + i * 0.05f);
+            kf->setRotation(Quaternion(Degree(Real(k * 20 + i)), Vector3::UNIT_X));
+            kf->setTranslate(Vector3(Real(k), Real(i), 0));
+            kf->setScale(Vector3(1 + k * 0.1f));
+        }
+    }
+    anim->createNodeTrack(3, skel->getBone(3));
+    EXPECT_FALSE(anim->getUsePackedKeyFrames());
+    anim->setUsePackedKeyFrames(true);
+
+    AnimationStateSet states;
+    AnimationState* state = states.createAnimationState("walk", 0, 3);
+    state->setEnabled(true);
+    AnimationState::BoneBlendMask mask(4, 1);
+    mask[1] = 0.5f;
+
+    // forward, repeated, backwards, past the end and onto the last key frame
+    Real times[] = {0, 0.1f, 0.35f, 0.35f, 0.8f, 1.3f, 2.1f, 2.9f, 0.4f, 0.05f, 4.2f, 2.1f};
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        if (pass == 1)
+            anim->getNodeTrack(1)->getNodeKeyFrame(2)->setRotation(Quaternion(Degree(90), Vector3::UNIT_Y));
+        if (pass == 2)
+        {
+            state->createBlendMask(4, 1);
+            state->setBlendMaskEntry(1, 0.5f);
+        }
+
+        for (size_t t = 0; t < sizeof(times) / sizeof(times[0]); ++t)
+        {
+            skel->reset();
+            TimeIndex timeIndex = anim->_getTimeIndex(times[t]);
+            for (unsigned short i = 0; i < 4; ++i)
+            {
+                Real weight = pass == 2 ? mask[i] : 1;
+                anim->getNodeTrack(i)->applyToNode(skel->getBone(i), timeIndex, weight);
+            }
+            std::vector<Affine3> expected;
+            for (unsigned short i = 0; i < 4; ++i)
+                expected.push_back(Affine3(skel->getBone(i)->getPosition(), skel->getBone(i)->getOrientation(),
+                                           skel->getBone(i)->getScale()));
+
+            skel->reset();
+            if (pass == 2)
+                anim->apply(skel.get(), times[t], 1, &mask, 1);
+            else
+                anim->apply(skel.get(), times[t]);
+            for (unsigned short i = 0; i < 4; ++i)
+                EXPECT_EQ(Affine3(skel->getBone(i)->getPosition(), skel->getBone(i)->getOrientation(),
+                                  skel->getBone(i)->getScale()), expected[i]);
+
+            // sequential playback continues from the cursor of the state
+            state->setTimePosition(times[t]);
+            skel->setAnimationState(states);
+            for (unsigned short i = 0; i < 4; ++i)
+                EXPECT_EQ(Affine3(skel->getBone(i)->getPosition(), skel->getBone(i)->getOrientation(),
+                                  skel->getBone(i)->getScale()), expected[i]);
+        }
+    }
+}
+
+TEST_F(AnimationTests, ReduceKeyFrames)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("reduced", RGN_DEFAULT, true);
+    skel->createBone(0);
+    skel->createBone(1);
+    Animation* anim = skel->createAnimation("walk", 4);
+    anim->setRotationInterpolationMode(Animation::RIM_SPHERICAL);
+
+    // two linear segments
+    NodeAnimationTrack* linear = anim->createNodeTrack(0, skel->getBone(0));
+    for (int k = 0; k <= 20; ++k)
+    {
+        TransformKeyFrame* kf = linear->createNodeKeyFrame(k * 0.1f);
+        kf->setTranslate(Vector3(Real(k <= 10 ? k : 20 - k), 0, 0));
+        kf->setRotation(Quaternion(Degree(Real(k * 5)), Vector3::UNIT_Y));
+    }
+
+    // a curve
+    NodeAnimationTrack* curve = anim->createNodeTrack(1, skel->getBone(1));
+    std::vector<TransformKeyFrame> original;
+    for (int k = 0; k <= 100; ++k)
+    {
+        TransformKeyFrame* kf = curve->createNodeKeyFrame(k * 0.04f);
+        kf->setTranslate(Vector3(Math::Sin(Radian(k * 0.1f)), 0, Real(k) / 10));
+        kf->setRotation(Quaternion(Radian(Math::Cos(Radian(k * 0.05f))), Vector3::UNIT_X));
+        kf->setScale(Vector3(1 + Real(k % 2) * 0.0001f));
+        original.push_back(*kf);
+    }
+
+    anim->reduceNodeKeyFrames(0.01f, Degree(0.5f), 0.001f);
+
+    ASSERT_EQ(linear->getNumKeyFrames(), 3);
+    EXPECT_EQ(linear->getNodeKeyFrame(1)->getTime(), 1.0f);
+    EXPECT_EQ(linear->getNodeKeyFrame(1)->getTranslate(), Vector3(10, 0, 0));
+
+    EXPECT_LT(curve->getNumKeyFrames(), 50);
+    EXPECT_EQ(curve->getNodeKeyFrame(0)->getTime(), 0.0f);
+    EXPECT_EQ(curve->getNodeKeyFrame(curve->getNumKeyFrames() - 1)->getTime(), 4.0f);
+    for (size_t k = 0; k < original.size(); ++k)
+    {
+        TransformKeyFrame kf(0, 0);
+        curve->getInterpolatedKeyFrame(anim->_getTimeIndex(original[k].getTime()), &kf);
+        EXPECT_LE(kf.getTranslate().distance(original[k].getTranslate()), 0.01f);
+        EXPECT_TRUE(kf.getRotation().equals(original[k].getRotation(), Degree(0.5f)));
+        EXPECT_LE(kf.getScale().distance(original[k].getScale()), 0.001f);
+    }
+}
+
+TEST_F(AnimationTests, CompressedKeyFrames)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("compressed", RGN_DEFAULT, true);
+    Bone* bone = skel->createBone(0);
+    for (unsigned short i = 1; i < 3; ++i)
+        bone = bone->createChild(i, Vector3(0, 10, 0));
+    skel->setBindingPose();
+
+    Animation* anim = skel->createAnimation("walk", 10);
+    for (unsigned short i = 0; i < 3; ++i)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(i, skel->getBone(i));
+        for (int k = 0; k < 200; ++k)
+        {
+            TransformKeyFrame* kf = track->createNodeKeyFrame(k * 0.05f);
+            Vector3 axis(Math::Sin(Radian(Real(k))), 1, Real(i));
+            kf->setRotation(Quaternion(Degree(Real(k * 7 % 360)), axis.normalisedCopy()));
+            kf->setTranslate(Vector3(Math::Cos(Radian(k * 0.1f)) * 5, Real(k % 7), 0));
+            // constant scale is left out
+            if (i == 2)
+                kf->setScale(Vector3(1 + Real(k % 3)));
+        }
+    }
+
+    Real times[] = {0, 0.03f, 1.71f, 5, 9.96f, 9.99f, 12.5f, 0.02f};
+    std::vector<Vector3> positions, scales;
+    std::vector<Quaternion> orientations;
+    for (size_t t = 0; t < sizeof(times) / sizeof(times[0]); ++t)
+    {
+        skel->reset();
+        anim->apply(skel.get(), times[t]);
+        for (unsigned short i = 0; i < 3; ++i)
+        {
+            positions.push_back(skel->getBone(i)->getPosition());
+            orientations.push_back(skel->getBone(i)->getOrientation());
+            scales.push_back(skel->getBone(i)->getScale());
+        }
+    }
+
+    size_t size = 0;
+    for (unsigned short i = 0; i < 3; ++i)
+        size += anim->getNodeTrack(i)->calculateKeyFrameSize();
+    anim->compressNodeTracks();
+    size_t compressedSize = 0;
+    for (unsigned short i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(anim->getNodeTrack(i)->isCompressed());
+        ASSERT_EQ(anim->getNodeTrack(i)->getNumKeyFrames(), 200);
+        compressedSize += anim->getNodeTrack(i)->calculateKeyFrameSize();
+    }
+    EXPECT_LT(compressedSize * 3, size);
+
+    // the same within the quantisation error, also when cloned or decompressed
+    Animation* cloned = anim->clone("cloned");
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        Animation* sampled = pass == 1 ? cloned : anim;
+        if (pass == 2)
+        {
+            anim->getNodeTrack(1)->decompress();
+            EXPECT_FALSE(anim->getNodeTrack(1)->isCompressed());
+        }
+
+        for (size_t t = 0; t < sizeof(times) / sizeof(times[0]); ++t)
+        {
+            skel->reset();
+            sampled->apply(skel.get(), times[t]);
+            for (unsigned short i = 0; i < 3; ++i)
+            {
+                Bone* b = skel->getBone(i);
+                size_t k = t * 3 + i;
+                EXPECT_LE(b->getPosition().distance(positions[k]), 2e-4f);
+                // about half the angle between them, either sign
+                Quaternion q = b->getOrientation();
+                EXPECT_LE(std::min((q - orientations[k]).Norm(), (q + orientations[k]).Norm()), 1e-4f);
+                EXPECT_LE(b->getScale().distance(scales[k]), 1e-4f);
+            }
+        }
+    }
+    OGRE_DELETE cloned;
+
+    // key frames can be read as copies, and adding one decompresses the track
+    NodeAnimationTrack* track = anim->getNodeTrack(0);
+    TransformKeyFrame decoded = track->getNodeKeyFrameCopy(20);
+    EXPECT_EQ(decoded.getTime(), 20 * 0.05f);
+    EXPECT_LE(decoded.getTranslate().distance(Vector3(Math::Cos(Radian(2)) * 5, 6, 0)), 1e-4f);
+    EXPECT_EQ(track->getNodeKeyFrameCopy(21).getTime(), 21 * 0.05f);
+    EXPECT_EQ(decoded.getTime(), 20 * 0.05f);
+    // there are no key frame objects to point to
+    EXPECT_THROW(track->getNodeKeyFrame(20), InvalidStateException);
+    KeyFrame *kf1, *kf2;
+    EXPECT_THROW(track->getKeyFramesAtTime(TimeIndex(1), &kf1, &kf2), InvalidStateException);
+    EXPECT_TRUE(track->hasNonZeroKeyFrames());
+    track->createNodeKeyFrame(10.01f);
+    EXPECT_FALSE(track->isCompressed());
+    EXPECT_EQ(track->getNumKeyFrames(), 201);
+}
@@ -71,6 +71,15 @@ public:
     }
 };
 //--------------------------------------------------------------------------
+class KeyIndexSortFunctor
+{
+public:
+    uint64 operator()(const std::pair<uint64, int>& p) const
+    {
+        return p.first;
+    }
+};
+//--------------------------------------------------------------------------
 TEST_F(RadixSortTests,FloatVector)
 {
     std::vector<float> container;
@@ -203,5 +212,49 @@ TEST_F(RadixSortTests,IntVector)
     }
 }
 //--------------------------------------------------------------------------
+TEST_F(RadixSortTests,NegativeFloatVector)
+{
+    std::vector<float> container;
+    FloatSortFunctor func;
+    RadixSort<std::vector<float>, float, float> sorter;
+
+    // all values share the sign byte
+    for (int i = 0; i < 1000; ++i)
+    {
+        container.push_back(Math::RangeRandom(-2.0f, -1.0f));
+    }
+
+    sorter.sort(container, func);
+
+    std::vector<float>::iterator v = container.begin();
+    float lastValue = *v++;
+    for (;v != container.end(); ++v)
+    {
+        EXPECT_TRUE(*v >= lastValue);
+        lastValue = *v;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,UInt64VectorStable)
+{
+    std::vector<std::pair<uint64, int> > container;
+    KeyIndexSortFunctor func;
+    RadixSort<std::vector<std::pair<uint64, int> >, std::pair<uint64, int>, uint64> sorter;
 
+    // few distinct keys, bytes 0-3 are equal for all of them
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint64 key = uint64(Math::RangeRandom(0, 16)) << 56 | uint64(Math::RangeRandom(0, 4)) << 32 | 0xABCD;
+        container.push_back(std::make_pair(key, i));
+    }
+
+    sorter.sort(container, func);
 
+    for (size_t i = 1; i < container.size(); ++i)
+    {
+        EXPECT_LE(container[i - 1].first, container[i].first);
+        if (container[i - 1].first == container[i].first)
+            EXPECT_LT(container[i - 1].second, container[i].second);
+    }
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,268 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreRoot.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreSceneNode.h"
+#include "OgreMovableObject.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace Ogre;
+//--------------------------------------------------------------------------
+namespace
+{
+/// Object with fixed bounds which counts how often it was queued
+class BoxObject : public MovableObject
+{
+    AxisAlignedBox mBox;
+public:
+    int mQueued;
+
+    BoxObject(const AxisAlignedBox& box) : mBox(box), mQueued(0) {}
+
+    const String& getMovableType(void) const
+    {
+        static const String type = "BoxObject";
+        return type;
+    }
+    const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+    Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+    void _updateRenderQueue(RenderQueue* queue) { ++mQueued; }
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables) {}
+};
+
+/// Collects the query results
+struct ResultCollector : public SceneQueryListener, public RaySceneQueryListener
+{
+    std::set<MovableObject*> objects;
+
+    bool queryResult(MovableObject* object) { objects.insert(object); return true; }
+    bool queryResult(SceneQuery::WorldFragment* fragment) { return true; }
+    bool queryResult(MovableObject* object, Real distance) { objects.insert(object); return true; }
+    bool queryResult(SceneQuery::WorldFragment* fragment, Real distance) { return true; }
+};
+
+/// A flat scene of randomly placed boxes, so culling per node equals culling per object
+struct BoxScene
+{
+    SceneManager* sm;
+    Camera* cam;
+    std::vector<SceneNode*> nodes;
+    std::vector<BoxObject*> objects;
+    std::mt19937 rng;
+
+    BoxScene(SceneManager* mgr, size_t count) : sm(mgr), rng(42)
+    {
+        cam = sm->createCamera("cam");
+        cam->setNearClipDistance(1);
+        cam->setFarClipDistance(500);
+        cam->setAspectRatio(1.5f);
+        cam->setPosition(Vector3::ZERO);
+        cam->lookAt(Vector3(1, 0.2f, 0.5f));
+
+        std::uniform_real_distribution<Real> size(0.5f, 5);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 half(size(rng), size(rng), size(rng));
+            objects.push_back(new BoxObject(AxisAlignedBox(-half, half)));
+            nodes.push_back(sm->getRootSceneNode()->createChildSceneNode(randomPosition()));
+            nodes.back()->attachObject(objects.back());
+        }
+        sm->_updateSceneGraph(cam);
+    }
+
+    ~BoxScene()
+    {
+        sm->clearScene();
+        for (auto o : objects)
+            delete o;
+    }
+
+    Vector3 randomPosition()
+    {
+        std::uniform_real_distribution<Real> pos(-1000, 1000);
+        return Vector3(pos(rng), pos(rng) * 0.2f, pos(rng));
+    }
+
+    /// Move a fraction of the nodes, small steps mostly and some far jumps
+    void moveNodes(size_t every)
+    {
+        std::uniform_real_distribution<Real> step(-1, 1);
+        for (size_t i = 0; i < nodes.size(); i += every)
+        {
+            if (i % (every * 10) == 0)
+                nodes[i]->setPosition(randomPosition());
+            else
+                nodes[i]->translate(step(rng), step(rng), step(rng));
+        }
+        sm->_updateSceneGraph(cam);
+    }
+
+    std::set<MovableObject*> findVisible()
+    {
+        for (auto o : objects)
+            o->mQueued = 0;
+        sm->_findVisibleObjects(cam, NULL, false);
+        std::set<MovableObject*> ret;
+        for (auto o : objects)
+            if (o->mQueued)
+                ret.insert(o);
+        return ret;
+    }
+};
+}
+
+typedef RootWithoutRenderSystemFixture BVHSceneManagerTest;
+//--------------------------------------------------------------------------
+TEST_F(BVHSceneManagerTest, CullingMatchesDefault)
+{
+    BVHSceneManager bvh("bvh");
+    DefaultSceneManager def("default");
+    // nodes update the shared tree, so this keeps updating serially
+    bvh.setParallelSceneGraphUpdate(true);
+    EXPECT_FALSE(bvh.supportsParallelNodeUpdate());
+    BoxScene a(&bvh, 1000), b(&def, 1000);
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        std::set<MovableObject*> visible = a.findVisible();
+        std::set<MovableObject*> expected = b.findVisible();
+
+        // map the objects of the default scene onto the identical BVH scene
+        std::set<MovableObject*> mapped;
+        for (size_t i = 0; i < b.objects.size(); ++i)
+            if (expected.count(b.objects[i]))
+                mapped.insert(a.objects[i]);
+
+        EXPECT_FALSE(visible.empty());
+        EXPECT_EQ(mapped, visible);
+
+        a.moveNodes(3);
+        b.moveNodes(3);
+    }
+
+    size_t proxies = 0;
+    bvh.getOption("ProxyCount", &proxies);
+    EXPECT_EQ(1000u, proxies);
+}
+//--------------------------------------------------------------------------
+TEST_F(BVHSceneManagerTest, QueriesMatchBruteForce)
+{
+    BVHSceneManager bvh("bvh");
+    SceneManager* sm = &bvh;
+    BoxScene scene(sm, 1000);
+    scene.moveNodes(2);
+
+    std::uniform_real_distribution<Real> radius(10, 200);
+    for (int i = 0; i < 20; ++i)
+    {
+        Vector3 centre = scene.randomPosition();
+        Real r = radius(scene.rng);
+
+        AxisAlignedBox box(centre - r, centre + r);
+        Sphere sphere(centre, r);
+        Ray ray(centre, scene.randomPosition() - centre);
+        PlaneBoundedVolume volume;
+        volume.planes.push_back(Plane(Vector3::UNIT_X, -centre.x + r)); // x > centre.x - r
+        volume.planes.push_back(Plane(Vector3::NEGATIVE_UNIT_Z, centre.z + r)); // z < centre.z + r
+        PlaneBoundedVolumeList volumes(1, volume);
+
+        std::set<MovableObject*> inBox, inSphere, onRay, inVolume;
+        for (auto o : scene.objects)
+        {
+            const AxisAlignedBox& bounds = o->getWorldBoundingBox();
+            if (box.intersects(bounds))
+                inBox.insert(o);
+            if (sphere.intersects(bounds))
+                inSphere.insert(o);
+            if (ray.intersects(bounds).first)
+                onRay.insert(o);
+            if (volume.intersects(bounds))
+                inVolume.insert(o);
+        }
+
+        ResultCollector boxResult, sphereResult, rayResult, volumeResult;
+        SceneQuery* q = sm->createAABBQuery(box);
+        static_cast<AxisAlignedBoxSceneQuery*>(q)->execute(&boxResult);
+        sm->destroyQuery(q);
+        q = sm->createSphereQuery(sphere);
+        static_cast<SphereSceneQuery*>(q)->execute(&sphereResult);
+        sm->destroyQuery(q);
+        q = sm->createRayQuery(ray);
+        static_cast<RaySceneQuery*>(q)->execute(&rayResult);
+        sm->destroyQuery(q);
+        q = sm->createPlaneBoundedVolumeQuery(volumes);
+        static_cast<PlaneBoundedVolumeListSceneQuery*>(q)->execute(&volumeResult);
+        sm->destroyQuery(q);
+
+        EXPECT_EQ(inBox, boxResult.objects);
+        EXPECT_EQ(inSphere, sphereResult.objects);
+        EXPECT_EQ(onRay, rayResult.objects);
+        EXPECT_EQ(inVolume, volumeResult.objects);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(BVHSceneManagerTest, NodeLifetime)
+{
+    BVHSceneManager bvh("bvh");
+    BoxObject obj(AxisAlignedBox(-1, -1, -1, 1, 1, 1));
+    size_t proxies = 0;
+
+    SceneNode* parent = bvh.getRootSceneNode()->createChildSceneNode();
+    SceneNode* node = parent->createChildSceneNode();
+    node->attachObject(&obj);
+    bvh._updateSceneGraph(NULL);
+    bvh.getOption("ProxyCount", &proxies);
+    EXPECT_EQ(1u, proxies);
+
+    // leaving the scene graph takes the whole branch out of the tree
+    bvh.getRootSceneNode()->removeChild(parent);
+    bvh.getOption("ProxyCount", &proxies);
+    EXPECT_EQ(0u, proxies);
+
+    bvh.getRootSceneNode()->addChild(parent);
+    bvh._updateSceneGraph(NULL);
+    bvh.getOption("ProxyCount", &proxies);
+    EXPECT_EQ(1u, proxies);
+
+    node->detachObject(&obj);
+    bvh._updateSceneGraph(NULL);
+    bvh.getOption("ProxyCount", &proxies);
+    EXPECT_EQ(0u, proxies);
+
+    node->attachObject(&obj);
+    bvh._updateSceneGraph(NULL);
+    bvh.destroySceneNode(node);
+    bvh.getOption("ProxyCount", &proxies);
+    EXPECT_EQ(0u, proxies);
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,775 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreRoot.h"
+#include "OgreNullPlugin.h"
+#include "OgreNullRenderSystem.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreEntity.h"
+#include "OgreSceneNode.h"
+#include "OgreRenderWindow.h"
+#include "OgreRenderTexture.h"
+#include "OgreViewport.h"
+#include "OgreMeshManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreRectangle2D.h"
+#include "OgreSubEntity.h"
+#include "OgreWorkQueue.h"
+#include "OgreRenderCommandList.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreAutoParamDataSource.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreMesh.h"
+
+#include <gtest/gtest.h>
+
+using namespace Ogre;
+//--------------------------------------------------------------------------
+class NullRenderSystemTests : public ::testing::Test
+{
+public:
+    Root* mRoot;
+    NullPlugin* mPlugin;
+    NullRenderSystem* mRenderSystem;
+    RenderWindow* mWindow;
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+
+    void SetUp()
+    {
+        mRoot = OGRE_NEW Root("");
+        mPlugin = OGRE_NEW NullPlugin();
+        mRoot->installPlugin(mPlugin);
+
+        mRenderSystem = static_cast<NullRenderSystem*>(
+            mRoot->getRenderSystemByName("Null Rendering Subsystem"));
+        ASSERT_TRUE(mRenderSystem);
+        mRoot->setRenderSystem(mRenderSystem);
+        mRoot->initialise(false);
+        mWindow = mRoot->createRenderWindow("NullRenderSystemTests", 800, 600, false);
+
+        mSceneMgr = mRoot->createSceneManager();
+        mCamera = mSceneMgr->createCamera("Camera");
+        mCamera->setNearClipDistance(1);
+        SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+        camNode->attachObject(mCamera);
+        camNode->setPosition(0, 0, 500);
+        mWindow->addViewport(mCamera);
+
+        MeshManager::getSingleton().createPlane("plane", RGN_DEFAULT, Plane(Vector3::UNIT_Z, 0),
+                                                 100, 100);
+    }
+
+    void TearDown()
+    {
+        OGRE_DELETE mRoot;
+        OGRE_DELETE mPlugin;
+    }
+
+    void addPlanes(int count, const String& material)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Entity* ent = mSceneMgr->createEntity("plane");
+            ent->setMaterialName(material);
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+            node->attachObject(ent);
+            node->setPosition(Real(i * 10 - count * 5), 0, 0);
+        }
+    }
+};
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, CountsDrawCalls)
+{
+    EXPECT_TRUE(mRenderSystem->getCapabilities()->hasCapability(RSC_FIXED_FUNCTION));
+
+    addPlanes(5, "BaseWhite");
+    mRenderSystem->resetStatistics();
+
+    ASSERT_TRUE(mRoot->renderOneFrame());
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    EXPECT_EQ(stats.frames, 1u);
+    EXPECT_EQ(stats.drawCalls, 5u);
+    EXPECT_EQ(mRenderSystem->_getBatchCount(), 5u);
+    EXPECT_GT(stats.stateChanges, 0u);
+    EXPECT_GT(stats.viewportChanges, 0u);
+    EXPECT_GT(stats.clears, 0u);
+    EXPECT_TRUE(mWindow->getDepthBuffer());
+
+    mRenderSystem->resetStatistics();
+    EXPECT_EQ(stats.drawCalls, 0u);
+
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_EQ(stats.drawCalls, 5u);
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, RenderToTexture)
+{
+    TexturePtr tex = TextureManager::getSingleton().createManual(
+        "rtt", RGN_DEFAULT, TEX_TYPE_2D, 256, 256, 0, PF_BYTE_RGBA, TU_RENDERTARGET);
+    RenderTexture* rtt = tex->getBuffer()->getRenderTarget();
+    rtt->addViewport(mCamera);
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("textured", RGN_DEFAULT);
+    mat->getTechnique(0)->getPass(0)->createTextureUnitState("rtt");
+    addPlanes(3, "textured");
+
+    // contents are kept in system memory
+    HardwarePixelBufferSharedPtr buf = tex->getBuffer();
+    uint32 texel = 0xFF00FF00;
+    buf->blitFromMemory(PixelBox(1, 1, 1, PF_BYTE_RGBA, &texel), Box(4, 4, 5, 5));
+    uint32 readBack = 0;
+    buf->blitToMemory(Box(4, 4, 5, 5), PixelBox(1, 1, 1, PF_BYTE_RGBA, &readBack));
+    EXPECT_EQ(readBack, texel);
+
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    // the RTT sees the planes, which sample the RTT itself
+    EXPECT_EQ(stats.drawCalls, 6u);
+    EXPECT_GE(stats.renderTargetChanges, 2u);
+    EXPECT_GT(stats.textureBinds, 0u);
+    EXPECT_TRUE(rtt->getDepthBuffer());
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, BindsGpuPrograms)
+{
+    HighLevelGpuProgramPtr vp = HighLevelGpuProgramManager::getSingleton().createProgram(
+        "vs", RGN_DEFAULT, "glsl", GPT_VERTEX_PROGRAM);
+    vp->setSource("void main() { gl_Position = ftransform(); }");
+    HighLevelGpuProgramPtr fp = HighLevelGpuProgramManager::getSingleton().createProgram(
+        "fs", RGN_DEFAULT, "glsl", GPT_FRAGMENT_PROGRAM);
+    fp->setSource("void main() { gl_FragColor = vec4(1.0); }");
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("shaded", RGN_DEFAULT);
+    Pass* pass = mat->getTechnique(0)->getPass(0);
+    pass->setVertexProgram("vs");
+    pass->setFragmentProgram("fs");
+    pass->getVertexProgramParameters()->setNamedAutoConstant(
+        "worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+    mat->load();
+
+    EXPECT_TRUE(vp->isSupported());
+    EXPECT_TRUE(mat->getBestTechnique());
+
+    addPlanes(2, "shaded");
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    EXPECT_EQ(stats.drawCalls, 2u);
+    EXPECT_GT(stats.programBinds, 0u);
+    EXPECT_GE(stats.parameterUploads, 2u);
+    EXPECT_TRUE(mRenderSystem->isGpuProgramBound(GPT_VERTEX_PROGRAM));
+}
+//--------------------------------------------------------------------------
+namespace
+{
+struct CountingRectangle : public Rectangle2D
+{
+    int queued;
+    CountingRectangle() : queued(0) {}
+    void _updateRenderQueue(RenderQueue* queue)
+    {
+        ++queued;
+        Rectangle2D::_updateRenderQueue(queue);
+    }
+};
+}
+
+TEST_F(NullRenderSystemTests, StaticObjectsReplayQueueEntries)
+{
+    CountingRectangle rect;
+    rect.setBoundingBox(AxisAlignedBox::BOX_INFINITE);
+    rect.setStatic(true);
+    mSceneMgr->getRootSceneNode()->attachObject(&rect);
+
+    addPlanes(2, "BaseWhite");
+    Entity* ent = mSceneMgr->createEntity("plane");
+    ent->setStatic(true);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ent);
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    for (int i = 0; i < 3; ++i)
+    {
+        mRenderSystem->resetStatistics();
+        ASSERT_TRUE(mRoot->renderOneFrame());
+        EXPECT_EQ(stats.drawCalls, 4u);
+    }
+    EXPECT_EQ(rect.queued, 1);
+
+    // recorded again when invalidated
+    rect.notifyStaticDirty();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_EQ(rect.queued, 2);
+
+    // sub entity changes invalidate the parent entity
+    ent->getSubEntity(0)->setVisible(false);
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_EQ(stats.drawCalls, 3u);
+
+    rect.setStatic(false);
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_EQ(rect.queued, 3);
+
+    mSceneMgr->getRootSceneNode()->detachObject(&rect);
+}
+//--------------------------------------------------------------------------
+namespace
+{
+struct QueueContents : public QueuedRenderableVisitor
+{
+    std::vector<std::pair<const Pass*, Renderable*> > entries;
+    void visit(RenderablePass* rp) { entries.push_back(std::make_pair(rp->pass, rp->renderable)); }
+    void visit(const Pass* p, RenderableList& rs)
+    {
+        for (size_t i = 0; i < rs.size(); ++i)
+            entries.push_back(std::make_pair(p, rs[i]));
+    }
+};
+
+std::vector<std::pair<const Pass*, Renderable*> > getMainQueueContents(SceneManager* sm)
+{
+    QueueContents contents;
+    RenderQueueGroup::PriorityMapIterator it =
+        sm->getRenderQueue()->getQueueGroup(RENDER_QUEUE_MAIN)->getIterator();
+    while (it.hasMoreElements())
+    {
+        RenderPriorityGroup* group = it.getNext();
+        group->getSolidsBasic().acceptVisitor(&contents, QueuedRenderableCollection::OM_PASS_GROUP);
+        group->getTransparents().acceptVisitor(&contents, QueuedRenderableCollection::OM_SORT_DESCENDING);
+    }
+    return contents.entries;
+}
+}
+
+TEST_F(NullRenderSystemTests, ParallelRenderQueueBuild)
+{
+    mRoot->getWorkQueue()->startup();
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("transparent", RGN_DEFAULT);
+    mat->setSceneBlending(SBT_TRANSPARENT_ALPHA);
+    mat->setDepthWriteEnabled(false);
+    addPlanes(150, "BaseWhite");
+    addPlanes(50, "transparent");
+
+    std::vector<Entity*> entities;
+    SceneManager::MovableObjectIterator it = mSceneMgr->getMovableObjectIterator("Entity");
+    while (it.hasMoreElements())
+    {
+        entities.push_back(static_cast<Entity*>(it.getNext()));
+        entities.back()->setStatic(true);
+    }
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    size_t drawCalls = stats.drawCalls;
+    std::vector<std::pair<const Pass*, Renderable*> > serial = getMainQueueContents(mSceneMgr);
+    ASSERT_GT(drawCalls, 100u);
+
+    mSceneMgr->setParallelRenderQueueBuild(true);
+    for (int i = 0; i < 2; ++i)
+    {
+        mRenderSystem->resetStatistics();
+        ASSERT_TRUE(mRoot->renderOneFrame());
+        EXPECT_EQ(stats.drawCalls, drawCalls);
+        // blocks are merged in order, so all static is exactly the serial order
+        EXPECT_TRUE(getMainQueueContents(mSceneMgr) == serial);
+    }
+
+    // the others are queued after the merge
+    for (size_t i = 0; i < entities.size(); i += 3)
+        entities[i]->setStatic(false);
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_EQ(stats.drawCalls, drawCalls);
+    EXPECT_EQ(getMainQueueContents(mSceneMgr).size(), serial.size());
+
+    // static objects which have to record their entries again are notified once as well
+    struct RenderingCounter : public MovableObject::Listener
+    {
+        std::map<const MovableObject*, int> counts;
+        bool objectRendering(const MovableObject* mo, const Camera*) { ++counts[mo]; return true; }
+    } counter;
+    for (size_t i = 0; i < entities.size(); i += 3)
+    {
+        entities[i]->setStatic(true);
+        entities[i]->setListener(&counter);
+        counter.counts[entities[i]] = 0;
+    }
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    int notified = 0;
+    for (size_t i = 0; i < entities.size(); i += 3)
+    {
+        EXPECT_LE(counter.counts[entities[i]], 1);
+        notified += counter.counts[entities[i]];
+        entities[i]->setListener(0);
+    }
+    EXPECT_GT(notified, 0);
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, RecordsAndReplaysRenderCommands)
+{
+    HighLevelGpuProgramManager::getSingleton()
+        .createProgram("recorded_vs", RGN_DEFAULT, "glsl", GPT_VERTEX_PROGRAM)
+        ->setSource("void main() { gl_Position = ftransform(); }");
+    HighLevelGpuProgramManager::getSingleton()
+        .createProgram("recorded_fs", RGN_DEFAULT, "glsl", GPT_FRAGMENT_PROGRAM)
+        ->setSource("void main() { gl_FragColor = vec4(1.0); }");
+    MaterialPtr mat = MaterialManager::getSingleton().create("recorded", RGN_DEFAULT);
+    Pass* pass = mat->getTechnique(0)->getPass(0);
+    pass->setVertexProgram("recorded_vs");
+    pass->setFragmentProgram("recorded_fs");
+    pass->getVertexProgramParameters()->setNamedAutoConstant(
+        "worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+
+    addPlanes(4, "BaseWhite");
+    addPlanes(3, "recorded");
+
+    RenderCommandList commands;
+    mSceneMgr->setRenderCommandList(&commands);
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    NullRenderSystem::Statistics rendered = stats;
+    mSceneMgr->setRenderCommandList(0);
+
+    EXPECT_TRUE(commands.isComplete());
+    EXPECT_EQ(commands.getDrawCount(), 7u);
+    EXPECT_EQ(commands.getCommandType(0), RenderCommandList::CT_SET_PROJECTION_MATRIX);
+    EXPECT_EQ(commands.getCommandType(commands.size() - 1), RenderCommandList::CT_RENDER);
+
+    // not recorded any more
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_EQ(commands.getDrawCount(), 7u);
+
+    mRenderSystem->resetStatistics();
+    mRenderSystem->_setViewport(mWindow->getViewport(0));
+    mRenderSystem->_beginGeometryCount();
+    mRenderSystem->_beginFrame();
+    commands.execute(mRenderSystem);
+    mRenderSystem->_endFrame();
+    mSceneMgr->_markRenderStateDirty();
+
+    EXPECT_EQ(stats.drawCalls, rendered.drawCalls);
+    // programs bound by the previous frame get unbound as well
+    EXPECT_GE(stats.programBinds, rendered.programBinds);
+    EXPECT_EQ(stats.parameterUploads, rendered.parameterUploads);
+    EXPECT_EQ(mRenderSystem->_getBatchCount(), 7u);
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, SkipsRedundantRenderState)
+{
+    MaterialPtr mat = MaterialManager::getSingleton().create("lit", RGN_DEFAULT);
+    mat->getTechnique(0)->getPass(0)->setDiffuse(ColourValue::Red);
+    addPlanes(5, "BaseWhite");
+    addPlanes(5, "lit");
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    NullRenderSystem::Statistics uncached = stats;
+    EXPECT_EQ(mSceneMgr->getRenderStateStatistics().skipped, 0u);
+
+    mSceneMgr->setRenderStateCaching(true);
+    for (int i = 0; i < 2; ++i)
+    {
+        mSceneMgr->resetRenderStateStatistics();
+        mRenderSystem->resetStatistics();
+        ASSERT_TRUE(mRoot->renderOneFrame());
+        EXPECT_EQ(stats.drawCalls, uncached.drawCalls);
+        EXPECT_LT(stats.stateChanges, uncached.stateChanges);
+        EXPECT_GT(mSceneMgr->getRenderStateStatistics().skipped, 0u);
+        EXPECT_GT(mSceneMgr->getRenderStateStatistics().applied, 0u);
+    }
+
+    // the same pass state is set again after the cache was dropped
+    mSceneMgr->_markRenderStateDirty();
+    mRenderSystem->resetStatistics();
+    mSceneMgr->_setPass(mat->getTechnique(0)->getPass(0));
+    size_t stateChanges = stats.stateChanges;
+    EXPECT_GT(stateChanges, 0u);
+    mSceneMgr->_setPass(mat->getTechnique(0)->getPass(0));
+    EXPECT_EQ(stats.stateChanges, stateChanges);
+
+    // the render system derives the depth bias per iteration, so it is set again
+    Pass* biased = MaterialManager::getSingleton().create("biased", RGN_DEFAULT)->getTechnique(0)->getPass(0);
+    biased->setIterationDepthBias(1);
+    mSceneMgr->_setPass(biased);
+    mSceneMgr->_setPass(biased);
+    mRenderSystem->resetStatistics();
+    mSceneMgr->_setPass(biased);
+    stateChanges = stats.stateChanges;
+    mSceneMgr->getRootSceneNode()->removeAndDestroyAllChildren();
+    addPlanes(1, "biased");
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    mRenderSystem->resetStatistics();
+    mSceneMgr->_setPass(biased);
+    EXPECT_EQ(stats.stateChanges, stateChanges + 1);
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, MemoisesDerivedAutoParams)
+{
+    SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+        Vector3(10, 20, 30), Quaternion(Degree(30), Vector3::UNIT_Y));
+    Entity* first = mSceneMgr->createEntity("plane");
+    Entity* second = mSceneMgr->createEntity("plane");
+    node->attachObject(first);
+    node->attachObject(second);
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(mSceneMgr);
+    source.setCurrentViewport(mWindow->getViewport(0));
+    source.setCurrentCamera(mCamera, false);
+
+    source.setCurrentRenderable(first->getSubEntity(0));
+    source.getInverseWorldMatrix();
+    source.getViewProjectionMatrix();
+    EXPECT_EQ(source.getCacheStatistics().hits, 0u);
+    EXPECT_EQ(source.getCacheStatistics().misses, 2u);
+
+    // same world transform and camera
+    source.resetCacheStatistics();
+    source.setCurrentRenderable(second->getSubEntity(0));
+    source.getInverseWorldMatrix();
+    source.getViewProjectionMatrix();
+    EXPECT_EQ(source.getCacheStatistics().hits, 2u);
+    EXPECT_EQ(source.getCacheStatistics().misses, 0u);
+
+    // a moved node only invalidates what depends on the world matrix
+    node->translate(5, 0, 0);
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+    source.resetCacheStatistics();
+    source.setCurrentRenderable(first->getSubEntity(0));
+    EXPECT_EQ(source.getInverseWorldMatrix(), node->_getFullTransform().inverse());
+    source.getViewProjectionMatrix();
+    EXPECT_EQ(source.getCacheStatistics().hits, 1u);
+    EXPECT_EQ(source.getCacheStatistics().misses, 1u);
+
+    // as does a moved camera for the view dependent values
+    mCamera->getParentSceneNode()->translate(0, 10, 0);
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+    source.setCurrentCamera(mCamera, false);
+    source.setCurrentRenderable(first->getSubEntity(0));
+    EXPECT_EQ(source.getViewProjectionMatrix(),
+              mCamera->getProjectionMatrixWithRSDepth() * mCamera->getViewMatrix(true));
+    EXPECT_EQ(source.getCameraPositionObjectSpace(),
+              Vector4(node->_getFullTransform().inverse() * mCamera->getDerivedPosition()));
+}
+//--------------------------------------------------------------------------
+namespace
+{
+void addFloatConstant(GpuNamedConstants& defs, const String& name, GpuConstantType type)
+{
+    GpuConstantDefinition def;
+    def.constType = type;
+    def.elementSize = GpuConstantDefinition::getElementSize(type, false);
+    def.arraySize = 1;
+    def.logicalIndex = defs.map.size();
+    def.physicalIndex = defs.floatBufferSize;
+    defs.floatBufferSize += def.elementSize;
+    defs.map[name] = def;
+}
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, SharedParamsUniformBuffer)
+{
+    GpuSharedParametersPtr frame = GpuProgramManager::getSingleton().createSharedParameters("frame");
+    frame->addConstantDefinition("viewProj", GCT_MATRIX_4X4);
+    frame->addConstantDefinition("time", GCT_FLOAT1);
+    frame->addConstantDefinition("frameIndex", GCT_INT1);
+
+    GpuNamedConstants constants;
+    addFloatConstant(constants, "viewProj", GCT_MATRIX_4X4);
+    addFloatConstant(constants, "time", GCT_FLOAT1);
+    GpuProgramPtr vp = GpuProgramManager::getSingleton().createProgramFromString(
+        "shared", RGN_DEFAULT, "", GPT_VERTEX_PROGRAM, "glsl");
+    vp->setManualNamedConstants(constants);
+
+    GpuProgramParametersSharedPtr params[2] = {vp->createParameters(), vp->createParameters()};
+    for (int i = 0; i < 2; ++i)
+        params[i]->addSharedParameters(frame);
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    size_t timeIndex = params[1]->getConstantDefinition("time").physicalIndex;
+
+    // by default the set is copied into every program
+    frame->setNamedConstant("time", Real(1));
+    mRenderSystem->resetStatistics();
+    for (int i = 0; i < 2; ++i)
+        mRenderSystem->bindGpuProgramParameters(GPT_VERTEX_PROGRAM, params[i], GPV_GLOBAL);
+    EXPECT_EQ(stats.sharedParameterCopies, 2u);
+    EXPECT_EQ(stats.sharedParameterBytes, 2 * 17 * sizeof(float));
+    EXPECT_EQ(stats.uniformBufferUploads, 0u);
+    EXPECT_FLOAT_EQ(params[1]->getFloatPointer(timeIndex)[0], 1);
+
+    // render systems that do not bind the buffer would never see the values
+    mRenderSystem->getMutableCapabilities()->unsetCapability(RSC_SHARED_PARAMETER_BUFFERS);
+    EXPECT_THROW(frame->enableUniformBuffer(), InvalidStateException);
+    EXPECT_FALSE(frame->_getHardwareBuffer());
+    mRenderSystem->getMutableCapabilities()->setCapability(RSC_SHARED_PARAMETER_BUFFERS);
+
+    frame->enableUniformBuffer();
+    ASSERT_TRUE(frame->_getHardwareBuffer());
+    // whole vec4s, like std140 uniform blocks
+    EXPECT_EQ(frame->_getHardwareBuffer()->getSizeInBytes(), 20 * sizeof(float));
+
+    // the first bind writes the whole buffer once
+    mRenderSystem->resetStatistics();
+    for (int i = 0; i < 2; ++i)
+        mRenderSystem->bindGpuProgramParameters(GPT_VERTEX_PROGRAM, params[i], GPV_GLOBAL);
+    EXPECT_EQ(stats.sharedParameterCopies, 0u);
+    EXPECT_EQ(stats.uniformBufferUploads, 1u);
+    EXPECT_EQ(stats.uniformBufferBytes, 17 * sizeof(float));
+    EXPECT_FALSE(frame->isDirty());
+
+    // only the changed constant is written, int constants are not in the buffer
+    frame->setNamedConstant("frameIndex", 3);
+    frame->setNamedConstant("time", Real(2));
+    mRenderSystem->resetStatistics();
+    for (int i = 0; i < 2; ++i)
+        mRenderSystem->bindGpuProgramParameters(GPT_VERTEX_PROGRAM, params[i], GPV_GLOBAL);
+    EXPECT_EQ(stats.uniformBufferUploads, 1u);
+    EXPECT_EQ(stats.uniformBufferBytes, sizeof(float));
+
+    float time = 0;
+    frame->_getHardwareBuffer()->readData(16 * sizeof(float), sizeof(float), &time);
+    EXPECT_FLOAT_EQ(time, 2);
+    // programs no longer receive copies
+    EXPECT_FLOAT_EQ(params[1]->getFloatPointer(timeIndex)[0], 1);
+
+    // nothing changed, nothing written
+    mRenderSystem->resetStatistics();
+    mRenderSystem->bindGpuProgramParameters(GPT_VERTEX_PROGRAM, params[0], GPV_GLOBAL);
+    EXPECT_EQ(stats.uniformBufferUploads, 0u);
+
+    // new definitions recreate the buffer
+    frame->addConstantDefinition("fogColour", GCT_FLOAT4);
+    EXPECT_EQ(frame->_getHardwareBuffer()->getSizeInBytes(), 24 * sizeof(float));
+    EXPECT_TRUE(frame->isDirty());
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, MicrocodeCache)
+{
+    GpuProgramManager& mgr = GpuProgramManager::getSingleton();
+    for (uint32 id = 1; id <= 3; ++id)
+    {
+        GpuProgramManager::Microcode microcode = mgr.createMicrocode(1000);
+        memset(microcode->getPtr(), int(id), 1000);
+        mgr.addMicrocodeToCache(id, microcode);
+    }
+    EXPECT_TRUE(mgr.isCacheDirty());
+
+    DataStreamPtr file(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveMicrocodeCache(file);
+#if OGRE_NO_ZIP_ARCHIVE == 0
+    EXPECT_LT(file->tell(), 1000u);
+#endif
+    file->seek(0);
+    mgr.loadMicrocodeCache(file);
+    EXPECT_FALSE(mgr.isCacheDirty());
+
+    ASSERT_TRUE(mgr.isMicrocodeAvailableInCache(2));
+    const GpuProgramManager::Microcode& microcode = mgr.getMicrocodeFromCache(2);
+    ASSERT_EQ(microcode->size(), 1000u);
+    EXPECT_EQ(microcode->getPtr()[0], 2);
+    EXPECT_EQ(microcode->getPtr()[999], 2);
+    EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(4));
+
+    // entries not used in this session are dropped
+    mgr.setMicrocodeCacheMaxAge(1);
+    mgr.addMicrocodeToCache(4, mgr.createMicrocode(16));
+    DataStreamPtr file2(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveMicrocodeCache(file2);
+    file2->seek(0);
+    mgr.loadMicrocodeCache(file2);
+    EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(1));
+    EXPECT_TRUE(mgr.isMicrocodeAvailableInCache(2));
+    EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(3));
+    EXPECT_TRUE(mgr.isMicrocodeAvailableInCache(4));
+    EXPECT_EQ(mgr.getMicrocodeFromCache(2)->getPtr()[500], 2);
+
+    // incompressible entries round trip as well
+    GpuProgramManager::Microcode noise = mgr.createMicrocode(1000);
+    uint32 seed = 1;
+    for (size_t i = 0; i < noise->size(); ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        noise->getPtr()[i] = uchar(seed >> 24);
+    }
+    mgr.setMicrocodeCacheMaxAge(0);
+    mgr.addMicrocodeToCache(5, noise);
+    DataStreamPtr file3(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveMicrocodeCache(file3);
+    file3->seek(0);
+    mgr.loadMicrocodeCache(file3);
+
+    // the cache may be saved over its source before all entries were used
+    mgr.addMicrocodeToCache(6, mgr.createMicrocode(16));
+    file3->seek(0);
+    mgr.saveMicrocodeCache(file3);
+    file3->seek(0);
+    mgr.loadMicrocodeCache(file3);
+    ASSERT_TRUE(mgr.isMicrocodeAvailableInCache(5));
+    EXPECT_EQ(memcmp(mgr.getMicrocodeFromCache(5)->getPtr(), noise->getPtr(), noise->size()), 0);
+    EXPECT_EQ(mgr.getMicrocodeFromCache(2)->getPtr()[999], 2);
+    EXPECT_TRUE(mgr.isMicrocodeAvailableInCache(6));
+    EXPECT_THROW(mgr.getMicrocodeFromCache(7), ItemIdentityException);
+
+    // like a file opened twice, the entries not used yet are read from the source
+    std::vector<uchar> fileData(64 * 1024);
+    DataStreamPtr source(OGRE_NEW MemoryDataStream("shaders.cache", fileData.data(), fileData.size()));
+    mgr.addMicrocodeToCache(8, mgr.createMicrocode(16));
+    mgr.saveMicrocodeCache(source);
+    source->seek(0);
+    mgr.loadMicrocodeCache(source);
+    mgr.addMicrocodeToCache(9, mgr.createMicrocode(16));
+    DataStreamPtr dest(OGRE_NEW MemoryDataStream("shaders.cache", fileData.data(), fileData.size()));
+    mgr.saveMicrocodeCache(dest);
+    std::fill(fileData.begin(), fileData.end(), 0);
+    ASSERT_TRUE(mgr.isMicrocodeAvailableInCache(5));
+    EXPECT_EQ(memcmp(mgr.getMicrocodeFromCache(5)->getPtr(), noise->getPtr(), noise->size()), 0);
+    EXPECT_EQ(mgr.getMicrocodeFromCache(2)->getPtr()[0], 2);
+
+#if OGRE_NO_ZIP_ARCHIVE == 0
+    // corrupt entries are reported and dropped
+    GpuProgramManager::Microcode microcode7 = mgr.createMicrocode(1000);
+    memset(microcode7->getPtr(), 7, 1000);
+    mgr.addMicrocodeToCache(7, microcode7);
+    DataStreamPtr file4(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveMicrocodeCache(file4);
+    // inside the data of the last entry
+    size_t corruptPos = file4->tell() - 8;
+    uchar byte;
+    file4->seek(corruptPos);
+    file4->read(&byte, 1);
+    byte ^= 0xff;
+    file4->seek(corruptPos);
+    file4->write(&byte, 1);
+    file4->seek(0);
+    mgr.loadMicrocodeCache(file4);
+    EXPECT_THROW(mgr.getMicrocodeFromCache(7), InvalidStateException);
+    EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(7));
+    EXPECT_TRUE(mgr.isCacheDirty());
+#endif
+}
+//--------------------------------------------------------------------------
+TEST_F(NullRenderSystemTests, ParallelAnimationUpdate)
+{
+    mRoot->getWorkQueue()->startup();
+
+    // a quad bent by a chain of bones, with spline interpolation built on demand
+    const unsigned short numBones = 4;
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("chain", RGN_DEFAULT, true);
+    Bone* bone = skel->createBone(0);
+    for (unsigned short i = 1; i < numBones; ++i)
+        bone = bone->createChild(i, Vector3(0, 25, 0));
+    skel->setBindingPose();
+    Animation* anim = skel->createAnimation("bend", 2);
+    anim->setInterpolationMode(Animation::IM_SPLINE);
+    for (unsigned short i = 0; i < numBones; ++i)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(i, skel->getBone(i));
+        for (int k = 0; k <= 4; ++k)
+            track->createNodeKeyFrame(k * 0.5f)->setRotation(
+                Quaternion(Degree(Real(k * 10 + i)), Vector3::UNIT_Z));
+    }
+
+    MeshPtr mesh = MeshManager::getSingleton().createPlane("skinned", RGN_DEFAULT,
+                                                           Plane(Vector3::UNIT_Z, 0), 20, 100);
+    for (unsigned int v = 0; v < mesh->sharedVertexData->vertexCount; ++v)
+    {
+        VertexBoneAssignment vba;
+        vba.vertexIndex = v;
+        vba.boneIndex = static_cast<unsigned short>(v % numBones);
+        vba.weight = 1;
+        mesh->addBoneAssignment(vba);
+    }
+    mesh->_notifySkeleton(skel);
+    mesh->_compileBoneAssignments();
+
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 20; ++i)
+    {
+        Entity* ent = mSceneMgr->createEntity("skinned");
+        ent->getAnimationState("bend")->setEnabled(true);
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+        node->setPosition(Real(i * 10 - 100), 0, 0);
+        node->attachObject(ent);
+        entities.push_back(ent);
+    }
+    // updated as usual, as the skeleton is shared or an object is attached to a bone
+    entities[1]->shareSkeletonInstanceWith(entities[2]);
+    entities[3]->attachObjectToBone(skel->getBone(2)->getName(), mSceneMgr->createEntity("plane"));
+
+    std::vector<Affine3> serial;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        mSceneMgr->setParallelAnimationUpdate(pass == 1);
+        for (size_t i = 0; i < entities.size(); ++i)
+            entities[i]->getAnimationState("bend")->setTimePosition(0);
+        ASSERT_TRUE(mRoot->renderOneFrame());
+
+        for (size_t i = 0; i < entities.size(); ++i)
+            entities[i]->getAnimationState("bend")->setTimePosition(Real(i) / 10);
+        ASSERT_TRUE(mRoot->renderOneFrame());
+
+        std::vector<Affine3> matrices;
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            const Affine3* m = entities[i]->_getBoneMatrices();
+            matrices.insert(matrices.end(), m, m + entities[i]->_getNumBoneMatrices());
+        }
+        if (pass == 0)
+            serial = matrices;
+        else
+            EXPECT_TRUE(matrices == serial);
+    }
+
+    // skeletons are updated before culling, so also when leaving the view
+    Entity* ent = entities.back();
+    Affine3 first = ent->_getBoneMatrices()[1];
+    ent->getParentSceneNode()->setPosition(0, 0, 1000);
+    ent->getAnimationState("bend")->setTimePosition(1.5f);
+    ASSERT_TRUE(mRoot->renderOneFrame());
+    EXPECT_NE(ent->_getBoneMatrices()[1], first);
+}
@@ -50,6 +50,7 @@ void help(void)
 {
     // Print help message
     cout << endl << "OgreMeshUpgrader: Upgrades or downgrades .mesh file versions." << endl;
+    cout << "Also upgrades .skeleton files, optionally reducing their keyframes." << endl;
     cout << "Provided for OGRE by Steve Streeting 2004-2014" << endl << endl;
     cout << "Usage: OgreMeshUpgrader [opts] sourcefile [destfile] " << endl;
     cout << "-i             = Interactive mode, prompt for options" << endl;
@@ -74,6 +75,10 @@ void help(void)
     cout << "-b         = Recalculate bounding box (static meshes only)" << endl;
     cout << "-V version = Specify OGRE version format to write instead of latest" << endl;
     cout << "             Options are: 1.10, 1.8, 1.7, 1.4, 1.0" << endl;
+    cout << "-kt tolerance  = Remove skeleton keyframes which interpolation reproduces" << endl;
+    cout << "                 within this distance (default 0.001 if -kr or -ks is given)" << endl;
+    cout << "-kr degrees    = Rotation tolerance of keyframe reduction (default 0.1)" << endl;
+    cout << "-ks tolerance  = Scale tolerance of keyframe reduction (default 0.001)" << endl;
     cout << "sourcefile = name of file to convert" << endl;
     cout << "destfile   = optional name of file to write to. If you don't" << endl;
     cout << "             specify this OGRE overwrites the existing file." << endl;
@@ -103,6 +108,10 @@ struct UpgradeOptions {
     Serializer::Endian endian;
     bool recalcBounds;
     MeshVersion targetVersion;
+    bool reduceKeyFrames;
+    Real keyTranslationTolerance;
+    Real keyRotationTolerance;
+    Real keyScaleTolerance;
 
 };
 
@@ -144,6 +153,10 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     opts.usePercent = true;
     opts.recalcBounds = false;
     opts.targetVersion = MESH_VERSION_LATEST;
+    opts.reduceKeyFrames = false;
+    opts.keyTranslationTolerance = 0.001f;
+    opts.keyRotationTolerance = 0.1f;
+    opts.keyScaleTolerance = 0.001f;
 
 
     UnaryOptionList::iterator ui = unOpts.find("-e");
@@ -252,6 +265,22 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
             logMgr->stream() << "Unrecognised target mesh version '" << bi->second << "'";          
     }
     }
+
+    bi = binOpts.find("-kt");
+    if (!bi->second.empty()) {
+        opts.reduceKeyFrames = true;
+        opts.keyTranslationTolerance = StringConverter::parseReal(bi->second);
+    }
+    bi = binOpts.find("-kr");
+    if (!bi->second.empty()) {
+        opts.reduceKeyFrames = true;
+        opts.keyRotationTolerance = StringConverter::parseReal(bi->second);
+    }
+    bi = binOpts.find("-ks");
+    if (!bi->second.empty()) {
+        opts.reduceKeyFrames = true;
+        opts.keyScaleTolerance = StringConverter::parseReal(bi->second);
+    }
     
 }
 
@@ -979,6 +1008,142 @@ void resolveColourAmbiguities(Mesh* mesh)
 
 
 }
+
+void upgradeSkeleton(DataStreamPtr& stream, const String& dest)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("conversion",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    skeletonSerializer->importSkeleton(stream, skel.get());
+
+    if (opts.reduceKeyFrames) {
+        cout << "\nReducing keyframes...";
+        size_t before = 0, after = 0;
+        for (unsigned short i = 0; i < skel->getNumAnimations(); ++i) {
+            Animation* anim = skel->getAnimation(i);
+            Animation::NodeTrackIterator it = anim->getNodeTrackIterator();
+            while (it.hasMoreElements())
+                before += it.getNext()->getNumKeyFrames();
+
+            anim->reduceNodeKeyFrames(opts.keyTranslationTolerance,
+                Degree(opts.keyRotationTolerance), opts.keyScaleTolerance);
+
+            it = anim->getNodeTrackIterator();
+            while (it.hasMoreElements())
+                after += it.getNext()->getNumKeyFrames();
+        }
+        cout << "success, " << after << " of " << before << " keyframes left\n";
+    }
+
+    // the skeleton format changed in 1.8
+    SkeletonVersion version = opts.targetVersion <= MESH_VERSION_1_8 ? SKELETON_VERSION_LATEST
+                                                                      : SKELETON_VERSION_1_0;
+    skeletonSerializer->exportSkeleton(skel.get(), dest, version, opts.endian);
+}
+
+void upgradeMesh(DataStreamPtr& stream, const String& dest)
+{
+    MeshPtr meshPtr = MeshManager::getSingleton().createManual("conversion",
+                                                               ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Mesh* mesh = meshPtr.get();
+
+    meshSerializer->importMesh(stream, mesh);
+
+    String response;
+
+    vertexBufferReorg(*mesh);
+
+    // Deal with VET_COLOUR ambiguities
+    resolveColourAmbiguities(mesh);
+    
+    buildLod(meshPtr);
+
+    if (opts.interactive) {
+        do {
+            std::cout << "\nWould you like to (b)uild/(r)emove/(k)eep Edge lists? (b/r/k) ";
+            cin >> response;
+            StringUtil::toLowerCase(response);
+            if (response == "k") {
+                // Do nothing
+            } else if (response == "b") {
+                cout << "\nGenerating edge lists...";
+                mesh->buildEdgeList();
+                cout << "success\n";
+            } else if (response == "r") {
+                mesh->freeEdgeList();
+            } else {
+                std::cout << "Wrong answer!\n";
+                response = "";
+            }
+        } while (response == "");
+    } else {
+    // Make sure we generate edge lists, provided they are not deliberately disabled
+        if (!opts.suppressEdgeLists) {
+            cout << "\nGenerating edge lists...";
+            mesh->buildEdgeList();
+            cout << "success\n";
+        } else {
+            mesh->freeEdgeList();
+    }
+    }
+    if (opts.interactive) {
+        do {
+            std::cout << "\nWould you like to (g)enerate/(k)eep tangent buffer? (g/k) ";
+            cin >> response;
+            StringUtil::toLowerCase(response);
+            if (response == "k") {
+                opts.generateTangents = false;
+            } else if (response == "g") {
+                opts.generateTangents = true;
+            } else {
+                std::cout << "Wrong answer!\n";
+                response = "";
+            }
+        } while (response == "");
+    }
+    // Generate tangents?
+    if (opts.generateTangents) {
+        unsigned short srcTex, destTex;
+        bool existing = mesh->suggestTangentVectorBuildParams(opts.tangentSemantic, srcTex, destTex);
+        if (existing) {
+            if (opts.interactive) {
+                do {
+                std::cout << "\nThis mesh appears to already have a set of tangents, " <<
+                    "which would suggest tangent vectors have already been calculated. Do you really " <<
+                    "want to generate new tangent vectors (may duplicate)? (y/n) ";
+                    cin >> response;
+                    StringUtil::toLowerCase(response);
+                    if (response == "y") {
+                        // Do nothing
+                    } else if (response == "n") {
+                        opts.generateTangents = false;
+                    } else {
+                        std::cout << "Wrong answer!\n";
+                        response = "";
+                    }
+
+                } while (response == "");
+            } else {
+                // safe
+                opts.generateTangents = false;
+            }
+
+        }
+        if (opts.generateTangents) {
+            cout << "\nGenerating tangent vectors....";
+            mesh->buildTangentVectors(opts.tangentSemantic, srcTex, destTex,
+                opts.tangentSplitMirrored, opts.tangentSplitRotated, 
+                opts.tangentUseParity);
+            cout << "success" << std::endl;
+        }
+    }
+
+
+    if (opts.recalcBounds) {
+        recalcBounds(mesh);
+    }
+
+    meshSerializer->exportMesh(mesh, dest, opts.targetVersion, opts.endian);
+}
 }
 
 int main(int numargs, char** args)
@@ -1030,6 +1195,9 @@ int main(int numargs, char** args)
         binOptList["-td"] = "";
         binOptList["-ts"] = "";
         binOptList["-V"] = "";
+        binOptList["-kt"] = "";
+        binOptList["-kr"] = "";
+        binOptList["-ks"] = "";
 
         int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
         parseOpts(unOptList, binOptList);
@@ -1053,12 +1221,7 @@ int main(int numargs, char** args)
                 "Unexpected error while reading file " + source, "OgreMeshUpgrade");
         fclose( pFile );
 
-        MeshPtr meshPtr = MeshManager::getSingleton().createManual("conversion",
-                                                                   ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-        Mesh* mesh = meshPtr.get();
-
         DataStreamPtr stream(memstream);
-        meshSerializer->importMesh(stream, mesh);
 
         // Write out the converted mesh
         String dest;
@@ -1068,101 +1231,10 @@ int main(int numargs, char** args)
             dest = source;
         }
 
-        String response;
-
-        vertexBufferReorg(*mesh);
-
-        // Deal with VET_COLOUR ambiguities
-        resolveColourAmbiguities(mesh);
-        
-        buildLod(meshPtr);
-
-        if (opts.interactive) {
-            do {
-                std::cout << "\nWould you like to (b)uild/(r)emove/(k)eep Edge lists? (b/r/k) ";
-                cin >> response;
-                StringUtil::toLowerCase(response);
-                if (response == "k") {
-                    // Do nothing
-                } else if (response == "b") {
-                    cout << "\nGenerating edge lists...";
-                    mesh->buildEdgeList();
-                    cout << "success\n";
-                } else if (response == "r") {
-                    mesh->freeEdgeList();
-                } else {
-                    std::cout << "Wrong answer!\n";
-                    response = "";
-                }
-            } while (response == "");
-        } else {
-        // Make sure we generate edge lists, provided they are not deliberately disabled
-            if (!opts.suppressEdgeLists) {
-                cout << "\nGenerating edge lists...";
-                mesh->buildEdgeList();
-                cout << "success\n";
-            } else {
-                mesh->freeEdgeList();
-        }
-        }
-        if (opts.interactive) {
-            do {
-                std::cout << "\nWould you like to (g)enerate/(k)eep tangent buffer? (g/k) ";
-                cin >> response;
-                StringUtil::toLowerCase(response);
-                if (response == "k") {
-                    opts.generateTangents = false;
-                } else if (response == "g") {
-                    opts.generateTangents = true;
-                } else {
-                    std::cout << "Wrong answer!\n";
-                    response = "";
-                }
-            } while (response == "");
-        }
-        // Generate tangents?
-        if (opts.generateTangents) {
-            unsigned short srcTex, destTex;
-            bool existing = mesh->suggestTangentVectorBuildParams(opts.tangentSemantic, srcTex, destTex);
-            if (existing) {
-                if (opts.interactive) {
-                    do {
-                    std::cout << "\nThis mesh appears to already have a set of tangents, " <<
-                        "which would suggest tangent vectors have already been calculated. Do you really " <<
-                        "want to generate new tangent vectors (may duplicate)? (y/n) ";
-                        cin >> response;
-                        StringUtil::toLowerCase(response);
-                        if (response == "y") {
-                            // Do nothing
-                        } else if (response == "n") {
-                            opts.generateTangents = false;
-                        } else {
-                            std::cout << "Wrong answer!\n";
-                            response = "";
-                        }
-
-                    } while (response == "");
-                } else {
-                    // safe
-                    opts.generateTangents = false;
-                }
-
-            }
-            if (opts.generateTangents) {
-                cout << "\nGenerating tangent vectors....";
-                mesh->buildTangentVectors(opts.tangentSemantic, srcTex, destTex,
-                    opts.tangentSplitMirrored, opts.tangentSplitRotated, 
-                    opts.tangentUseParity);
-                cout << "success" << std::endl;
-            }
-        }
-
-
-        if (opts.recalcBounds) {
-            recalcBounds(mesh);
-        }
-
-        meshSerializer->exportMesh(mesh, dest, opts.targetVersion, opts.endian);
+        if (StringUtil::endsWith(source, ".skeleton"))
+            upgradeSkeleton(stream, dest);
+        else
+            upgradeMesh(stream, dest);
     
     }
     catch (Exception& e)
@@ -592,7 +592,8 @@ namespace Ogre {
             trackNode->InsertEndChild(TiXmlElement("keyframes"))->ToElement();
         for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
         {
-            writeKeyFrame(keysNode, track->getNodeKeyFrame(i));
+            TransformKeyFrame key = track->getNodeKeyFrameCopy(i);
+            writeKeyFrame(keysNode, &key);
         }
     }
     //---------------------------------------------------------------------